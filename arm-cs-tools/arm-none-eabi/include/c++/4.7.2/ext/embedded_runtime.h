@@ -0,0 +1,130 @@
+// Minimal C++ runtime support for exception-free builds -*- C++ -*-
+
+// Copyright (C) 2012
+// Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// Under Section 7 of GPL version 3, you are granted additional
+// permissions described in the GCC Runtime Library Exception, version
+// 3.1, as published by the Free Software Foundation.
+
+// You should have received a copy of the GNU General Public License and
+// a copy of the GCC Runtime Library Exception along with this program;
+// see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+// <http://www.gnu.org/licenses/>.
+
+/** @file ext/embedded_runtime.h
+ *  This file is a GNU extension to the Standard C++ Library.
+ *
+ *  Replacement runtime hooks for programs built without exceptions
+ *  and RTTI.  Compile every translation unit with
+ *
+ *    -fno-exceptions -fno-rtti -fno-unwind-tables
+ *    -fno-asynchronous-unwind-tables -fno-threadsafe-statics
+ *
+ *  and include this header, with _GLIBCXX_EMBEDDED_RUNTIME_DEFINE
+ *  defined, in exactly one of them.  That translation unit then
+ *  provides operator new and delete on top of malloc() and free(),
+ *  aborting instead of throwing std::bad_alloc, along with
+ *  __cxa_pure_virtual and the ARM EHABI personality routines.
+ *  Defining these keeps the linker from pulling the unwinder, the
+ *  exception classes and their type_info objects out of libsupc++
+ *  and libgcc.
+ *
+ *  The nothrow forms of operator new return 0 on failure as usual.
+ *  Code that throws, uses dynamic_cast or typeid on polymorphic
+ *  types, or relies on std::set_new_handler cannot be used in this
+ *  configuration.
+ */
+
+#ifndef _EMBEDDED_RUNTIME_H
+#define _EMBEDDED_RUNTIME_H 1
+
+#include <bits/c++config.h>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS)
+# warning "ext/embedded_runtime.h is meant for -fno-exceptions builds"
+#endif
+
+#ifdef _GLIBCXX_EMBEDDED_RUNTIME_DEFINE
+
+void*
+operator new(std::size_t __sz) _GLIBCXX_THROW (std::bad_alloc)
+{
+  void* __p = std::malloc(__sz ? __sz : 1);
+  if (!__p)
+    std::abort();
+  return __p;
+}
+
+void*
+operator new[](std::size_t __sz) _GLIBCXX_THROW (std::bad_alloc)
+{ return ::operator new(__sz); }
+
+void*
+operator new(std::size_t __sz, const std::nothrow_t&) _GLIBCXX_USE_NOEXCEPT
+{ return std::malloc(__sz ? __sz : 1); }
+
+void*
+operator new[](std::size_t __sz, const std::nothrow_t&) _GLIBCXX_USE_NOEXCEPT
+{ return std::malloc(__sz ? __sz : 1); }
+
+void
+operator delete(void* __p) _GLIBCXX_USE_NOEXCEPT
+{ std::free(__p); }
+
+void
+operator delete[](void* __p) _GLIBCXX_USE_NOEXCEPT
+{ std::free(__p); }
+
+void
+operator delete(void* __p, const std::nothrow_t&) _GLIBCXX_USE_NOEXCEPT
+{ std::free(__p); }
+
+void
+operator delete[](void* __p, const std::nothrow_t&) _GLIBCXX_USE_NOEXCEPT
+{ std::free(__p); }
+
+extern "C"
+{
+  // Called if a pure virtual function is invoked during construction
+  // or destruction.  The libsupc++ version writes a message through
+  // the verbose terminate handler, which drags in stdio.
+  void
+  __cxa_pure_virtual()
+  { std::abort(); }
+
+#ifdef __ARM_EABI__
+  // Only referenced from unwind tables.  With unwind tables disabled
+  // nothing should call these; defining them stops a stray reference
+  // from linking the whole unwinder.
+  void
+  __aeabi_unwind_cpp_pr0()
+  { std::abort(); }
+
+  void
+  __aeabi_unwind_cpp_pr1()
+  { std::abort(); }
+
+  void
+  __aeabi_unwind_cpp_pr2()
+  { std::abort(); }
+#endif
+}
+
+#endif // _GLIBCXX_EMBEDDED_RUNTIME_DEFINE
+
+#endif
@@ -0,0 +1,605 @@
+// Fixed-capacity, non-allocating containers -*- C++ -*-
+
+// Copyright (C) 2012
+// Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// Under Section 7 of GPL version 3, you are granted additional
+// permissions described in the GCC Runtime Library Exception, version
+// 3.1, as published by the Free Software Foundation.
+
+// You should have received a copy of the GNU General Public License and
+// a copy of the GCC Runtime Library Exception along with this program;
+// see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+// <http://www.gnu.org/licenses/>.
+
+/** @file ext/fixed_containers.h
+ *  This file is a GNU extension to the Standard C++ Library.
+ *
+ *  Containers whose storage is part of the container object itself.
+ *  None of them allocate memory or throw: operations that would
+ *  exceed the capacity return false instead, so they can be used
+ *  with -fno-exceptions and on systems without a heap.
+ */
+
+#ifndef _FIXED_CONTAINERS_H
+#define _FIXED_CONTAINERS_H 1
+
+#include <bits/c++config.h>
+#include <cstddef>
+#include <new>
+#include <bits/stl_function.h>
+#include <bits/move.h>
+
+extern "C"
+{
+  /**
+   *  @brief  Link of an intrusive_list.
+   *
+   *  This is a plain C struct so that it can be embedded in structs
+   *  that are shared with C code.  An unlinked hook has both pointers
+   *  set to 0.
+   */
+  struct fixed_list_hook
+  {
+    struct fixed_list_hook* next;
+    struct fixed_list_hook* prev;
+  };
+}
+
+namespace __gnu_cxx _GLIBCXX_VISIBILITY(default)
+{
+_GLIBCXX_BEGIN_NAMESPACE_VERSION
+
+  using std::size_t;
+
+  /// Uninitialized storage for _Nm objects of type _Tp.
+  template<typename _Tp, size_t _Nm>
+    union __fixed_storage
+    {
+      char        _M_bytes[_Nm * sizeof(_Tp) ? _Nm * sizeof(_Tp) : 1];
+      long double _M_align_ld;
+      long long   _M_align_ll;
+      void*       _M_align_p;
+
+      _Tp*
+      _M_ptr() _GLIBCXX_USE_NOEXCEPT
+      { return reinterpret_cast<_Tp*>(_M_bytes); }
+
+      const _Tp*
+      _M_ptr() const _GLIBCXX_USE_NOEXCEPT
+      { return reinterpret_cast<const _Tp*>(_M_bytes); }
+    };
+
+  /**
+   *  @brief  A vector with a fixed capacity and in-object storage.
+   *
+   *  Elements are constructed in place and the interface follows
+   *  std::vector, except that push_back() and insert() return false
+   *  when the vector is full.
+   */
+  template<typename _Tp, size_t _Nm>
+    class static_vector
+    {
+    public:
+      typedef _Tp        value_type;
+      typedef _Tp*       pointer;
+      typedef const _Tp* const_pointer;
+      typedef _Tp&       reference;
+      typedef const _Tp& const_reference;
+      typedef _Tp*       iterator;
+      typedef const _Tp* const_iterator;
+      typedef size_t     size_type;
+
+    private:
+      __fixed_storage<_Tp, _Nm> _M_storage;
+      size_type                 _M_size;
+
+    public:
+      static_vector() _GLIBCXX_USE_NOEXCEPT
+      : _M_size(0) { }
+
+      static_vector(const static_vector& __o)
+      : _M_size(0)
+      {
+	for (const_iterator __it = __o.begin(); __it != __o.end(); ++__it)
+	  push_back(*__it);
+      }
+
+      static_vector&
+      operator=(const static_vector& __o)
+      {
+	if (this != &__o)
+	  {
+	    clear();
+	    for (const_iterator __it = __o.begin(); __it != __o.end(); ++__it)
+	      push_back(*__it);
+	  }
+	return *this;
+      }
+
+      ~static_vector()
+      { clear(); }
+
+      iterator
+      begin() _GLIBCXX_USE_NOEXCEPT
+      { return _M_storage._M_ptr(); }
+
+      const_iterator
+      begin() const _GLIBCXX_USE_NOEXCEPT
+      { return _M_storage._M_ptr(); }
+
+      iterator
+      end() _GLIBCXX_USE_NOEXCEPT
+      { return _M_storage._M_ptr() + _M_size; }
+
+      const_iterator
+      end() const _GLIBCXX_USE_NOEXCEPT
+      { return _M_storage._M_ptr() + _M_size; }
+
+      size_type
+      size() const _GLIBCXX_USE_NOEXCEPT
+      { return _M_size; }
+
+      static size_type
+      capacity() _GLIBCXX_USE_NOEXCEPT
+      { return _Nm; }
+
+      bool
+      empty() const _GLIBCXX_USE_NOEXCEPT
+      { return _M_size == 0; }
+
+      bool
+      full() const _GLIBCXX_USE_NOEXCEPT
+      { return _M_size == _Nm; }
+
+      reference
+      operator[](size_type __n) _GLIBCXX_USE_NOEXCEPT
+      { return begin()[__n]; }
+
+      const_reference
+      operator[](size_type __n) const _GLIBCXX_USE_NOEXCEPT
+      { return begin()[__n]; }
+
+      reference
+      front() _GLIBCXX_USE_NOEXCEPT
+      { return *begin(); }
+
+      reference
+      back() _GLIBCXX_USE_NOEXCEPT
+      { return end()[-1]; }
+
+      pointer
+      data() _GLIBCXX_USE_NOEXCEPT
+      { return begin(); }
+
+      /// Appends a copy of __x.  Returns false if the vector is full.
+      bool
+      push_back(const value_type& __x)
+      {
+	if (full())
+	  return false;
+	::new((void *)end()) value_type(__x);
+	++_M_size;
+	return true;
+      }
+
+      void
+      pop_back()
+      {
+	--_M_size;
+	end()->~value_type();
+      }
+
+      /// Inserts a copy of __x before __pos.  Returns false if the
+      /// vector is full.
+      bool
+      insert(iterator __pos, const value_type& __x)
+      {
+	if (full())
+	  return false;
+	if (__pos == end())
+	  return push_back(__x);
+	value_type __tmp(__x);
+	::new((void *)end()) value_type(back());
+	++_M_size;
+	for (iterator __it = end() - 2; __it != __pos; --__it)
+	  *__it = __it[-1];
+	*__pos = __tmp;
+	return true;
+      }
+
+      /// Erases the element at __pos and returns the iterator that
+      /// follows it.
+      iterator
+      erase(iterator __pos)
+      {
+	for (iterator __it = __pos; __it + 1 != end(); ++__it)
+	  *__it = __it[1];
+	pop_back();
+	return __pos;
+      }
+
+      void
+      clear()
+      {
+	while (_M_size)
+	  pop_back();
+      }
+    };
+
+  /**
+   *  @brief  A first-in, first-out ring buffer with in-object storage.
+   *
+   *  push_back() returns false when the buffer is full, unless
+   *  overwrite is requested, in which case the oldest element is
+   *  dropped.
+   */
+  template<typename _Tp, size_t _Nm>
+    class ring_buffer
+    {
+    public:
+      typedef _Tp        value_type;
+      typedef _Tp&       reference;
+      typedef const _Tp& const_reference;
+      typedef size_t     size_type;
+
+    private:
+      __fixed_storage<_Tp, _Nm> _M_storage;
+      size_type                 _M_head;
+      size_type                 _M_size;
+
+      _Tp*
+      _M_slot(size_type __i) _GLIBCXX_USE_NOEXCEPT
+      { return _M_storage._M_ptr() + (_M_head + __i) % _Nm; }
+
+      const _Tp*
+      _M_slot(size_type __i) const _GLIBCXX_USE_NOEXCEPT
+      { return _M_storage._M_ptr() + (_M_head + __i) % _Nm; }
+
+      // Copying would need element-wise construction; not needed for
+      // the intended uses.
+      ring_buffer(const ring_buffer&);
+      ring_buffer& operator=(const ring_buffer&);
+
+    public:
+      ring_buffer() _GLIBCXX_USE_NOEXCEPT
+      : _M_head(0), _M_size(0) { }
+
+      ~ring_buffer()
+      { clear(); }
+
+      size_type
+      size() const _GLIBCXX_USE_NOEXCEPT
+      { return _M_size; }
+
+      static size_type
+      capacity() _GLIBCXX_USE_NOEXCEPT
+      { return _Nm; }
+
+      bool
+      empty() const _GLIBCXX_USE_NOEXCEPT
+      { return _M_size == 0; }
+
+      bool
+      full() const _GLIBCXX_USE_NOEXCEPT
+      { return _M_size == _Nm; }
+
+      /// The __i-th oldest element.
+      reference
+      operator[](size_type __i) _GLIBCXX_USE_NOEXCEPT
+      { return *_M_slot(__i); }
+
+      const_reference
+      operator[](size_type __i) const _GLIBCXX_USE_NOEXCEPT
+      { return *_M_slot(__i); }
+
+      reference
+      front() _GLIBCXX_USE_NOEXCEPT
+      { return *_M_slot(0); }
+
+      reference
+      back() _GLIBCXX_USE_NOEXCEPT
+      { return *_M_slot(_M_size - 1); }
+
+      /// Appends a copy of __x as the newest element.  If the buffer is
+      /// full, returns false, or drops the oldest element first if
+      /// __overwrite is true.
+      bool
+      push_back(const value_type& __x, bool __overwrite = false)
+      {
+	if (full())
+	  {
+	    if (!__overwrite || _Nm == 0)
+	      return false;
+	    pop_front();
+	  }
+	::new((void *)_M_slot(_M_size)) value_type(__x);
+	++_M_size;
+	return true;
+      }
+
+      /// Removes the oldest element.
+      void
+      pop_front()
+      {
+	_M_slot(0)->~value_type();
+	_M_head = (_M_head + 1) % _Nm;
+	--_M_size;
+      }
+
+      void
+      clear()
+      {
+	while (_M_size)
+	  pop_front();
+	_M_head = 0;
+      }
+    };
+
+  /**
+   *  @brief  A sorted associative array with in-object storage.
+   *
+   *  Entries are kept in a sorted static_vector, so lookups are binary
+   *  searches over contiguous memory and insertions move the entries
+   *  that follow.  This is faster and much smaller than std::map for
+   *  the small maps that apps typically hold.
+   */
+  template<typename _Key, typename _Tp, size_t _Nm,
+	   typename _Compare = std::less<_Key> >
+    class flat_map
+    {
+    public:
+      typedef _Key                key_type;
+      typedef _Tp                 mapped_type;
+      struct value_type
+      {
+	_Key first;
+	_Tp  second;
+
+	value_type(const _Key& __k, const _Tp& __v)
+	: first(__k), second(__v) { }
+      };
+
+      typedef value_type*         iterator;
+      typedef const value_type*   const_iterator;
+      typedef size_t              size_type;
+
+    private:
+      static_vector<value_type, _Nm> _M_entries;
+      _Compare                       _M_comp;
+
+      iterator
+      _M_lower_bound(const key_type& __k)
+      {
+	iterator __first = _M_entries.begin();
+	size_type __len = _M_entries.size();
+	while (__len > 0)
+	  {
+	    size_type __half = __len >> 1;
+	    iterator __mid = __first + __half;
+	    if (_M_comp(__mid->first, __k))
+	      {
+		__first = __mid + 1;
+		__len = __len - __half - 1;
+	      }
+	    else
+	      __len = __half;
+	  }
+	return __first;
+      }
+
+    public:
+      flat_map(const _Compare& __comp = _Compare())
+      : _M_comp(__comp) { }
+
+      iterator
+      begin() _GLIBCXX_USE_NOEXCEPT
+      { return _M_entries.begin(); }
+
+      iterator
+      end() _GLIBCXX_USE_NOEXCEPT
+      { return _M_entries.end(); }
+
+      size_type
+      size() const _GLIBCXX_USE_NOEXCEPT
+      { return _M_entries.size(); }
+
+      bool
+      empty() const _GLIBCXX_USE_NOEXCEPT
+      { return _M_entries.empty(); }
+
+      bool
+      full() const _GLIBCXX_USE_NOEXCEPT
+      { return _M_entries.full(); }
+
+      iterator
+      find(const key_type& __k)
+      {
+	iterator __it = _M_lower_bound(__k);
+	if (__it != end() && !_M_comp(__k, __it->first))
+	  return __it;
+	return end();
+      }
+
+      /// Sets the value for __k, inserting it if needed.  Returns false
+      /// if __k is new and the map is full.
+      bool
+      set(const key_type& __k, const mapped_type& __v)
+      {
+	iterator __it = _M_lower_bound(__k);
+	if (__it != end() && !_M_comp(__k, __it->first))
+	  {
+	    __it->second = __v;
+	    return true;
+	  }
+	return _M_entries.insert(__it, value_type(__k, __v));
+      }
+
+      /// Removes __k.  Returns the number of removed entries.
+      size_type
+      erase(const key_type& __k)
+      {
+	iterator __it = find(__k);
+	if (__it == end())
+	  return 0;
+	_M_entries.erase(__it);
+	return 1;
+      }
+
+      void
+      clear()
+      { _M_entries.clear(); }
+    };
+
+  /**
+   *  @brief  A doubly linked list of objects that embed their own link.
+   *
+   *  The list never allocates: each element contains a fixed_list_hook
+   *  member, given as the _Hook template argument, and an element can
+   *  be in one list per hook at a time.  The list does not own its
+   *  elements.
+   *
+   *  @code
+   *  struct Item { int value; fixed_list_hook hook; };
+   *  __gnu_cxx::intrusive_list<Item, &Item::hook> items;
+   *  items.push_back(&item);
+   *  @endcode
+   */
+  template<typename _Tp, fixed_list_hook _Tp::* _Hook>
+    class intrusive_list
+    {
+    private:
+      fixed_list_hook _M_root;
+
+      static fixed_list_hook*
+      _S_hook(_Tp* __x) _GLIBCXX_USE_NOEXCEPT
+      { return &(__x->*_Hook); }
+
+      static _Tp*
+      _S_object(fixed_list_hook* __h) _GLIBCXX_USE_NOEXCEPT
+      {
+	const size_t __off =
+	  reinterpret_cast<size_t>(&(static_cast<_Tp*>(0)->*_Hook));
+	return reinterpret_cast<_Tp*>(reinterpret_cast<char*>(__h) - __off);
+      }
+
+      static void
+      _S_link_before(fixed_list_hook* __pos, fixed_list_hook* __h)
+      _GLIBCXX_USE_NOEXCEPT
+      {
+	__h->next = __pos;
+	__h->prev = __pos->prev;
+	__pos->prev->next = __h;
+	__pos->prev = __h;
+      }
+
+      intrusive_list(const intrusive_list&);
+      intrusive_list& operator=(const intrusive_list&);
+
+    public:
+      class iterator
+      {
+	fixed_list_hook* _M_node;
+
+      public:
+	explicit iterator(fixed_list_hook* __n = 0) _GLIBCXX_USE_NOEXCEPT
+	: _M_node(__n) { }
+
+	_Tp&
+	operator*() const _GLIBCXX_USE_NOEXCEPT
+	{ return *_S_object(_M_node); }
+
+	_Tp*
+	operator->() const _GLIBCXX_USE_NOEXCEPT
+	{ return _S_object(_M_node); }
+
+	iterator&
+	operator++() _GLIBCXX_USE_NOEXCEPT
+	{ _M_node = _M_node->next; return *this; }
+
+	iterator&
+	operator--() _GLIBCXX_USE_NOEXCEPT
+	{ _M_node = _M_node->prev; return *this; }
+
+	bool
+	operator==(const iterator& __o) const _GLIBCXX_USE_NOEXCEPT
+	{ return _M_node == __o._M_node; }
+
+	bool
+	operator!=(const iterator& __o) const _GLIBCXX_USE_NOEXCEPT
+	{ return _M_node != __o._M_node; }
+      };
+
+      intrusive_list() _GLIBCXX_USE_NOEXCEPT
+      { _M_root.next = _M_root.prev = &_M_root; }
+
+      ~intrusive_list()
+      { clear(); }
+
+      iterator
+      begin() _GLIBCXX_USE_NOEXCEPT
+      { return iterator(_M_root.next); }
+
+      iterator
+      end() _GLIBCXX_USE_NOEXCEPT
+      { return iterator(&_M_root); }
+
+      bool
+      empty() const _GLIBCXX_USE_NOEXCEPT
+      { return _M_root.next == &_M_root; }
+
+      _Tp*
+      front() _GLIBCXX_USE_NOEXCEPT
+      { return empty() ? 0 : _S_object(_M_root.next); }
+
+      _Tp*
+      back() _GLIBCXX_USE_NOEXCEPT
+      { return empty() ? 0 : _S_object(_M_root.prev); }
+
+      void
+      push_back(_Tp* __x) _GLIBCXX_USE_NOEXCEPT
+      { _S_link_before(&_M_root, _S_hook(__x)); }
+
+      void
+      push_front(_Tp* __x) _GLIBCXX_USE_NOEXCEPT
+      { _S_link_before(_M_root.next, _S_hook(__x)); }
+
+      /// Unlinks __x, which must be in this list, in constant time.
+      static void
+      remove(_Tp* __x) _GLIBCXX_USE_NOEXCEPT
+      {
+	fixed_list_hook* __h = _S_hook(__x);
+	__h->prev->next = __h->next;
+	__h->next->prev = __h->prev;
+	__h->next = __h->prev = 0;
+      }
+
+      /// Whether __x is currently linked into a list through _Hook.
+      static bool
+      is_linked(_Tp* __x) _GLIBCXX_USE_NOEXCEPT
+      { return _S_hook(__x)->next != 0; }
+
+      /// Unlinks all elements.  The elements themselves are untouched.
+      void
+      clear() _GLIBCXX_USE_NOEXCEPT
+      {
+	while (!empty())
+	  remove(_S_object(_M_root.next));
+      }
+    };
+
+_GLIBCXX_END_NAMESPACE_VERSION
+} // namespace
+
+#endif
@@ -0,0 +1,379 @@
+// Fixed-capacity allocator over caller-provided memory -*- C++ -*-
+
+// Copyright (C) 2012
+// Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// Under Section 7 of GPL version 3, you are granted additional
+// permissions described in the GCC Runtime Library Exception, version
+// 3.1, as published by the Free Software Foundation.
+
+// You should have received a copy of the GNU General Public License and
+// a copy of the GCC Runtime Library Exception along with this program;
+// see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+// <http://www.gnu.org/licenses/>.
+
+/** @file ext/fixed_pool_allocator.h
+ *  This file is a GNU extension to the Standard C++ Library.
+ */
+
+#ifndef _FIXED_POOL_ALLOCATOR_H
+#define _FIXED_POOL_ALLOCATOR_H 1
+
+#include <bits/c++config.h>
+#include <cstddef>
+#include <new>
+#include <bits/functexcept.h>
+#include <bits/move.h>
+
+namespace __gnu_cxx _GLIBCXX_VISIBILITY(default)
+{
+_GLIBCXX_BEGIN_NAMESPACE_VERSION
+
+  using std::size_t;
+  using std::ptrdiff_t;
+
+  /**
+   *  @brief  A fixed-capacity memory arena for single-threaded use.
+   *
+   *  The arena carves blocks out of one region of memory supplied by
+   *  the caller (a static array, or a single block obtained from the
+   *  system heap) and never grows.  Freed blocks of up to
+   *  _S_max_small_bytes are kept on per-size free lists and reused in
+   *  constant time, which suits the node allocations of std::list,
+   *  std::map and std::set.  Larger freed blocks go to a first-fit
+   *  list, merged with the free blocks of any size next to them; a
+   *  larger block reused for a smaller request is split and the rest
+   *  freed again, so that it can be merged back later.
+   *  No per-block header is stored, so blocks carry no overhead
+   *  beyond rounding to _S_align bytes.
+   *
+   *  The arena does not lock; share it only between objects used from
+   *  the same thread.
+   */
+  class fixed_arena
+  {
+  public:
+    enum
+      {
+	_S_align = 8,
+	_S_max_small_bytes = 128,
+	_S_num_bins = _S_max_small_bytes / _S_align
+      };
+
+  private:
+    struct _Free_block
+    {
+      _Free_block* _M_next;
+      size_t       _M_size;
+    };
+
+    char*        _M_cur;
+    char*        _M_end;
+    size_t       _M_used;
+    _Free_block* _M_small[_S_num_bins];
+    _Free_block* _M_large;
+
+    // Not copyable: allocators refer to the arena by pointer.
+    fixed_arena(const fixed_arena&);
+    fixed_arena& operator=(const fixed_arena&);
+
+    static size_t
+    _S_round_up(size_t __bytes)
+    { return (__bytes + size_t(_S_align) - 1) & ~(size_t(_S_align) - 1); }
+
+    // Unlinks the free block, large or small, that ends at __p or
+    // starts at __p + __size.  Returns its size and sets __q to its
+    // start, or returns 0 if there is none.
+    size_t
+    _M_unlink_adjacent(char* __p, size_t __size, char*& __q)
+    _GLIBCXX_USE_NOEXCEPT
+    {
+      for (_Free_block** __link = &_M_large; *__link;
+	   __link = &(*__link)->_M_next)
+	{
+	  __q = reinterpret_cast<char*>(*__link);
+	  const size_t __n = (*__link)->_M_size;
+	  if (__q + __n == __p || __p + __size == __q)
+	    {
+	      *__link = (*__link)->_M_next;
+	      return __n;
+	    }
+	}
+      for (int __i = 0; __i < _S_num_bins; ++__i)
+	{
+	  const size_t __n = size_t(__i + 1) * _S_align;
+	  for (_Free_block** __link = &_M_small[__i]; *__link;
+	       __link = &(*__link)->_M_next)
+	    {
+	      __q = reinterpret_cast<char*>(*__link);
+	      if (__q + __n == __p || __p + __size == __q)
+		{
+		  *__link = (*__link)->_M_next;
+		  return __n;
+		}
+	    }
+	}
+      return 0;
+    }
+
+    // Makes __size bytes at __p available again: large blocks are
+    // merged with the free blocks next to them first, then the block
+    // goes back to the bump region if it ends there, or to its free
+    // list.  Small blocks are only merged into the bump region, which
+    // keeps their release constant time unless they end at it.
+    void
+    _M_release(char* __p, size_t __size) _GLIBCXX_USE_NOEXCEPT
+    {
+      char* __q;
+      if (__size > size_t(_S_max_small_bytes))
+	while (const size_t __n = _M_unlink_adjacent(__p, __size, __q))
+	  {
+	    if (__q < __p)
+	      __p = __q;
+	    __size += __n;
+	  }
+      if (__p + __size == _M_cur)
+	{
+	  _M_cur = __p;
+	  // Free blocks may now end at the bump region as well.
+	  while (const size_t __n = _M_unlink_adjacent(_M_cur, 0, __q))
+	    _M_cur -= __n;
+	  return;
+	}
+      _Free_block* __block = static_cast<_Free_block*>(static_cast<void*>(__p));
+      if (__size <= size_t(_S_max_small_bytes))
+	{
+	  _Free_block*& __bin = _M_small[__size / _S_align - 1];
+	  __block->_M_next = __bin;
+	  __bin = __block;
+	}
+      else
+	{
+	  __block->_M_size = __size;
+	  __block->_M_next = _M_large;
+	  _M_large = __block;
+	}
+    }
+
+  public:
+    fixed_arena(void* __mem, size_t __size) _GLIBCXX_USE_NOEXCEPT
+    : _M_cur(static_cast<char*>(__mem)), _M_end(_M_cur), _M_used(0),
+      _M_large(0)
+    {
+      // Align the start of the region, then trim the end to a whole
+      // number of blocks.
+      size_t __mis = reinterpret_cast<size_t>(_M_cur) & (size_t(_S_align) - 1);
+      size_t __skip = __mis ? size_t(_S_align) - __mis : 0;
+      if (__size > __skip)
+	{
+	  _M_cur += __skip;
+	  _M_end = _M_cur + ((__size - __skip) & ~(size_t(_S_align) - 1));
+	}
+      for (int __i = 0; __i < _S_num_bins; ++__i)
+	_M_small[__i] = 0;
+    }
+
+    /// Returns a block of at least __bytes bytes, or 0 if the arena is
+    /// exhausted.
+    void*
+    allocate(size_t __bytes) _GLIBCXX_USE_NOEXCEPT
+    {
+      const size_t __size = _S_round_up(__bytes ? __bytes : 1);
+      if (__size <= size_t(_S_max_small_bytes))
+	{
+	  _Free_block*& __bin = _M_small[__size / _S_align - 1];
+	  if (__bin)
+	    {
+	      _Free_block* __ret = __bin;
+	      __bin = __ret->_M_next;
+	      _M_used += __size;
+	      return __ret;
+	    }
+	}
+      else
+	{
+	  for (_Free_block** __link = &_M_large; *__link;
+	       __link = &(*__link)->_M_next)
+	    if ((*__link)->_M_size >= __size)
+	      {
+		_Free_block* __ret = *__link;
+		*__link = __ret->_M_next;
+		// Hand out exactly __size bytes, as deallocate() only
+		// knows the size that was asked for.
+		if (__ret->_M_size > __size)
+		  _M_release(reinterpret_cast<char*>(__ret) + __size,
+			     __ret->_M_size - __size);
+		_M_used += __size;
+		return __ret;
+	      }
+	}
+
+      if (size_t(_M_end - _M_cur) < __size)
+	return 0;
+      void* __ret = _M_cur;
+      _M_cur += __size;
+      _M_used += __size;
+      return __ret;
+    }
+
+    /// Returns a block obtained from allocate(__bytes) to the arena.
+    void
+    deallocate(void* __p, size_t __bytes) _GLIBCXX_USE_NOEXCEPT
+    {
+      if (!__p)
+	return;
+      const size_t __size = _S_round_up(__bytes ? __bytes : 1);
+      _M_used -= __size;
+      _M_release(static_cast<char*>(__p), __size);
+    }
+
+    /// Number of bytes currently handed out.
+    size_t
+    bytes_used() const _GLIBCXX_USE_NOEXCEPT
+    { return _M_used; }
+
+    /// Number of never-used bytes left at the end of the region.  Freed
+    /// blocks are not included, as small ones can only be reused for
+    /// requests of the same size.
+    size_t
+    bytes_untouched() const _GLIBCXX_USE_NOEXCEPT
+    { return size_t(_M_end - _M_cur); }
+  };
+
+  /**
+   *  @brief  An allocator that draws from a fixed_arena.
+   *  @ingroup allocators
+   *
+   *  Containers using this allocator never touch the system heap.
+   *  All copies and rebinds of an allocator share the same arena, and
+   *  compare equal exactly when they do.  When the arena is
+   *  exhausted, allocate() calls std::__throw_bad_alloc(), which
+   *  aborts when exceptions are disabled.
+   *
+   *  @code
+   *  static char s_buffer[2048];
+   *  __gnu_cxx::fixed_arena s_arena(s_buffer, sizeof(s_buffer));
+   *  std::map<int, int, std::less<int>,
+   *           __gnu_cxx::fixed_pool_allocator<std::pair<const int, int> > >
+   *    s_map(std::less<int>(), &s_arena);
+   *  @endcode
+   */
+  template<typename _Tp>
+    class fixed_pool_allocator
+    {
+    public:
+      typedef size_t     size_type;
+      typedef ptrdiff_t  difference_type;
+      typedef _Tp*       pointer;
+      typedef const _Tp* const_pointer;
+      typedef _Tp&       reference;
+      typedef const _Tp& const_reference;
+      typedef _Tp        value_type;
+
+      template<typename _Tp1>
+        struct rebind
+        { typedef fixed_pool_allocator<_Tp1> other; };
+
+    private:
+      template<typename _Tp1>
+        friend class fixed_pool_allocator;
+
+      fixed_arena* _M_arena;
+
+    public:
+      fixed_pool_allocator(fixed_arena* __arena = 0) _GLIBCXX_USE_NOEXCEPT
+      : _M_arena(__arena) { }
+
+      fixed_pool_allocator(const fixed_pool_allocator& __o)
+      _GLIBCXX_USE_NOEXCEPT
+      : _M_arena(__o._M_arena) { }
+
+      template<typename _Tp1>
+        fixed_pool_allocator(const fixed_pool_allocator<_Tp1>& __o)
+	_GLIBCXX_USE_NOEXCEPT
+	: _M_arena(__o._M_arena) { }
+
+      ~fixed_pool_allocator() _GLIBCXX_USE_NOEXCEPT { }
+
+      fixed_arena*
+      arena() const _GLIBCXX_USE_NOEXCEPT
+      { return _M_arena; }
+
+      pointer
+      address(reference __x) const _GLIBCXX_NOEXCEPT
+      { return std::__addressof(__x); }
+
+      const_pointer
+      address(const_reference __x) const _GLIBCXX_NOEXCEPT
+      { return std::__addressof(__x); }
+
+      pointer
+      allocate(size_type __n, const void* = 0)
+      {
+	if (__n > this->max_size() || _M_arena == 0)
+	  std::__throw_bad_alloc();
+	void* __ret = _M_arena->allocate(__n * sizeof(_Tp));
+	if (!__ret)
+	  std::__throw_bad_alloc();
+	return static_cast<_Tp*>(__ret);
+      }
+
+      void
+      deallocate(pointer __p, size_type __n)
+      {
+	if (_M_arena)
+	  _M_arena->deallocate(__p, __n * sizeof(_Tp));
+      }
+
+      size_type
+      max_size() const _GLIBCXX_USE_NOEXCEPT
+      { return size_t(-1) / sizeof(_Tp); }
+
+#ifdef __GXX_EXPERIMENTAL_CXX0X__
+      template<typename _Up, typename... _Args>
+        void
+        construct(_Up* __p, _Args&&... __args)
+	{ ::new((void *)__p) _Up(std::forward<_Args>(__args)...); }
+
+      template<typename _Up>
+        void
+        destroy(_Up* __p) { __p->~_Up(); }
+#else
+      // _GLIBCXX_RESOLVE_LIB_DEFECTS
+      // 402. wrong new expression in [some_] allocator::construct
+      void
+      construct(pointer __p, const _Tp& __val)
+      { ::new((void *)__p) value_type(__val); }
+
+      void
+      destroy(pointer __p) { __p->~_Tp(); }
+#endif
+    };
+
+  template<typename _Tp>
+    inline bool
+    operator==(const fixed_pool_allocator<_Tp>& __a,
+	       const fixed_pool_allocator<_Tp>& __b)
+    { return __a.arena() == __b.arena(); }
+
+  template<typename _Tp>
+    inline bool
+    operator!=(const fixed_pool_allocator<_Tp>& __a,
+	       const fixed_pool_allocator<_Tp>& __b)
+    { return __a.arena() != __b.arena(); }
+
+_GLIBCXX_END_NAMESPACE_VERSION
+} // namespace
+
+#endif
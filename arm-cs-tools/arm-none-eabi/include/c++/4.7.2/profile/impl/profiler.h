@@ -72,7 +72,12 @@ namespace __gnu_profile
     static bool&
     __inside()
     {
+#ifdef _GLIBCXX_PROFILE_LOG_OUTPUT
+      // Watch apps run on a single thread and have no TLS.
+      static bool _S_inside(false);
+#else
       static __thread bool _S_inside(false);
+#endif
       return _S_inside;
     }
 
@@ -0,0 +1,150 @@
+// -*- C++ -*-
+//
+// Copyright (C) 2012 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// Under Section 7 of GPL version 3, you are granted additional
+// permissions described in the GCC Runtime Library Exception, version
+// 3.1, as published by the Free Software Foundation.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+/** @file profile/impl/profiler_log.h
+ *  @brief Trace output through the Pebble app log.
+ *
+ *  Watch apps, including those running in the emulator, have no file
+ *  system to write the trace files to.  Building with
+ *  -D_GLIBCXX_PROFILE -D_GLIBCXX_PROFILE_LOG_OUTPUT writes every trace
+ *  file to the app log instead, one app_log() line per line of the
+ *  file:
+ *
+ *    libstdcxx-profile.txt begin
+ *    libstdcxx-profile.txt: vector-to-list: improvement = 5: ...
+ *    libstdcxx-profile.txt+ ...rest of a line longer than one message
+ *    libstdcxx-profile.txt end
+ *
+ *  "pebble logs" shows these lines, and common/tools/profile_mode.py in
+ *  the SDK turns a saved log back into the trace files.  Since apps do
+ *  not run atexit handlers, the app has to call __profcxx_report()
+ *  itself, usually from its deinit function.
+ *
+ *  The streams are made with newlib's funopen(), so this pulls stdio
+ *  into the app binary and is meant for emulator builds.  Call stacks
+ *  are empty, so each diagnostic is reported for all containers of a
+ *  kind together rather than per allocation site.
+ */
+
+#ifndef _GLIBCXX_PROFILE_PROFILER_LOG_H
+#define _GLIBCXX_PROFILE_PROFILER_LOG_H 1
+
+#include <cstdio>
+#include <stdio.h>  // funopen
+
+// The trace lines are logged at APP_LOG_LEVEL_DEBUG.
+#ifndef _GLIBCXX_PROFILE_LOG_LEVEL
+#define _GLIBCXX_PROFILE_LOG_LEVEL 200
+#endif
+// Longer lines are split, since the app log truncates long messages.
+#ifndef _GLIBCXX_PROFILE_LOG_LINE_LENGTH
+#define _GLIBCXX_PROFILE_LOG_LINE_LENGTH 96
+#endif
+
+extern "C" void
+app_log(unsigned char __log_level, const char* __src_filename,
+	int __src_line_number, const char* __fmt, ...);
+
+namespace __gnu_profile
+{
+  struct __log_output
+  {
+    const char* _M_name;
+    std::size_t _M_length;
+    bool _M_continued;
+    char _M_line[_GLIBCXX_PROFILE_LOG_LINE_LENGTH + 1];
+  };
+
+  inline void
+  __log_line(__log_output* __out)
+  {
+    __out->_M_line[__out->_M_length] = '\0';
+    app_log(_GLIBCXX_PROFILE_LOG_LEVEL, "libstdcxx-profile", 0, "%s%c %s",
+	    __out->_M_name, __out->_M_continued ? '+' : ':', __out->_M_line);
+    __out->_M_length = 0;
+  }
+
+  inline int
+  __log_write(void* __cookie, const char* __buf, int __n)
+  {
+    __log_output* __out = static_cast<__log_output*>(__cookie);
+    for (int __i = 0; __i < __n; ++__i)
+      {
+	if (__buf[__i] == '\n')
+	  {
+	    __log_line(__out);
+	    __out->_M_continued = false;
+	    continue;
+	  }
+	if (__out->_M_length == _GLIBCXX_PROFILE_LOG_LINE_LENGTH)
+	  {
+	    __log_line(__out);
+	    __out->_M_continued = true;
+	  }
+	__out->_M_line[__out->_M_length++] = __buf[__i];
+      }
+    return __n;
+  }
+
+  inline int
+  __log_close(void* __cookie)
+  {
+    __log_output* __out = static_cast<__log_output*>(__cookie);
+    if (__out->_M_length)
+      __log_line(__out);
+    app_log(_GLIBCXX_PROFILE_LOG_LEVEL, "libstdcxx-profile", 0, "%s end",
+	    __out->_M_name);
+    delete[] __out->_M_name;
+    delete __out;
+    return 0;
+  }
+
+  /** @brief Open a stream that logs each line written to it.
+   *
+   *  Takes ownership of @a __file_name, which must have been allocated
+   *  with new[].
+   */
+  inline FILE*
+  __open_log_output(char* __file_name)
+  {
+    __log_output* __out = new __log_output;
+    __out->_M_name = __file_name;
+    __out->_M_length = 0;
+    __out->_M_continued = false;
+
+    FILE* __file = funopen(__out, 0, __log_write, 0, __log_close);
+    if (!__file)
+      {
+	delete[] __file_name;
+	delete __out;
+	return 0;
+      }
+    // Lines are collected in __log_output already.
+    std::setvbuf(__file, 0, _IONBF, 0);
+    app_log(_GLIBCXX_PROFILE_LOG_LEVEL, "libstdcxx-profile", 0, "%s begin",
+	    __file_name);
+    return __file;
+  }
+} // namespace __gnu_profile
+
+#endif /* _GLIBCXX_PROFILE_PROFILER_LOG_H */
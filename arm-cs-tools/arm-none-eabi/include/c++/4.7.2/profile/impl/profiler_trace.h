@@ -51,6 +51,9 @@
 #include "profile/impl/profiler_algos.h"
 #include "profile/impl/profiler_state.h"
 #include "profile/impl/profiler_node.h"
+#ifdef _GLIBCXX_PROFILE_LOG_OUTPUT
+#include "profile/impl/profiler_log.h"
+#endif
 
 namespace __gnu_profile
 {
@@ -397,6 +400,11 @@ namespace __gnu_profile
     __builtin_memcpy(__file_name + __root_len + 1,
 		     __extension, __ext_len + 1);
 
+#ifdef _GLIBCXX_PROFILE_LOG_OUTPUT
+    FILE* __out_file = __open_log_output(__file_name);
+    if (!__out_file)
+      std::abort();
+#else
     FILE* __out_file = std::fopen(__file_name, "w");
     if (!__out_file)
       {
@@ -406,6 +414,7 @@ namespace __gnu_profile
       }
 
     delete[] __file_name;
+#endif
     return __out_file;
   }
 
@@ -474,8 +483,10 @@ namespace __gnu_profile
     if (__env_trace_file_name)
       _GLIBCXX_PROFILE_DATA(_S_trace_file_name) = __env_trace_file_name;
 
+#ifndef _GLIBCXX_PROFILE_LOG_OUTPUT
     // Make sure early that we can create the trace file.
     std::fclose(__open_output_file("txt"));
+#endif
   }
 
   inline void
@@ -632,7 +643,9 @@ namespace __gnu_profile
 	    __trace_list_to_vector_init();
 	    __trace_map_to_unordered_map_init();
 
+#ifndef _GLIBCXX_PROFILE_LOG_OUTPUT
 	    std::atexit(__report);
+#endif
 
 	    __turn_on();
 	  }
@@ -0,0 +1,290 @@
+/* ARM DSP extension (SIMD) intrinsics.
+
+   Copyright (C) 2012 Free Software Foundation, Inc.
+
+   This file is part of GCC.
+
+   GCC is free software; you can redistribute it and/or modify it
+   under the terms of the GNU General Public License as published
+   by the Free Software Foundation; either version 3, or (at your
+   option) any later version.
+
+   GCC is distributed in the hope that it will be useful, but WITHOUT
+   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+   or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+   License for more details.
+
+   Under Section 7 of GPL version 3, you are granted additional
+   permissions described in the GCC Runtime Library Exception, version
+   3.1, as published by the Free Software Foundation.
+
+   You should have received a copy of the GNU General Public License and
+   a copy of the GCC Runtime Library Exception along with this program;
+   see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+   <http://www.gnu.org/licenses/>.  */
+
+/* CMSIS-style names for the packed 8- and 16-bit arithmetic of the
+   ARMv7E-M DSP extension (Cortex-M4).  Each function operates on the
+   four bytes or two halfwords of its 32-bit operands independently.
+
+   On cores without the extension (Cortex-M3, and any build that
+   defines PBL_PLATFORM_APLITE) the same functions are provided as
+   portable C, so code using them builds for every platform.  The C
+   versions are several times slower, so hot loops should still be
+   written with the scalar case in mind.
+
+   __SEL picks bytes according to the GE flags left by the most recent
+   __SADD8, __UADD8, __SSUB8, __USUB8, __SADD16, __UADD16, __SSUB16 or
+   __USUB16.  In the C versions the flags are kept in a variable local
+   to the translation unit, so the flag-setting call and __SEL must be
+   in the same source file, as they would be in practice.  */
+
+#ifndef _ARM_DSP_H_INCLUDED
+#define _ARM_DSP_H_INCLUDED
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define __ARM_DSP_INLINE \
+  static __inline__ __attribute__ ((__always_inline__, __unused__))
+
+#if defined (__ARM_ARCH_7EM__) && !defined (PBL_PLATFORM_APLITE)
+
+#define __ARM_DSP_HW 1
+
+/* GE-setting instructions and __SEL are volatile so that the compiler
+   keeps them in program order.  */
+#define __ARM_DSP_OP2(__name, __insn)					\
+  __ARM_DSP_INLINE uint32_t						\
+  __name (uint32_t __a, uint32_t __b)					\
+  {									\
+    uint32_t __r;							\
+    __asm__ __volatile__ (__insn " %0, %1, %2"				\
+			  : "=r" (__r) : "r" (__a), "r" (__b));		\
+    return __r;								\
+  }
+
+#define __ARM_DSP_OP3(__name, __insn)					\
+  __ARM_DSP_INLINE uint32_t						\
+  __name (uint32_t __a, uint32_t __b, uint32_t __c)			\
+  {									\
+    uint32_t __r;							\
+    __asm__ (__insn " %0, %1, %2, %3"					\
+	     : "=r" (__r) : "r" (__a), "r" (__b), "r" (__c));		\
+    return __r;								\
+  }
+
+__ARM_DSP_OP2 (__SADD8,   "sadd8")
+__ARM_DSP_OP2 (__UADD8,   "uadd8")
+__ARM_DSP_OP2 (__SSUB8,   "ssub8")
+__ARM_DSP_OP2 (__USUB8,   "usub8")
+__ARM_DSP_OP2 (__QADD8,   "qadd8")
+__ARM_DSP_OP2 (__UQADD8,  "uqadd8")
+__ARM_DSP_OP2 (__QSUB8,   "qsub8")
+__ARM_DSP_OP2 (__UQSUB8,  "uqsub8")
+__ARM_DSP_OP2 (__UHADD8,  "uhadd8")
+__ARM_DSP_OP2 (__SADD16,  "sadd16")
+__ARM_DSP_OP2 (__UADD16,  "uadd16")
+__ARM_DSP_OP2 (__SSUB16,  "ssub16")
+__ARM_DSP_OP2 (__USUB16,  "usub16")
+__ARM_DSP_OP2 (__QADD16,  "qadd16")
+__ARM_DSP_OP2 (__UQADD16, "uqadd16")
+__ARM_DSP_OP2 (__QSUB16,  "qsub16")
+__ARM_DSP_OP2 (__UQSUB16, "uqsub16")
+__ARM_DSP_OP2 (__SEL,     "sel")
+__ARM_DSP_OP2 (__USAD8,   "usad8")
+__ARM_DSP_OP2 (__SMUAD,   "smuad")
+__ARM_DSP_OP2 (__SMUSD,   "smusd")
+__ARM_DSP_OP2 (__QADD,    "qadd")
+__ARM_DSP_OP2 (__QSUB,    "qsub")
+__ARM_DSP_OP3 (__USADA8,  "usada8")
+__ARM_DSP_OP3 (__SMLAD,   "smlad")
+__ARM_DSP_OP3 (__SMLSD,   "smlsd")
+
+#undef __ARM_DSP_OP2
+#undef __ARM_DSP_OP3
+
+#else /* No DSP extension.  */
+
+#define __ARM_DSP_HW 0
+
+static uint32_t __arm_dsp_ge __attribute__ ((__unused__));
+
+#define __ARM_DSP_B(__x, __i)  ((uint32_t) (__x) >> (8 * (__i)) & 0xff)
+#define __ARM_DSP_SB(__x, __i) ((int32_t) (int8_t) __ARM_DSP_B (__x, __i))
+#define __ARM_DSP_H(__x, __i)  ((uint32_t) (__x) >> (16 * (__i)) & 0xffff)
+#define __ARM_DSP_SH(__x, __i) ((int32_t) (int16_t) __ARM_DSP_H (__x, __i))
+
+__ARM_DSP_INLINE int32_t
+__arm_dsp_clamp (int32_t __v, int32_t __lo, int32_t __hi)
+{
+  return __v < __lo ? __lo : __v > __hi ? __hi : __v;
+}
+
+/* Per-byte operation.  __ge is nonzero if the lane sets its GE bit;
+   __setge says whether the instruction writes the GE flags at all.  */
+#define __ARM_DSP_BYTES(__name, __lane, __ge, __setge)			\
+  __ARM_DSP_INLINE uint32_t						\
+  __name (uint32_t __a, uint32_t __b)					\
+  {									\
+    uint32_t __r = 0, __g = 0;						\
+    int __i;								\
+    for (__i = 0; __i < 4; __i++)					\
+      {									\
+	int32_t __v = (__lane);						\
+	__r |= ((uint32_t) __v & 0xff) << (8 * __i);			\
+	if (__ge)							\
+	  __g |= 1u << __i;						\
+      }									\
+    if (__setge)							\
+      __arm_dsp_ge = __g;						\
+    return __r;								\
+  }
+
+#define __ARM_DSP_HALVES(__name, __lane, __ge, __setge)		\
+  __ARM_DSP_INLINE uint32_t						\
+  __name (uint32_t __a, uint32_t __b)					\
+  {									\
+    uint32_t __r = 0, __g = 0;						\
+    int __i;								\
+    for (__i = 0; __i < 2; __i++)					\
+      {									\
+	int32_t __v = (__lane);						\
+	__r |= ((uint32_t) __v & 0xffff) << (16 * __i);			\
+	if (__ge)							\
+	  __g |= 3u << (2 * __i);					\
+      }									\
+    if (__setge)							\
+      __arm_dsp_ge = __g;						\
+    return __r;								\
+  }
+
+#define __SA  __ARM_DSP_SB (__a, __i)
+#define __SB  __ARM_DSP_SB (__b, __i)
+#define __UA  ((int32_t) __ARM_DSP_B (__a, __i))
+#define __UB  ((int32_t) __ARM_DSP_B (__b, __i))
+
+__ARM_DSP_BYTES (__SADD8,  __SA + __SB, __v >= 0, 1)
+__ARM_DSP_BYTES (__UADD8,  __UA + __UB, __v >= 0x100, 1)
+__ARM_DSP_BYTES (__SSUB8,  __SA - __SB, __v >= 0, 1)
+__ARM_DSP_BYTES (__USUB8,  __UA - __UB, __v >= 0, 1)
+__ARM_DSP_BYTES (__QADD8,  __arm_dsp_clamp (__SA + __SB, -128, 127), 0, 0)
+__ARM_DSP_BYTES (__UQADD8, __arm_dsp_clamp (__UA + __UB, 0, 255), 0, 0)
+__ARM_DSP_BYTES (__QSUB8,  __arm_dsp_clamp (__SA - __SB, -128, 127), 0, 0)
+__ARM_DSP_BYTES (__UQSUB8, __arm_dsp_clamp (__UA - __UB, 0, 255), 0, 0)
+__ARM_DSP_BYTES (__UHADD8, (__UA + __UB) >> 1, 0, 0)
+
+#undef __SA
+#undef __SB
+#undef __UA
+#undef __UB
+
+#define __SA  __ARM_DSP_SH (__a, __i)
+#define __SB  __ARM_DSP_SH (__b, __i)
+#define __UA  ((int32_t) __ARM_DSP_H (__a, __i))
+#define __UB  ((int32_t) __ARM_DSP_H (__b, __i))
+
+__ARM_DSP_HALVES (__SADD16,  __SA + __SB, __v >= 0, 1)
+__ARM_DSP_HALVES (__UADD16,  __UA + __UB, __v >= 0x10000, 1)
+__ARM_DSP_HALVES (__SSUB16,  __SA - __SB, __v >= 0, 1)
+__ARM_DSP_HALVES (__USUB16,  __UA - __UB, __v >= 0, 1)
+__ARM_DSP_HALVES (__QADD16,  __arm_dsp_clamp (__SA + __SB, -32768, 32767), 0, 0)
+__ARM_DSP_HALVES (__UQADD16, __arm_dsp_clamp (__UA + __UB, 0, 65535), 0, 0)
+__ARM_DSP_HALVES (__QSUB16,  __arm_dsp_clamp (__SA - __SB, -32768, 32767), 0, 0)
+__ARM_DSP_HALVES (__UQSUB16, __arm_dsp_clamp (__UA - __UB, 0, 65535), 0, 0)
+
+#undef __SA
+#undef __SB
+#undef __UA
+#undef __UB
+#undef __ARM_DSP_BYTES
+#undef __ARM_DSP_HALVES
+
+__ARM_DSP_INLINE uint32_t
+__SEL (uint32_t __a, uint32_t __b)
+{
+  uint32_t __r = 0;
+  int __i;
+  for (__i = 0; __i < 4; __i++)
+    __r |= (__arm_dsp_ge & (1u << __i) ? __a : __b) & (0xffu << (8 * __i));
+  return __r;
+}
+
+__ARM_DSP_INLINE uint32_t
+__USADA8 (uint32_t __a, uint32_t __b, uint32_t __acc)
+{
+  int __i;
+  for (__i = 0; __i < 4; __i++)
+    {
+      int32_t __d = (int32_t) __ARM_DSP_B (__a, __i)
+		    - (int32_t) __ARM_DSP_B (__b, __i);
+      __acc += (uint32_t) (__d < 0 ? -__d : __d);
+    }
+  return __acc;
+}
+
+__ARM_DSP_INLINE uint32_t
+__USAD8 (uint32_t __a, uint32_t __b)
+{
+  return __USADA8 (__a, __b, 0);
+}
+
+__ARM_DSP_INLINE uint32_t
+__SMLAD (uint32_t __a, uint32_t __b, uint32_t __acc)
+{
+  return __acc + (uint32_t) (__ARM_DSP_SH (__a, 0) * __ARM_DSP_SH (__b, 0))
+	 + (uint32_t) (__ARM_DSP_SH (__a, 1) * __ARM_DSP_SH (__b, 1));
+}
+
+__ARM_DSP_INLINE uint32_t
+__SMLSD (uint32_t __a, uint32_t __b, uint32_t __acc)
+{
+  return __acc + (uint32_t) (__ARM_DSP_SH (__a, 0) * __ARM_DSP_SH (__b, 0))
+	 - (uint32_t) (__ARM_DSP_SH (__a, 1) * __ARM_DSP_SH (__b, 1));
+}
+
+__ARM_DSP_INLINE uint32_t
+__SMUAD (uint32_t __a, uint32_t __b)
+{
+  return __SMLAD (__a, __b, 0);
+}
+
+__ARM_DSP_INLINE uint32_t
+__SMUSD (uint32_t __a, uint32_t __b)
+{
+  return __SMLSD (__a, __b, 0);
+}
+
+__ARM_DSP_INLINE uint32_t
+__QADD (uint32_t __a, uint32_t __b)
+{
+  int64_t __v = (int64_t) (int32_t) __a + (int32_t) __b;
+  return (uint32_t) (int32_t) (__v > 0x7fffffff ? 0x7fffffff
+			       : __v < -0x7fffffff - 1 ? -0x7fffffff - 1 : __v);
+}
+
+__ARM_DSP_INLINE uint32_t
+__QSUB (uint32_t __a, uint32_t __b)
+{
+  int64_t __v = (int64_t) (int32_t) __a - (int32_t) __b;
+  return (uint32_t) (int32_t) (__v > 0x7fffffff ? 0x7fffffff
+			       : __v < -0x7fffffff - 1 ? -0x7fffffff - 1 : __v);
+}
+
+#undef __ARM_DSP_B
+#undef __ARM_DSP_SB
+#undef __ARM_DSP_H
+#undef __ARM_DSP_SH
+
+#endif /* __ARM_ARCH_7EM__ */
+
+#undef __ARM_DSP_INLINE
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _ARM_DSP_H_INCLUDED */
@@ -0,0 +1,204 @@
+/* Inline fixed-point arithmetic for ARM.
+
+   Copyright (C) 2012 Free Software Foundation, Inc.
+
+   This file is part of GCC.
+
+   GCC is free software; you can redistribute it and/or modify it
+   under the terms of the GNU General Public License as published
+   by the Free Software Foundation; either version 3, or (at your
+   option) any later version.
+
+   GCC is distributed in the hope that it will be useful, but WITHOUT
+   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+   or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+   License for more details.
+
+   Under Section 7 of GPL version 3, you are granted additional
+   permissions described in the GCC Runtime Library Exception, version
+   3.1, as published by the Free Software Foundation.
+
+   You should have received a copy of the GNU General Public License and
+   a copy of the GCC Runtime Library Exception along with this program;
+   see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+   <http://www.gnu.org/licenses/>.  */
+
+/* Additions to <stdfix.h> for the fract (s.15), long fract (s.31) and
+   accum (s16.15) types.
+
+   Addition, subtraction and comparison of these types compile to
+   integer instructions, but the operations the ARM backend does not
+   expand inline, such as multiplying or dividing two accums, call the
+   generic routines in libgcc.  Those are written for any fixed-point
+   format and cost several times what the equivalent integer code
+   does.  The functions here are that integer code:
+
+     mulr, mullr, mulk	     product, rounded down; mulr and mullr
+			     saturate -1 * -1, mulk wraps on overflow
+     mulk_sat		     product of two accums, saturating
+     divk		     quotient of two accums, truncated toward
+			     zero; dividing by zero is undefined
+     mulik, divik, idivk     ISO/IEC TR 18037 integer results:
+			     int * accum, int / accum and
+			     accum / accum, rounded like mulk and divk
+     absr, abslr, absk	     absolute value, saturating
+     roundk		     round to a number of fractional bits,
+			     saturating
+
+   bitsr, bitslr and bitsk return the integer holding the bits of a
+   value, and rbits, lrbits and kbits do the opposite, as in TR 18037.
+   Use them instead of casts between integers and fixed-point types,
+   which convert the value and go through libgcc too: kbits (i <<
+   ACCUM_FBIT) is the accum for the integer i, unless it overflows.  */
+
+#ifndef _ARM_FIXED_H_INCLUDED
+#define _ARM_FIXED_H_INCLUDED
+
+#ifdef __cplusplus
+#error "fixed-point types are not supported in C++"
+#endif
+
+#include <stdfix.h>
+#include <stdint.h>
+
+#if FRACT_FBIT != 15 || LFRACT_FBIT != 31 || ACCUM_FBIT != 15
+#error "arm_fixed.h expects the ARM EABI fixed-point formats"
+#endif
+
+#define __ARM_FIXED_INLINE \
+  static __inline__ __attribute__ ((__always_inline__, __unused__))
+
+typedef int16_t int_r_t;
+typedef int32_t int_lr_t;
+typedef int32_t int_k_t;
+
+#define __ARM_FIXED_BITS(__bits, __from, __fx, __int)			\
+  __ARM_FIXED_INLINE __int						\
+  __bits (__fx __v)							\
+  {									\
+    union { __fx __f; __int __i; } __u;					\
+    __u.__f = __v;							\
+    return __u.__i;							\
+  }									\
+									\
+  __ARM_FIXED_INLINE __fx						\
+  __from (__int __v)							\
+  {									\
+    union { __fx __f; __int __i; } __u;					\
+    __u.__i = __v;							\
+    return __u.__f;							\
+  }
+
+__ARM_FIXED_BITS (bitsr,  rbits,  fract,	int_r_t)
+__ARM_FIXED_BITS (bitslr, lrbits, long fract,	int_lr_t)
+__ARM_FIXED_BITS (bitsk,  kbits,  accum,	int_k_t)
+
+#undef __ARM_FIXED_BITS
+
+__ARM_FIXED_INLINE int32_t
+__arm_fixed_sat32 (int64_t __v)
+{
+  return (__v > INT32_MAX ? INT32_MAX
+	  : __v < INT32_MIN ? INT32_MIN : (int32_t) __v);
+}
+
+__ARM_FIXED_INLINE fract
+mulr (fract __a, fract __b)
+{
+  int32_t __p = (int32_t) bitsr (__a) * bitsr (__b);
+  return rbits (__p == 0x40000000
+		? INT16_MAX : (int_r_t) (__p >> FRACT_FBIT));
+}
+
+__ARM_FIXED_INLINE long fract
+mullr (long fract __a, long fract __b)
+{
+  int64_t __p = (int64_t) bitslr (__a) * bitslr (__b);
+  return lrbits (__p == (int64_t) 1 << 62
+		 ? INT32_MAX : (int_lr_t) (__p >> LFRACT_FBIT));
+}
+
+__ARM_FIXED_INLINE accum
+mulk (accum __a, accum __b)
+{
+  return kbits ((int_k_t) (((int64_t) bitsk (__a) * bitsk (__b))
+			   >> ACCUM_FBIT));
+}
+
+__ARM_FIXED_INLINE accum
+mulk_sat (accum __a, accum __b)
+{
+  return kbits (__arm_fixed_sat32 (((int64_t) bitsk (__a) * bitsk (__b))
+				   >> ACCUM_FBIT));
+}
+
+/* The dividend is shifted left by ACCUM_FBIT bits.  When that still
+   fits in 32 bits, which it does for dividends in [-2, 2), the
+   hardware divide instruction does the work instead of the 64-bit
+   division routine.  */
+__ARM_FIXED_INLINE accum
+divk (accum __a, accum __b)
+{
+  int32_t __n = bitsk (__a);
+  if ((__n >> (31 - ACCUM_FBIT)) == (__n >> 31))
+    return kbits ((int32_t) ((uint32_t) __n << ACCUM_FBIT) / bitsk (__b));
+  return kbits ((int_k_t) (((int64_t) __n << ACCUM_FBIT) / bitsk (__b)));
+}
+
+__ARM_FIXED_INLINE int
+mulik (int __i, accum __k)
+{
+  return (int) (((int64_t) __i * bitsk (__k)) >> ACCUM_FBIT);
+}
+
+__ARM_FIXED_INLINE int
+divik (int __i, accum __k)
+{
+  return (int) (((int64_t) __i << ACCUM_FBIT) / bitsk (__k));
+}
+
+__ARM_FIXED_INLINE int
+idivk (accum __a, accum __b)
+{
+  return bitsk (__a) / bitsk (__b);
+}
+
+__ARM_FIXED_INLINE fract
+absr (fract __f)
+{
+  int_r_t __v = bitsr (__f);
+  return rbits (__v >= 0 ? __v
+		: __v == INT16_MIN ? INT16_MAX : (int_r_t) -__v);
+}
+
+__ARM_FIXED_INLINE long fract
+abslr (long fract __f)
+{
+  int_lr_t __v = bitslr (__f);
+  return lrbits (__v >= 0 ? __v : __v == INT32_MIN ? INT32_MAX : -__v);
+}
+
+__ARM_FIXED_INLINE accum
+absk (accum __k)
+{
+  int_k_t __v = bitsk (__k);
+  return kbits (__v >= 0 ? __v : __v == INT32_MIN ? INT32_MAX : -__v);
+}
+
+/* Round to __n fractional bits, rounding halves up.  */
+__ARM_FIXED_INLINE accum
+roundk (accum __k, int __n)
+{
+  int64_t __half, __v;
+  if (__n >= ACCUM_FBIT)
+    return __k;
+  if (__n < 0)
+    __n = 0;
+  __half = (int64_t) 1 << (ACCUM_FBIT - 1 - __n);
+  __v = ((int64_t) bitsk (__k) + __half) & ~(__half * 2 - 1);
+  if (__v > INT32_MAX)
+    __v = INT32_MAX & ~(__half * 2 - 1);
+  return kbits ((int_k_t) __v);
+}
+
+#endif /* _ARM_FIXED_H_INCLUDED */
@@ -0,0 +1,108 @@
+// { dg-do run }
+
+// Copyright (C) 2012
+// Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// Byte accounting and block reuse of __gnu_cxx::fixed_arena.  Runs on
+// the host as well as on the target:
+//   g++ -iquote arm-cs-tools/arm-none-eabi/include/c++/4.7.2 accounting.cc
+
+#include "ext/fixed_pool_allocator.h"
+#include <cassert>
+
+#define VERIFY(fn) assert(fn)
+
+static char s_buffer[2048] __attribute__((__aligned__(8)));
+
+// A large block reused for a smaller request is split, and freeing the
+// smaller block merges it back into the whole.
+void
+test01()
+{
+  __gnu_cxx::fixed_arena arena(s_buffer, sizeof(s_buffer));
+  void* large = arena.allocate(512);
+  void* pin = arena.allocate(8);
+  arena.deallocate(large, 512);
+  VERIFY( arena.bytes_used() == 8 );
+
+  void* p = arena.allocate(200);
+  VERIFY( p == large );
+  VERIFY( arena.bytes_used() == 208 );
+  arena.deallocate(p, 200);
+  VERIFY( arena.bytes_used() == 8 );
+
+  void* q = arena.allocate(400);
+  VERIFY( q == large );
+  VERIFY( arena.bytes_used() == 408 );
+
+  // The 112 bytes left of the block serve a request of that size.
+  void* r = arena.allocate(112);
+  VERIFY( r == static_cast<char*>(large) + 400 );
+  arena.deallocate(r, 112);
+  arena.deallocate(q, 400);
+  arena.deallocate(pin, 8);
+  VERIFY( arena.bytes_used() == 0 );
+}
+
+// Adjacent freed large blocks merge, in either order, and go back to
+// the bump region when they end at it.
+void
+test02()
+{
+  __gnu_cxx::fixed_arena arena(s_buffer, sizeof(s_buffer));
+  void* a = arena.allocate(256);
+  void* b = arena.allocate(256);
+  void* c = arena.allocate(256);
+  void* pin = arena.allocate(8);
+  arena.deallocate(b, 256);
+  arena.deallocate(a, 256);
+  arena.deallocate(c, 256);
+  VERIFY( arena.bytes_used() == 8 );
+  VERIFY( arena.allocate(768) == a );
+  arena.deallocate(a, 768);
+  arena.deallocate(pin, 8);
+  VERIFY( arena.bytes_untouched() == sizeof(s_buffer) );
+}
+
+// A remainder small enough for a small bin is merged back when the
+// block it was split from is freed.
+void
+test03()
+{
+  static char buffer[1024] __attribute__((__aligned__(8)));
+  __gnu_cxx::fixed_arena arena(buffer, sizeof(buffer));
+  void* large = arena.allocate(512);
+  void* pin = arena.allocate(8);
+  arena.deallocate(large, 512);
+  void* p = arena.allocate(400);
+  VERIFY( p == large );
+  arena.deallocate(p, 400);
+  arena.deallocate(pin, 8);
+  VERIFY( arena.bytes_used() == 0 );
+  VERIFY( arena.bytes_untouched() == sizeof(buffer) );
+  VERIFY( arena.allocate(488) == large );
+}
+
+int
+main()
+{
+  test01();
+  test02();
+  test03();
+  return 0;
+}
@@ -0,0 +1,77 @@
+/* Check the inline routines of arm_fixed.h against their definitions.
+   Fixed-point types are only supported on the target:
+     arm-none-eabi-gcc -mcpu=cortex-m3 -mthumb -O2 arm_fixed.c  */
+/* { dg-do run } */
+/* { dg-require-effective-target fixed_point } */
+/* { dg-options "-O2" } */
+
+#include <arm_fixed.h>
+#include <stdlib.h>
+
+#define VERIFY(cond) do { if (!(cond)) abort (); } while (0)
+
+static void
+test_bits (void)
+{
+  VERIFY (bitsk (1.0k) == 1 << ACCUM_FBIT);
+  VERIFY (bitsk (-0.5k) == -(1 << (ACCUM_FBIT - 1)));
+  VERIFY (kbits (3 << ACCUM_FBIT) == 3.0k);
+  VERIFY (bitsr (0.5r) == 1 << (FRACT_FBIT - 1));
+  VERIFY (lrbits (bitslr (-0.25lr)) == -0.25lr);
+}
+
+static void
+test_multiply (void)
+{
+  VERIFY (mulk (1.5k, 2.0k) == 3.0k);
+  VERIFY (mulk (-1.5k, 2.0k) == -3.0k);
+  /* The product of the smallest steps rounds down to 0.  */
+  VERIFY (mulk (kbits (1), kbits (1)) == 0);
+  VERIFY (mulk_sat (30000.0k, 30000.0k) == kbits (INT32_MAX));
+  VERIFY (mulk_sat (-30000.0k, 30000.0k) == kbits (INT32_MIN));
+  VERIFY (mulr (0.5r, 0.5r) == 0.25r);
+  VERIFY (mulr (-1.0r, -1.0r) == rbits (INT16_MAX));
+  VERIFY (mullr (-1.0lr, -1.0lr) == lrbits (INT32_MAX));
+  VERIFY (mulik (100, 0.25k) == 25);
+  VERIFY (mulik (-100, 0.25k) == -25);
+}
+
+static void
+test_divide (void)
+{
+  /* Dividends in [-2, 2) take the 32-bit path; the rest the 64-bit one.  */
+  VERIFY (divk (1.0k, 4.0k) == 0.25k);
+  VERIFY (divk (-2.0k, 0.5k) == -4.0k);
+  VERIFY (divk (kbits ((2 << ACCUM_FBIT) - 1), 1.0k)
+	  == kbits ((2 << ACCUM_FBIT) - 1));
+  VERIFY (divk (2.0k, 0.5k) == 4.0k);
+  VERIFY (divk (1000.0k, 8.0k) == 125.0k);
+  VERIFY (divk (-1000.0k, 8.0k) == -125.0k);
+  VERIFY (divik (3, 0.5k) == 6);
+  VERIFY (idivk (10.0k, 3.0k) == 3);
+}
+
+static void
+test_abs_round (void)
+{
+  VERIFY (absk (-1.25k) == 1.25k);
+  VERIFY (absk (kbits (INT32_MIN)) == kbits (INT32_MAX));
+  VERIFY (absr (-1.0r) == rbits (INT16_MAX));
+  VERIFY (abslr (-0.5lr) == 0.5lr);
+  VERIFY (roundk (1.25k, 1) == 1.5k);
+  VERIFY (roundk (1.2k, 0) == 1.0k);
+  VERIFY (roundk (-1.5k, 0) == -1.0k);
+  VERIFY (roundk (1.2k, ACCUM_FBIT) == 1.2k);
+  VERIFY (roundk (kbits (INT32_MAX), 0)
+	  == kbits (INT32_MAX & ~((1 << ACCUM_FBIT) - 1)));
+}
+
+int
+main (void)
+{
+  test_bits ();
+  test_multiply ();
+  test_divide ();
+  test_abs_round ();
+  return 0;
+}
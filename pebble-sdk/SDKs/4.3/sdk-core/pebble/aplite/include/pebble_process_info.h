@@ -41,9 +41,39 @@ typedef enum {
 // .major:0x08 .minor:0x02 -- 2.0, added resource crc and resource timestamp
 // .major:0x09 .minor:0x00 -- 2.0, no more reloc_list_start
 // .major:0x10 .minor:0x00 -- 2.0, added virtual_size
+// .major:0x11 .minor:0x00 -- reserved: compressed reloc table (see PROCESS_INFO_RELOC_RUN)
+// .major:0x12 .minor:0x00 -- reserved: added cold_text_offset and cold_text_size
 #define PROCESS_INFO_CURRENT_STRUCT_VERSION_MAJOR 0x10
 #define PROCESS_INFO_CURRENT_STRUCT_VERSION_MINOR 0x0
 
+// The struct version of binaries with a compressed reloc table. Binaries with an older struct
+// version carry one uint32_t offset per relocated word. This is a major version, so that firmware
+// which would read the compressed table as plain offsets refuses the binary instead of loading it.
+// No loader in the field decodes the table yet, so the SDK build does not compress it and keeps
+// PROCESS_INFO_CURRENT_STRUCT_VERSION; only a binary whose table is compressed carries this one.
+#define PROCESS_INFO_FIRST_COMPRESSED_RELOC_STRUCT_VERSION_MAJOR 0x11
+#define PROCESS_INFO_FIRST_COMPRESSED_RELOC_STRUCT_VERSION_MINOR 0x0
+
+// The struct version of binaries with cold_text_offset and cold_text_size, which are only part of
+// PebbleProcessInfo when PROCESS_INFO_COLD_TEXT is defined. The cold section is not part of
+// load_size, so firmware that does not know these fields would load the app without it; as with
+// the compressed reloc table, this is a major version so that such firmware refuses it, and the
+// SDK build does not produce it until a loader exists.
+#define PROCESS_INFO_FIRST_COLD_TEXT_STRUCT_VERSION_MAJOR 0x12
+#define PROCESS_INFO_FIRST_COLD_TEXT_STRUCT_VERSION_MINOR 0x0
+
+// Compressed reloc table format
+// ================================
+// The table is a sequence of ULEB128-encoded records, starting at offset 0 with no relocated
+// word before it. For a record value v:
+// - if (v & PROCESS_INFO_RELOC_RUN) == 0, the next relocated word is (v >> 1) words after the
+//   previous one (delta record)
+// - otherwise the (v >> 1) words directly following the previous one are all relocated (run
+//   record), which covers vtables, function pointer tables and pointer arrays in .data
+// num_reloc_entries still counts relocated words, so the loader decodes records until it has
+// applied that many, in a single forward pass over the table.
+#define PROCESS_INFO_RELOC_RUN 0x1
+
 // process info version for last know 1.x
 // let this be a warning to engineers everywhere
 // who want to design a system with fancy versioning and
@@ -124,14 +154,19 @@ typedef enum {
 // sdk.major:0x5 .minor:0x4c -- More Health service API calls (rev 79)
 // sdk.major:0x5 .minor:0x4d -- Add health_service_get_measurement_system_for_display() (rev 80)
 // sdk.major:0x5 .minor:0x4e -- Export gdraw_command_frame_get_command_list() (rev 81)
+// sdk.major:0x5 .minor:0x4f -- 4.3: Add partial redraws, window preloading and hibernation, allocators, persist blobs/logs/transactions, AppMessage and DataLogging extensions, sensor pipelines, DSP and profiling APIs (rev 82)
 
 #define PROCESS_INFO_CURRENT_SDK_VERSION_MAJOR 0x5
-#define PROCESS_INFO_CURRENT_SDK_VERSION_MINOR 0x4e
+#define PROCESS_INFO_CURRENT_SDK_VERSION_MINOR 0x4f
 
 // The first SDK to ship with 3.0 APIs
 #define PROCESS_INFO_FIRST_3_0_SDK_VERSION_MAJOR 0x5
 #define PROCESS_INFO_FIRST_3_0_SDK_VERSION_MINOR 0x16
 
+// The first SDK with the 4.3 APIs
+#define PROCESS_INFO_FIRST_4_3_X_SDK_VERSION_MAJOR 0x5
+#define PROCESS_INFO_FIRST_4_3_X_SDK_VERSION_MINOR 0x4f
+
 
 #define PROCESS_NAME_BYTES 32
 #define COMPANY_NAME_BYTES 32
@@ -187,6 +222,10 @@ typedef struct __attribute__((__packed__)) {
   uint32_t resource_crc;            //!< CRC of the resource data only
   uint32_t resource_timestamp;      //!< timestamp of the resource data
   uint16_t virtual_size;            //!< The total amount of memory used by the process (.text + .data + .bss)
+#if defined(PROCESS_INFO_COLD_TEXT)
+  uint32_t cold_text_offset;        //!< Offset in the binary of the cold code section (PBL_COLD), 0 if none
+  uint32_t cold_text_size;          //!< Size of the cold code section, which is not part of load_size or virtual_size
+#endif
 } PebbleProcessInfo;
 
 //! @internal
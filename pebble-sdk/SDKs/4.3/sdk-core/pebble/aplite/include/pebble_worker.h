@@ -170,8 +170,155 @@ int32_t cos_lookup(int32_t angle);
 //! The angle value is scaled linearly, such that a value of 0x10000 corresponds to 360 degrees or 2 PI radians.
 int32_t atan2_lookup(int16_t y, int16_t x);
 
+#if defined(PBL_FIXED_POINT) && !defined(__cplusplus)
+#include <arm_fixed.h>
+
+//! Look-up the sine of the given angle as an `accum`, for C code written with the fixed-point
+//! types of `<stdfix.h>`. The result is between -1.0k and 1.0k, within one step of the exact
+//! value, so `mulik(radius, sin_lookup_k(angle))` replaces
+//! `radius * sin_lookup(angle) / TRIG_MAX_RATIO`.
+//! The `_k` look-ups are only declared when `PBL_FIXED_POINT` is defined before including
+//! pebble.h. pebble.h then includes `<arm_fixed.h>`, which provides mulk(), mulik() and the other
+//! routines that multiply and divide fixed-point values without calling into the much slower
+//! generic ones in libgcc. `<stdfix.h>`, which it includes in turn, defines `fract`, `accum` and
+//! `sat` as macros, so code that uses those names or the names of the routines for anything else
+//! cannot opt in.
+//! \code{.c}
+//! #define PBL_FIXED_POINT
+//! #include <pebble.h>
+//! \endcode
+//! @param angle The angle for which to compute the sine, scaled like the angle of \ref sin_lookup
+#define sin_lookup_k(angle) kbits((sin_lookup(angle) + 1) >> 1)
+
+//! Look-up the cosine of the given angle as an `accum`, like \ref sin_lookup_k.
+//! @param angle The angle for which to compute the cosine, scaled like the angle of
+//! \ref sin_lookup
+#define cos_lookup_k(angle) kbits((cos_lookup(angle) + 1) >> 1)
+
+//! Look-up the arctangent of a given x, y pair of `accum` values. Unlike \ref atan2_lookup, the
+//! components do not have to fit into an int16_t, and small components keep their precision.
+//! The angle value is scaled linearly, such that a value of 0x10000 corresponds to 360 degrees or
+//! 2 PI radians.
+//! Both components are shifted right by the same number of bits until they fit the arguments of
+//! \ref atan2_lookup, which keeps their ratio.
+static inline int32_t atan2_lookup_k(accum y, accum x) {
+  int32_t y_bits = bitsk(y);
+  int32_t x_bits = bitsk(x);
+  while (y_bits != (int16_t)y_bits || x_bits != (int16_t)x_bits) {
+    y_bits >>= 1;
+    x_bits >>= 1;
+  }
+  return atan2_lookup((int16_t)y_bits, (int16_t)x_bits);
+}
+#endif
+
+//! Linearly interpolates between two values using a ratio in the same fixed point representation
+//! as the results of \ref sin_lookup and \ref cos_lookup.
+//! @param from The value for a ratio of 0
+//! @param to The value for a ratio of \ref TRIG_MAX_RATIO
+//! @param ratio The interpolation ratio, between 0 and \ref TRIG_MAX_RATIO
+#define INTERPOLATE_BY_RATIO(from, to, ratio) \
+  ((int32_t)((from) + (((int64_t)(to) - (from)) * (ratio)) / TRIG_MAX_RATIO))
+
+//! Computes the integer square root of a value, rounded down.
+//! @param value The value of which to compute the square root
+//! @return The largest integer whose square is less than or equal to `value`
+uint32_t integer_sqrt(uint32_t value);
+
+//! Computes the length of the vector (x, y), rounded to the nearest integer, without the risk of
+//! overflowing intermediate results.
+//! @param x The horizontal component of the vector
+//! @param y The vertical component of the vector
+//! @return The length of the vector
+uint32_t integer_hypot(int32_t x, int32_t y);
+
 //! @} // group Math
 
+//! @addtogroup SignalProcessing Signal Processing
+//! \brief Fixed-point digital signal processing kernels
+//!
+//! Optimized kernels for filtering and analyzing sampled signals, such as accelerometer readings.
+//! Samples are 16-bit signed integers and coefficients are Q15 fixed-point values, where
+//! \ref DSP_Q15_ONE represents 1.0. The kernels use the DSP instructions of the processor where it
+//! has them. The same kernels can be attached to the accelerometer service, see
+//! \ref accel_feature_service_subscribe().
+//! @{
+
+//! The Q15 fixed-point representation of 1.0 (approximately).
+#define DSP_Q15_ONE ((int16_t) 0x7fff)
+
+//! A finite impulse response filter.
+//! @see dsp_fir_filter
+typedef struct {
+  //! The Q15 filter coefficients, `num_taps` elements.
+  const int16_t *coefficients;
+  //! State of the filter, `num_taps` elements. Zero it before the first use.
+  int16_t *state;
+  //! The number of filter taps.
+  uint16_t num_taps;
+} DspFirFilter;
+
+//! A second-order infinite impulse response filter section (biquad), in direct form I.
+//! Coefficients are Q14 fixed-point values, so that values between -2.0 and 2.0 can be
+//! represented. The feedback coefficients `a1` and `a2` are stored with their signs inverted.
+//! @see dsp_biquad_filter
+typedef struct {
+  int16_t b0; //!< Feed-forward coefficient of the current input
+  int16_t b1; //!< Feed-forward coefficient of the previous input
+  int16_t b2; //!< Feed-forward coefficient of the input before the previous one
+  int16_t a1; //!< Negated feedback coefficient of the previous output
+  int16_t a2; //!< Negated feedback coefficient of the output before the previous one
+  int16_t state[4]; //!< State of the filter. Zero it before the first use.
+} DspBiquad;
+
+//! Window functions to apply before a spectrum is computed.
+//! @see dsp_spectrum
+typedef enum {
+  DspWindowRectangular = 0, //!< No window
+  DspWindowHann,            //!< Hann window
+  DspWindowHamming,         //!< Hamming window
+} DspWindow;
+
+//! Filters samples with a finite impulse response filter.
+//! @param filter The filter. Its state is updated, so consecutive calls filter a continuous signal.
+//! @param input The input samples
+//! @param[out] output The filtered samples. May be the same buffer as `input`.
+//! @param num_samples The number of samples in `input` and `output`
+void dsp_fir_filter(DspFirFilter *filter, const int16_t *input, int16_t *output,
+                    uint32_t num_samples);
+
+//! Filters samples with a biquad filter section.
+//! @param filter The filter. Its state is updated, so consecutive calls filter a continuous signal.
+//! @param input The input samples
+//! @param[out] output The filtered samples. May be the same buffer as `input`.
+//! @param num_samples The number of samples in `input` and `output`
+void dsp_biquad_filter(DspBiquad *filter, const int16_t *input, int16_t *output,
+                       uint32_t num_samples);
+
+//! Computes the magnitude spectrum of a block of samples with a fixed-point FFT.
+//! @param input The input samples, `1 << log2_num_samples` elements
+//! @param[out] magnitudes The magnitude of each frequency bin from 0 up to half the sampling rate,
+//! `(1 << log2_num_samples) / 2` elements
+//! @param log2_num_samples The base 2 logarithm of the number of samples, between 4 and 9
+//! (16 to 512 samples)
+//! @param window The window function to apply to the samples first
+void dsp_spectrum(const int16_t *input, uint16_t *magnitudes, uint8_t log2_num_samples,
+                  DspWindow window);
+
+//! Finds the local maxima of a signal.
+//! @param input The input samples
+//! @param num_samples The number of samples in `input`
+//! @param threshold Maxima below this value are ignored
+//! @param min_distance The minimum distance in samples between two peaks. Of two peaks that are
+//! closer together, only the higher one is reported.
+//! @param[out] peak_indices The indices of the peaks that were found, in ascending order
+//! @param max_peaks The number of elements in `peak_indices`
+//! @return The number of peaks that were written to `peak_indices`
+uint32_t dsp_find_peaks(const int16_t *input, uint32_t num_samples, int16_t threshold,
+                        uint16_t min_distance, uint32_t *peak_indices, uint32_t max_peaks);
+
+//! @} // group SignalProcessing
+
 //! @addtogroup WallTime Wall Time
 //!   \brief Functions, data structures and other things related to wall clock time.
 //!
@@ -229,6 +376,37 @@ bool clock_is_timezone_set(void);
 //! @note timezone buffer should be at least TIMEZONE_NAME_LENGTH bytes
 void clock_get_timezone(char *timezone, const size_t buffer_size);
 
+//! Gets the current time broken down and adjusted for the local timezone, like
+//! `localtime(&(time_t){ time(NULL) })`. The result is computed at most once per second and shared
+//! with the `tick_time` passed to \ref TickHandler, so calling this from every tick is cheap.
+//! @return A pointer to the broken-down local time of the current second. It is overwritten when
+//! the second changes and must not be modified.
+const struct tm *clock_get_local_time(void);
+
+struct TimeFormatter;
+typedef struct TimeFormatter TimeFormatter;
+
+//! Creates a formatter for a `strftime` format string. The format string is parsed once when the
+//! formatter is created, and each call to \ref time_formatter_format() only re-renders the fields
+//! whose time components changed since the previous call. Use this for strings that are updated
+//! on every tick, such as a watchface's time display.
+//! @param format a formatting string, as accepted by `strftime`
+//! @param max_length The maximum length of the formatted string, not including the null byte
+//! @return A pointer to the formatter, or NULL if the format string is invalid or there was not
+//! enough memory
+TimeFormatter *time_formatter_create(const char *format, size_t max_length);
+
+//! Formats a time with a formatter created by \ref time_formatter_create().
+//! @param formatter The formatter to use
+//! @param tm_p A pointer to a struct tm containing a broken out time value
+//! @return A pointer to the formatted, null-terminated string owned by the formatter. It stays
+//! valid until the next call to this function or until the formatter is destroyed.
+const char *time_formatter_format(TimeFormatter *formatter, const struct tm *tm_p);
+
+//! Destroys a formatter created by \ref time_formatter_create().
+//! @param formatter The formatter to destroy
+void time_formatter_destroy(TimeFormatter *formatter);
+
 //! @} // group WallTime
 
 //! @addtogroup Platform
@@ -299,6 +477,36 @@ bool connection_service_peek_pebble_app_connection(void);
 //! @return true if a PebbleKit companion app is connected, false otherwise
 bool connection_service_peek_pebblekit_connection(void);
 
+//! Estimates of the quality of the Bluetooth link to the phone, see
+//! \ref connection_service_peek_link_quality()
+typedef struct {
+  //! The largest payload in bytes a single Bluetooth packet carries on this link. Messages are
+  //! sent in packets of this size, so AppMessage chunks that are a multiple of it, less the
+  //! dictionary and tuple headers, waste the least airtime.
+  uint16_t mtu;
+  //! The current interval in milliseconds at which the radio wakes up to exchange packets. This
+  //! is the actual interval the link negotiated, which \ref app_comm_set_sniff_interval() only
+  //! influences.
+  uint16_t sniff_interval_ms;
+  //! The average time in milliseconds from sending an AppMessage to receiving its
+  //! acknowledgement, over the recent messages of all apps
+  uint16_t round_trip_ms;
+  //! The received signal strength in dBm, typically between -100 (weak) and -40 (strong)
+  int8_t rssi_dbm;
+  //! The estimated number of bytes per second the link can carry with the current interval and
+  //! signal strength, including retransmissions
+  uint32_t throughput_bytes_per_sec;
+} ConnectionLinkQuality;
+
+//! Gets estimates of the quality of the link to the phone, so that an app can size its
+//! AppMessage chunks or choose the quality of the images it requests from the link it actually
+//! has, instead of from the slowest link it may ever have. The estimates are updated as packets
+//! are exchanged, so they are most accurate while the app is sending. Reading them does not use
+//! the radio.
+//! @param[out] quality The estimates
+//! @return true if the Pebble app is connected and `quality` was filled in, false otherwise
+bool connection_service_peek_link_quality(ConnectionLinkQuality *quality);
+
 //! Subscribe to the connection event service. Once subscribed, the appropriate
 //! handler gets called based on the type of connection event and user provided
 //! handlers
@@ -376,6 +584,60 @@ void battery_state_service_unsubscribe(void);
 //! @return a \ref BatteryChargeState containing the last known data
 BatteryChargeState battery_state_service_peek(void);
 
+//! Performance tiers that the system selects from the battery state, so that apps can scale
+//! their work down as the battery runs low instead of each app choosing its own thresholds.
+//! @see performance_tier_service_subscribe
+typedef enum {
+  //! The watch is charging or the battery is above 40%: do all work.
+  PerformanceTierFull = 0,
+  //! The battery is between 20% and 40%: skip work the user is unlikely to miss, such as
+  //! decorative animations or refreshing data that did not change.
+  PerformanceTierBalanced,
+  //! The battery is below 20%: do only the work needed to show correct information.
+  PerformanceTierSaver,
+} PerformanceTier;
+
+//! System services that can adapt to the performance tier by themselves.
+//! @see performance_tier_set_follow
+typedef enum {
+  //! Lower the frame rate of the app's animations to 20 frames per second in
+  //! \ref PerformanceTierBalanced and 10 in \ref PerformanceTierSaver. Animations keep their
+  //! durations. Only applies to the foreground app.
+  PerformanceFollowAnimations = 1 << 0,
+  //! Halve the accelerometer sampling rate set with \ref accel_service_set_sampling_rate() in
+  //! each tier below \ref PerformanceTierFull, down to \ref ACCEL_SAMPLING_10HZ.
+  PerformanceFollowAccelSamplingRate = 1 << 1,
+  //! Double the heart rate sample period requested with
+  //! \ref health_service_set_heart_rate_sample_period() in each tier below
+  //! \ref PerformanceTierFull.
+  PerformanceFollowHeartRateSamplePeriod = 1 << 2,
+  //! All of the above
+  PerformanceFollowAll = (1 << 3) - 1,
+} PerformanceFollowMask;
+
+//! Callback type for performance tier change events
+//! @param tier The new performance tier
+typedef void (*PerformanceTierHandler)(PerformanceTier tier);
+
+//! Subscribe to the performance tier event service. Once subscribed, the handler gets called
+//! every time the system selects another tier. The tier does not change back and forth when
+//! the charge level hovers around a threshold.
+//! @param handler A callback to be executed on performance tier change events
+void performance_tier_service_subscribe(PerformanceTierHandler handler);
+
+//! Unsubscribe from the performance tier event service. Once unsubscribed, the previously
+//! registered handler will no longer be called.
+void performance_tier_service_unsubscribe(void);
+
+//! Peek at the current performance tier.
+//! @return The current \ref PerformanceTier
+PerformanceTier performance_tier_service_peek(void);
+
+//! Choose the system services that adapt to the performance tier automatically. By default no
+//! service does, so an app's frame and sampling rates only change when it opts in.
+//! @param mask The services to adapt, see \ref PerformanceFollowMask, or 0 for none
+void performance_tier_set_follow(PerformanceFollowMask mask);
+
 //! @} // group BatteryStateService
 
 //! @addtogroup AccelerometerService
@@ -501,6 +763,109 @@ void accel_tap_service_unsubscribe(void);
 //! @param samples_per_update the number of samples to buffer, between 0 and 25.
 void accel_raw_data_service_subscribe(uint32_t samples_per_update, AccelRawDataHandler handler);
 
+//! The maximum number of samples that can be buffered between each event of
+//! \ref accel_raw_data_service_subscribe_batched() and \ref accel_feature_service_subscribe().
+//! This is the largest block \ref dsp_spectrum() transforms, so every spectrum size can be used.
+#define ACCEL_BATCH_MAX_SAMPLES_PER_UPDATE 512
+
+//! Subscribe to the accelerometer raw data event service with a deep sample buffer. This works
+//! like \ref accel_raw_data_service_subscribe(), but the samples are collected by the system
+//! into a ring buffer on the app's heap, so that hundreds of samples can be delivered per event.
+//! At high sampling rates this wakes the app far less often, which saves battery and handler
+//! overhead.
+//! @note Cannot use \ref accel_service_peek() when subscribed to accelerometer data events.
+//! @param handler A callback to be executed on accelerometer data events. The samples are spaced
+//! evenly at the sampling rate, starting at `timestamp`.
+//! @param samples_per_update the number of samples to buffer, between 1 and
+//! \ref ACCEL_BATCH_MAX_SAMPLES_PER_UPDATE.
+//! @return 0 on success, or -1 if the buffer could not be allocated.
+int accel_raw_data_service_subscribe_batched(uint32_t samples_per_update,
+                                             AccelRawDataHandler handler);
+
+//! The features that an accelerometer pipeline can deliver.
+//! @see accel_feature_service_subscribe
+typedef enum {
+  //! The vector magnitude of each sample, one value per sample.
+  ACCEL_FEATURE_MAGNITUDE = 0,
+  //! The magnitude spectrum of the vector magnitudes of a batch of samples, see
+  //! \ref dsp_spectrum(). `samples_per_update` must be a power of two from 16 to
+  //! \ref ACCEL_BATCH_MAX_SAMPLES_PER_UPDATE, and half as many values are delivered.
+  ACCEL_FEATURE_SPECTRUM,
+} AccelFeature;
+
+//! Configuration of an accelerometer pipeline.
+//! @see accel_feature_service_subscribe
+typedef struct {
+  //! A filter that is applied to the samples of each axis before the features are computed, or
+  //! NULL. The coefficients are shared between the axes, and each axis keeps its own state.
+  const DspBiquad *filter;
+  //! The feature to compute.
+  AccelFeature feature;
+  //! The window function to apply for \ref ACCEL_FEATURE_SPECTRUM.
+  DspWindow window;
+} AccelPipelineConfig;
+
+//! Callback type for accelerometer feature events
+//! @param features Pointer to the computed feature values. Both magnitudes and spectra are
+//! unsigned.
+//! @param num_features the number of values stored in features.
+//! @param timestamp the timestamp, in ms, of the first sample that the features were computed from.
+typedef void (*AccelFeatureHandler)(const uint16_t *features, uint32_t num_features,
+                                    uint64_t timestamp);
+
+//! Subscribe to the accelerometer feature event service. The samples are processed by the
+//! \ref SignalProcessing kernels in the system before the handler is called, so the handler
+//! receives the features instead of raw samples.
+//! Use \ref accel_data_service_unsubscribe() to unsubscribe.
+//! @note Cannot use \ref accel_service_peek() when subscribed to accelerometer data events.
+//! @param samples_per_update the number of samples to process per event, between 1 and
+//! \ref ACCEL_BATCH_MAX_SAMPLES_PER_UPDATE.
+//! @param config The pipeline configuration. Copied during the call.
+//! @param handler A callback to be executed on accelerometer feature events
+//! @return 0 on success, or -1 if the configuration is invalid or the buffers could not be
+//! allocated.
+int accel_feature_service_subscribe(uint32_t samples_per_update,
+                                    const AccelPipelineConfig *config,
+                                    AccelFeatureHandler handler);
+
+//! Configuration of the motion gate of the accelerometer data services.
+//! @see accel_data_service_set_motion_gate
+typedef struct {
+  //! The change of acceleration in milli-Gs on each axis, indexed by \ref AccelAxisType, that
+  //! counts as motion. Gravity is removed first, so these are independent of how the watch is
+  //! held. 0 ignores the axis.
+  uint16_t threshold_mg[3];
+  //! How long in milliseconds one of the thresholds has to be exceeded before the gate opens.
+  //! Short values catch the start of a wrist raise, longer ones ignore bumps.
+  uint16_t open_duration_ms;
+  //! How long in milliseconds all axes have to stay below their thresholds before the gate
+  //! closes again.
+  uint16_t close_duration_ms;
+} AccelMotionGateConfig;
+
+//! Callback type for motion gate events
+//! @param open true when motion started and samples are delivered again, false when the
+//! watch came to rest and delivery stopped
+typedef void (*AccelMotionGateHandler)(bool open);
+
+//! Gate the accelerometer data services on motion. While the gate is closed, samples are not
+//! delivered to the handlers of \ref accel_data_service_subscribe(),
+//! \ref accel_raw_data_service_subscribe(), \ref accel_raw_data_service_subscribe_batched()
+//! or \ref accel_feature_service_subscribe(), and neither the app nor the main processor is
+//! woken up: the accelerometer watches the thresholds by itself at a low sampling rate and raises
+//! an interrupt when they are exceeded. While the gate is open, samples are delivered at the
+//! configured rate, starting with the samples of the `open_duration_ms` that opened it, so the
+//! start of the motion is not lost. Apps that only look for motion starts, such as wrist raises,
+//! should use this instead of analyzing a continuous stream. The gate starts out closed.
+//! @note \ref accel_tap_service_subscribe() already works this way and is not affected by the
+//! gate.
+//! @param config The thresholds and durations, copied during the call, or NULL to remove the
+//! gate and deliver all samples again
+//! @param handler A callback to be executed when the gate opens or closes, or NULL
+//! @return 0 on success, or -1 if the configuration is invalid
+int accel_data_service_set_motion_gate(const AccelMotionGateConfig *config,
+                                       AccelMotionGateHandler handler);
+
 //! @} // group AccelerometerService
 
 //! @addtogroup CompassService
@@ -591,6 +956,47 @@ void compass_service_unsubscribe(void);
 //! @return Always returns 0 to indicate success.
 int compass_service_peek(CompassHeadingData *data);
 
+//! Structure containing a single tilt-compensated orientation of the watch.
+typedef struct {
+  //! Angle that increases counter-clockwise from magnetic north, like
+  //! \ref CompassHeadingData.magnetic_heading, but compensated for the tilt of the watch using the
+  //! accelerometer, so it stays valid when the watch is not held level.
+  CompassHeading heading;
+  //! Rotation around the X axis, scaled like \ref CompassHeading. 0 when the watch is level.
+  int32_t pitch;
+  //! Rotation around the Y axis, scaled like \ref CompassHeading. 0 when the watch is level.
+  int32_t roll;
+  //! Indicates the current state of the Compass Service calibration.
+  CompassStatus compass_status;
+  //! timestamp, in milliseconds
+  uint64_t timestamp;
+} CompassOrientationData;
+
+//! Callback type for orientation events
+//! @param data Pointer to the orientation samples, oldest first.
+//! @param num_samples the number of samples stored in data.
+typedef void (*CompassOrientationHandler)(const CompassOrientationData *data,
+                                          uint32_t num_samples);
+
+//! Subscribe to the fused orientation service. The system combines the compass and the
+//! accelerometer readings internally and delivers tilt-compensated orientation samples at the
+//! requested rate, in batches, so the app does not have to run both services at their full rate
+//! to fuse them itself.
+//! @note The fused orientation service uses the accelerometer, but does not conflict with
+//! subscriptions to the \ref AccelerometerService.
+//! @param rate_hz The number of orientation samples per second, between 1 and 25.
+//! @param samples_per_update the number of samples to buffer, between 1 and 25.
+//! @param handler A callback to be executed on orientation events
+//! @return 0 on success, or non-zero if a parameter is invalid.
+//! @see compass_orientation_service_unsubscribe
+int compass_orientation_service_subscribe(uint8_t rate_hz, uint32_t samples_per_update,
+                                          CompassOrientationHandler handler);
+
+//! Unsubscribe from the fused orientation service. Once unsubscribed,
+//! the previously registered handler will no longer be called.
+//! @see compass_orientation_service_subscribe
+void compass_orientation_service_unsubscribe(void);
+
 //! @} // group CompassService
 
 //! @addtogroup TickTimerService
@@ -599,6 +1005,11 @@ int compass_service_peek(CompassHeadingData *data);
 //! The TickTimerService allows your app to be called every time one Time component has changed.
 //! This is extremely important for watchfaces. Your app can choose on which time component
 //! change a tick should occur. Time components are defined by a \ref TimeUnits enum bitmask.
+//!
+//! Besides the single subscription made with \ref tick_timer_service_subscribe(), additional
+//! subscriptions with their own units and handlers can be added with
+//! \ref tick_timer_service_add_subscription(). All subscriptions are driven by one system timer,
+//! so they never drift apart and cause only one wakeup per tick.
 //! @{
 
 //! Time unit flags that can be used to create a bitmask for use in \ref tick_timer_service_subscribe().
@@ -635,6 +1046,25 @@ void tick_timer_service_subscribe(TimeUnits tick_units, TickHandler handler);
 //! handler will no longer be called.
 void tick_timer_service_unsubscribe(void);
 
+struct TickTimerSubscription;
+typedef struct TickTimerSubscription TickTimerSubscription;
+
+//! Adds a subscription to the tick timer event service, in addition to the one made with
+//! \ref tick_timer_service_subscribe(). Each subscription's handler is called on its own
+//! requested unit changes, and handlers whose units changed on the same tick are called one
+//! after another from the same wakeup.
+//! @param tick_units a bitmask of all the units that should trigger the handler
+//! @param handler The callback to be executed on tick events
+//! @return A pointer to the subscription that can be used to remove it, or NULL if there was
+//! not enough memory
+TickTimerSubscription *tick_timer_service_add_subscription(TimeUnits tick_units,
+                                                           TickHandler handler);
+
+//! Removes a subscription added with \ref tick_timer_service_add_subscription(). Once removed,
+//! the handle may no longer be used for any purpose.
+//! @param subscription The subscription to remove
+void tick_timer_service_remove_subscription(TickTimerSubscription *subscription);
+
 //! @} // group TickTimerService
 
 //! @addtogroup HealthService
@@ -792,6 +1222,31 @@ typedef enum {
 //!  if available.
 #define health_service_aggregate_averaged(metric, time_start, time_end, aggregation, scope) (0)
 
+//! Describes one query for \ref health_service_query_many().
+typedef struct {
+  //! Which \ref HealthMetric to query.
+  HealthMetric metric;
+  //! UTC time of the start of the query interval.
+  time_t time_start;
+  //! UTC time of the end of the query interval.
+  time_t time_end;
+  //! The aggregation function to perform on the metric.
+  HealthAggregation aggregation;
+  //! \ref HealthServiceTimeScope value describing how the average should be computed.
+  HealthServiceTimeScope scope;
+  //! Out: the result of the query, as \ref health_service_aggregate_averaged() would return it.
+  HealthValue result;
+} HealthServiceQuery;
+
+//! Runs several metric queries in one call. The system maintains hourly and daily aggregates of
+//! each metric as data is recorded, so each query is answered from those buckets, and only the
+//! partial hours at the edges of a query interval are computed from minute data. Queries that
+//! share a time range are answered in the same pass.
+//! @param queries The queries to run. The `.result` field of each query is set.
+//! @param num_queries The number of elements in `queries`
+//! @return The number of queries for which data was available.
+uint32_t health_service_query_many(HealthServiceQuery *queries, uint32_t num_queries);
+
 //! Expresses a set of \ref HealthActivity values as a bitmask.
 typedef uint32_t HealthActivityMask;
 
@@ -963,6 +1418,21 @@ bool health_service_events_subscribe(HealthEventHandler handler, void *context);
 //! @return `true` on success, `false` on failure.
 bool health_service_events_unsubscribe(void);
 
+//! Set how often events of the given type are delivered to the \ref HealthEventHandler. The
+//! system coalesces events of that type and only delivers one after at least `min_interval_sec`
+//! have passed since the previous one, and only if the relevant metric changed by at least
+//! `min_change` since the previous event. This avoids waking the app for changes that it does not
+//! display, like single steps during a walk.
+//! @note Only \ref HealthEventMovementUpdate, with \ref HealthMetricStepCount as the relevant metric,
+//! and \ref HealthEventHeartRateUpdate, with \ref HealthMetricHeartRateBPM as the relevant metric,
+//! can be filtered. \ref HealthEventSignificantUpdate is always delivered immediately.
+//! @param event The type of event to filter.
+//! @param min_interval_sec The minimum number of seconds between two events of the type, or 0.
+//! @param min_change The minimum change of the relevant metric between two events, or 0.
+//! @return `true` on success, `false` if the event type cannot be filtered.
+bool health_service_set_event_filter(HealthEventType event, uint16_t min_interval_sec,
+                                     HealthValue min_change);
+
 //! Set the desired sampling period for heart rate readings. Normally, the system will sample the
 //! heart rate using a sampling period that is automatically chosen to provide useful information
 //! without undue battery drain (it automatically samples more often during periods of intense
@@ -996,6 +1466,44 @@ bool health_service_events_unsubscribe(void);
 //! the app exits, or 0 if there is no active request by this app.
 #define health_service_get_heart_rate_sample_period_expiration_sec() (0)
 
+//! The largest number of heart rate samples delivered in one batch, see
+//! \ref health_service_set_heart_rate_batch_handler()
+#define HEALTH_HEART_RATE_BATCH_MAX_SAMPLES 240
+
+//! A heart rate reading delivered by \ref health_service_set_heart_rate_batch_handler()
+typedef struct {
+  //! The time the reading was taken
+  time_t timestamp;
+  //! The filtered heart rate, as \ref HealthMetricHeartRateBPM would report it
+  uint8_t bpm;
+  //! The unfiltered heart rate, as \ref HealthMetricHeartRateRawBPM would report it
+  uint8_t raw_bpm;
+} HealthHeartRateSample;
+
+//! Developer-supplied handler for batches of heart rate readings.
+//! @param samples The readings since the previous batch, oldest first. Only valid during the
+//! call.
+//! @param num_samples The number of readings in `samples`
+//! @param context The context pointer passed to \ref health_service_set_heart_rate_batch_handler()
+typedef void (*HealthHeartRateBatchHandler)(const HealthHeartRateSample *samples,
+                                            uint16_t num_samples, void *context);
+
+//! Have heart rate readings delivered in batches instead of one \ref HealthEventHeartRateUpdate
+//! event per reading. The system collects the readings in its own memory and calls the handler
+//! once every `batch_interval_sec` seconds with all of them, or earlier when
+//! \ref HEALTH_HEART_RATE_BATCH_MAX_SAMPLES readings are collected. Combined with
+//! \ref health_service_set_heart_rate_sample_period(), a workout app can record every reading at
+//! a high sample rate while waking up only a few times per minute. While a batch handler is set,
+//! \ref HealthEventHeartRateUpdate is not sent for the readings it delivers.
+//! @note The handler is not called while the app is not running; readings taken meanwhile can be
+//! read with \ref health_service_get_minute_history().
+//! @param batch_interval_sec The maximum number of seconds between two batches. Pass 0 to stop
+//! batching; readings that were collected are delivered first.
+//! @param handler The function to call with each batch
+//! @param context Developer-supplied context pointer passed to the handler
+//! @return `true` on success, `false` if the watch has no heart rate sensor or on failure
+#define health_service_set_heart_rate_batch_handler(batch_interval_sec, handler, context) (false)
+
 //! Register for an alert when a metric crosses a given threshold. When the metric crosses this
 //! threshold (either goes above or below it), a \ref HealthEventMetricRange event will be
 //! generated. To cancel this registration, pass the returned \ref HealthMetricAlert value to
@@ -1065,6 +1573,43 @@ uint32_t
 health_service_get_minute_history(HealthMinuteData *minute_data, uint32_t max_records,
                                            time_t *time_start, time_t *time_end);
 
+//! Fields of \ref HealthMinuteData that can be requested from
+//! \ref health_service_minute_history_iterate(), expressed as a bitmask.
+typedef enum {
+  HealthMinuteFieldSteps = 1 << 0,       //!< `HealthMinuteData.steps`
+  HealthMinuteFieldOrientation = 1 << 1, //!< `HealthMinuteData.orientation`
+  HealthMinuteFieldVMC = 1 << 2,         //!< `HealthMinuteData.vmc`
+  HealthMinuteFieldLight = 1 << 3,       //!< `HealthMinuteData.light`
+  HealthMinuteFieldHeartRate = 1 << 4,   //!< `HealthMinuteData.heart_rate_bpm`
+} HealthMinuteFieldMask;
+
+//! Callback used by \ref health_service_minute_history_iterate().
+//! @param minute_start UTC time of the first second of the minute.
+//! @param minute_data The minute data record. Only the requested fields and `is_invalid` are
+//!     filled in, the other fields are 0. Only valid until the callback returns.
+//! @param context The `context` parameter initially passed
+//!     to \ref health_service_minute_history_iterate().
+//! @return `true` if you are interested in more records, or `false` to stop iterating.
+typedef bool (*HealthMinuteHistoryIteratorCB)(time_t minute_start,
+                                              const HealthMinuteData *minute_data,
+                                              void *context);
+
+//! Iterates over historical minute data records in time order, oldest first. Unlike
+//! \ref health_service_get_minute_history(), the records are streamed from storage in small blocks
+//! and only the requested fields are decoded, so a full day of records can be processed without
+//! allocating an array for them.
+//! @param fields A bitmask of the fields you are interested in.
+//! @param time_start UTC time of the first requested record. If it is somewhere in the middle of a
+//!      minute interval, this function behaves as if the caller passed in the start of that minute.
+//! @param time_end UTC time of the end of the requested range of records.
+//! @param callback Developer-supplied callback that is called for each record.
+//! @param context Developer-supplied context pointer that is passed to the callback.
+//! @return The number of records that were passed to the callback.
+uint32_t health_service_minute_history_iterate(HealthMinuteFieldMask fields, time_t time_start,
+                                               time_t time_end,
+                                               HealthMinuteHistoryIteratorCB callback,
+                                               void *context);
+
 //! Convenience macro to switch between two expressions depending on health support.
 //! On platforms with health support the first expression will be chosen, the second otherwise.
 #define PBL_IF_HEALTH_ELSE(if_true, if_false) (if_false)
@@ -1089,6 +1634,165 @@ MeasurementSystem health_service_get_measurement_system_for_display(HealthMetric
 
 //! @} // group EventService
 
+//! @addtogroup SensorPipeline Sensor Pipeline
+//! \brief Combining accelerometer, compass, health and timer data in the system
+//!
+//! Apps that combine several sensors usually subscribe to each service, keep their own buffers
+//! and merge the readings in every handler, which wakes the app for each batch of each service.
+//! A sensor pipeline describes the processing instead: each stream takes the values of one
+//! source at a given rate and passes them through a list of stages, such as a filter, a window
+//! and an aggregate over the window. The system runs the stages as the values arrive, in place
+//! in its own sample buffers, and calls the app once per `max_latency_ms` with the results of
+//! all streams together.
+//!
+//! For example, a stream of the mean acceleration magnitude per second and a stream of the
+//! heading at the same time:
+//! \code{.c}
+//! static const SensorStage s_per_second[] = {
+//!   { .type = SensorStageWindow, .window_ms = 1000 },
+//!   { .type = SensorStageAggregate, .aggregate = SensorAggregateMean },
+//! };
+//!
+//! SensorPipeline *pipeline = sensor_pipeline_create();
+//! sensor_pipeline_add_stream(pipeline, SensorSourceAccelMagnitude, 25, s_per_second, 2);
+//! sensor_pipeline_add_stream(pipeline, SensorSourceCompassHeading, 5, s_per_second, 2);
+//! sensor_pipeline_start(pipeline, 10000, prv_results_handler, NULL);
+//! \endcode
+//!
+//! Windows with a duration end at the same time in all streams and are aligned to the system
+//! timer, so streams of sources with different rates produce results for the same periods.
+//! A pipeline uses the services it reads from like a subscription would, so an app cannot
+//! subscribe to \ref accel_data_service_subscribe() while it runs a pipeline with an
+//! accelerometer source.
+//! @{
+
+//! The maximum number of streams in a pipeline.
+#define SENSOR_PIPELINE_MAX_STREAMS 8
+//! The maximum number of stages in a stream.
+#define SENSOR_PIPELINE_MAX_STAGES 4
+
+//! The values a stream of a \ref SensorPipeline reads.
+typedef enum {
+  //! The vector magnitude of each accelerometer sample, in milli-Gs
+  SensorSourceAccelMagnitude = 0,
+  //! The X axis of each accelerometer sample, in milli-Gs
+  SensorSourceAccelX,
+  //! The Y axis of each accelerometer sample, in milli-Gs
+  SensorSourceAccelY,
+  //! The Z axis of each accelerometer sample, in milli-Gs
+  SensorSourceAccelZ,
+  //! The tilt-compensated heading, scaled like \ref CompassHeading, see
+  //! \ref compass_orientation_service_subscribe()
+  SensorSourceCompassHeading,
+  //! The heart rate in beats per minute, at the rate set with
+  //! \ref health_service_set_heart_rate_sample_period(); the stream's rate is ignored
+  SensorSourceHeartRate,
+  //! The steps taken since the previous value
+  SensorSourceSteps,
+  //! A 0 at every tick of the stream's rate, for a stream that marks fixed periods among the
+  //! results of sources that produce values rarely, such as \ref SensorSourceSteps
+  SensorSourceTimer,
+} SensorSource;
+
+//! The kinds of stages of a stream.
+typedef enum {
+  //! Filters the values with \ref dsp_biquad_filter(), saturated to 16 bits. The system keeps
+  //! the filter state.
+  SensorStageFilter = 0,
+  //! Drops the values below `threshold`.
+  SensorStageThreshold,
+  //! Collects the values into windows of `window_length` values, or of `window_ms`
+  //! milliseconds if `window_length` is 0. Must be followed by a \ref SensorStageAggregate.
+  SensorStageWindow,
+  //! Reduces each window to one value.
+  SensorStageAggregate,
+} SensorStageType;
+
+//! How a \ref SensorStageAggregate reduces a window.
+typedef enum {
+  SensorAggregateMean = 0, //!< The mean of the values
+  SensorAggregateMin,      //!< The smallest value
+  SensorAggregateMax,      //!< The largest value
+  SensorAggregateSum,      //!< The sum of the values
+  SensorAggregateRms,      //!< The root mean square of the values
+  SensorAggregateCount,    //!< The number of values, for example above a threshold
+  SensorAggregateLast,     //!< The last value
+} SensorAggregate;
+
+//! One stage of a stream. Only the fields of the stage's type are used.
+typedef struct {
+  //! The kind of stage
+  SensorStageType type;
+  //! \ref SensorStageFilter: the filter coefficients. The state field is not used.
+  const DspBiquad *filter;
+  //! \ref SensorStageThreshold: the smallest value that is passed on
+  int32_t threshold;
+  //! \ref SensorStageWindow: the number of values per window, or 0 to use `window_ms`
+  uint16_t window_length;
+  //! \ref SensorStageWindow: the duration of a window in milliseconds
+  uint32_t window_ms;
+  //! \ref SensorStageAggregate: how each window is reduced
+  SensorAggregate aggregate;
+} SensorStage;
+
+//! A value delivered by a pipeline.
+typedef struct {
+  //! The stream, as returned by \ref sensor_pipeline_add_stream()
+  uint8_t stream;
+  //! The value: the aggregate of a window, or a single value of a stream without a window
+  int32_t value;
+  //! The time of the first value the result was computed from, in milliseconds
+  uint64_t timestamp;
+} SensorResult;
+
+//! Callback type for pipeline results
+//! @param results The results of all streams since the previous call, oldest first
+//! @param num_results The number of elements in `results`
+//! @param context The context passed to \ref sensor_pipeline_start()
+typedef void (*SensorPipelineHandler)(const SensorResult *results, uint32_t num_results,
+                                      void *context);
+
+struct SensorPipeline;
+typedef struct SensorPipeline SensorPipeline;
+
+//! Creates an empty sensor pipeline.
+//! @return The pipeline, or NULL if it could not be allocated
+SensorPipeline *sensor_pipeline_create(void);
+
+//! Adds a stream to a pipeline that is not running.
+//! @param pipeline The pipeline
+//! @param source The values the stream reads
+//! @param rate_hz The number of values per second read from the source, between 1 and 100 for
+//! the accelerometer and between 1 and 25 for the other sources
+//! @param stages The stages to pass the values through, in order. Copied during the call.
+//! @param num_stages The number of elements in `stages`, at most \ref SENSOR_PIPELINE_MAX_STAGES
+//! @return The number of the stream, which identifies its results, or -1 if the stages are
+//! invalid, the pipeline is running or already has \ref SENSOR_PIPELINE_MAX_STREAMS streams
+int sensor_pipeline_add_stream(SensorPipeline *pipeline, SensorSource source, uint16_t rate_hz,
+                               const SensorStage *stages, uint8_t num_stages);
+
+//! Starts a pipeline. Results are collected by the system and delivered to the handler together,
+//! so the app is woken up at most once every `max_latency_ms`, unless the results fill the
+//! buffer of the pipeline first.
+//! @param pipeline The pipeline
+//! @param max_latency_ms The longest time a result waits before it is delivered
+//! @param handler The function to call with the results
+//! @param context Pointer to application data that is passed to the handler
+//! @return true if the pipeline was started, false if it has no streams or one of its sources is
+//! in use by a subscription of the app
+bool sensor_pipeline_start(SensorPipeline *pipeline, uint32_t max_latency_ms,
+                           SensorPipelineHandler handler, void *context);
+
+//! Stops a pipeline. Results that were not delivered yet are delivered first.
+//! @param pipeline The pipeline
+void sensor_pipeline_stop(SensorPipeline *pipeline);
+
+//! Stops a pipeline if it is running and frees it.
+//! @param pipeline The pipeline
+void sensor_pipeline_destroy(SensorPipeline *pipeline);
+
+//! @} // group SensorPipeline
+
 //! @addtogroup DataLogging
 //! \brief Enables logging data asynchronously to a mobile app
 //!
@@ -1109,6 +1813,10 @@ MeasurementSystem health_service_get_measurement_system_for_display(HealthMetric
 //! If a phone is available, the data is sent directly to the phone. Otherwise, it is saved to the
 //! watch storage until the watch is connected to a phone.
 //!
+//! During development, `datalog_download.py` in the SDK downloads the sessions from the watch
+//! over the developer connection instead, which is much faster than the phone application for
+//! large amounts of data, and writes them to CSV or Parquet files.
+//!
 //!
 //! For example:
 //!
@@ -1170,6 +1878,79 @@ typedef enum {
 DataLoggingSessionRef data_logging_create(uint32_t tag, DataLoggingItemType item_type,
                                           uint16_t item_length, bool resume);
 
+//! The encodings that a buffered data logging session can apply to a block of items before it
+//! is committed to storage.
+//! @see data_logging_create_buffered
+typedef enum {
+  //! The items are stored as they are logged.
+  DATA_LOGGING_ENCODING_NONE = 0,
+  //! Each integer item is stored as the difference to the previous item, which makes slowly
+  //! changing values like sensor readings compress well. Only valid for \ref DATA_LOGGING_UINT
+  //! and \ref DATA_LOGGING_INT sessions; byte arrays are stored as they are logged.
+  DATA_LOGGING_ENCODING_DELTA,
+  //! The block is delta encoded where possible and then compressed with an LZ-family compressor.
+  DATA_LOGGING_ENCODING_DELTA_COMPRESSED,
+} DataLoggingEncoding;
+
+//! Create a new buffered data logging session. The items logged to a buffered session are
+//! accumulated in a RAM buffer of `buffer_size` bytes and committed to storage as one encoded
+//! block when the buffer is full, when \ref data_logging_flush() is called, or when the session is
+//! finished. This saves CPU time and flash bandwidth for high rate data, like accelerometer
+//! samples, and the encoding lets more data fit into the data logging storage. The blocks are
+//! decoded transparently before the data is handed to the phone application.
+//! @note Items that have not been committed yet are lost if the app exits without finishing the
+//! session.
+//!
+//! @param tag A tag associated with the logging session.
+//! @param item_type The type of data stored in this logging session
+//! @param item_length The size of a single data item in bytes
+//! @param resume See \ref data_logging_create()
+//! @param buffer_size The size of the RAM buffer in bytes, which is allocated on the app's heap.
+//!   Must be at least `item_length`.
+//! @param encoding The encoding to apply to each block
+//! @return An opaque reference to the data logging session, or NULL if the buffer could not be
+//!   allocated
+DataLoggingSessionRef data_logging_create_buffered(uint32_t tag, DataLoggingItemType item_type,
+                                                   uint16_t item_length, bool resume,
+                                                   uint16_t buffer_size,
+                                                   DataLoggingEncoding encoding);
+
+//! The maximum number of fields in the schema of a data logging session.
+#define DATA_LOGGING_MAX_FIELDS 16
+
+//! Describes one field of the records logged to a schema session.
+//! @see data_logging_create_with_schema
+typedef struct {
+  //! The name of the field, which is passed on to the phone application. Copied during
+  //! \ref data_logging_create_with_schema().
+  const char *name;
+  //! The type of the field
+  DataLoggingItemType type;
+  //! The size of the field in bytes. Must be 1, 2 or 4 for integer fields.
+  uint16_t length;
+} DataLoggingField;
+
+//! Create a new buffered data logging session whose items are records with multiple typed fields.
+//! Each item passed to \ref data_logging_log() is one record with its fields packed in schema order,
+//! without padding. The session buffers items like \ref data_logging_create_buffered(), but
+//! stores each block column by column, so every column is encoded on its own where the encoding
+//! allows it. The phone application receives the schema with the session and can read the
+//! columns directly instead of parsing opaque byte arrays.
+//!
+//! @param tag A tag associated with the logging session.
+//! @param fields The fields of a record
+//! @param num_fields The number of elements in `fields`, at most \ref DATA_LOGGING_MAX_FIELDS
+//! @param resume See \ref data_logging_create(). A session is only resumed if its schema matches.
+//! @param buffer_size See \ref data_logging_create_buffered()
+//! @param encoding The encoding to apply to each column of a block
+//! @return An opaque reference to the data logging session, or NULL if the parameters were invalid
+//!   or the buffer could not be allocated
+DataLoggingSessionRef data_logging_create_with_schema(uint32_t tag,
+                                                      const DataLoggingField *fields,
+                                                      uint8_t num_fields, bool resume,
+                                                      uint16_t buffer_size,
+                                                      DataLoggingEncoding encoding);
+
 //! Finish up a data logging_session. Logging data is kept until it has successfully been
 //! transferred over to the phone, but no data may be added to the session after this function is
 //! called.
@@ -1203,6 +1984,55 @@ void data_logging_finish(DataLoggingSessionRef logging_session);
 DataLoggingResult data_logging_log(DataLoggingSessionRef logging_session, const void *data,
                                    uint32_t num_items);
 
+//! Commit the items that have been accumulated in the RAM buffer of a buffered data logging
+//! session to storage. For sessions that are not buffered, this is a no-op.
+//!
+//! @param logging_session a reference to the data logging session to flush
+//! @return DATA_LOGGING_SUCCESS on success, DATA_LOGGING_FULL if there is no more space to save the
+//!   block, or DATA_LOGGING_NOT_FOUND if the logging session is invalid
+DataLoggingResult data_logging_flush(DataLoggingSessionRef logging_session);
+
+//! Storage usage of a data logging session and of data logging as a whole.
+//! @see data_logging_get_stats
+typedef struct {
+  //! The number of bytes of the session that have not been transferred to the phone yet,
+  //! including items in the RAM buffer of a buffered session.
+  uint32_t session_bytes_pending;
+  //! The number of bytes of data logging storage used by the app's sessions.
+  uint32_t app_bytes_used;
+  //! The number of bytes of data logging storage that the app can use before
+  //! \ref DATA_LOGGING_FULL is returned.
+  uint32_t app_bytes_available;
+  //! The estimated number of seconds until the pending data of the session has been transferred,
+  //! or 0 if no phone is connected.
+  uint32_t estimated_flush_time_s;
+} DataLoggingStats;
+
+//! Get the storage usage of a data logging session.
+//!
+//! @param logging_session a reference to the data logging session
+//! @param[out] stats The storage usage
+//! @return DATA_LOGGING_SUCCESS on success, DATA_LOGGING_NOT_FOUND if the logging session is
+//!   invalid or DATA_LOGGING_INVALID_PARAMS if stats is NULL
+DataLoggingResult data_logging_get_stats(DataLoggingSessionRef logging_session,
+                                         DataLoggingStats *stats);
+
+//! Function signature of the handler that is called when the data logging storage usage of the
+//! app crosses the threshold set with \ref data_logging_set_usage_handler().
+//! @param usage_percent The share of the storage available to the app that is used, in percent
+//! @param context Pointer to application data as passed to
+//!   \ref data_logging_set_usage_handler()
+typedef void (*DataLoggingUsageHandler)(uint8_t usage_percent, void *context);
+
+//! Set a handler that is called when the data logging storage usage of the app rises above or
+//! falls below a threshold, so the app can reduce the amount of data it logs before data is lost.
+//! @param threshold_percent The threshold, as a share of the storage available to the app in
+//!   percent
+//! @param handler The handler to call, or NULL to remove the handler
+//! @param context Pointer to application data that is passed to the handler
+void data_logging_set_usage_handler(uint8_t threshold_percent, DataLoggingUsageHandler handler,
+                                    void *context);
+
 //! @} // group DataLogging
 
 //! @addtogroup DataStructures
@@ -1576,6 +2406,18 @@ DictionaryResult dict_write_int16(DictionaryIterator *iter, const uint32_t key,
 
 DictionaryResult dict_write_int32(DictionaryIterator *iter, const uint32_t key, const int32_t value);
 
+//! Adds an array of 32-bit integers to the dictionary as a single tuple, packed little endian in
+//! a byte array value. This takes one tuple header instead of one per element, so it is the wire
+//! format of array message keys such as `"values[10]"` in package.json, which get a single key.
+//! @param iter The dictionary iterator
+//! @param key The key
+//! @param values The integers to add
+//! @param count The number of integers in `values`
+//! @return \ref DICT_OK, \ref DICT_NOT_ENOUGH_STORAGE or \ref DICT_INVALID_ARGS
+//! @see dict_read_int32_array
+DictionaryResult dict_write_int32_array(DictionaryIterator *iter, const uint32_t key,
+                                        const int32_t *values, const uint16_t count);
+
 //! End a series of writing operations to a dictionary.
 //! This must be called before reading back from the dictionary.
 //! @param iter The dictionary iterator
@@ -1738,6 +2580,8 @@ typedef void (*DictionaryKeyUpdatedCallback)(const uint32_t key, const Tuple *ne
 //! @param key_callback The callback that will be called for each Tuple in the merged destination dictionary.
 //! @param context Pointer to app specific data that will get passed in when `update_key_callback` is called.
 //! @return \ref DICT_OK, \ref DICT_INVALID_ARGS, \ref DICT_NOT_ENOUGH_STORAGE
+//! @note The keys of `dest` are looked up through a temporary \ref DictionaryIndex when there is
+//! enough heap memory for it, so merging large dictionaries does not take quadratic time.
 DictionaryResult dict_merge(DictionaryIterator *dest, uint32_t *dest_max_size_in_out,
                              DictionaryIterator *source,
                              const bool update_existing_keys_only,
@@ -1749,6 +2593,93 @@ DictionaryResult dict_merge(DictionaryIterator *dest, uint32_t *dest_max_size_in
 //! @return Pointer to a found Tuple, or NULL if there was no Tuple with the specified key.
 Tuple *dict_find(const DictionaryIterator *iter, const uint32_t key);
 
+//! The number of slots to provide to \ref dict_index_init() for a dictionary with the given
+//! number of tuples. Half of the slots stay empty, which keeps lookups short.
+#define DICT_INDEX_NUM_SLOTS(tuple_count) ((uint16_t)((tuple_count) * 2))
+
+//! A hash index over the tuples of a dictionary, see \ref dict_index_init().
+typedef struct {
+  const DictionaryIterator *iter; //!< The dictionary that is indexed
+  uint16_t *slots; //!< The storage of the index, provided by the app
+  uint16_t num_slots; //!< The number of slots in `slots`
+} DictionaryIndex;
+
+//! Builds a hash index over a dictionary, so that \ref dict_index_find() can find tuples in
+//! constant time instead of scanning the dictionary like \ref dict_find() does. Build the index
+//! once, after \ref dict_read_begin_from_buffer() or \ref dict_write_end(); it needs to be built
+//! again after the dictionary has been modified.
+//! @param index The index to build
+//! @param iter Iterator to the dictionary to index. Must remain valid while the index is used.
+//! @param slots The storage of the index
+//! @param num_slots The number of slots in `slots`, see \ref DICT_INDEX_NUM_SLOTS()
+//! @return \ref DICT_OK, \ref DICT_INVALID_ARGS or \ref DICT_NOT_ENOUGH_STORAGE if the
+//! dictionary holds more tuples than `num_slots`
+DictionaryResult dict_index_init(DictionaryIndex *index, const DictionaryIterator *iter,
+                                 uint16_t *slots, uint16_t num_slots);
+
+//! Tries to find a Tuple with specified key using an index built with \ref dict_index_init().
+//! @param index The index of the dictionary to search in.
+//! @param key The key for which to find a Tuple
+//! @return Pointer to a found Tuple, or NULL if there was no Tuple with the specified key.
+Tuple *dict_index_find(const DictionaryIndex *index, const uint32_t key);
+
+//! Fills a table with the tuples of a dictionary whose keys are small, contiguous integers, so each
+//! tuple can then be found by indexing the table with its key. The message keys the SDK generates
+//! from the `messageKeys` in package.json are numbered from 0 in order, and `MESSAGE_KEY_COUNT` is
+//! the size of the table they need:
+//! \code{.c}
+//! const Tuple *tuples[MESSAGE_KEY_COUNT];
+//! dict_index_dense(iter, tuples, MESSAGE_KEY_COUNT, 0);
+//! const Tuple *temperature = tuples[MESSAGE_KEY_temperature];
+//! \endcode
+//! Unlike \ref dict_index_init(), no hashing is involved. Entries of keys that are not in the
+//! dictionary are set to NULL, and tuples whose key is outside of the table are ignored.
+//! @param iter Iterator to the dictionary to index
+//! @param table The table to fill, `num_keys` entries
+//! @param num_keys The number of entries in `table`
+//! @param first_key The key of the first entry in `table`
+//! @return The number of tuples stored in the table
+uint16_t dict_index_dense(const DictionaryIterator *iter, const Tuple **table, uint16_t num_keys,
+                          uint32_t first_key);
+
+//! Reads an array of 32-bit integers written with \ref dict_write_int32_array(). The tuple's data
+//! does not need to be aligned.
+//! @param tuple A tuple holding a packed integer array
+//! @param[out] values The buffer to read the integers into
+//! @param max_count The number of integers `values` can hold
+//! @return The number of integers read, 0 if the tuple is not a byte array
+uint16_t dict_read_int32_array(const Tuple *tuple, int32_t *values, uint16_t max_count);
+
+//! Encodes a dictionary into the compact wire format. In the compact format, keys are stored as
+//! variable length deltas to the previous key, integers are zigzag encoded and stored in as few
+//! bytes as their value needs, and the type and length of each value share a single byte where
+//! possible. A message of small integer values with ascending keys typically shrinks to a
+//! third of its size.
+//! @note Tuples are accessed in place, so dictionaries are always read and written in the regular
+//! format described by \ref dict_calc_buffer_size(). The compact format is meant for
+//! transport and storage.
+//! @param iter Iterator to the dictionary to encode
+//! @param buffer The buffer to write the compact encoding into
+//! @param [in,out] size_in_out In: the size of `buffer`. Out: the size of the compact encoding.
+//! @return \ref DICT_OK, \ref DICT_INVALID_ARGS or \ref DICT_NOT_ENOUGH_STORAGE
+//! @see dict_decode_compact
+DictionaryResult dict_encode_compact(const DictionaryIterator *iter, uint8_t *buffer,
+                                     uint32_t *size_in_out);
+
+//! Decodes a dictionary from the compact wire format, see \ref dict_encode_compact(), and
+//! prepares the iterator for reading the decoded dictionary, like
+//! \ref dict_read_begin_from_buffer() does.
+//! @param iter The dictionary iterator
+//! @param compact The compact encoding
+//! @param compact_size The size of the compact encoding in bytes
+//! @param buffer The storage for the decoded dictionary
+//! @param [in,out] size_in_out In: the size of `buffer`. Out: the size of the decoded dictionary.
+//! @return \ref DICT_OK, \ref DICT_INVALID_ARGS, \ref DICT_NOT_ENOUGH_STORAGE or
+//! \ref DICT_INTERNAL_INCONSISTENCY if the encoding could not be parsed
+DictionaryResult dict_decode_compact(DictionaryIterator *iter, const uint8_t *compact,
+                                     uint32_t compact_size, uint8_t *buffer,
+                                     uint32_t *size_in_out);
+
 //! @} // group Dictionary
 
 //! @addtogroup Worker
@@ -1761,6 +2692,32 @@ void worker_event_loop(void);
 //! Launch the foreground app for this worker
 void worker_launch_app(void);
 
+//! The type of function which is called at the start of each scheduled worker wake.
+//! @param context The data passed to \ref worker_set_wake_budget()
+typedef void (*WorkerWakeHandler)(void *context);
+
+//! Puts the worker on a duty cycle: it is woken up once every `period_ms` milliseconds and may
+//! run for up to `budget_ms` milliseconds before it is put back to sleep. While the worker
+//! sleeps, data for its accelerometer data service and health event subscriptions is buffered
+//! by the system and delivered in batches at the next wake, instead of waking the worker for
+//! each update. Timers registered by the worker still fire on time but are delivered within
+//! the next wake when possible.
+//! @param period_ms The interval between wakes in milliseconds
+//! @param budget_ms The maximum run time per wake in milliseconds
+//! @param handler The callback to execute at the start of each wake, or NULL
+//! @param context The data that will be passed to handler
+//! @return true if the budget was applied, false if the period or budget is out of range
+bool worker_set_wake_budget(uint32_t period_ms, uint32_t budget_ms, WorkerWakeHandler handler,
+                            void *context);
+
+//! Takes the worker off its duty cycle, so that events are delivered as soon as they occur.
+void worker_clear_wake_budget(void);
+
+//! Gets the remaining run time of the current wake. The worker should finish its work and
+//! return to the event loop before this reaches zero.
+//! @return The remaining run time in milliseconds, or UINT32_MAX if no wake budget is set
+uint32_t worker_get_wake_budget_remaining(void);
+
 //! @} // group Worker
 
 //! @addtogroup AppWorker
@@ -1824,10 +2781,112 @@ bool app_worker_message_unsubscribe(void);
 //! @param data the message data structure
 void app_worker_send_message(uint8_t type, AppWorkerMessage *data);
 
+//! The largest ring buffer that can be shared between an app and its worker, in bytes.
+#define APP_WORKER_RING_BUFFER_SIZE_MAXIMUM 4096
+
+struct AppWorkerRingBuffer;
+typedef struct AppWorkerRingBuffer AppWorkerRingBuffer;
+
+//! Callback type for ring buffer data notifications.
+//! @param ring_buffer The ring buffer that received data
+//! @param bytes_available The number of bytes that can currently be read from the ring buffer
+//! @param context The context passed to \ref app_worker_ring_buffer_open()
+typedef void (*AppWorkerRingBufferDataHandler)(AppWorkerRingBuffer *ring_buffer,
+                                               uint32_t bytes_available, void *context);
+
+//! Opens the ring buffer shared between the app and its worker, creating it if the other task
+//! has not opened it yet. The buffer lives in memory reserved by the system outside of the app
+//! and worker heaps, and stays valid while at least one of the two tasks has it open.
+//! The buffer is single-producer, single-consumer: one task writes and the other reads, without
+//! locking. This makes it suitable for streaming sensor batches from a worker to the foreground
+//! app without going through persistent storage.
+//! @param size The size of the buffer in bytes, up to \ref APP_WORKER_RING_BUFFER_SIZE_MAXIMUM.
+//! Ignored if the other task already created the buffer.
+//! @param handler The callback to be executed when the other task writes to the buffer while
+//! it was empty, or NULL for no notifications
+//! @param context The data that will be passed to handler
+//! @return A pointer to the ring buffer, or NULL if it could not be created
+AppWorkerRingBuffer *app_worker_ring_buffer_open(uint32_t size,
+                                                 AppWorkerRingBufferDataHandler handler,
+                                                 void *context);
+
+//! Closes the ring buffer for the calling task. The handle may no longer be used afterwards.
+//! @param ring_buffer The ring buffer to close
+void app_worker_ring_buffer_close(AppWorkerRingBuffer *ring_buffer);
+
+//! Writes data to the ring buffer. Only as many bytes as there is free space are written;
+//! data that is not read yet is never overwritten.
+//! @param ring_buffer The ring buffer to write to
+//! @param data The data to write
+//! @param length The number of bytes to write
+//! @return The number of bytes actually written
+uint32_t app_worker_ring_buffer_write(AppWorkerRingBuffer *ring_buffer, const void *data,
+                                      uint32_t length);
+
+//! Reads and consumes data from the ring buffer.
+//! @param ring_buffer The ring buffer to read from
+//! @param buffer The buffer to copy the data into
+//! @param length The maximum number of bytes to read
+//! @return The number of bytes actually read
+uint32_t app_worker_ring_buffer_read(AppWorkerRingBuffer *ring_buffer, void *buffer,
+                                     uint32_t length);
+
+//! Gets the number of bytes that can currently be read from the ring buffer.
+//! @param ring_buffer The ring buffer to query
+//! @return The number of bytes available to read
+uint32_t app_worker_ring_buffer_get_bytes_available(AppWorkerRingBuffer *ring_buffer);
+
+//! The largest value that can be stored in the area shared between an app and its worker, in
+//! bytes.
+#define APP_WORKER_SHARED_VALUE_MAX_LENGTH 64
+
+//! The total size of all values in the area shared between an app and its worker, in bytes.
+#define APP_WORKER_SHARED_SIZE_MAXIMUM 1024
+
+//! Writes a value to the key-value area shared between the app and its worker. The area lives
+//! in memory reserved by the system, so either task reads the latest values the other one wrote
+//! without accessing flash, for example the worker's daily aggregates for the app's UI. The
+//! values are saved to flash once both tasks have exited, and are loaded again when either one
+//! next reads or writes the area. The keys are separate from those of persistent storage.
+//! @param key The key of the value
+//! @param data The value, or NULL to delete the key
+//! @param size The size of the value in bytes, up to \ref APP_WORKER_SHARED_VALUE_MAX_LENGTH,
+//! or 0 to delete the key
+//! @return true on success, false if the value is too large or the area is full
+bool app_worker_shared_write(uint32_t key, const void *data, size_t size);
+
+//! Reads a value from the key-value area shared between the app and its worker.
+//! @param key The key of the value
+//! @param buffer The buffer to copy the value into
+//! @param buffer_size The size of the buffer in bytes
+//! @return The number of bytes copied into the buffer, or 0 if the key has no value
+int app_worker_shared_read(uint32_t key, void *buffer, size_t buffer_size);
+
+//! Callback type for changes to the area shared between an app and its worker.
+//! @param key The key whose value the other task wrote or deleted
+//! @param context The context passed to \ref app_worker_shared_subscribe()
+typedef void (*AppWorkerSharedChangedHandler)(uint32_t key, void *context);
+
+//! Subscribe to changes the other task makes to the area shared between the app and its worker.
+//! Writes of the calling task do not call the handler. Several writes of the same key before the
+//! handler runs call it once.
+//! @param handler A callback to be executed when the other task writes or deletes a value
+//! @param context The data that will be passed to handler
+//! @return true on success
+bool app_worker_shared_subscribe(AppWorkerSharedChangedHandler handler, void *context);
+
+//! Unsubscribe from changes to the area shared between the app and its worker.
+void app_worker_shared_unsubscribe(void);
+
 //! @} // group AppWorker
 
 //! @addtogroup Timer
 //!   \brief Can be used to execute some code at some point in the future.
+//!
+//! Timers are kept in a timer wheel, so registering, rescheduling and cancelling a timer takes
+//! constant time regardless of how many timers the app has running. Timers registered with a
+//! slack (see \ref app_timer_register_with_slack()) may be fired together with other timers
+//! whose deadlines fall within the slack, so that the system wakes up once for all of them.
 //! @{
 
 //! Waits for a certain amount of milliseconds
@@ -1858,6 +2917,19 @@ bool app_timer_reschedule(AppTimer *timer_handle, uint32_t new_timeout_ms);
 //! Once cancelled the handle may no longer be used for any purpose.
 void app_timer_cancel(AppTimer *timer_handle);
 
+//! Registers a timer like \ref app_timer_register(), but allows the system to fire it up to
+//! `slack_ms` milliseconds late. Timers whose deadlines fall within each other's slack are
+//! coalesced into a single wakeup, which saves power when an app runs many timers that do not
+//! need to be exact, such as display refreshes or polling.
+//! @param timeout_ms The expiry time in milliseconds from the current time
+//! @param slack_ms The maximum number of milliseconds the timer may fire after its expiry time
+//! @param callback The callback that gets called at expiry time
+//! @param callback_data The data that will be passed to callback
+//! @return A pointer to an `AppTimer` that can be used to later reschedule or cancel this timer
+//! @note Rescheduling the timer with \ref app_timer_reschedule() keeps its slack.
+AppTimer* app_timer_register_with_slack(uint32_t timeout_ms, uint32_t slack_ms,
+                                        AppTimerCallback callback, void* callback_data);
+
 //! @} // group Timer
 
 //! @addtogroup MemoryManagement Memory Management
@@ -1873,6 +2945,187 @@ size_t heap_bytes_free(void);
 //! @return The number of bytes on the heap currently being used.
 size_t heap_bytes_used(void);
 
+//! Number of buckets in \ref HeapStats.free_block_histogram
+#define HEAP_STATS_HISTOGRAM_BUCKETS 8
+
+//! Detailed statistics about the application's heap
+//! @see \ref heap_get_stats
+typedef struct {
+  //! The number of bytes on the heap not currently being used, see \ref heap_bytes_free
+  size_t bytes_free;
+  //! The number of bytes on the heap currently being used, see \ref heap_bytes_used
+  size_t bytes_used;
+  //! The size of the largest contiguous free block, which is the largest allocation that can
+  //! currently succeed
+  size_t largest_free_block;
+  //! The largest value of `bytes_used` since the application started
+  size_t high_water_mark;
+  //! The number of free blocks. Many free blocks with a small `largest_free_block` indicate
+  //! fragmentation.
+  uint16_t num_free_blocks;
+  //! Number of free blocks by size: bucket `i` counts the blocks of at least `16 << i` bytes and
+  //! less than `16 << (i + 1)` bytes, with the first bucket also counting smaller blocks and the
+  //! last bucket also counting larger blocks.
+  uint16_t free_block_histogram[HEAP_STATS_HISTOGRAM_BUCKETS];
+} HeapStats;
+
+//! Collects detailed statistics about the application's heap, including its fragmentation.
+//! @note This walks the whole heap and is considerably slower than \ref heap_bytes_free.
+//! @param[out] stats The statistics of the heap
+void heap_get_stats(HeapStats *stats);
+
+//! Enables or disables tracking of allocations by call site. While enabled, every allocation is
+//! tagged with the return address of its caller, so that \ref heap_log_allocations can report
+//! which code owns how much memory.
+//! @note Tracking uses a small amount of heap memory per call site and should only be enabled
+//! while debugging.
+//! @param enabled true to start tracking allocations, false to stop and discard the data
+void heap_set_allocation_tracking(bool enabled);
+
+//! Writes the number of live allocations and bytes per tracked call site, together with the
+//! statistics of \ref heap_get_stats, to the app log. Call site addresses can be resolved to
+//! source lines with `arm-none-eabi-addr2line` on the app's ELF file.
+void heap_log_allocations(void);
+
+//! Sets a threshold for `bytes_used` above which a new high water mark is written to the app log
+//! every time it is exceeded.
+//! @param threshold_bytes The threshold in bytes, 0 to disable logging
+void heap_set_high_water_mark_logging(size_t threshold_bytes);
+
+//! Levels of memory pressure on the heap of the application.
+//! @see memory_pressure_subscribe
+typedef enum {
+  //! The heap has more free memory than the low threshold again.
+  MemoryPressureLevelNormal = 0,
+  //! The free memory on the heap dropped below the low threshold. Release what is cheap to
+  //! recreate, such as prefetched data or decoded bitmaps that are not shown.
+  MemoryPressureLevelLow,
+  //! The free memory on the heap dropped below the critical threshold, or an allocation is about
+  //! to fail. Release everything that can be recreated later.
+  MemoryPressureLevelCritical,
+} MemoryPressureLevel;
+
+//! Callback type for memory pressure events
+//! @param level The new level of memory pressure
+//! @param context The context passed to \ref memory_pressure_subscribe
+typedef void (*MemoryPressureHandler)(MemoryPressureLevel level, void *context);
+
+//! Subscribe to memory pressure events, so that an app holding caches can release them before an
+//! allocation fails. The handler is called from the event loop when the free memory on the heap
+//! crosses one of the thresholds, in either direction. In addition, when an allocation cannot be
+//! satisfied, the handler is called with \ref MemoryPressureLevelCritical right away, before
+//! `malloc` returns, and the allocation is tried again once after it returns. The handler must
+//! therefore not allocate memory itself. The caches of the system are trimmed at the critical level
+//! before the handler is called.
+//! @param low_threshold_bytes The free heap in bytes below which \ref MemoryPressureLevelLow is
+//! reported
+//! @param critical_threshold_bytes The free heap in bytes below which
+//! \ref MemoryPressureLevelCritical is reported, at most `low_threshold_bytes`
+//! @param handler A callback to be executed on memory pressure events
+//! @param context A pointer passed to the handler
+//! @return true on success, false if the thresholds are invalid
+bool memory_pressure_subscribe(size_t low_threshold_bytes, size_t critical_threshold_bytes,
+                               MemoryPressureHandler handler, void *context);
+
+//! Unsubscribe from memory pressure events. Once unsubscribed, the previously registered handler
+//! will no longer be called.
+void memory_pressure_unsubscribe(void);
+
+//! Statistics about the stack of the calling task
+//! @see \ref stack_get_stats
+typedef struct {
+  //! The size of the stack in bytes
+  size_t size;
+  //! The number of bytes of the stack currently in use
+  size_t bytes_used;
+  //! The largest number of bytes of the stack that were in use since the task started
+  size_t high_water_mark;
+} StackStats;
+
+//! Collects statistics about the stack of the calling task, which is the app or the worker. The
+//! stack is filled with a known pattern when the task is launched, and the high water mark is
+//! found by scanning for the deepest byte that no longer holds the pattern. Compare it to the
+//! size after exercising the deepest code paths, such as recursive layouts or large local
+//! buffers, to learn how much headroom is left.
+//! @note Scanning takes time proportional to the unused part of the stack, so do not call this
+//! on every frame.
+//! @param[out] stats The statistics of the stack
+void stack_get_stats(StackStats *stats);
+
+//! Writes the statistics of \ref stack_get_stats to the log when the task exits, as a line of the
+//! form `stack: size <bytes> high water mark <bytes>`, which `pebble logs` shows for the app and
+//! its worker.
+//! @param enabled true to log the statistics at exit, false to stop (default)
+void stack_set_exit_logging(bool enabled);
+
+struct ArenaAllocator;
+typedef struct ArenaAllocator ArenaAllocator;
+
+//! Creates an arena on the heap. An arena hands out memory from a single block with no per
+//! allocation overhead, and all of it is released at once with \ref arena_allocator_reset or
+//! \ref arena_allocator_destroy. Use it for objects that share a lifetime, like everything that
+//! belongs to one window.
+//! @param size The number of bytes the arena can hand out
+//! @return A pointer to the arena, `NULL` if it could not be created
+ArenaAllocator *arena_allocator_create(size_t size);
+
+//! Destroys an arena and frees its memory, including all allocations made from it.
+//! @param arena The arena to destroy
+void arena_allocator_destroy(ArenaAllocator *arena);
+
+//! Allocates memory from an arena. The memory is aligned to 4 bytes and cannot be freed
+//! individually.
+//! @param arena The arena to allocate from
+//! @param size The number of bytes to allocate
+//! @return A pointer to the memory, `NULL` if the arena does not have enough space left
+void *arena_allocator_alloc(ArenaAllocator *arena, size_t size);
+
+//! Releases all allocations made from an arena at once, so that its full size can be used again.
+//! @param arena The arena to reset
+void arena_allocator_reset(ArenaAllocator *arena);
+
+//! Calculates the number of bytes that can still be allocated from an arena.
+//! @param arena The arena to query
+//! @return The number of bytes left in the arena
+size_t arena_allocator_bytes_free(const ArenaAllocator *arena);
+
+//! Makes an arena the target of all subsequent allocations of the calling code, including the
+//! memory allocated by system constructors, until \ref arena_allocator_pop is called.
+//! Calls to `free` and the matching `_destroy` functions for such objects do not release any
+//! memory; it is reclaimed when the arena is reset or destroyed. Calls can be nested.
+//! @note Objects allocated from an arena must not be used after the arena is reset.
+//! @param arena The arena to allocate from
+void arena_allocator_push(ArenaAllocator *arena);
+
+//! Restores the allocation target that was active before the matching
+//! \ref arena_allocator_push call.
+void arena_allocator_pop(void);
+
+struct PoolAllocator;
+typedef struct PoolAllocator PoolAllocator;
+
+//! Creates a pool of fixed size blocks on the heap. Allocating and freeing blocks from a pool
+//! takes constant time and does not fragment the heap, which makes it well suited for many small
+//! objects of the same type.
+//! @param block_size The size of each block in bytes
+//! @param num_blocks The number of blocks in the pool
+//! @return A pointer to the pool, `NULL` if it could not be created
+PoolAllocator *pool_allocator_create(size_t block_size, uint16_t num_blocks);
+
+//! Destroys a pool and frees its memory, including all blocks allocated from it.
+//! @param pool The pool to destroy
+void pool_allocator_destroy(PoolAllocator *pool);
+
+//! Allocates a block from a pool. The memory is aligned to 4 bytes.
+//! @param pool The pool to allocate from
+//! @return A pointer to the block, `NULL` if all blocks of the pool are in use
+void *pool_allocator_alloc(PoolAllocator *pool);
+
+//! Returns a block to the pool it was allocated from.
+//! @param pool The pool that the block was allocated from
+//! @param block The block to free
+void pool_allocator_free(PoolAllocator *pool, void *block);
+
 //! Flushes the data cache and invalidates the instruction cache for the given region of memory,
 //! if necessary. This is only required when your app is loading or modifying code in memory and
 //! intends to execute it. On some platforms, code executed may be cached internally to improve
@@ -1905,6 +3158,11 @@ size_t heap_bytes_used(void);
 //! In addition, it draws less power from the battery.
 //!
 //! Note that the size of all persisted values cannot exceed 4K per app.
+//!
+//! Recently read values are kept in a small in-RAM cache, so reading the same key repeatedly does
+//! not access flash every time. To restore many values at startup, use \ref persist_read_many() or
+//! \ref persist_iterate(), which read all requested keys in one pass. State that changes every
+//! few seconds is better saved as records of an append-only log, see \ref persist_log_open().
 //! @{
 
 //! The maximum size of a persist value in bytes
@@ -1913,6 +3171,10 @@ size_t heap_bytes_used(void);
 //! The maximum size of a persist string in bytes including the NULL terminator
 #define PERSIST_STRING_MAX_LENGTH PERSIST_DATA_MAX_LENGTH
 
+//! The maximum size of a persist value in bytes before compression, for values written while
+//! compression is enabled, see \ref persist_set_compression()
+#define PERSIST_COMPRESSED_DATA_MAX_LENGTH 1024
+
 //! Status codes. See \ref status_t
 typedef enum StatusCode {
   //! Operation completed successfully.
@@ -1982,6 +3244,14 @@ bool persist_exists(const uint32_t key);
 //! if there is no field matching the given key.
 int persist_get_size(const uint32_t key);
 
+//! Gets the number of bytes a value takes in persistent storage, which is its compressed size if
+//! it was written with compression enabled, see \ref persist_set_compression(). These are the
+//! bytes that count towards the storage limit of the app.
+//! @param key The key of the field to lookup the stored size.
+//! @return The stored size of the value in bytes or \ref E_DOES_NOT_EXIST
+//! if there is no field matching the given key.
+int persist_get_stored_size(const uint32_t key);
+
 //! Reads a bool value for a given key from persistent storage.
 //! If the value has not yet been set, this will return false.
 //! @param key The key of the field to read from.
@@ -2014,6 +3284,43 @@ int persist_read_data(const uint32_t key, void *buffer, const size_t buffer_size
 //! if there is no field matching the given key.
 int persist_read_string(const uint32_t key, char *buffer, const size_t buffer_size);
 
+//! Callback type for \ref persist_iterate().
+//! @param key The key of the field
+//! @param data The value of the field. Only valid until the callback returns.
+//! @param size The size of the value in bytes
+//! @param context Pointer to application data as passed to \ref persist_iterate()
+//! @return true to continue iterating, false to stop
+typedef bool (*PersistIteratorCallback)(const uint32_t key, const void *data, const size_t size,
+                                        void *context);
+
+//! Calls a callback for every key of the app in persistent storage, reading all of them in one
+//! pass over flash. Keys are passed in no particular order.
+//! @param callback The callback to call for each key
+//! @param context Pointer to application data that is passed to the callback
+//! @return \ref S_SUCCESS if all keys were passed, \ref S_NO_MORE_ITEMS if the callback stopped the
+//! iteration, or a value from \ref StatusCode otherwise.
+status_t persist_iterate(PersistIteratorCallback callback, void *context);
+
+//! Describes one value to read with \ref persist_read_many().
+typedef struct {
+  //! The key of the field to read from.
+  uint32_t key;
+  //! The pointer to a buffer to be written to.
+  void *buffer;
+  //! The maximum size of the given buffer.
+  size_t buffer_size;
+  //! Out: the number of bytes written into the buffer or \ref E_DOES_NOT_EXIST if there is no field
+  //! matching the key, as \ref persist_read_data() would return.
+  int result;
+} PersistReadRequest;
+
+//! Reads the values of many keys from persistent storage in one pass over flash, instead of looking
+//! up each key separately.
+//! @param requests The values to read. The `.result` field of each request is set.
+//! @param num_requests The number of elements in `requests`
+//! @return \ref S_SUCCESS if the requests were processed, or a value from \ref StatusCode otherwise.
+status_t persist_read_many(PersistReadRequest *requests, const size_t num_requests);
+
 //! Writes a bool value flag for a given key into persistent storage.
 //! @param key The key of the field to write to.
 //! @param value The boolean value to write.
@@ -2028,7 +3335,8 @@ status_t persist_write_bool(const uint32_t key, const bool value);
 status_t persist_write_int(const uint32_t key, const int32_t value);
 
 //! Writes a blob of data of a specified size in bytes for a given key into persistent storage.
-//! The maximum size is \ref PERSIST_DATA_MAX_LENGTH
+//! The maximum size is \ref PERSIST_DATA_MAX_LENGTH, or \ref PERSIST_COMPRESSED_DATA_MAX_LENGTH
+//! while compression is enabled, see \ref persist_set_compression().
 //! @param key The key of the field to write to.
 //! @param data The pointer to the blob of data.
 //! @param size The size in bytes.
@@ -2046,6 +3354,158 @@ int persist_write_string(const uint32_t key, const char *cstring);
 //! @param key The key of the field to delete from.
 status_t persist_delete(const uint32_t key);
 
+//! Sets whether values are compressed when they are written to persistent storage. While
+//! compression is enabled, \ref persist_write_data(), \ref persist_write_string() and persist
+//! blobs store values LZ4 compressed if that makes them smaller, which typically halves the
+//! size of cached text. Values are decompressed by the read functions transparently, and
+//! \ref persist_get_size() keeps returning their uncompressed size, so code that reads values
+//! does not change. Writing fewer bytes also makes writes faster.
+//! @note Values written while compression is enabled may be up to
+//! \ref PERSIST_COMPRESSED_DATA_MAX_LENGTH bytes long, as long as they compress to at most
+//! \ref PERSIST_DATA_MAX_LENGTH bytes; otherwise \ref E_RANGE is returned. Integers and bools are
+//! never compressed. Compressed values can be read whether or not compression is enabled, so it
+//! can be turned on in an update of an app without migrating its existing values.
+//! @param enabled true to compress values written from now on, false to store them as they are
+//! (default)
+void persist_set_compression(const bool enabled);
+
+struct PersistBlob;
+typedef struct PersistBlob PersistBlob;
+
+//! Values that are used to indicate how a persist blob is opened.
+//! @see persist_blob_open
+typedef enum {
+  //! Open the existing value of the key for reading.
+  PersistBlobModeRead = 0,
+  //! Create a new value for the key, replacing the existing value when the blob is closed.
+  PersistBlobModeWrite,
+} PersistBlobMode;
+
+//! Opens the value of a key in persistent storage as a blob, for reading or writing values that
+//! are larger than \ref PERSIST_DATA_MAX_LENGTH in multiple steps. A blob that was opened for
+//! writing is committed with a single flash operation when it is closed, so cached data like
+//! forecasts does not have to be sharded across many keys.
+//! @note Blobs count towards the total size of all persisted values of the app.
+//! \ref persist_get_size() returns the size of a blob, and \ref persist_read_data() reads its first
+//! `buffer_size` bytes.
+//! @note Only one blob can be open for writing at a time.
+//! @param key The key of the field to open.
+//! @param mode Whether to open the blob for reading or writing
+//! @return A handle to the blob, or NULL if the key does not exist (when reading), another blob
+//! is already open for writing, or there is not enough memory.
+PersistBlob *persist_blob_open(const uint32_t key, const PersistBlobMode mode);
+
+//! Reads the next bytes of a blob that was opened with \ref PersistBlobModeRead.
+//! @param blob The blob to read from.
+//! @param buffer The pointer to a buffer to be written to.
+//! @param buffer_size The maximum number of bytes to read.
+//! @return The number of bytes written into the buffer, which is 0 at the end of the blob, or a
+//! value from \ref StatusCode otherwise.
+int persist_blob_read(PersistBlob *blob, void *buffer, const size_t buffer_size);
+
+//! Appends bytes to a blob that was opened with \ref PersistBlobModeWrite. The data is not visible
+//! to readers of the key until the blob is closed.
+//! @param blob The blob to write to.
+//! @param data The pointer to the data to append.
+//! @param size The size in bytes.
+//! @return The number of bytes written if successful, a value from \ref StatusCode otherwise,
+//! such as \ref E_OUT_OF_STORAGE.
+int persist_blob_write(PersistBlob *blob, const void *data, const size_t size);
+
+//! Closes a blob. If the blob was opened for writing, the written data replaces the value of the
+//! key atomically.
+//! @param blob The blob to close.
+//! @return \ref S_SUCCESS if successful, a value from \ref StatusCode otherwise.
+status_t persist_blob_close(PersistBlob *blob);
+
+//! Begins a transaction of persistent storage writes. Until \ref persist_transaction_commit() is
+//! called, the writes and deletes of the app are collected in memory instead of being written to
+//! flash one at a time. Reads during the transaction return the values that have been written in
+//! it. Saving many values on exit is faster this way and causes less flash wear.
+//! @note If the app exits before the transaction is committed, the transaction is discarded.
+//! Transactions cannot be nested.
+//! @return \ref S_SUCCESS if successful, or \ref E_INVALID_OPERATION if a transaction is already
+//! in progress.
+status_t persist_transaction_begin(void);
+
+//! Commits the current transaction of persistent storage writes with a single journaled flash
+//! operation. Either all writes of the transaction become visible or, if the watch resets during
+//! the commit, none of them do.
+//! @return \ref S_SUCCESS if successful, or a value from \ref StatusCode otherwise, such as
+//! \ref E_OUT_OF_STORAGE, in which case none of the writes are applied.
+status_t persist_transaction_commit(void);
+
+//! Discards the current transaction of persistent storage writes, without applying any of them.
+void persist_transaction_abort(void);
+
+struct PersistLog;
+typedef struct PersistLog PersistLog;
+
+//! Opens an append-only log in persistent storage, creating it if the key does not exist yet.
+//! Logs suit data that is saved often and read rarely, such as a journal of step counts or the
+//! moves of a game for a replay: appending a record only programs the bytes of that record
+//! instead of rewriting a whole value like \ref persist_write_data() does, and the log's pages
+//! are used in turn, so that saving every few seconds spreads the flash wear evenly. Records
+//! are numbered by a sequence number that starts at 0 and increases with each append.
+//! When the log is full, appending drops the oldest records to make room.
+//! @note Logs count towards the total size of all persisted values of the app with their
+//! capacity. The key of a log cannot be used with the other persist functions, except
+//! \ref persist_exists() and \ref persist_delete(), which deletes the whole log.
+//! @param key The key of the log
+//! @param capacity The number of bytes to keep records in, rounded up to a multiple of 256. Each
+//! record takes 4 bytes more than its data. Ignored if the log already exists.
+//! @return A handle to the log, or NULL if the key holds another kind of value, or there is not
+//! enough storage or memory.
+PersistLog *persist_log_open(const uint32_t key, const size_t capacity);
+
+//! Appends a record to a log. The record is on flash when the function returns, so it survives
+//! the app being killed or the watch resetting.
+//! @param log The log to append to
+//! @param data The data of the record
+//! @param size The size of the data, at most \ref PERSIST_DATA_MAX_LENGTH bytes
+//! @return \ref S_SUCCESS if successful, or a value from \ref StatusCode otherwise, such as
+//! \ref E_RANGE if `size` is too large.
+status_t persist_log_append(PersistLog *log, const void *data, const size_t size);
+
+//! Callback type for \ref persist_log_iterate().
+//! @param sequence The sequence number of the record
+//! @param data The data of the record, only valid during the callback
+//! @param size The size of the data
+//! @param context Pointer to application data as passed to \ref persist_log_iterate()
+//! @return true to read the next record, false to stop
+typedef bool (*PersistLogIteratorCallback)(uint32_t sequence, const void *data, size_t size,
+                                           void *context);
+
+//! Reads the records of a log in the order they were appended.
+//! @param log The log to read
+//! @param first_sequence The sequence number to start at. Older records are skipped, which
+//! makes it cheap to resume reading where an earlier iteration stopped.
+//! @param callback Called for each record
+//! @param context Pointer to application data that is passed to the callback
+//! @return \ref S_SUCCESS if all records were read or the callback stopped the iteration, or a
+//! value from \ref StatusCode otherwise.
+status_t persist_log_iterate(PersistLog *log, const uint32_t first_sequence,
+                             PersistLogIteratorCallback callback, void *context);
+
+//! Discards the records of a log up to and including a sequence number, for example once they
+//! have been uploaded to the phone. Discarding only marks the records; their flash pages are
+//! erased and reused by the next compaction.
+//! @param log The log to trim
+//! @param last_sequence The sequence number of the last record to discard
+//! @return \ref S_SUCCESS if successful, or a value from \ref StatusCode otherwise.
+status_t persist_log_trim(PersistLog *log, const uint32_t last_sequence);
+
+//! Compacts a log now, erasing the pages that only hold discarded records. The system compacts
+//! logs by itself while the watch is idle, so this only needs to be called before appending a
+//! burst of records that should not drop the oldest ones.
+//! @param log The log to compact
+//! @return \ref S_SUCCESS if successful, or a value from \ref StatusCode otherwise.
+status_t persist_log_compact(PersistLog *log);
+
+//! Closes a log. Records that were appended stay in storage.
+//! @param log The log to close
+void persist_log_close(PersistLog *log);
+
 //! @} // group Storage
 
 //! @} // group Foundation
@@ -2053,6 +3513,77 @@ status_t persist_delete(const uint32_t key);
 //! @addtogroup Profiling
 //! @{
 
+//! Returns the value of a free-running counter that is incremented with every CPU clock cycle.
+//! Use the difference between two values to measure code that runs much shorter than the
+//! resolution of \ref time_ms. The counter wraps around, so always compute differences with
+//! unsigned arithmetic.
+//! On platforms without a hardware cycle counter, the value is derived from the system tick timer
+//! and has a lower resolution.
+//! @return The current cycle count
+//! @see \ref profiler_cycles_per_second
+uint32_t profiler_cycles(void);
+
+//! Returns the frequency at which \ref profiler_cycles increments, which is the CPU clock
+//! frequency on platforms with a hardware cycle counter.
+//! @return The number of cycles per second
+uint32_t profiler_cycles_per_second(void);
+
+//! Aggregated timing of a code section measured with \ref PROFILE_SCOPE. All fields are
+//! maintained by the system and should be treated as read-only.
+typedef struct ProfilerNode {
+  //! Label of the measured code section
+  const char *name;
+  //! Cycle count at the start of the current measurement
+  uint32_t start_cycles;
+  //! Number of completed measurements
+  uint32_t count;
+  //! Sum of the cycles of all measurements
+  uint64_t total_cycles;
+  //! Fewest cycles of a single measurement
+  uint32_t min_cycles;
+  //! Most cycles of a single measurement
+  uint32_t max_cycles;
+  //! Next registered node, for internal use
+  struct ProfilerNode *next;
+} ProfilerNode;
+
+//! Starts a measurement for a node. The node is registered on first use, and the minimum,
+//! average and maximum of all registered nodes are written to the app log when the app exits.
+//! @param node The node to start measuring, usually with static storage duration
+//! @return The node that was passed in
+ProfilerNode *profiler_node_start(ProfilerNode *node);
+
+//! Stops the current measurement of a node and adds it to the node's statistics.
+//! @param node The node to stop measuring
+void profiler_node_stop(ProfilerNode *node);
+
+//! Cleanup handler used by \ref PROFILE_SCOPE. Equivalent to calling \ref profiler_node_stop.
+//! @param node Pointer to the node to stop measuring
+void profiler_node_stop_scope(ProfilerNode **node);
+
+//! Writes the statistics of all registered nodes to the app log immediately, one line per node
+//! of the form `profile <name>: count <n> min <cycles> avg <cycles> max <cycles>`.
+void profiler_print_stats(void);
+
+#define PROFILER_CONCAT_(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_(a, b)
+#define PROFILE_SCOPE_(label, id) \
+  static ProfilerNode PROFILER_CONCAT(s_profiler_node_, id) = { .name = (label) }; \
+  ProfilerNode *PROFILER_CONCAT(profiler_scope_, id) \
+      __attribute__((cleanup(profiler_node_stop_scope), unused)) = \
+      profiler_node_start(&PROFILER_CONCAT(s_profiler_node_, id))
+
+//! Measures the time from this statement to the end of the enclosing block, aggregating the
+//! results of all executions under the given label. For example:
+//! \code{.c}
+//! static void prv_draw_hands(Layer *layer, GContext *ctx) {
+//!   PROFILE_SCOPE("draw_hands");
+//!   ...
+//! }
+//! \endcode
+//! @param label String literal identifying the measured code section
+#define PROFILE_SCOPE(label) PROFILE_SCOPE_(label, __COUNTER__)
+
 //! @} // group Profiling
 
 //! @addtogroup StandardC Standard C
@@ -2164,5 +3695,101 @@ time_t time_start_of_today(void);
 
 //! @} // group StandardTime
 
+//! @addtogroup StandardMemory Memory
+//! \brief Standard memory copy, fill and compare functions
+//!
+//! These functions are provided by the firmware rather than linked into each app, and use an
+//! implementation tuned for the watch's Cortex-M core. Once the start of the destination is
+//! word aligned, data is moved with LDM/STM bursts of eight words, with a word-at-a-time loop
+//! for the remainder and byte accesses only for the unaligned head and tail. Copies run at
+//! full speed when the source and destination have the same alignment modulo 4, which is
+//! always the case for rows of a \ref GBitmap with the same format and row size. When the
+//! alignments differ, the source is read a word at a time and shifted into place.
+//!
+//! Clearing a framebuffer or bitmap with \ref memset therefore costs about one cycle per
+//! word, and is considerably faster than setting pixels or bytes in a loop.
+//! The functions behave as documented at https://sourceware.org/newlib/libc.html#Strings
+//! @{
+
+//! Compares the first n bytes of two blocks of memory.
+//! @param s1 The first block of memory
+//! @param s2 The second block of memory
+//! @param n The number of bytes to compare
+//! @return 0 if the blocks are equal, otherwise the difference between the first differing
+//!   bytes, interpreted as unsigned char
+int memcmp(const void *s1, const void *s2, size_t n);
+
+//! Copies n bytes between two blocks of memory, which must not overlap.
+//! @param dest The destination
+//! @param src The source
+//! @param n The number of bytes to copy
+//! @return dest
+void *memcpy(void *dest, const void *src, size_t n);
+
+//! Copies n bytes between two blocks of memory, which may overlap. Non-overlapping copies and
+//! copies to a lower address run as fast as \ref memcpy.
+//! @param dest The destination
+//! @param src The source
+//! @param n The number of bytes to copy
+//! @return dest
+void *memmove(void *dest, const void *src, size_t n);
+
+//! Sets n bytes of a block of memory to a value.
+//! @param s The block of memory
+//! @param c The value, converted to unsigned char
+//! @param n The number of bytes to set
+//! @return s
+void *memset(void *s, int c, size_t n);
+
+//! @} // group StandardMemory
+
+//! @addtogroup StandardFormat Integer Formatting
+//! \brief Small, integer-only replacements for snprintf
+//!
+//! The newlib snprintf linked into apps supports every conversion, including floating point,
+//! and adds several kilobytes of code and a noticeable per-call cost. Apps that only format
+//! integers and strings, such as a watchface drawing the time and step count on every tick, can
+//! use \ref int_snprintf instead. It is implemented in the firmware, so it adds nothing to the
+//! app binary, and it does not take the reentrancy lock that newlib uses.
+//!
+//! To route all calls to snprintf in a source file to \ref int_snprintf, define
+//! `PBL_INT_SNPRINTF` before including pebble.h:
+//! \code{.c}
+//! #define PBL_INT_SNPRINTF
+//! #include <pebble.h>
+//! \endcode
+//! @{
+
+//! Formats a string like snprintf, with support for integer and string conversions only.
+//! The supported conversions are `%d`, `%i`, `%u`, `%x`, `%X`, `%c`, `%s`, `%p` and `%%`, with
+//! the `-`, `0`, `+` and space flags, a field width, a precision, the `l`, `ll`, `h` and `z`
+//! length modifiers and `*` for width and precision. Floating point conversions are not
+//! supported and are written to the output unchanged.
+//! The format string is checked at compile time as for printf, so mismatched arguments produce
+//! a warning.
+//! @param str The buffer to write to, which is always NUL terminated if size is not 0
+//! @param size The size of the buffer in bytes
+//! @param format The format string
+//! @return The number of characters that would have been written if the buffer were large
+//!   enough, not counting the terminating NUL
+int int_snprintf(char *str, size_t size, const char *format, ...)
+    __attribute__((__format__(__printf__, 3, 4)));
+
+//! Writes a signed integer in decimal, without a terminating NUL. This is the fastest way to
+//! format a single number, for example when building a label piece by piece.
+//! @param buffer The buffer to write to
+//! @param size The size of the buffer in bytes
+//! @param value The integer to write
+//! @param min_digits The minimum number of digits, padded with leading zeros, for example 2
+//!   for minutes
+//! @return The number of characters written, or 0 if the buffer is too small
+size_t int_format(char *buffer, size_t size, int32_t value, uint8_t min_digits);
+
+#if defined(PBL_INT_SNPRINTF)
+#define snprintf int_snprintf
+#endif
+
+//! @} // group StandardFormat
+
 //! @} // group StandardC
 
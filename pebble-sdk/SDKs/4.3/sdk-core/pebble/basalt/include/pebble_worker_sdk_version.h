@@ -9,13 +9,25 @@
 #define _PBL_API_EXISTS_sin_lookup
 #define _PBL_API_EXISTS_cos_lookup
 #define _PBL_API_EXISTS_atan2_lookup
+#define _PBL_API_EXISTS_atan2_lookup_k
+#define _PBL_API_EXISTS_integer_sqrt
+#define _PBL_API_EXISTS_integer_hypot
+#define _PBL_API_EXISTS_dsp_fir_filter
+#define _PBL_API_EXISTS_dsp_biquad_filter
+#define _PBL_API_EXISTS_dsp_spectrum
+#define _PBL_API_EXISTS_dsp_find_peaks
 #define _PBL_API_EXISTS_clock_copy_time_string
 #define _PBL_API_EXISTS_clock_is_24h_style
 #define _PBL_API_EXISTS_clock_to_timestamp
 #define _PBL_API_EXISTS_clock_is_timezone_set
 #define _PBL_API_EXISTS_clock_get_timezone
+#define _PBL_API_EXISTS_clock_get_local_time
+#define _PBL_API_EXISTS_time_formatter_create
+#define _PBL_API_EXISTS_time_formatter_format
+#define _PBL_API_EXISTS_time_formatter_destroy
 #define _PBL_API_EXISTS_connection_service_peek_pebble_app_connection
 #define _PBL_API_EXISTS_connection_service_peek_pebblekit_connection
+#define _PBL_API_EXISTS_connection_service_peek_link_quality
 #define _PBL_API_EXISTS_connection_service_subscribe
 #define _PBL_API_EXISTS_connection_service_unsubscribe
 #define _PBL_API_EXISTS_bluetooth_connection_service_peek
@@ -24,6 +36,10 @@
 #define _PBL_API_EXISTS_battery_state_service_subscribe
 #define _PBL_API_EXISTS_battery_state_service_unsubscribe
 #define _PBL_API_EXISTS_battery_state_service_peek
+#define _PBL_API_EXISTS_performance_tier_service_subscribe
+#define _PBL_API_EXISTS_performance_tier_service_unsubscribe
+#define _PBL_API_EXISTS_performance_tier_service_peek
+#define _PBL_API_EXISTS_performance_tier_set_follow
 #define _PBL_API_EXISTS_accel_service_peek
 #define _PBL_API_EXISTS_accel_service_set_sampling_rate
 #define _PBL_API_EXISTS_accel_service_set_samples_per_update
@@ -32,17 +48,25 @@
 #define _PBL_API_EXISTS_accel_tap_service_subscribe
 #define _PBL_API_EXISTS_accel_tap_service_unsubscribe
 #define _PBL_API_EXISTS_accel_raw_data_service_subscribe
+#define _PBL_API_EXISTS_accel_raw_data_service_subscribe_batched
+#define _PBL_API_EXISTS_accel_feature_service_subscribe
+#define _PBL_API_EXISTS_accel_data_service_set_motion_gate
 #define _PBL_API_EXISTS_compass_service_set_heading_filter
 #define _PBL_API_EXISTS_compass_service_subscribe
 #define _PBL_API_EXISTS_compass_service_unsubscribe
 #define _PBL_API_EXISTS_compass_service_peek
+#define _PBL_API_EXISTS_compass_orientation_service_subscribe
+#define _PBL_API_EXISTS_compass_orientation_service_unsubscribe
 #define _PBL_API_EXISTS_tick_timer_service_subscribe
 #define _PBL_API_EXISTS_tick_timer_service_unsubscribe
+#define _PBL_API_EXISTS_tick_timer_service_add_subscription
+#define _PBL_API_EXISTS_tick_timer_service_remove_subscription
 #define _PBL_API_EXISTS_health_service_sum
 #define _PBL_API_EXISTS_health_service_sum_today
 #define _PBL_API_EXISTS_health_service_peek_current_value
 #define _PBL_API_EXISTS_health_service_sum_averaged
 #define _PBL_API_EXISTS_health_service_aggregate_averaged
+#define _PBL_API_EXISTS_health_service_query_many
 #define _PBL_API_EXISTS_health_service_peek_current_activities
 #define _PBL_API_EXISTS_health_service_activities_iterate
 #define _PBL_API_EXISTS_health_service_metric_accessible
@@ -51,15 +75,28 @@
 #define _PBL_API_EXISTS_health_service_any_activity_accessible
 #define _PBL_API_EXISTS_health_service_events_subscribe
 #define _PBL_API_EXISTS_health_service_events_unsubscribe
+#define _PBL_API_EXISTS_health_service_set_event_filter
 #define _PBL_API_EXISTS_health_service_set_heart_rate_sample_period
 #define _PBL_API_EXISTS_health_service_get_heart_rate_sample_period_expiration_sec
+#define _PBL_API_EXISTS_health_service_set_heart_rate_batch_handler
 #define _PBL_API_EXISTS_health_service_register_metric_alert
 #define _PBL_API_EXISTS_health_service_cancel_metric_alert
 #define _PBL_API_EXISTS_health_service_get_minute_history
+#define _PBL_API_EXISTS_health_service_minute_history_iterate
 #define _PBL_API_EXISTS_health_service_get_measurement_system_for_display
+#define _PBL_API_EXISTS_sensor_pipeline_create
+#define _PBL_API_EXISTS_sensor_pipeline_add_stream
+#define _PBL_API_EXISTS_sensor_pipeline_start
+#define _PBL_API_EXISTS_sensor_pipeline_stop
+#define _PBL_API_EXISTS_sensor_pipeline_destroy
 #define _PBL_API_EXISTS_data_logging_create
+#define _PBL_API_EXISTS_data_logging_create_buffered
+#define _PBL_API_EXISTS_data_logging_create_with_schema
 #define _PBL_API_EXISTS_data_logging_finish
 #define _PBL_API_EXISTS_data_logging_log
+#define _PBL_API_EXISTS_data_logging_flush
+#define _PBL_API_EXISTS_data_logging_get_stats
+#define _PBL_API_EXISTS_data_logging_set_usage_handler
 #define _PBL_API_EXISTS_uuid_equal
 #define _PBL_API_EXISTS_uuid_to_string
 #define _PBL_API_EXISTS_app_log
@@ -75,6 +112,7 @@
 #define _PBL_API_EXISTS_dict_write_int8
 #define _PBL_API_EXISTS_dict_write_int16
 #define _PBL_API_EXISTS_dict_write_int32
+#define _PBL_API_EXISTS_dict_write_int32_array
 #define _PBL_API_EXISTS_dict_write_end
 #define _PBL_API_EXISTS_dict_read_begin_from_buffer
 #define _PBL_API_EXISTS_dict_read_next
@@ -86,32 +124,93 @@
 #define _PBL_API_EXISTS_dict_calc_buffer_size_from_tuplets
 #define _PBL_API_EXISTS_dict_merge
 #define _PBL_API_EXISTS_dict_find
+#define _PBL_API_EXISTS_dict_index_init
+#define _PBL_API_EXISTS_dict_index_find
+#define _PBL_API_EXISTS_dict_index_dense
+#define _PBL_API_EXISTS_dict_read_int32_array
+#define _PBL_API_EXISTS_dict_encode_compact
+#define _PBL_API_EXISTS_dict_decode_compact
 #define _PBL_API_EXISTS_worker_event_loop
 #define _PBL_API_EXISTS_worker_launch_app
+#define _PBL_API_EXISTS_worker_set_wake_budget
+#define _PBL_API_EXISTS_worker_clear_wake_budget
+#define _PBL_API_EXISTS_worker_get_wake_budget_remaining
 #define _PBL_API_EXISTS_app_worker_is_running
 #define _PBL_API_EXISTS_app_worker_launch
 #define _PBL_API_EXISTS_app_worker_kill
 #define _PBL_API_EXISTS_app_worker_message_subscribe
 #define _PBL_API_EXISTS_app_worker_message_unsubscribe
 #define _PBL_API_EXISTS_app_worker_send_message
+#define _PBL_API_EXISTS_app_worker_ring_buffer_open
+#define _PBL_API_EXISTS_app_worker_ring_buffer_close
+#define _PBL_API_EXISTS_app_worker_ring_buffer_write
+#define _PBL_API_EXISTS_app_worker_ring_buffer_read
+#define _PBL_API_EXISTS_app_worker_ring_buffer_get_bytes_available
+#define _PBL_API_EXISTS_app_worker_shared_write
+#define _PBL_API_EXISTS_app_worker_shared_read
+#define _PBL_API_EXISTS_app_worker_shared_subscribe
+#define _PBL_API_EXISTS_app_worker_shared_unsubscribe
 #define _PBL_API_EXISTS_psleep
 #define _PBL_API_EXISTS_app_timer_register
 #define _PBL_API_EXISTS_app_timer_reschedule
 #define _PBL_API_EXISTS_app_timer_cancel
+#define _PBL_API_EXISTS_app_timer_register_with_slack
 #define _PBL_API_EXISTS_heap_bytes_free
 #define _PBL_API_EXISTS_heap_bytes_used
+#define _PBL_API_EXISTS_heap_get_stats
+#define _PBL_API_EXISTS_heap_set_allocation_tracking
+#define _PBL_API_EXISTS_heap_log_allocations
+#define _PBL_API_EXISTS_heap_set_high_water_mark_logging
+#define _PBL_API_EXISTS_memory_pressure_subscribe
+#define _PBL_API_EXISTS_memory_pressure_unsubscribe
+#define _PBL_API_EXISTS_stack_get_stats
+#define _PBL_API_EXISTS_stack_set_exit_logging
+#define _PBL_API_EXISTS_arena_allocator_create
+#define _PBL_API_EXISTS_arena_allocator_destroy
+#define _PBL_API_EXISTS_arena_allocator_alloc
+#define _PBL_API_EXISTS_arena_allocator_reset
+#define _PBL_API_EXISTS_arena_allocator_bytes_free
+#define _PBL_API_EXISTS_arena_allocator_push
+#define _PBL_API_EXISTS_arena_allocator_pop
+#define _PBL_API_EXISTS_pool_allocator_create
+#define _PBL_API_EXISTS_pool_allocator_destroy
+#define _PBL_API_EXISTS_pool_allocator_alloc
+#define _PBL_API_EXISTS_pool_allocator_free
 #define _PBL_API_EXISTS_memory_cache_flush
 #define _PBL_API_EXISTS_persist_exists
 #define _PBL_API_EXISTS_persist_get_size
+#define _PBL_API_EXISTS_persist_get_stored_size
 #define _PBL_API_EXISTS_persist_read_bool
 #define _PBL_API_EXISTS_persist_read_int
 #define _PBL_API_EXISTS_persist_read_data
 #define _PBL_API_EXISTS_persist_read_string
+#define _PBL_API_EXISTS_persist_iterate
+#define _PBL_API_EXISTS_persist_read_many
 #define _PBL_API_EXISTS_persist_write_bool
 #define _PBL_API_EXISTS_persist_write_int
 #define _PBL_API_EXISTS_persist_write_data
 #define _PBL_API_EXISTS_persist_write_string
 #define _PBL_API_EXISTS_persist_delete
+#define _PBL_API_EXISTS_persist_set_compression
+#define _PBL_API_EXISTS_persist_blob_open
+#define _PBL_API_EXISTS_persist_blob_read
+#define _PBL_API_EXISTS_persist_blob_write
+#define _PBL_API_EXISTS_persist_blob_close
+#define _PBL_API_EXISTS_persist_transaction_begin
+#define _PBL_API_EXISTS_persist_transaction_commit
+#define _PBL_API_EXISTS_persist_transaction_abort
+#define _PBL_API_EXISTS_persist_log_open
+#define _PBL_API_EXISTS_persist_log_append
+#define _PBL_API_EXISTS_persist_log_iterate
+#define _PBL_API_EXISTS_persist_log_trim
+#define _PBL_API_EXISTS_persist_log_compact
+#define _PBL_API_EXISTS_persist_log_close
+#define _PBL_API_EXISTS_profiler_cycles
+#define _PBL_API_EXISTS_profiler_cycles_per_second
+#define _PBL_API_EXISTS_profiler_node_start
+#define _PBL_API_EXISTS_profiler_node_stop
+#define _PBL_API_EXISTS_profiler_node_stop_scope
+#define _PBL_API_EXISTS_profiler_print_stats
 #define _PBL_API_EXISTS_strftime
 #define _PBL_API_EXISTS_localtime
 #define _PBL_API_EXISTS_gmtime
@@ -120,6 +219,8 @@
 #define _PBL_API_EXISTS_difftime
 #define _PBL_API_EXISTS_time_ms
 #define _PBL_API_EXISTS_time_start_of_today
+#define _PBL_API_EXISTS_int_snprintf
+#define _PBL_API_EXISTS_int_format
 
 //! @addtogroup Misc
 //! @{
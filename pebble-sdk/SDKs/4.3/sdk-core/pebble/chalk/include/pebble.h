@@ -191,6 +191,33 @@ typedef enum {
 //! And thus, two calls to i18n_get_system_locale may return different values.
 const char *i18n_get_system_locale(void);
 
+struct StringTable;
+typedef struct StringTable StringTable;
+
+//! Opens a compiled string table resource (a resource of type `strings`) for a locale. A string
+//! table contains a section per locale, each mapping numeric string IDs to strings through a
+//! hash index, so that looking up a string takes constant time. Only the index of the selected
+//! section is loaded when the table is opened; strings are read from the resource the first
+//! time they are looked up.
+//! @param resource_id The resource ID of the string table
+//! @param locale The ISO locale name of the section to use, or NULL to use the locale returned by
+//! \ref i18n_get_system_locale(). If there is no section for the locale, the section for its
+//! language (e.g. "fr" for "fr_CA") is used, and then the table's default section.
+//! @return A pointer to the string table, or NULL if the resource is not a valid string table or
+//! there was not enough memory
+StringTable *string_table_create_with_resource(uint32_t resource_id, const char *locale);
+
+//! Looks up a string in a string table.
+//! @param table The string table to look up the string in
+//! @param string_id The ID of the string
+//! @return A pointer to the null-terminated string, or NULL if the table does not contain the ID.
+//! The string stays valid until the string table is destroyed.
+const char *string_table_get(StringTable *table, uint32_t string_id);
+
+//! Destroys a string table and frees the strings that were loaded from it.
+//! @param table The string table to destroy
+void string_table_destroy(StringTable *table);
+
 //! @} // group Internationalization
 
 //! @addtogroup WatchInfo
@@ -320,8 +347,155 @@ int32_t cos_lookup(int32_t angle);
 //! The angle value is scaled linearly, such that a value of 0x10000 corresponds to 360 degrees or 2 PI radians.
 int32_t atan2_lookup(int16_t y, int16_t x);
 
+#if defined(PBL_FIXED_POINT) && !defined(__cplusplus)
+#include <arm_fixed.h>
+
+//! Look-up the sine of the given angle as an `accum`, for C code written with the fixed-point
+//! types of `<stdfix.h>`. The result is between -1.0k and 1.0k, within one step of the exact
+//! value, so `mulik(radius, sin_lookup_k(angle))` replaces
+//! `radius * sin_lookup(angle) / TRIG_MAX_RATIO`.
+//! The `_k` look-ups are only declared when `PBL_FIXED_POINT` is defined before including
+//! pebble.h. pebble.h then includes `<arm_fixed.h>`, which provides mulk(), mulik() and the other
+//! routines that multiply and divide fixed-point values without calling into the much slower
+//! generic ones in libgcc. `<stdfix.h>`, which it includes in turn, defines `fract`, `accum` and
+//! `sat` as macros, so code that uses those names or the names of the routines for anything else
+//! cannot opt in.
+//! \code{.c}
+//! #define PBL_FIXED_POINT
+//! #include <pebble.h>
+//! \endcode
+//! @param angle The angle for which to compute the sine, scaled like the angle of \ref sin_lookup
+#define sin_lookup_k(angle) kbits((sin_lookup(angle) + 1) >> 1)
+
+//! Look-up the cosine of the given angle as an `accum`, like \ref sin_lookup_k.
+//! @param angle The angle for which to compute the cosine, scaled like the angle of
+//! \ref sin_lookup
+#define cos_lookup_k(angle) kbits((cos_lookup(angle) + 1) >> 1)
+
+//! Look-up the arctangent of a given x, y pair of `accum` values. Unlike \ref atan2_lookup, the
+//! components do not have to fit into an int16_t, and small components keep their precision.
+//! The angle value is scaled linearly, such that a value of 0x10000 corresponds to 360 degrees or
+//! 2 PI radians.
+//! Both components are shifted right by the same number of bits until they fit the arguments of
+//! \ref atan2_lookup, which keeps their ratio.
+static inline int32_t atan2_lookup_k(accum y, accum x) {
+  int32_t y_bits = bitsk(y);
+  int32_t x_bits = bitsk(x);
+  while (y_bits != (int16_t)y_bits || x_bits != (int16_t)x_bits) {
+    y_bits >>= 1;
+    x_bits >>= 1;
+  }
+  return atan2_lookup((int16_t)y_bits, (int16_t)x_bits);
+}
+#endif
+
+//! Linearly interpolates between two values using a ratio in the same fixed point representation
+//! as the results of \ref sin_lookup and \ref cos_lookup.
+//! @param from The value for a ratio of 0
+//! @param to The value for a ratio of \ref TRIG_MAX_RATIO
+//! @param ratio The interpolation ratio, between 0 and \ref TRIG_MAX_RATIO
+#define INTERPOLATE_BY_RATIO(from, to, ratio) \
+  ((int32_t)((from) + (((int64_t)(to) - (from)) * (ratio)) / TRIG_MAX_RATIO))
+
+//! Computes the integer square root of a value, rounded down.
+//! @param value The value of which to compute the square root
+//! @return The largest integer whose square is less than or equal to `value`
+uint32_t integer_sqrt(uint32_t value);
+
+//! Computes the length of the vector (x, y), rounded to the nearest integer, without the risk of
+//! overflowing intermediate results.
+//! @param x The horizontal component of the vector
+//! @param y The vertical component of the vector
+//! @return The length of the vector
+uint32_t integer_hypot(int32_t x, int32_t y);
+
 //! @} // group Math
 
+//! @addtogroup SignalProcessing Signal Processing
+//! \brief Fixed-point digital signal processing kernels
+//!
+//! Optimized kernels for filtering and analyzing sampled signals, such as accelerometer readings.
+//! Samples are 16-bit signed integers and coefficients are Q15 fixed-point values, where
+//! \ref DSP_Q15_ONE represents 1.0. The kernels use the DSP instructions of the processor where it
+//! has them. The same kernels can be attached to the accelerometer service, see
+//! \ref accel_feature_service_subscribe().
+//! @{
+
+//! The Q15 fixed-point representation of 1.0 (approximately).
+#define DSP_Q15_ONE ((int16_t) 0x7fff)
+
+//! A finite impulse response filter.
+//! @see dsp_fir_filter
+typedef struct {
+  //! The Q15 filter coefficients, `num_taps` elements.
+  const int16_t *coefficients;
+  //! State of the filter, `num_taps` elements. Zero it before the first use.
+  int16_t *state;
+  //! The number of filter taps.
+  uint16_t num_taps;
+} DspFirFilter;
+
+//! A second-order infinite impulse response filter section (biquad), in direct form I.
+//! Coefficients are Q14 fixed-point values, so that values between -2.0 and 2.0 can be
+//! represented. The feedback coefficients `a1` and `a2` are stored with their signs inverted.
+//! @see dsp_biquad_filter
+typedef struct {
+  int16_t b0; //!< Feed-forward coefficient of the current input
+  int16_t b1; //!< Feed-forward coefficient of the previous input
+  int16_t b2; //!< Feed-forward coefficient of the input before the previous one
+  int16_t a1; //!< Negated feedback coefficient of the previous output
+  int16_t a2; //!< Negated feedback coefficient of the output before the previous one
+  int16_t state[4]; //!< State of the filter. Zero it before the first use.
+} DspBiquad;
+
+//! Window functions to apply before a spectrum is computed.
+//! @see dsp_spectrum
+typedef enum {
+  DspWindowRectangular = 0, //!< No window
+  DspWindowHann,            //!< Hann window
+  DspWindowHamming,         //!< Hamming window
+} DspWindow;
+
+//! Filters samples with a finite impulse response filter.
+//! @param filter The filter. Its state is updated, so consecutive calls filter a continuous signal.
+//! @param input The input samples
+//! @param[out] output The filtered samples. May be the same buffer as `input`.
+//! @param num_samples The number of samples in `input` and `output`
+void dsp_fir_filter(DspFirFilter *filter, const int16_t *input, int16_t *output,
+                    uint32_t num_samples);
+
+//! Filters samples with a biquad filter section.
+//! @param filter The filter. Its state is updated, so consecutive calls filter a continuous signal.
+//! @param input The input samples
+//! @param[out] output The filtered samples. May be the same buffer as `input`.
+//! @param num_samples The number of samples in `input` and `output`
+void dsp_biquad_filter(DspBiquad *filter, const int16_t *input, int16_t *output,
+                       uint32_t num_samples);
+
+//! Computes the magnitude spectrum of a block of samples with a fixed-point FFT.
+//! @param input The input samples, `1 << log2_num_samples` elements
+//! @param[out] magnitudes The magnitude of each frequency bin from 0 up to half the sampling rate,
+//! `(1 << log2_num_samples) / 2` elements
+//! @param log2_num_samples The base 2 logarithm of the number of samples, between 4 and 9
+//! (16 to 512 samples)
+//! @param window The window function to apply to the samples first
+void dsp_spectrum(const int16_t *input, uint16_t *magnitudes, uint8_t log2_num_samples,
+                  DspWindow window);
+
+//! Finds the local maxima of a signal.
+//! @param input The input samples
+//! @param num_samples The number of samples in `input`
+//! @param threshold Maxima below this value are ignored
+//! @param min_distance The minimum distance in samples between two peaks. Of two peaks that are
+//! closer together, only the higher one is reported.
+//! @param[out] peak_indices The indices of the peaks that were found, in ascending order
+//! @param max_peaks The number of elements in `peak_indices`
+//! @return The number of peaks that were written to `peak_indices`
+uint32_t dsp_find_peaks(const int16_t *input, uint32_t num_samples, int16_t threshold,
+                        uint16_t min_distance, uint32_t *peak_indices, uint32_t max_peaks);
+
+//! @} // group SignalProcessing
+
 //! @addtogroup WallTime Wall Time
 //!   \brief Functions, data structures and other things related to wall clock time.
 //!
@@ -379,6 +553,38 @@ bool clock_is_timezone_set(void);
 //! @note timezone buffer should be at least TIMEZONE_NAME_LENGTH bytes
 void clock_get_timezone(char *timezone, const size_t buffer_size);
 
+//! Gets the current time broken down and adjusted for the local timezone, like
+//! `localtime(&(time_t){ time(NULL) })`. The result is computed at most once per second and shared
+//! with the `tick_time` passed to \ref TickHandler, so calling this from every tick is cheap.
+//! @return A pointer to the broken-down local time of the current second. It is overwritten when
+//! the second changes and must not be modified.
+const struct tm *clock_get_local_time(void);
+
+struct TimeFormatter;
+typedef struct TimeFormatter TimeFormatter;
+
+//! Creates a formatter for a `strftime` format string. The format string is parsed once when the
+//! formatter is created, and each call to \ref time_formatter_format() only re-renders the fields
+//! whose time components changed since the previous call. Use this for strings that are updated
+//! on every tick, such as a watchface's time display.
+//! @param format a formatting string, as accepted by `strftime`
+//! @param max_length The maximum length of the formatted string, not including the null byte
+//! @return A pointer to the formatter, or NULL if the format string is invalid or there was not
+//! enough memory
+TimeFormatter *time_formatter_create(const char *format, size_t max_length);
+
+//! Formats a time with a formatter created by \ref time_formatter_create().
+//! @param formatter The formatter to use
+//! @param tm_p A pointer to a struct tm containing a broken out time value
+//! @return A pointer to the formatted, null-terminated string owned by the formatter. It stays
+//! valid until the next call to this function or until the formatter is destroyed, so it can be
+//! passed directly to \ref text_layer_set_text().
+const char *time_formatter_format(TimeFormatter *formatter, const struct tm *tm_p);
+
+//! Destroys a formatter created by \ref time_formatter_create().
+//! @param formatter The formatter to destroy
+void time_formatter_destroy(TimeFormatter *formatter);
+
 //! @} // group WallTime
 
 //! @addtogroup Platform
@@ -457,6 +663,36 @@ bool connection_service_peek_pebble_app_connection(void);
 //! @return true if a PebbleKit companion app is connected, false otherwise
 bool connection_service_peek_pebblekit_connection(void);
 
+//! Estimates of the quality of the Bluetooth link to the phone, see
+//! \ref connection_service_peek_link_quality()
+typedef struct {
+  //! The largest payload in bytes a single Bluetooth packet carries on this link. Messages are
+  //! sent in packets of this size, so AppMessage chunks that are a multiple of it, less the
+  //! dictionary and tuple headers, waste the least airtime.
+  uint16_t mtu;
+  //! The current interval in milliseconds at which the radio wakes up to exchange packets. This
+  //! is the actual interval the link negotiated, which \ref app_comm_set_sniff_interval() only
+  //! influences.
+  uint16_t sniff_interval_ms;
+  //! The average time in milliseconds from sending an AppMessage to receiving its
+  //! acknowledgement, over the recent messages of all apps
+  uint16_t round_trip_ms;
+  //! The received signal strength in dBm, typically between -100 (weak) and -40 (strong)
+  int8_t rssi_dbm;
+  //! The estimated number of bytes per second the link can carry with the current interval and
+  //! signal strength, including retransmissions
+  uint32_t throughput_bytes_per_sec;
+} ConnectionLinkQuality;
+
+//! Gets estimates of the quality of the link to the phone, so that an app can size its
+//! AppMessage chunks or choose the quality of the images it requests from the link it actually
+//! has, instead of from the slowest link it may ever have. The estimates are updated as packets
+//! are exchanged, so they are most accurate while the app is sending. Reading them does not use
+//! the radio.
+//! @param[out] quality The estimates
+//! @return true if the Pebble app is connected and `quality` was filled in, false otherwise
+bool connection_service_peek_link_quality(ConnectionLinkQuality *quality);
+
 //! Subscribe to the connection event service. Once subscribed, the appropriate
 //! handler gets called based on the type of connection event and user provided
 //! handlers
@@ -606,6 +842,60 @@ void battery_state_service_unsubscribe(void);
 //! @return a \ref BatteryChargeState containing the last known data
 BatteryChargeState battery_state_service_peek(void);
 
+//! Performance tiers that the system selects from the battery state, so that apps can scale
+//! their work down as the battery runs low instead of each app choosing its own thresholds.
+//! @see performance_tier_service_subscribe
+typedef enum {
+  //! The watch is charging or the battery is above 40%: do all work.
+  PerformanceTierFull = 0,
+  //! The battery is between 20% and 40%: skip work the user is unlikely to miss, such as
+  //! decorative animations or refreshing data that did not change.
+  PerformanceTierBalanced,
+  //! The battery is below 20%: do only the work needed to show correct information.
+  PerformanceTierSaver,
+} PerformanceTier;
+
+//! System services that can adapt to the performance tier by themselves.
+//! @see performance_tier_set_follow
+typedef enum {
+  //! Lower the frame rate of animations to 20 frames per second in
+  //! \ref PerformanceTierBalanced and 10 in \ref PerformanceTierSaver. Animations keep their
+  //! durations, see \ref animation_get_frame_interval().
+  PerformanceFollowAnimations = 1 << 0,
+  //! Halve the accelerometer sampling rate set with \ref accel_service_set_sampling_rate() in
+  //! each tier below \ref PerformanceTierFull, down to \ref ACCEL_SAMPLING_10HZ.
+  PerformanceFollowAccelSamplingRate = 1 << 1,
+  //! Double the heart rate sample period requested with
+  //! \ref health_service_set_heart_rate_sample_period() in each tier below
+  //! \ref PerformanceTierFull.
+  PerformanceFollowHeartRateSamplePeriod = 1 << 2,
+  //! All of the above
+  PerformanceFollowAll = (1 << 3) - 1,
+} PerformanceFollowMask;
+
+//! Callback type for performance tier change events
+//! @param tier The new performance tier
+typedef void (*PerformanceTierHandler)(PerformanceTier tier);
+
+//! Subscribe to the performance tier event service. Once subscribed, the handler gets called
+//! every time the system selects another tier. The tier does not change back and forth when
+//! the charge level hovers around a threshold.
+//! @param handler A callback to be executed on performance tier change events
+void performance_tier_service_subscribe(PerformanceTierHandler handler);
+
+//! Unsubscribe from the performance tier event service. Once unsubscribed, the previously
+//! registered handler will no longer be called.
+void performance_tier_service_unsubscribe(void);
+
+//! Peek at the current performance tier.
+//! @return The current \ref PerformanceTier
+PerformanceTier performance_tier_service_peek(void);
+
+//! Choose the system services that adapt to the performance tier automatically. By default no
+//! service does, so an app's frame and sampling rates only change when it opts in.
+//! @param mask The services to adapt, see \ref PerformanceFollowMask, or 0 for none
+void performance_tier_set_follow(PerformanceFollowMask mask);
+
 //! @} // group BatteryStateService
 
 //! @addtogroup AccelerometerService
@@ -731,6 +1021,109 @@ void accel_tap_service_unsubscribe(void);
 //! @param samples_per_update the number of samples to buffer, between 0 and 25.
 void accel_raw_data_service_subscribe(uint32_t samples_per_update, AccelRawDataHandler handler);
 
+//! The maximum number of samples that can be buffered between each event of
+//! \ref accel_raw_data_service_subscribe_batched() and \ref accel_feature_service_subscribe().
+//! This is the largest block \ref dsp_spectrum() transforms, so every spectrum size can be used.
+#define ACCEL_BATCH_MAX_SAMPLES_PER_UPDATE 512
+
+//! Subscribe to the accelerometer raw data event service with a deep sample buffer. This works
+//! like \ref accel_raw_data_service_subscribe(), but the samples are collected by the system
+//! into a ring buffer on the app's heap, so that hundreds of samples can be delivered per event.
+//! At high sampling rates this wakes the app far less often, which saves battery and handler
+//! overhead.
+//! @note Cannot use \ref accel_service_peek() when subscribed to accelerometer data events.
+//! @param handler A callback to be executed on accelerometer data events. The samples are spaced
+//! evenly at the sampling rate, starting at `timestamp`.
+//! @param samples_per_update the number of samples to buffer, between 1 and
+//! \ref ACCEL_BATCH_MAX_SAMPLES_PER_UPDATE.
+//! @return 0 on success, or -1 if the buffer could not be allocated.
+int accel_raw_data_service_subscribe_batched(uint32_t samples_per_update,
+                                             AccelRawDataHandler handler);
+
+//! The features that an accelerometer pipeline can deliver.
+//! @see accel_feature_service_subscribe
+typedef enum {
+  //! The vector magnitude of each sample, one value per sample.
+  ACCEL_FEATURE_MAGNITUDE = 0,
+  //! The magnitude spectrum of the vector magnitudes of a batch of samples, see
+  //! \ref dsp_spectrum(). `samples_per_update` must be a power of two from 16 to
+  //! \ref ACCEL_BATCH_MAX_SAMPLES_PER_UPDATE, and half as many values are delivered.
+  ACCEL_FEATURE_SPECTRUM,
+} AccelFeature;
+
+//! Configuration of an accelerometer pipeline.
+//! @see accel_feature_service_subscribe
+typedef struct {
+  //! A filter that is applied to the samples of each axis before the features are computed, or
+  //! NULL. The coefficients are shared between the axes, and each axis keeps its own state.
+  const DspBiquad *filter;
+  //! The feature to compute.
+  AccelFeature feature;
+  //! The window function to apply for \ref ACCEL_FEATURE_SPECTRUM.
+  DspWindow window;
+} AccelPipelineConfig;
+
+//! Callback type for accelerometer feature events
+//! @param features Pointer to the computed feature values. Both magnitudes and spectra are
+//! unsigned.
+//! @param num_features the number of values stored in features.
+//! @param timestamp the timestamp, in ms, of the first sample that the features were computed from.
+typedef void (*AccelFeatureHandler)(const uint16_t *features, uint32_t num_features,
+                                    uint64_t timestamp);
+
+//! Subscribe to the accelerometer feature event service. The samples are processed by the
+//! \ref SignalProcessing kernels in the system before the handler is called, so the handler
+//! receives the features instead of raw samples.
+//! Use \ref accel_data_service_unsubscribe() to unsubscribe.
+//! @note Cannot use \ref accel_service_peek() when subscribed to accelerometer data events.
+//! @param samples_per_update the number of samples to process per event, between 1 and
+//! \ref ACCEL_BATCH_MAX_SAMPLES_PER_UPDATE.
+//! @param config The pipeline configuration. Copied during the call.
+//! @param handler A callback to be executed on accelerometer feature events
+//! @return 0 on success, or -1 if the configuration is invalid or the buffers could not be
+//! allocated.
+int accel_feature_service_subscribe(uint32_t samples_per_update,
+                                    const AccelPipelineConfig *config,
+                                    AccelFeatureHandler handler);
+
+//! Configuration of the motion gate of the accelerometer data services.
+//! @see accel_data_service_set_motion_gate
+typedef struct {
+  //! The change of acceleration in milli-Gs on each axis, indexed by \ref AccelAxisType, that
+  //! counts as motion. Gravity is removed first, so these are independent of how the watch is
+  //! held. 0 ignores the axis.
+  uint16_t threshold_mg[3];
+  //! How long in milliseconds one of the thresholds has to be exceeded before the gate opens.
+  //! Short values catch the start of a wrist raise, longer ones ignore bumps.
+  uint16_t open_duration_ms;
+  //! How long in milliseconds all axes have to stay below their thresholds before the gate
+  //! closes again.
+  uint16_t close_duration_ms;
+} AccelMotionGateConfig;
+
+//! Callback type for motion gate events
+//! @param open true when motion started and samples are delivered again, false when the
+//! watch came to rest and delivery stopped
+typedef void (*AccelMotionGateHandler)(bool open);
+
+//! Gate the accelerometer data services on motion. While the gate is closed, samples are not
+//! delivered to the handlers of \ref accel_data_service_subscribe(),
+//! \ref accel_raw_data_service_subscribe(), \ref accel_raw_data_service_subscribe_batched()
+//! or \ref accel_feature_service_subscribe(), and neither the app nor the main processor is
+//! woken up: the accelerometer watches the thresholds by itself at a low sampling rate and raises
+//! an interrupt when they are exceeded. While the gate is open, samples are delivered at the
+//! configured rate, starting with the samples of the `open_duration_ms` that opened it, so the
+//! start of the motion is not lost. Apps that only look for motion starts, such as wrist raises,
+//! should use this instead of analyzing a continuous stream. The gate starts out closed.
+//! @note \ref accel_tap_service_subscribe() already works this way and is not affected by the
+//! gate.
+//! @param config The thresholds and durations, copied during the call, or NULL to remove the
+//! gate and deliver all samples again
+//! @param handler A callback to be executed when the gate opens or closes, or NULL
+//! @return 0 on success, or -1 if the configuration is invalid
+int accel_data_service_set_motion_gate(const AccelMotionGateConfig *config,
+                                       AccelMotionGateHandler handler);
+
 //! @} // group AccelerometerService
 
 //! @addtogroup CompassService
@@ -821,6 +1214,47 @@ void compass_service_unsubscribe(void);
 //! @return Always returns 0 to indicate success.
 int compass_service_peek(CompassHeadingData *data);
 
+//! Structure containing a single tilt-compensated orientation of the watch.
+typedef struct {
+  //! Angle that increases counter-clockwise from magnetic north, like
+  //! \ref CompassHeadingData.magnetic_heading, but compensated for the tilt of the watch using the
+  //! accelerometer, so it stays valid when the watch is not held level.
+  CompassHeading heading;
+  //! Rotation around the X axis, scaled like \ref CompassHeading. 0 when the watch is level.
+  int32_t pitch;
+  //! Rotation around the Y axis, scaled like \ref CompassHeading. 0 when the watch is level.
+  int32_t roll;
+  //! Indicates the current state of the Compass Service calibration.
+  CompassStatus compass_status;
+  //! timestamp, in milliseconds
+  uint64_t timestamp;
+} CompassOrientationData;
+
+//! Callback type for orientation events
+//! @param data Pointer to the orientation samples, oldest first.
+//! @param num_samples the number of samples stored in data.
+typedef void (*CompassOrientationHandler)(const CompassOrientationData *data,
+                                          uint32_t num_samples);
+
+//! Subscribe to the fused orientation service. The system combines the compass and the
+//! accelerometer readings internally and delivers tilt-compensated orientation samples at the
+//! requested rate, in batches, so the app does not have to run both services at their full rate
+//! to fuse them itself.
+//! @note The fused orientation service uses the accelerometer, but does not conflict with
+//! subscriptions to the \ref AccelerometerService.
+//! @param rate_hz The number of orientation samples per second, between 1 and 25.
+//! @param samples_per_update the number of samples to buffer, between 1 and 25.
+//! @param handler A callback to be executed on orientation events
+//! @return 0 on success, or non-zero if a parameter is invalid.
+//! @see compass_orientation_service_unsubscribe
+int compass_orientation_service_subscribe(uint8_t rate_hz, uint32_t samples_per_update,
+                                          CompassOrientationHandler handler);
+
+//! Unsubscribe from the fused orientation service. Once unsubscribed,
+//! the previously registered handler will no longer be called.
+//! @see compass_orientation_service_subscribe
+void compass_orientation_service_unsubscribe(void);
+
 //! @} // group CompassService
 
 //! @addtogroup TickTimerService
@@ -829,6 +1263,11 @@ int compass_service_peek(CompassHeadingData *data);
 //! The TickTimerService allows your app to be called every time one Time component has changed.
 //! This is extremely important for watchfaces. Your app can choose on which time component
 //! change a tick should occur. Time components are defined by a \ref TimeUnits enum bitmask.
+//!
+//! Besides the single subscription made with \ref tick_timer_service_subscribe(), additional
+//! subscriptions with their own units and handlers can be added with
+//! \ref tick_timer_service_add_subscription(). All subscriptions are driven by one system timer,
+//! so they never drift apart and cause only one wakeup per tick.
 //! @{
 
 //! Time unit flags that can be used to create a bitmask for use in \ref tick_timer_service_subscribe().
@@ -865,8 +1304,97 @@ void tick_timer_service_subscribe(TimeUnits tick_units, TickHandler handler);
 //! handler will no longer be called.
 void tick_timer_service_unsubscribe(void);
 
+struct TickTimerSubscription;
+typedef struct TickTimerSubscription TickTimerSubscription;
+
+//! Adds a subscription to the tick timer event service, in addition to the one made with
+//! \ref tick_timer_service_subscribe(). Each subscription's handler is called on its own
+//! requested unit changes, and handlers whose units changed on the same tick are called one
+//! after another from the same wakeup.
+//! @param tick_units a bitmask of all the units that should trigger the handler
+//! @param handler The callback to be executed on tick events
+//! @return A pointer to the subscription that can be used to remove it, or NULL if there was
+//! not enough memory
+TickTimerSubscription *tick_timer_service_add_subscription(TimeUnits tick_units,
+                                                           TickHandler handler);
+
+//! Callback type for sub-second tick events
+//! @param tick_time the time at which the tick event was triggered
+//! @param milliseconds the milliseconds elapsed within the current second of `tick_time`
+typedef void (*TickSubSecondHandler)(struct tm *tick_time, uint16_t milliseconds);
+
+//! Adds a sub-second subscription to the tick timer event service. The interval is rounded to a
+//! multiple of the display refresh period and ticks are aligned to the display refresh, so a
+//! frame rendered from the handler is shown without extra latency. The ticks fall on the same
+//! system timer as the other subscriptions, so a tick at the start of a second is delivered
+//! together with `SECOND_UNIT` ticks.
+//! @param interval_ms The interval between ticks in milliseconds, less than 1000
+//! @param handler The callback to be executed on tick events
+//! @return A pointer to the subscription that can be used to remove it, or NULL if there was
+//! not enough memory
+TickTimerSubscription *tick_timer_service_add_subsecond_subscription(uint16_t interval_ms,
+                                                                     TickSubSecondHandler handler);
+
+//! Removes a subscription added with \ref tick_timer_service_add_subscription() or
+//! \ref tick_timer_service_add_subsecond_subscription(). Once removed, the handle may no longer
+//! be used for any purpose.
+//! @param subscription The subscription to remove
+void tick_timer_service_remove_subscription(TickTimerSubscription *subscription);
+
 //! @} // group TickTimerService
 
+//! @addtogroup DisplayFrameService
+//!
+//! \brief Get notified when a frame has been pushed to the display
+//!
+//! Animations paced with \ref app_timer_register() drift relative to the display refresh, so
+//! frames are sometimes shown late or skipped. The DisplayFrameService calls its handler right
+//! after each frame that the app rendered has been transferred to the display, with the time
+//! left until the next frame has to be ready. Advance animations from the handler by the time
+//! that actually passed and mark layers dirty there, and use the budget to skip optional work,
+//! such as extra particles, when frames run long.
+//!
+//! The handler is only called for frames the app rendered, so an app that stops marking layers
+//! dirty stops receiving calls and the display can stay idle.
+//! @{
+
+//! Timing of the last frame shown on the display
+typedef struct {
+  //! Number of the frame, counting every frame the app rendered since it was launched
+  uint32_t frame;
+  //! Time the frame finished transferring to the display, in milliseconds since the app was
+  //! launched
+  uint32_t timestamp_ms;
+  //! Milliseconds until the next display refresh. A frame rendered within this budget is shown
+  //! at that refresh without extra latency.
+  uint16_t budget_ms;
+  //! Number of display refreshes since the previous frame that had no new frame ready, because
+  //! rendering took longer than the budget
+  uint16_t missed_refreshes;
+} DisplayFrameInfo;
+
+//! Callback type for display frame events
+//! @param info Timing of the frame that was just shown
+//! @param context The context passed to \ref display_frame_service_subscribe()
+typedef void (*DisplayFrameHandler)(const DisplayFrameInfo *info, void *context);
+
+//! Subscribe to the display frame event service. Once subscribed, the handler gets called after
+//! every frame the app renders has been pushed to the display.
+//! @param handler A callback to be executed on display frame events
+//! @param context A pointer passed to the handler
+void display_frame_service_subscribe(DisplayFrameHandler handler, void *context);
+
+//! Unsubscribe from the display frame event service. Once unsubscribed, the previously
+//! registered handler will no longer be called.
+void display_frame_service_unsubscribe(void);
+
+//! Peek at the timing of the last frame shown on the display, for example to compute the budget
+//! left while rendering.
+//! @return The timing of the last frame. All fields are 0 if no frame has been shown yet.
+DisplayFrameInfo display_frame_service_peek(void);
+
+//! @} // group DisplayFrameService
+
 //! @addtogroup HealthService
 //!
 //! \brief Get access to health information like step count, sleep totals, etc.
@@ -1032,6 +1560,31 @@ HealthValue health_service_aggregate_averaged(HealthMetric metric, time_t time_s
                                               time_t time_end, HealthAggregation aggregation,
                                               HealthServiceTimeScope scope);
 
+//! Describes one query for \ref health_service_query_many().
+typedef struct {
+  //! Which \ref HealthMetric to query.
+  HealthMetric metric;
+  //! UTC time of the start of the query interval.
+  time_t time_start;
+  //! UTC time of the end of the query interval.
+  time_t time_end;
+  //! The aggregation function to perform on the metric.
+  HealthAggregation aggregation;
+  //! \ref HealthServiceTimeScope value describing how the average should be computed.
+  HealthServiceTimeScope scope;
+  //! Out: the result of the query, as \ref health_service_aggregate_averaged() would return it.
+  HealthValue result;
+} HealthServiceQuery;
+
+//! Runs several metric queries in one call. The system maintains hourly and daily aggregates of
+//! each metric as data is recorded, so each query is answered from those buckets, and only the
+//! partial hours at the edges of a query interval are computed from minute data. Queries that
+//! share a time range are answered in the same pass.
+//! @param queries The queries to run. The `.result` field of each query is set.
+//! @param num_queries The number of elements in `queries`
+//! @return The number of queries for which data was available.
+uint32_t health_service_query_many(HealthServiceQuery *queries, uint32_t num_queries);
+
 //! Expresses a set of \ref HealthActivity values as a bitmask.
 typedef uint32_t HealthActivityMask;
 
@@ -1208,6 +1761,21 @@ bool health_service_events_subscribe(HealthEventHandler handler, void *context);
 //! @return `true` on success, `false` on failure.
 bool health_service_events_unsubscribe(void);
 
+//! Set how often events of the given type are delivered to the \ref HealthEventHandler. The
+//! system coalesces events of that type and only delivers one after at least `min_interval_sec`
+//! have passed since the previous one, and only if the relevant metric changed by at least
+//! `min_change` since the previous event. This avoids waking the app for changes that it does not
+//! display, like single steps during a walk.
+//! @note Only \ref HealthEventMovementUpdate, with \ref HealthMetricStepCount as the relevant metric,
+//! and \ref HealthEventHeartRateUpdate, with \ref HealthMetricHeartRateBPM as the relevant metric,
+//! can be filtered. \ref HealthEventSignificantUpdate is always delivered immediately.
+//! @param event The type of event to filter.
+//! @param min_interval_sec The minimum number of seconds between two events of the type, or 0.
+//! @param min_change The minimum change of the relevant metric between two events, or 0.
+//! @return `true` on success, `false` if the event type cannot be filtered.
+bool health_service_set_event_filter(HealthEventType event, uint16_t min_interval_sec,
+                                     HealthValue min_change);
+
 //! Set the desired sampling period for heart rate readings. Normally, the system will sample the
 //! heart rate using a sampling period that is automatically chosen to provide useful information
 //! without undue battery drain (it automatically samples more often during periods of intense
@@ -1237,6 +1805,46 @@ bool health_service_set_heart_rate_sample_period(uint16_t interval_sec);
 //! the app exits, or 0 if there is no active request by this app.
 uint16_t health_service_get_heart_rate_sample_period_expiration_sec(void);
 
+//! The largest number of heart rate samples delivered in one batch, see
+//! \ref health_service_set_heart_rate_batch_handler()
+#define HEALTH_HEART_RATE_BATCH_MAX_SAMPLES 240
+
+//! A heart rate reading delivered by \ref health_service_set_heart_rate_batch_handler()
+typedef struct {
+  //! The time the reading was taken
+  time_t timestamp;
+  //! The filtered heart rate, as \ref HealthMetricHeartRateBPM would report it
+  uint8_t bpm;
+  //! The unfiltered heart rate, as \ref HealthMetricHeartRateRawBPM would report it
+  uint8_t raw_bpm;
+} HealthHeartRateSample;
+
+//! Developer-supplied handler for batches of heart rate readings.
+//! @param samples The readings since the previous batch, oldest first. Only valid during the
+//! call.
+//! @param num_samples The number of readings in `samples`
+//! @param context The context pointer passed to \ref health_service_set_heart_rate_batch_handler()
+typedef void (*HealthHeartRateBatchHandler)(const HealthHeartRateSample *samples,
+                                            uint16_t num_samples, void *context);
+
+//! Have heart rate readings delivered in batches instead of one \ref HealthEventHeartRateUpdate
+//! event per reading. The system collects the readings in its own memory and calls the handler
+//! once every `batch_interval_sec` seconds with all of them, or earlier when
+//! \ref HEALTH_HEART_RATE_BATCH_MAX_SAMPLES readings are collected. Combined with
+//! \ref health_service_set_heart_rate_sample_period(), a workout app can record every reading at
+//! a high sample rate while waking up only a few times per minute. While a batch handler is set,
+//! \ref HealthEventHeartRateUpdate is not sent for the readings it delivers.
+//! @note The handler is not called while the app is not running; readings taken meanwhile can be
+//! read with \ref health_service_get_minute_history().
+//! @param batch_interval_sec The maximum number of seconds between two batches. Pass 0 to stop
+//! batching; readings that were collected are delivered first.
+//! @param handler The function to call with each batch
+//! @param context Developer-supplied context pointer passed to the handler
+//! @return `true` on success, `false` if the watch has no heart rate sensor or on failure
+bool health_service_set_heart_rate_batch_handler(uint16_t batch_interval_sec,
+                                                 HealthHeartRateBatchHandler handler,
+                                                 void *context);
+
 //! Register for an alert when a metric crosses the given threshold. When the metric crosses this
 //! threshold (either goes above or below it), a \ref HealthEventMetricAlert event will be
 //! generated. To cancel this registration, pass the returned \ref HealthMetricAlert value to
@@ -1312,6 +1920,43 @@ typedef struct {
 uint32_t health_service_get_minute_history(HealthMinuteData *minute_data, uint32_t max_records,
                                            time_t *time_start, time_t *time_end);
 
+//! Fields of \ref HealthMinuteData that can be requested from
+//! \ref health_service_minute_history_iterate(), expressed as a bitmask.
+typedef enum {
+  HealthMinuteFieldSteps = 1 << 0,       //!< `HealthMinuteData.steps`
+  HealthMinuteFieldOrientation = 1 << 1, //!< `HealthMinuteData.orientation`
+  HealthMinuteFieldVMC = 1 << 2,         //!< `HealthMinuteData.vmc`
+  HealthMinuteFieldLight = 1 << 3,       //!< `HealthMinuteData.light`
+  HealthMinuteFieldHeartRate = 1 << 4,   //!< `HealthMinuteData.heart_rate_bpm`
+} HealthMinuteFieldMask;
+
+//! Callback used by \ref health_service_minute_history_iterate().
+//! @param minute_start UTC time of the first second of the minute.
+//! @param minute_data The minute data record. Only the requested fields and `is_invalid` are
+//!     filled in, the other fields are 0. Only valid until the callback returns.
+//! @param context The `context` parameter initially passed
+//!     to \ref health_service_minute_history_iterate().
+//! @return `true` if you are interested in more records, or `false` to stop iterating.
+typedef bool (*HealthMinuteHistoryIteratorCB)(time_t minute_start,
+                                              const HealthMinuteData *minute_data,
+                                              void *context);
+
+//! Iterates over historical minute data records in time order, oldest first. Unlike
+//! \ref health_service_get_minute_history(), the records are streamed from storage in small blocks
+//! and only the requested fields are decoded, so a full day of records can be processed without
+//! allocating an array for them.
+//! @param fields A bitmask of the fields you are interested in.
+//! @param time_start UTC time of the first requested record. If it is somewhere in the middle of a
+//!      minute interval, this function behaves as if the caller passed in the start of that minute.
+//! @param time_end UTC time of the end of the requested range of records.
+//! @param callback Developer-supplied callback that is called for each record.
+//! @param context Developer-supplied context pointer that is passed to the callback.
+//! @return The number of records that were passed to the callback.
+uint32_t health_service_minute_history_iterate(HealthMinuteFieldMask fields, time_t time_start,
+                                               time_t time_end,
+                                               HealthMinuteHistoryIteratorCB callback,
+                                               void *context);
+
 //! Convenience macro to switch between two expressions depending on health support.
 //! On platforms with health support the first expression will be chosen, the second otherwise.
 #define PBL_IF_HEALTH_ELSE(if_true, if_false) (if_true)
@@ -1336,6 +1981,165 @@ MeasurementSystem health_service_get_measurement_system_for_display(HealthMetric
 
 //! @} // group EventService
 
+//! @addtogroup SensorPipeline Sensor Pipeline
+//! \brief Combining accelerometer, compass, health and timer data in the system
+//!
+//! Apps that combine several sensors usually subscribe to each service, keep their own buffers
+//! and merge the readings in every handler, which wakes the app for each batch of each service.
+//! A sensor pipeline describes the processing instead: each stream takes the values of one
+//! source at a given rate and passes them through a list of stages, such as a filter, a window
+//! and an aggregate over the window. The system runs the stages as the values arrive, in place
+//! in its own sample buffers, and calls the app once per `max_latency_ms` with the results of
+//! all streams together.
+//!
+//! For example, a stream of the mean acceleration magnitude per second and a stream of the
+//! heading at the same time:
+//! \code{.c}
+//! static const SensorStage s_per_second[] = {
+//!   { .type = SensorStageWindow, .window_ms = 1000 },
+//!   { .type = SensorStageAggregate, .aggregate = SensorAggregateMean },
+//! };
+//!
+//! SensorPipeline *pipeline = sensor_pipeline_create();
+//! sensor_pipeline_add_stream(pipeline, SensorSourceAccelMagnitude, 25, s_per_second, 2);
+//! sensor_pipeline_add_stream(pipeline, SensorSourceCompassHeading, 5, s_per_second, 2);
+//! sensor_pipeline_start(pipeline, 10000, prv_results_handler, NULL);
+//! \endcode
+//!
+//! Windows with a duration end at the same time in all streams and are aligned to the system
+//! timer, so streams of sources with different rates produce results for the same periods.
+//! A pipeline uses the services it reads from like a subscription would, so an app cannot
+//! subscribe to \ref accel_data_service_subscribe() while it runs a pipeline with an
+//! accelerometer source.
+//! @{
+
+//! The maximum number of streams in a pipeline.
+#define SENSOR_PIPELINE_MAX_STREAMS 8
+//! The maximum number of stages in a stream.
+#define SENSOR_PIPELINE_MAX_STAGES 4
+
+//! The values a stream of a \ref SensorPipeline reads.
+typedef enum {
+  //! The vector magnitude of each accelerometer sample, in milli-Gs
+  SensorSourceAccelMagnitude = 0,
+  //! The X axis of each accelerometer sample, in milli-Gs
+  SensorSourceAccelX,
+  //! The Y axis of each accelerometer sample, in milli-Gs
+  SensorSourceAccelY,
+  //! The Z axis of each accelerometer sample, in milli-Gs
+  SensorSourceAccelZ,
+  //! The tilt-compensated heading, scaled like \ref CompassHeading, see
+  //! \ref compass_orientation_service_subscribe()
+  SensorSourceCompassHeading,
+  //! The heart rate in beats per minute, at the rate set with
+  //! \ref health_service_set_heart_rate_sample_period(); the stream's rate is ignored
+  SensorSourceHeartRate,
+  //! The steps taken since the previous value
+  SensorSourceSteps,
+  //! A 0 at every tick of the stream's rate, for a stream that marks fixed periods among the
+  //! results of sources that produce values rarely, such as \ref SensorSourceSteps
+  SensorSourceTimer,
+} SensorSource;
+
+//! The kinds of stages of a stream.
+typedef enum {
+  //! Filters the values with \ref dsp_biquad_filter(), saturated to 16 bits. The system keeps
+  //! the filter state.
+  SensorStageFilter = 0,
+  //! Drops the values below `threshold`.
+  SensorStageThreshold,
+  //! Collects the values into windows of `window_length` values, or of `window_ms`
+  //! milliseconds if `window_length` is 0. Must be followed by a \ref SensorStageAggregate.
+  SensorStageWindow,
+  //! Reduces each window to one value.
+  SensorStageAggregate,
+} SensorStageType;
+
+//! How a \ref SensorStageAggregate reduces a window.
+typedef enum {
+  SensorAggregateMean = 0, //!< The mean of the values
+  SensorAggregateMin,      //!< The smallest value
+  SensorAggregateMax,      //!< The largest value
+  SensorAggregateSum,      //!< The sum of the values
+  SensorAggregateRms,      //!< The root mean square of the values
+  SensorAggregateCount,    //!< The number of values, for example above a threshold
+  SensorAggregateLast,     //!< The last value
+} SensorAggregate;
+
+//! One stage of a stream. Only the fields of the stage's type are used.
+typedef struct {
+  //! The kind of stage
+  SensorStageType type;
+  //! \ref SensorStageFilter: the filter coefficients. The state field is not used.
+  const DspBiquad *filter;
+  //! \ref SensorStageThreshold: the smallest value that is passed on
+  int32_t threshold;
+  //! \ref SensorStageWindow: the number of values per window, or 0 to use `window_ms`
+  uint16_t window_length;
+  //! \ref SensorStageWindow: the duration of a window in milliseconds
+  uint32_t window_ms;
+  //! \ref SensorStageAggregate: how each window is reduced
+  SensorAggregate aggregate;
+} SensorStage;
+
+//! A value delivered by a pipeline.
+typedef struct {
+  //! The stream, as returned by \ref sensor_pipeline_add_stream()
+  uint8_t stream;
+  //! The value: the aggregate of a window, or a single value of a stream without a window
+  int32_t value;
+  //! The time of the first value the result was computed from, in milliseconds
+  uint64_t timestamp;
+} SensorResult;
+
+//! Callback type for pipeline results
+//! @param results The results of all streams since the previous call, oldest first
+//! @param num_results The number of elements in `results`
+//! @param context The context passed to \ref sensor_pipeline_start()
+typedef void (*SensorPipelineHandler)(const SensorResult *results, uint32_t num_results,
+                                      void *context);
+
+struct SensorPipeline;
+typedef struct SensorPipeline SensorPipeline;
+
+//! Creates an empty sensor pipeline.
+//! @return The pipeline, or NULL if it could not be allocated
+SensorPipeline *sensor_pipeline_create(void);
+
+//! Adds a stream to a pipeline that is not running.
+//! @param pipeline The pipeline
+//! @param source The values the stream reads
+//! @param rate_hz The number of values per second read from the source, between 1 and 100 for
+//! the accelerometer and between 1 and 25 for the other sources
+//! @param stages The stages to pass the values through, in order. Copied during the call.
+//! @param num_stages The number of elements in `stages`, at most \ref SENSOR_PIPELINE_MAX_STAGES
+//! @return The number of the stream, which identifies its results, or -1 if the stages are
+//! invalid, the pipeline is running or already has \ref SENSOR_PIPELINE_MAX_STREAMS streams
+int sensor_pipeline_add_stream(SensorPipeline *pipeline, SensorSource source, uint16_t rate_hz,
+                               const SensorStage *stages, uint8_t num_stages);
+
+//! Starts a pipeline. Results are collected by the system and delivered to the handler together,
+//! so the app is woken up at most once every `max_latency_ms`, unless the results fill the
+//! buffer of the pipeline first.
+//! @param pipeline The pipeline
+//! @param max_latency_ms The longest time a result waits before it is delivered
+//! @param handler The function to call with the results
+//! @param context Pointer to application data that is passed to the handler
+//! @return true if the pipeline was started, false if it has no streams or one of its sources is
+//! in use by a subscription of the app
+bool sensor_pipeline_start(SensorPipeline *pipeline, uint32_t max_latency_ms,
+                           SensorPipelineHandler handler, void *context);
+
+//! Stops a pipeline. Results that were not delivered yet are delivered first.
+//! @param pipeline The pipeline
+void sensor_pipeline_stop(SensorPipeline *pipeline);
+
+//! Stops a pipeline if it is running and frees it.
+//! @param pipeline The pipeline
+void sensor_pipeline_destroy(SensorPipeline *pipeline);
+
+//! @} // group SensorPipeline
+
 //! @addtogroup DataLogging
 //! \brief Enables logging data asynchronously to a mobile app
 //!
@@ -1356,6 +2160,10 @@ MeasurementSystem health_service_get_measurement_system_for_display(HealthMetric
 //! If a phone is available, the data is sent directly to the phone. Otherwise, it is saved to the
 //! watch storage until the watch is connected to a phone.
 //!
+//! During development, `datalog_download.py` in the SDK downloads the sessions from the watch
+//! over the developer connection instead, which is much faster than the phone application for
+//! large amounts of data, and writes them to CSV or Parquet files.
+//!
 //!
 //! For example:
 //!
@@ -1417,6 +2225,79 @@ typedef enum {
 DataLoggingSessionRef data_logging_create(uint32_t tag, DataLoggingItemType item_type,
                                           uint16_t item_length, bool resume);
 
+//! The encodings that a buffered data logging session can apply to a block of items before it
+//! is committed to storage.
+//! @see data_logging_create_buffered
+typedef enum {
+  //! The items are stored as they are logged.
+  DATA_LOGGING_ENCODING_NONE = 0,
+  //! Each integer item is stored as the difference to the previous item, which makes slowly
+  //! changing values like sensor readings compress well. Only valid for \ref DATA_LOGGING_UINT
+  //! and \ref DATA_LOGGING_INT sessions; byte arrays are stored as they are logged.
+  DATA_LOGGING_ENCODING_DELTA,
+  //! The block is delta encoded where possible and then compressed with an LZ-family compressor.
+  DATA_LOGGING_ENCODING_DELTA_COMPRESSED,
+} DataLoggingEncoding;
+
+//! Create a new buffered data logging session. The items logged to a buffered session are
+//! accumulated in a RAM buffer of `buffer_size` bytes and committed to storage as one encoded
+//! block when the buffer is full, when \ref data_logging_flush() is called, or when the session is
+//! finished. This saves CPU time and flash bandwidth for high rate data, like accelerometer
+//! samples, and the encoding lets more data fit into the data logging storage. The blocks are
+//! decoded transparently before the data is handed to the phone application.
+//! @note Items that have not been committed yet are lost if the app exits without finishing the
+//! session.
+//!
+//! @param tag A tag associated with the logging session.
+//! @param item_type The type of data stored in this logging session
+//! @param item_length The size of a single data item in bytes
+//! @param resume See \ref data_logging_create()
+//! @param buffer_size The size of the RAM buffer in bytes, which is allocated on the app's heap.
+//!   Must be at least `item_length`.
+//! @param encoding The encoding to apply to each block
+//! @return An opaque reference to the data logging session, or NULL if the buffer could not be
+//!   allocated
+DataLoggingSessionRef data_logging_create_buffered(uint32_t tag, DataLoggingItemType item_type,
+                                                   uint16_t item_length, bool resume,
+                                                   uint16_t buffer_size,
+                                                   DataLoggingEncoding encoding);
+
+//! The maximum number of fields in the schema of a data logging session.
+#define DATA_LOGGING_MAX_FIELDS 16
+
+//! Describes one field of the records logged to a schema session.
+//! @see data_logging_create_with_schema
+typedef struct {
+  //! The name of the field, which is passed on to the phone application. Copied during
+  //! \ref data_logging_create_with_schema().
+  const char *name;
+  //! The type of the field
+  DataLoggingItemType type;
+  //! The size of the field in bytes. Must be 1, 2 or 4 for integer fields.
+  uint16_t length;
+} DataLoggingField;
+
+//! Create a new buffered data logging session whose items are records with multiple typed fields.
+//! Each item passed to \ref data_logging_log() is one record with its fields packed in schema order,
+//! without padding. The session buffers items like \ref data_logging_create_buffered(), but
+//! stores each block column by column, so every column is encoded on its own where the encoding
+//! allows it. The phone application receives the schema with the session and can read the
+//! columns directly instead of parsing opaque byte arrays.
+//!
+//! @param tag A tag associated with the logging session.
+//! @param fields The fields of a record
+//! @param num_fields The number of elements in `fields`, at most \ref DATA_LOGGING_MAX_FIELDS
+//! @param resume See \ref data_logging_create(). A session is only resumed if its schema matches.
+//! @param buffer_size See \ref data_logging_create_buffered()
+//! @param encoding The encoding to apply to each column of a block
+//! @return An opaque reference to the data logging session, or NULL if the parameters were invalid
+//!   or the buffer could not be allocated
+DataLoggingSessionRef data_logging_create_with_schema(uint32_t tag,
+                                                      const DataLoggingField *fields,
+                                                      uint8_t num_fields, bool resume,
+                                                      uint16_t buffer_size,
+                                                      DataLoggingEncoding encoding);
+
 //! Finish up a data logging_session. Logging data is kept until it has successfully been
 //! transferred over to the phone, but no data may be added to the session after this function is
 //! called.
@@ -1450,6 +2331,55 @@ void data_logging_finish(DataLoggingSessionRef logging_session);
 DataLoggingResult data_logging_log(DataLoggingSessionRef logging_session, const void *data,
                                    uint32_t num_items);
 
+//! Commit the items that have been accumulated in the RAM buffer of a buffered data logging
+//! session to storage. For sessions that are not buffered, this is a no-op.
+//!
+//! @param logging_session a reference to the data logging session to flush
+//! @return DATA_LOGGING_SUCCESS on success, DATA_LOGGING_FULL if there is no more space to save the
+//!   block, or DATA_LOGGING_NOT_FOUND if the logging session is invalid
+DataLoggingResult data_logging_flush(DataLoggingSessionRef logging_session);
+
+//! Storage usage of a data logging session and of data logging as a whole.
+//! @see data_logging_get_stats
+typedef struct {
+  //! The number of bytes of the session that have not been transferred to the phone yet,
+  //! including items in the RAM buffer of a buffered session.
+  uint32_t session_bytes_pending;
+  //! The number of bytes of data logging storage used by the app's sessions.
+  uint32_t app_bytes_used;
+  //! The number of bytes of data logging storage that the app can use before
+  //! \ref DATA_LOGGING_FULL is returned.
+  uint32_t app_bytes_available;
+  //! The estimated number of seconds until the pending data of the session has been transferred,
+  //! or 0 if no phone is connected.
+  uint32_t estimated_flush_time_s;
+} DataLoggingStats;
+
+//! Get the storage usage of a data logging session.
+//!
+//! @param logging_session a reference to the data logging session
+//! @param[out] stats The storage usage
+//! @return DATA_LOGGING_SUCCESS on success, DATA_LOGGING_NOT_FOUND if the logging session is
+//!   invalid or DATA_LOGGING_INVALID_PARAMS if stats is NULL
+DataLoggingResult data_logging_get_stats(DataLoggingSessionRef logging_session,
+                                         DataLoggingStats *stats);
+
+//! Function signature of the handler that is called when the data logging storage usage of the
+//! app crosses the threshold set with \ref data_logging_set_usage_handler().
+//! @param usage_percent The share of the storage available to the app that is used, in percent
+//! @param context Pointer to application data as passed to
+//!   \ref data_logging_set_usage_handler()
+typedef void (*DataLoggingUsageHandler)(uint8_t usage_percent, void *context);
+
+//! Set a handler that is called when the data logging storage usage of the app rises above or
+//! falls below a threshold, so the app can reduce the amount of data it logs before data is lost.
+//! @param threshold_percent The threshold, as a share of the storage available to the app in
+//!   percent
+//! @param handler The handler to call, or NULL to remove the handler
+//! @param context Pointer to application data that is passed to the handler
+void data_logging_set_usage_handler(uint8_t threshold_percent, DataLoggingUsageHandler handler,
+                                    void *context);
+
 //! @} // group DataLogging
 
 //! @addtogroup DataStructures
@@ -1550,6 +2480,57 @@ typedef enum {
   APP_LOG_LEVEL_DEBUG_VERBOSE = 255,
 } AppLogLevel;
 
+//! Sends a binary log message. This is used by \ref APP_LOG_BINARY, which should be used
+//! instead of calling this function directly.
+//! @param log_level The log level to log output as
+//! @param fmt_id The offset of the message's format record in the .pbl_log_fmt section
+//! @param num_args The number of 32-bit arguments that follow
+void app_log_binary(uint8_t log_level, uint32_t fmt_id, uint8_t num_args, ...);
+
+//! @internal
+#define _PBL_LOG_STR(x) #x
+//! @internal
+#define _PBL_LOG_XSTR(x) _PBL_LOG_STR(x)
+//! @internal
+#define _PBL_LOG_NARGS(...) _PBL_LOG_NARGS_(__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+//! @internal
+#define _PBL_LOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8, N, ...) N
+
+//! Logs a message like \ref APP_LOG, but without formatting it on the watch.
+//! The format string, file name and line number are placed in the .pbl_log_fmt section of the
+//! app's ELF file. It is a non-alloc section, so it takes no space in the app binary or on the
+//! watch. Only the log level, the offset of the format string in the section and the argument
+//! values are sent, in batches, and `pebble logs` formats the message on the computer using
+//! the app's ELF file. A message costs a few dozen cycles instead of a call to snprintf and a
+//! Bluetooth packet, so this can be used in draw loops and other hot paths without changing
+//! their timing.
+//! If messages are logged faster than they can be sent, the oldest are dropped and
+//! `pebble logs` reports how many were lost.
+//! @note Up to 8 arguments are supported, each of which must fit in 32 bits. The integer
+//! conversions `%d`, `%i`, `%u`, `%x`, `%X` and `%c` are supported; pass pointers cast to
+//! uintptr_t and print them with `%x`. Strings cannot be logged this way, since only the
+//! argument values are sent.
+//! @param level The log level to log output as
+//! @param fmt A C formatting string, which must be a string literal
+//! @param args The arguments for the formatting string
+//! @internal
+//! The record is a static array, so every expansion has its own, however often the compiler
+//! inlines or unrolls the code around it. GCC appends the flags of an allocated section to the
+//! name given in the section attribute; the "@" that ends the name starts an assembler comment
+//! on ARM, which drops them and leaves .pbl_log_fmt a non-alloc section. The id is the record's
+//! offset in the section, loaded by a single asm statement with movw/movt so that it is neither
+//! PC-relative nor a word the loader relocates.
+#define APP_LOG_BINARY(level, fmt, args...)                                              \
+  do {                                                                                   \
+    static const char _pbl_log_record[]                                                  \
+        __attribute__((section(".pbl_log_fmt,\"\",%progbits @"), used)) =                 \
+        __FILE_NAME__ "\0" _PBL_LOG_XSTR(__LINE__) "\0" fmt;                              \
+    uint32_t _pbl_log_id;                                                                \
+    __asm__("movw %0, #:lower16:%c1\n\tmovt %0, #:upper16:%c1"                            \
+            : "=r" (_pbl_log_id) : "i" (_pbl_log_record));                               \
+    app_log_binary(level, _pbl_log_id, _PBL_LOG_NARGS(_, ## args), ## args);             \
+  } while (0)
+
 //! @} // group Logging
 
 //! @addtogroup Dictionary
@@ -1815,6 +2796,60 @@ DictionaryResult dict_write_int16(DictionaryIterator *iter, const uint32_t key,
 
 DictionaryResult dict_write_int32(DictionaryIterator *iter, const uint32_t key, const int32_t value);
 
+//! Adds an array of 32-bit integers to the dictionary as a single tuple, packed little endian in
+//! a byte array value. This takes one tuple header instead of one per element, so it is the wire
+//! format of array message keys such as `"values[10]"` in package.json, which get a single key.
+//! @param iter The dictionary iterator
+//! @param key The key
+//! @param values The integers to add
+//! @param count The number of integers in `values`
+//! @return \ref DICT_OK, \ref DICT_NOT_ENOUGH_STORAGE or \ref DICT_INVALID_ARGS
+//! @see dict_read_int32_array
+DictionaryResult dict_write_int32_array(DictionaryIterator *iter, const uint32_t key,
+                                        const int32_t *values, const uint16_t count);
+
+//! Size in bytes of the header of a dictionary, see \ref dict_calc_buffer_size()
+#define DICT_HEADER_SIZE 1
+
+//! Size in bytes of the header of each tuple in a dictionary, see \ref dict_calc_buffer_size()
+#define DICT_TUPLE_HEADER_SIZE 7
+
+//! The number of bytes a tuple with a value of `value_size` bytes adds to a dictionary, to add up
+//! the size of a message tuple by tuple instead of in one \ref dict_calc_buffer_size() call.
+#define DICT_TUPLE_SIZE(value_size) (DICT_TUPLE_HEADER_SIZE + (value_size))
+
+//! Gets how many bytes are left in the storage of a dictionary that is being written.
+//! A value of `n` bytes still fits if `n + DICT_TUPLE_HEADER_SIZE` is at most this.
+//! @param iter The dictionary iterator, after \ref dict_write_begin()
+//! @return The number of bytes not used yet
+uint32_t dict_write_space_left(const DictionaryIterator *iter);
+
+//! Adds a tuple whose value is filled in later, and gets a pointer to its value in the storage
+//! of the dictionary. Large values such as a blob from a resource or the pixels of an image can
+//! then be read or computed straight into the message, instead of into a buffer of their own
+//! that \ref dict_write_data() copies again. When unsure how large the value will be, reserve
+//! the most that is available and shrink the tuple with \ref dict_write_shrink_last() once the
+//! value is written.
+//! @param iter The dictionary iterator
+//! @param key The key
+//! @param type The type of the value; for integer types, `size` has to be 1, 2 or 4
+//! @param size The size of the value in bytes
+//! @param[out] value Receives a pointer to the `size` bytes of the value, which stays valid until
+//! the next write to the dictionary
+//! @return \ref DICT_OK, \ref DICT_NOT_ENOUGH_STORAGE or \ref DICT_INVALID_ARGS
+//! @note The bytes of the value are not initialized. The value of a \ref TUPLE_CSTRING tuple has
+//! to include the zero terminator.
+DictionaryResult dict_write_reserve(DictionaryIterator *iter, const uint32_t key,
+                                    const TupleType type, const uint16_t size, uint8_t **value);
+
+//! Shrinks the value of the tuple last written to a dictionary, giving the bytes past its new
+//! end back to the dictionary for further tuples.
+//! @param iter The dictionary iterator
+//! @param size The new size of the value, at most its current size
+//! @return \ref DICT_OK, or \ref DICT_INVALID_ARGS if nothing was written yet or `size` is larger
+//! than the current size
+DictionaryResult dict_write_shrink_last(DictionaryIterator *iter, const uint16_t size);
+
 //! End a series of writing operations to a dictionary.
 //! This must be called before reading back from the dictionary.
 //! @param iter The dictionary iterator
@@ -1925,6 +2960,9 @@ DictionaryResult dict_serialize_tuplets(DictionarySerializeCallback callback, vo
 //! @param [in] size_in_out The available buffer size in bytes
 //! @param [out] size_in_out The number of bytes written
 //! @return \ref DICT_OK, \ref DICT_NOT_ENOUGH_STORAGE or \ref DICT_INVALID_ARGS
+//! @note The values are copied once into the Tuplets and once more into the buffer. For large
+//! messages, writing the tuples straight into the outbox from \ref app_message_outbox_begin()
+//! with \ref dict_write_data() and \ref dict_write_reserve() takes a single pass.
 DictionaryResult dict_serialize_tuplets_to_buffer(const Tuplet * const tuplets, const uint8_t tuplets_count, uint8_t *buffer, uint32_t *size_in_out);
 
 //! Serializes an array of Tuplets into a dictionary with a given buffer and size.
@@ -1977,6 +3015,8 @@ typedef void (*DictionaryKeyUpdatedCallback)(const uint32_t key, const Tuple *ne
 //! @param key_callback The callback that will be called for each Tuple in the merged destination dictionary.
 //! @param context Pointer to app specific data that will get passed in when `update_key_callback` is called.
 //! @return \ref DICT_OK, \ref DICT_INVALID_ARGS, \ref DICT_NOT_ENOUGH_STORAGE
+//! @note The keys of `dest` are looked up through a temporary \ref DictionaryIndex when there is
+//! enough heap memory for it, so merging large dictionaries does not take quadratic time.
 DictionaryResult dict_merge(DictionaryIterator *dest, uint32_t *dest_max_size_in_out,
                              DictionaryIterator *source,
                              const bool update_existing_keys_only,
@@ -1988,6 +3028,93 @@ DictionaryResult dict_merge(DictionaryIterator *dest, uint32_t *dest_max_size_in
 //! @return Pointer to a found Tuple, or NULL if there was no Tuple with the specified key.
 Tuple *dict_find(const DictionaryIterator *iter, const uint32_t key);
 
+//! The number of slots to provide to \ref dict_index_init() for a dictionary with the given
+//! number of tuples. Half of the slots stay empty, which keeps lookups short.
+#define DICT_INDEX_NUM_SLOTS(tuple_count) ((uint16_t)((tuple_count) * 2))
+
+//! A hash index over the tuples of a dictionary, see \ref dict_index_init().
+typedef struct {
+  const DictionaryIterator *iter; //!< The dictionary that is indexed
+  uint16_t *slots; //!< The storage of the index, provided by the app
+  uint16_t num_slots; //!< The number of slots in `slots`
+} DictionaryIndex;
+
+//! Builds a hash index over a dictionary, so that \ref dict_index_find() can find tuples in
+//! constant time instead of scanning the dictionary like \ref dict_find() does. Build the index
+//! once, after \ref dict_read_begin_from_buffer() or \ref dict_write_end(); it needs to be built
+//! again after the dictionary has been modified.
+//! @param index The index to build
+//! @param iter Iterator to the dictionary to index. Must remain valid while the index is used.
+//! @param slots The storage of the index
+//! @param num_slots The number of slots in `slots`, see \ref DICT_INDEX_NUM_SLOTS()
+//! @return \ref DICT_OK, \ref DICT_INVALID_ARGS or \ref DICT_NOT_ENOUGH_STORAGE if the
+//! dictionary holds more tuples than `num_slots`
+DictionaryResult dict_index_init(DictionaryIndex *index, const DictionaryIterator *iter,
+                                 uint16_t *slots, uint16_t num_slots);
+
+//! Tries to find a Tuple with specified key using an index built with \ref dict_index_init().
+//! @param index The index of the dictionary to search in.
+//! @param key The key for which to find a Tuple
+//! @return Pointer to a found Tuple, or NULL if there was no Tuple with the specified key.
+Tuple *dict_index_find(const DictionaryIndex *index, const uint32_t key);
+
+//! Fills a table with the tuples of a dictionary whose keys are small, contiguous integers, so each
+//! tuple can then be found by indexing the table with its key. The message keys the SDK generates
+//! from the `messageKeys` in package.json are numbered from 0 in order, and `MESSAGE_KEY_COUNT` is
+//! the size of the table they need:
+//! \code{.c}
+//! const Tuple *tuples[MESSAGE_KEY_COUNT];
+//! dict_index_dense(iter, tuples, MESSAGE_KEY_COUNT, 0);
+//! const Tuple *temperature = tuples[MESSAGE_KEY_temperature];
+//! \endcode
+//! Unlike \ref dict_index_init(), no hashing is involved. Entries of keys that are not in the
+//! dictionary are set to NULL, and tuples whose key is outside of the table are ignored.
+//! @param iter Iterator to the dictionary to index
+//! @param table The table to fill, `num_keys` entries
+//! @param num_keys The number of entries in `table`
+//! @param first_key The key of the first entry in `table`
+//! @return The number of tuples stored in the table
+uint16_t dict_index_dense(const DictionaryIterator *iter, const Tuple **table, uint16_t num_keys,
+                          uint32_t first_key);
+
+//! Reads an array of 32-bit integers written with \ref dict_write_int32_array(). The tuple's data
+//! does not need to be aligned.
+//! @param tuple A tuple holding a packed integer array
+//! @param[out] values The buffer to read the integers into
+//! @param max_count The number of integers `values` can hold
+//! @return The number of integers read, 0 if the tuple is not a byte array
+uint16_t dict_read_int32_array(const Tuple *tuple, int32_t *values, uint16_t max_count);
+
+//! Encodes a dictionary into the compact wire format. In the compact format, keys are stored as
+//! variable length deltas to the previous key, integers are zigzag encoded and stored in as few
+//! bytes as their value needs, and the type and length of each value share a single byte where
+//! possible. A message of small integer values with ascending keys typically shrinks to a
+//! third of its size.
+//! @note Tuples are accessed in place, so dictionaries are always read and written in the regular
+//! format described by \ref dict_calc_buffer_size(). The compact format is meant for
+//! transport and storage.
+//! @param iter Iterator to the dictionary to encode
+//! @param buffer The buffer to write the compact encoding into
+//! @param [in,out] size_in_out In: the size of `buffer`. Out: the size of the compact encoding.
+//! @return \ref DICT_OK, \ref DICT_INVALID_ARGS or \ref DICT_NOT_ENOUGH_STORAGE
+//! @see dict_decode_compact
+DictionaryResult dict_encode_compact(const DictionaryIterator *iter, uint8_t *buffer,
+                                     uint32_t *size_in_out);
+
+//! Decodes a dictionary from the compact wire format, see \ref dict_encode_compact(), and
+//! prepares the iterator for reading the decoded dictionary, like
+//! \ref dict_read_begin_from_buffer() does.
+//! @param iter The dictionary iterator
+//! @param compact The compact encoding
+//! @param compact_size The size of the compact encoding in bytes
+//! @param buffer The storage for the decoded dictionary
+//! @param [in,out] size_in_out In: the size of `buffer`. Out: the size of the decoded dictionary.
+//! @return \ref DICT_OK, \ref DICT_INVALID_ARGS, \ref DICT_NOT_ENOUGH_STORAGE or
+//! \ref DICT_INTERNAL_INCONSISTENCY if the encoding could not be parsed
+DictionaryResult dict_decode_compact(DictionaryIterator *iter, const uint8_t *compact,
+                                     uint32_t compact_size, uint8_t *buffer,
+                                     uint32_t *size_in_out);
+
 //! @} // group Dictionary
 
 //! @addtogroup Dictation
@@ -2085,6 +3212,30 @@ void dictation_session_enable_confirmation(DictationSession *session, bool is_en
 //! @param is_enabled   set to true to enable error dialogs (default), false to disable
 void dictation_session_enable_error_dialogs(DictationSession *session, bool is_enabled);
 
+//! Dictation partial result callback. Called each time the phone sends an updated partial
+//! transcription while the user is still speaking, so that the app can show text before the
+//! final transcription is available. Each partial transcription replaces the previous one.
+//! The string will be freed after this call returns, so it should be copied if it needs to be
+//! retained afterwards.
+//! @param session                dictation session from which the partial result was received
+//! @param partial_transcription  transcribed string so far
+//! @param context                callback context specified with
+//!                               \ref dictation_session_set_partial_callback
+typedef void (*DictationSessionPartialCallback)(DictationSession *session,
+                                                const char *partial_transcription,
+                                                void *context);
+
+//! Enable streaming of partial transcriptions. Must be called before the session is started.
+//! Partial results are delivered whether or not user confirmation is enabled; combined with
+//! \ref dictation_session_enable_confirmation disabled, the app can show the transcription as it
+//! arrives and receive the final one in the status callback without any confirmation UI.
+//! @param session   dictation session to modify
+//! @param callback  partial result handler, or NULL to disable streaming (default)
+//! @param context   context pointer for the partial result handler
+void dictation_session_set_partial_callback(DictationSession *session,
+                                            DictationSessionPartialCallback callback,
+                                            void *context);
+
 //! Convenience macro to switch between two expressions depending on mic support.
 //! On platforms with a mic the first expression will be chosen, the second otherwise.
 #define PBL_IF_MICROPHONE_ELSE(if_true, if_false) (if_true)
@@ -2227,6 +3378,9 @@ typedef enum {
 
   //! (32768) The function was called while App Message was not in the appropriate state.
   APP_MSG_INVALID_STATE = 1 << 15,
+
+  //! (65536) The received data did not match its checksum.
+  APP_MSG_CHECKSUM_MISMATCH = 1 << 16,
 } AppMessageResult;
 
 //! Open AppMessage to transfers.
@@ -2244,6 +3398,79 @@ typedef enum {
 //!
 AppMessageResult app_message_open(const uint32_t size_inbound, const uint32_t size_outbound);
 
+//! Open AppMessage to transfers, with a pool of Inbox buffers that received messages can be
+//! retained in.
+//!
+//! Works like \ref app_message_open(), but allocates `num_inbox_buffers` Inbox buffers of
+//! `size_inbound` bytes each. While the app has retained received messages with
+//! \ref app_message_inbox_retain(), new messages are received into the remaining buffers.
+//!
+//! \param[in] size_inbound The required size for each Inbox buffer
+//! \param[in] size_outbound The required size for the Outbox buffer
+//! \param[in] num_inbox_buffers The number of Inbox buffers, at least 1
+//!
+//! \return A result code such as \ref APP_MSG_OK, \ref APP_MSG_INVALID_ARGS or
+//!   \ref APP_MSG_OUT_OF_MEMORY.
+//!
+AppMessageResult app_message_open_with_inbox_pool(const uint32_t size_inbound,
+                                                  const uint32_t size_outbound,
+                                                  const uint8_t num_inbox_buffers);
+
+//! Sets the number of outbound messages that can be in flight at the same time.
+//!
+//! By default only one message can be in flight, and \ref app_message_outbox_begin() returns
+//! \ref APP_MSG_BUSY until the \ref AppMessageOutboxSent or \ref AppMessageOutboxFailed callback
+//! for the previous message has been called. With a larger depth, messages can be begun and sent
+//! while earlier messages are still awaiting their (n)ack, which keeps the Bluetooth link busy
+//! during bulk uploads. Messages are delivered in the order in which they were sent, and the
+//! callbacks are called in the same order. Messages of the high priority lane, see
+//! \ref app_message_set_priority_lanes(), can overtake them.
+//!
+//! \param[in] depth The number of Outbox buffers, each of the `size_outbound` passed to
+//!   \ref app_message_open(), between 1 (default) and \ref APP_MESSAGE_OUTBOX_DEPTH_MAXIMUM.
+//!
+//! \return A result code, including but not limited to \ref APP_MSG_OK, \ref APP_MSG_INVALID_ARGS,
+//!   or \ref APP_MSG_INVALID_STATE if AppMessage is already open.
+//!
+//! \note Must be called before \ref app_message_open() or
+//!   \ref app_message_open_with_inbox_pool().
+//!
+AppMessageResult app_message_set_outbox_depth(const uint8_t depth);
+
+//! Enables a second, high priority lane for outgoing messages, see
+//! \ref app_message_outbox_begin_with_priority(). One more Outbox buffer of the `size_outbound`
+//! passed to \ref app_message_open() is reserved for the high priority lane, in addition to the
+//! buffers set with \ref app_message_set_outbox_depth(), so control messages can be begun even
+//! while all regular buffers are queued up with bulk data.
+//!
+//! \param[in] enabled Pass in `true` to enable the high priority lane (default: `false`)
+//!
+//! \return A result code, including but not limited to \ref APP_MSG_OK or
+//!   \ref APP_MSG_INVALID_STATE if AppMessage is already open.
+//!
+//! \note Must be called before \ref app_message_open() or
+//!   \ref app_message_open_with_inbox_pool().
+//!
+AppMessageResult app_message_set_priority_lanes(const bool enabled);
+
+//! Enables the compact wire encoding of messages, see \ref dict_encode_compact().
+//!
+//! When enabled, the encoding is negotiated with the phone when the connection is set up. If the
+//! phone supports it, messages are compacted before they are sent and expanded into the regular
+//! Dictionary format when they are received, so the Inbox and Outbox callbacks and iterators work
+//! as before. Fewer bytes are sent over the link, so messages need fewer round trips. If the
+//! phone does not support the compact encoding, the regular encoding is used.
+//!
+//! \param[in] enabled Pass in `true` to enable the compact encoding (default: `false`)
+//!
+//! \return A result code, including but not limited to \ref APP_MSG_OK or
+//!   \ref APP_MSG_INVALID_STATE if AppMessage is already open.
+//!
+//! \note Must be called before \ref app_message_open() or
+//!   \ref app_message_open_with_inbox_pool().
+//!
+AppMessageResult app_message_set_compact_encoding(const bool enabled);
+
 //! Deregisters all callbacks and their context.
 //!
 void app_message_deregister_callbacks(void);
@@ -2255,6 +3482,8 @@ void app_message_deregister_callbacks(void);
 //!   saved off.  The library may need to re-use the buffered space where this message is supplied.  Returning from
 //!   the callback indicates to the library that the received message contents are no longer needed or have already
 //!   been externalized outside its buffering space and iterator.
+//!   If AppMessage was opened with \ref app_message_open_with_inbox_pool(), the message can be
+//!   retained with \ref app_message_inbox_retain() to keep using it after returning.
 //!
 //! \param[in] context
 //!   Pointer to application data as specified when registering the callback.
@@ -2403,6 +3632,35 @@ uint32_t app_message_outbox_size_maximum(void);
 //!
 AppMessageResult app_message_outbox_begin(DictionaryIterator **iterator);
 
+//! Priorities of outgoing messages, see \ref app_message_outbox_begin_with_priority().
+typedef enum {
+  //! The lane of all messages begun with \ref app_message_outbox_begin()
+  AppMessagePriorityNormal,
+  //! The lane for small, latency sensitive messages such as button actions
+  AppMessagePriorityHigh,
+} AppMessagePriority;
+
+//! Begins an outbound message in the given priority lane; otherwise works like
+//! \ref app_message_outbox_begin(). Queued messages of the high priority lane are sent before all
+//! queued messages of the normal lane, as soon as the message that is currently being
+//! transferred has been sent. Messages are never interrupted partway, so the added latency of a
+//! high priority message is at most the transfer time of one message, regardless of how many
+//! bulk messages are queued. This also applies while data is received with
+//! \ref app_transfer_open(), whose chunks yield to high priority messages in both directions.
+//! The order of messages is kept within each lane, but not across lanes.
+//!
+//! \param[out] iterator Location to write the DictionaryIterator pointer. This will be NULL on
+//!   failure.
+//! \param[in] priority The lane of the message
+//!
+//! \return A result code, including but not limited to \ref APP_MSG_OK,
+//!   \ref APP_MSG_INVALID_ARGS, \ref APP_MSG_BUSY if the buffer of the lane is in use, or
+//!   \ref APP_MSG_INVALID_STATE for \ref AppMessagePriorityHigh if the high priority lane was
+//!   not enabled with \ref app_message_set_priority_lanes().
+//!
+AppMessageResult app_message_outbox_begin_with_priority(DictionaryIterator **iterator,
+                                                        AppMessagePriority priority);
+
 //! Sends the outbound dictionary.
 //!
 //! \return A result code, including but not limited to \ref APP_MSG_OK or \ref APP_MSG_BUSY.  The APP_MSG_OK code does
@@ -2414,6 +3672,161 @@ AppMessageResult app_message_outbox_begin(DictionaryIterator **iterator);
 //!
 AppMessageResult app_message_outbox_send(void);
 
+//! Called after an outbound message sent with \ref app_message_outbox_send_with_callback() has
+//! been sent and the reply has been received, or has not been sent successfully.
+//!
+//! \param[in] iterator
+//!   The dictionary iterator to the sent message. See \ref AppMessageOutboxSent for restrictions.
+//!
+//! \param[in] result
+//!   \ref APP_MSG_OK if the message was sent successfully, or the reason why it failed. See
+//!   \ref AppMessageOutboxFailed for the possible values.
+//!
+//! \param[in] context
+//!   Pointer to application data as passed to \ref app_message_outbox_send_with_callback().
+//!
+typedef void (*AppMessageOutboxResult)(DictionaryIterator *iterator, AppMessageResult result,
+                                       void *context);
+
+//! Sends the outbound dictionary, with a callback for this message only.
+//!
+//! Works like \ref app_message_outbox_send(), but calls `callback` instead of the registered
+//! \ref AppMessageOutboxSent and \ref AppMessageOutboxFailed callbacks when the result of this
+//! message is known. This makes it possible to tell in-flight messages apart, see
+//! \ref app_message_set_outbox_depth().
+//!
+//! \param[in] callback The callback to call with the result of this message
+//! \param[in] context Pointer to application data that is passed to the callback
+//!
+//! \return A result code, including but not limited to \ref APP_MSG_OK or \ref APP_MSG_BUSY.
+//!
+AppMessageResult app_message_outbox_send_with_callback(AppMessageOutboxResult callback,
+                                                       void *context);
+
+//! Retains the Inbox buffer of a received message, so the message can be read in place after the
+//! \ref AppMessageInboxReceived callback returns, without copying it into the app's heap. The
+//! iterator and the tuples it points to remain valid until \ref app_message_inbox_release() is
+//! called.
+//!
+//! \param[in] iterator The dictionary iterator passed to the \ref AppMessageInboxReceived
+//!   callback. Must be called from within the callback.
+//!
+//! \return A result code, including but not limited to \ref APP_MSG_OK, \ref APP_MSG_INVALID_ARGS,
+//!   or \ref APP_MSG_BUSY if retaining the buffer would leave no buffer to receive into.
+//!
+//! \note Only available if AppMessage was opened with \ref app_message_open_with_inbox_pool().
+//!
+AppMessageResult app_message_inbox_retain(DictionaryIterator *iterator);
+
+//! Releases an Inbox buffer retained with \ref app_message_inbox_retain(), so it can be used to
+//! receive new messages. The iterator and the tuples it points to must not be used afterwards.
+//!
+//! \param[in] iterator The dictionary iterator of the retained message.
+//!
+//! \return A result code, including but not limited to \ref APP_MSG_OK or
+//!   \ref APP_MSG_ALREADY_RELEASED.
+//!
+AppMessageResult app_message_inbox_release(DictionaryIterator *iterator);
+
+//! Size of the header in front of the data of a compressed tuple, see
+//! \ref app_message_set_inbox_inflate().
+#define APP_MESSAGE_COMPRESSED_HEADER_SIZE 6
+
+//! Enables inflating compressed tuples of received messages before they are passed to the
+//! \ref AppMessageInboxReceived callback.
+//!
+//! Phone apps can deflate large string and byte array values, for example with the
+//! `compressed_transport.js` helper for PebbleKit JS in the SDK. Such a value is sent as a byte
+//! array that starts with a header of \ref APP_MESSAGE_COMPRESSED_HEADER_SIZE bytes: the
+//! characters `PZ`, the original \ref TupleType, the deflate window size as a base 2 logarithm
+//! between 9 and 15, and the inflated length as a little endian `uint16_t`. It is followed by a raw
+//! deflate (RFC 1951) stream.
+//!
+//! When enabled, the system inflates these tuples in place in the Inbox buffer with a streaming
+//! decoder that uses the Inbox buffer itself as its window, so no additional memory is needed.
+//! The inflated message must fit in the Inbox buffer, otherwise the compressed tuples are passed on
+//! unchanged. Inflated tuples have their original type and length, so receiving code does not
+//! change.
+//!
+//! \param[in] enabled true to inflate compressed tuples, false to pass them on unchanged
+//!
+//! \return \ref APP_MSG_OK, or \ref APP_MSG_CLOSED if AppMessage has not been opened.
+//!
+AppMessageResult app_message_set_inbox_inflate(bool enabled);
+
+//! Inflates a compressed tuple into a buffer provided by the caller. Use this to keep values
+//! compressed in the Inbox, or to inflate them later, for example into persistent storage.
+//!
+//! \param[in] tuple A tuple whose value starts with the header described in
+//!   \ref app_message_set_inbox_inflate()
+//! \param[out] buffer The buffer to inflate into
+//! \param[in] size The size of the buffer in bytes
+//!
+//! \return The number of bytes written to the buffer, or 0 if the tuple is not compressed, is
+//!   corrupt, or does not fit in the buffer.
+//!
+size_t app_message_inflate_tuple(const Tuple *tuple, void *buffer, size_t size);
+
+//! Number of buckets in the latency histograms of \ref AppMessageStats. Bucket `i` counts the
+//! messages that took less than `25 << i` milliseconds, and less than `25 << (i - 1)` for
+//! bucket `i - 1`; the last bucket counts everything that took 1600 ms or longer.
+#define APP_MESSAGE_LATENCY_BUCKETS 8
+
+//! Counters of the AppMessage traffic of the app since it was launched, or since
+//! \ref app_message_reset_stats() was called.
+typedef struct AppMessageStats {
+  //! Outgoing messages that were acknowledged by the phone
+  uint32_t sent;
+  //! Outgoing messages that failed, see the result counters below for why
+  uint32_t failed;
+  //! Retransmissions of outgoing messages that were not acknowledged in time
+  uint32_t retries;
+  //! Incoming messages passed to the \ref AppMessageInboxReceived callback
+  uint32_t received;
+  //! Incoming messages passed to the \ref AppMessageInboxDropped callback
+  uint32_t dropped;
+  //! Bytes of the dictionaries of all sent messages
+  uint32_t bytes_sent;
+  //! Bytes of the dictionaries of all received messages
+  uint32_t bytes_received;
+  //! Outgoing bytes per second over the last 10 seconds in which messages were sent
+  uint32_t send_rate_bytes_per_sec;
+  //! Failures with \ref APP_MSG_SEND_TIMEOUT
+  uint16_t timeouts;
+  //! Failures with \ref APP_MSG_SEND_REJECTED
+  uint16_t rejected;
+  //! Failures with \ref APP_MSG_NOT_CONNECTED
+  uint16_t not_connected;
+  //! Failures with any other result
+  uint16_t other_failures;
+  //! Time from \ref app_message_outbox_send() until the message started to be transmitted,
+  //! which is the time it waited behind earlier messages
+  uint16_t queue_ms_histogram[APP_MESSAGE_LATENCY_BUCKETS];
+  //! Time from the start of the transmission until the phone's acknowledgement, including
+  //! retries
+  uint16_t ack_ms_histogram[APP_MESSAGE_LATENCY_BUCKETS];
+  //! The longest time from \ref app_message_outbox_send() until the acknowledgement
+  uint32_t max_latency_ms;
+} AppMessageStats;
+
+//! Gets the counters of the app's AppMessage traffic. Counting costs a few instructions per
+//! message and is always active, so the counters can help diagnose slow syncs in the field, for
+//! example by including them in a support screen or a data logging session.
+//! @param[out] stats The counters
+void app_message_get_stats(AppMessageStats *stats);
+
+//! Sets all counters of the app's AppMessage traffic to zero.
+void app_message_reset_stats(void);
+
+//! Sets how often the AppMessage counters are written to the app log, where they can be viewed
+//! with `pebble logs` and summarized with the `appmsg_stats.py` tool in the SDK. Each log entry
+//! has the form `appmsg: sent <n> failed <n> retries <n> received <n> dropped <n> tx <bytes>B
+//! rx <bytes>B rate <bytes>B/s timeouts <n> rejected <n> not_connected <n> other <n>
+//! queue <h0>,...,<h7> ack <h0>,...,<h7> max <ms>ms`, with the histograms listed bucket by
+//! bucket. Nothing is logged for intervals without any AppMessage traffic.
+//! @param seconds Log the counters every `seconds` seconds, 0 to disable logging (default)
+void app_message_set_stats_log_interval(uint16_t seconds);
+
 //! As long as the firmware maintains its current major version, inboxes of this size or smaller will be allowed.
 //!
 //! \sa app_message_inbox_size_maximum()
@@ -2428,6 +3841,12 @@ AppMessageResult app_message_outbox_send(void);
 //!
 #define APP_MESSAGE_OUTBOX_SIZE_MINIMUM 636
 
+//! The maximum number of outbound messages that can be in flight at the same time.
+//!
+//! \sa app_message_set_outbox_depth()
+//!
+#define APP_MESSAGE_OUTBOX_DEPTH_MAXIMUM 4
+
 //! @} // group AppMessage
 
 //! @addtogroup AppSync
@@ -2562,10 +3981,123 @@ AppMessageResult app_sync_set(struct AppSync *s, const Tuplet * const keys_and_v
 //! @param key The key for which to find a Tuple
 //! @return Pointer to a found Tuple, or NULL if there was no Tuple with the
 //! specified key.
+//! @note AppSync keeps a \ref DictionaryIndex over the "current" dictionary, so this is a
+//! constant time lookup.
 const Tuple * app_sync_get(const struct AppSync *s, const uint32_t key);
 
+//! Enables or disables delta-only updates (default: disabled).
+//! When enabled, \ref app_sync_set() only sends the tuplets whose values differ from the values in
+//! the "current" dictionary, and the `.value_changed` callback is not called for incoming tuples
+//! whose values are identical to the current ones. If none of the tuplets passed to
+//! \ref app_sync_set() changed, nothing is sent and \ref APP_MSG_OK is returned.
+//! @param s The AppSync context
+//! @param delta_only Supply `true` to only send and report changed values, or `false` to send and
+//! report all of them.
+void app_sync_set_delta_mode(struct AppSync *s, const bool delta_only);
+
+//! Gets the version of a key in the "current" dictionary. The version starts at 0 and is
+//! incremented each time the value of the key changes, which can be used to tell whether a value
+//! has changed since it was last read without comparing the values.
+//! @param s The AppSync context
+//! @param key The key for which to get the version
+//! @return The version of the key, or 0 if there was no Tuple with the specified key.
+uint16_t app_sync_get_version(const struct AppSync *s, const uint32_t key);
+
 //! @} // group AppSync
 
+//! @addtogroup AppTransfer Bulk Transfer
+//! \brief Receiving multi-kilobyte payloads from the phone
+//!
+//! Bulk Transfer resides on top of \ref AppMessage and receives payloads that are larger than the
+//! Inbox, such as images, without having to chunk them into Dictionary tuples by hand. The payload
+//! is split into chunks of the maximum size the Bluetooth link allows, and each chunk is passed to
+//! the app's `.data` handler as it arrives, so the payload never has to be held in memory in its
+//! entirety. The phone only sends as far ahead as the app has consumed, and a payload is verified
+//! against its CRC-32 when it has been received completely.
+//!
+//! While a transfer is in progress, the sniff interval is reduced automatically, as if
+//! \ref app_comm_set_sniff_interval() had been called with \ref SNIFF_INTERVAL_REDUCED, and
+//! restored afterwards.
+//!
+//! An interrupted transfer can be resumed: when the phone starts sending a payload that was
+//! already partially received, the `.started` handler can supply the offset to continue from.
+//! @{
+
+//! Information about a payload that the phone is starting to send.
+typedef struct AppTransferInfo {
+  //! Identifier of the payload, chosen by the phone. The same payload keeps its identifier when
+  //! a transfer is resumed.
+  uint32_t transfer_id;
+  //! The total size of the payload in bytes.
+  uint32_t total_size;
+  //! The CRC-32 checksum of the entire payload.
+  uint32_t crc32;
+} AppTransferInfo;
+
+//! Called when the phone starts sending a payload.
+//! @param info Information about the payload
+//! @param[out] resume_offset The offset in bytes from which the phone should send the payload.
+//! Defaults to 0; set it to the number of bytes already received to resume a transfer.
+//! @param context Pointer to application data as passed to \ref app_transfer_open()
+//! @return true to accept the payload, false to reject it
+typedef bool (*AppTransferStartedHandler)(const AppTransferInfo *info, uint32_t *resume_offset,
+                                          void *context);
+
+//! Called for every chunk of a payload that is received. Chunks are passed in order.
+//! @param transfer_id The identifier of the payload
+//! @param offset The offset of the chunk within the payload
+//! @param data The data of the chunk. Only valid until the handler returns.
+//! @param length The length of the chunk in bytes
+//! @param context Pointer to application data as passed to \ref app_transfer_open()
+//! @return true to receive the next chunk, or false to pause the transfer until
+//! \ref app_transfer_resume() is called
+typedef bool (*AppTransferDataHandler)(uint32_t transfer_id, uint32_t offset,
+                                       const uint8_t *data, uint16_t length, void *context);
+
+//! Called when a transfer has finished.
+//! @param transfer_id The identifier of the payload
+//! @param result \ref APP_MSG_OK if the entire payload was received and matched its checksum, or,
+//! among others, \ref APP_MSG_CHECKSUM_MISMATCH, \ref APP_MSG_NOT_CONNECTED or \ref APP_MSG_CLOSED.
+//! @param context Pointer to application data as passed to \ref app_transfer_open()
+typedef void (*AppTransferFinishedHandler)(uint32_t transfer_id, AppMessageResult result,
+                                           void *context);
+
+//! The handlers that are called during a transfer.
+//! @see app_transfer_open
+typedef struct AppTransferHandlers {
+  //! Called when the phone starts sending a payload. Optional; if `NULL`, every payload is
+  //! accepted from the start.
+  AppTransferStartedHandler started;
+  //! Called for every chunk of a payload. Mandatory.
+  AppTransferDataHandler data;
+  //! Called when a transfer has finished. Optional.
+  AppTransferFinishedHandler finished;
+} AppTransferHandlers;
+
+//! Starts accepting bulk transfers from the phone.
+//! @note \ref AppMessage must be open.
+//! @param handlers The handlers to call during a transfer
+//! @param context Pointer to application data that is passed to the handlers
+//! @return A result code such as \ref APP_MSG_OK, \ref APP_MSG_INVALID_STATE or
+//! \ref APP_MSG_OUT_OF_MEMORY.
+AppMessageResult app_transfer_open(AppTransferHandlers handlers, void *context);
+
+//! Stops accepting bulk transfers. A transfer that is in progress is cancelled and its
+//! `.finished` handler is called with \ref APP_MSG_CLOSED.
+void app_transfer_close(void);
+
+//! Resumes a transfer that was paused by returning false from the `.data` handler.
+//! @param transfer_id The identifier of the payload
+//! @return A result code such as \ref APP_MSG_OK or \ref APP_MSG_INVALID_ARGS.
+AppMessageResult app_transfer_resume(uint32_t transfer_id);
+
+//! Cancels a transfer. Its `.finished` handler is called with \ref APP_MSG_CLOSED.
+//! @param transfer_id The identifier of the payload
+//! @return A result code such as \ref APP_MSG_OK or \ref APP_MSG_INVALID_ARGS.
+AppMessageResult app_transfer_cancel(uint32_t transfer_id);
+
+//! @} // group AppTransfer
+
 //! @addtogroup Resources
 //! \brief Managing application resources
 //!
@@ -2686,6 +4218,116 @@ const Tuple * app_sync_get(const struct AppSync *s, const uint32_t key);
 
 //! @} // group PBIFileFormat
 
+//! @addtogroup RLESpriteFileFormat RLE Sprite File Format
+//!
+//! RLE sprites are bitmaps that the SDK tooling pre-encodes as runs of transparent and visible
+//! pixels when loaded as a resource-type "rle". They need neither a decompression buffer nor a
+//! full-size pixel buffer at runtime: \ref gbitmap_create_with_resource only allocates a small
+//! \ref GBitmap header and the encoded rows are read from flash while drawing.
+//!
+//! Each row is stored as a sequence of (skip, count) pairs followed by `count` pixels in the
+//! native pixel format of the platform (\ref GBitmapFormat1Bit or \ref GBitmapFormat8Bit).
+//! `skip` is the number of fully transparent pixels preceding the run. A row offset table allows
+//! rows that are clipped away to be skipped without decoding.
+//!
+//! Compared to PBI and PNG8 resources, RLE sprites are best suited for icons and sprites with
+//! large transparent areas, where skipping empty spans also makes drawing with \ref GCompOpSet
+//! faster. Since the pixel data is never expanded in RAM, \ref gbitmap_get_data returns `NULL` for
+//! such bitmaps and they cannot be used as the destination of drawing operations.
+//!
+//! @see \ref gbitmap_create_with_resource
+//! @see \ref GBitmapFormatRLESprite
+//!
+//! @{
+
+//! @} // group RLESpriteFileFormat
+
+//! @addtogroup CompressedBitmapFileFormat Compressed Bitmap File Format
+//!
+//! Compressed bitmaps keep their pixels LZ4 compressed in RAM and are decoded a few rows at a
+//! time while drawing. They are meant for large opaque images such as full-screen backgrounds,
+//! which take 24 to 45 KB of heap as 8-bit pixels but typically compress to a fraction of that,
+//! so several of them can stay loaded at once. The SDK tooling produces them from PNG images
+//! loaded as a resource-type "compressed", and \ref gbitmap_create_compressed converts bitmaps
+//! at runtime.
+//!
+//! All values are little endian:
+//! * `uint8_t version`: 1
+//! * `uint8_t format`: \ref GBitmapFormat1Bit or \ref GBitmapFormat8Bit, the format of the rows
+//! * `uint8_t rows_per_block`: number of rows compressed together, usually 8
+//! * `uint8_t reserved`: 0
+//! * `uint16_t width`, `uint16_t height`: size of the bitmap in pixels
+//! * `uint32_t block_offsets[num_blocks + 1]`: offsets of the blocks from the end of this table,
+//!   where `num_blocks` is `height` divided by `rows_per_block`, rounded up. The last entry is the
+//!   total size of the blocks.
+//! * The blocks, each an LZ4 raw block of `rows_per_block` rows (fewer for the last block) in the
+//!   row layout of a PBI of the same format.
+//!
+//! Drawing decodes only the blocks that intersect the clipping box, into a buffer of
+//! `rows_per_block` rows, so the CPU cost is roughly that of a memory copy of the visible rows.
+//! Since the pixel data is never expanded in RAM, \ref gbitmap_get_data returns `NULL` for such
+//! bitmaps and they cannot be used as the destination of drawing operations.
+//!
+//! @see \ref gbitmap_create_with_resource
+//! @see \ref GBitmapFormatCompressed
+//!
+//! @{
+
+//! @} // group CompressedBitmapFileFormat
+
+//! @addtogroup PathFileFormat Path File Format
+//!
+//! Paths can be stored as resources of type "path", which the SDK tooling produces from the
+//! first `<path>`, `<polygon>` or `<polyline>` element of an SVG file, with curves flattened into
+//! points. Path resources let shapes such as watch hands or glyphs change without rebuilding the
+//! app's code, and \ref gpath_create_with_resource reads their points directly from flash.
+//!
+//! All values are little endian:
+//! * `uint8_t magic[4]`: "PPTH"
+//! * `uint16_t version`: 1
+//! * `uint16_t num_points`: number of points
+//! * `uint16_t num_triangles`: number of triangles, 0 if the path was not triangulated
+//! * `uint16_t reserved`: 0
+//! * `GPoint points[num_points]`: the points, as `int16_t x` and `int16_t y`
+//! * `uint16_t triangles[num_triangles][3]`: indices into `points` of the corners of each
+//!   triangle
+//!
+//! The optional triangles partition the filled area of the path, so that
+//! \ref gpath_draw_filled() can fill each of them with a simple span walk instead of sorting the
+//! edges of the whole path on every call. Since they refer to the points by index, they stay
+//! valid when the path is rotated or moved.
+//!
+//! @see \ref gpath_create_with_resource
+//!
+//! @{
+
+//! @} // group PathFileFormat
+
+//! @addtogroup MenuFileFormat Menu File Format
+//!
+//! Static menus can be stored as resources of type "menu", which the SDK tooling produces from a
+//! JSON description of the menu's sections and items. Unlike \ref SimpleMenuSection and
+//! \ref SimpleMenuItem arrays, which are loaded into app RAM together with the rest of the app's
+//! constant data, a menu resource stays in flash, so even menus with hundreds of items cost no
+//! heap. See \ref simple_menu_layer_create_with_resource.
+//!
+//! All values are little endian:
+//! * `uint8_t magic[4]`: "PMNU"
+//! * `uint16_t version`: 1
+//! * `uint16_t num_sections`
+//! * `num_sections` sections of `uint32_t title_offset`, `uint16_t first_item` and
+//!   `uint16_t num_items`, where `first_item` indexes the item table
+//! * `uint32_t num_items`, followed by that many items of `uint32_t title_offset`,
+//!   `uint32_t subtitle_offset`, `uint32_t icon_resource_id` and `uint32_t item_id`
+//! * The strings, zero terminated UTF-8
+//!
+//! String offsets are relative to the start of the resource, and 0 means that there is no
+//! string. An `icon_resource_id` of 0 means that the item has no icon.
+//!
+//! @{
+
+//! @} // group MenuFileFormat
+
 //! @} // group FileFormats
 
 //! Opaque reference to a resource.
@@ -2742,6 +4384,48 @@ size_t resource_load(ResHandle h, uint8_t *buffer, size_t max_length);
 size_t resource_load_byte_range(
     ResHandle h, uint32_t start_offset, uint8_t *buffer, size_t num_bytes);
 
+//! Opaque handle to a buffered random-access reader over a resource.
+//! @see \ref resource_reader_create
+struct ResourceReader;
+typedef struct ResourceReader ResourceReader;
+
+//! Creates a reader that caches blocks of a resource in RAM, so that many small reads at nearby
+//! offsets only go to flash once per block. When a read misses the cache, the following block is
+//! read ahead as well, which makes sequential scans cost one flash access per block.
+//! Use this instead of repeated calls to \ref resource_load_byte_range() when indexing into large
+//! custom resources such as lookup tables or dictionaries.
+//! @param h The handle to the resource
+//! @param block_size Size in bytes of each cached block. Larger blocks favor sequential access,
+//! smaller blocks favor scattered access.
+//! @param num_blocks Number of blocks to keep cached. The reader uses roughly
+//! `block_size * num_blocks` bytes of the app heap.
+//! @return A pointer to the new reader, or NULL if there was not enough memory
+ResourceReader *resource_reader_create(ResHandle h, uint16_t block_size, uint8_t num_blocks);
+
+//! Copies bytes from the resource into the buffer, using the reader's block cache.
+//! @param reader The reader created with \ref resource_reader_create()
+//! @param offset The offset in bytes from the start of the resource
+//! @param buffer The buffer to copy the bytes into
+//! @param num_bytes The maximum number of bytes to copy
+//! @return The number of bytes actually copied
+size_t resource_reader_read(
+    ResourceReader *reader, uint32_t offset, uint8_t *buffer, size_t num_bytes);
+
+//! Destroys a reader and frees its block cache.
+//! @param reader The reader to destroy
+void resource_reader_destroy(ResourceReader *reader);
+
+//! Gets a pointer to the data of a resource that is stored in memory-mapped flash, without
+//! copying it to RAM. The returned data is read-only and stays valid as long as the app runs.
+//! On platforms or for resources where flash is not memory-mapped this returns NULL and the
+//! resource must be read with \ref resource_load() or a \ref ResourceReader instead.
+//! @note Lookup tables generated at build time with the `lut_gen.py` tool of the SDK are laid out
+//! to be used in place this way, so the app computes and copies nothing at launch.
+//! @param h The handle to the resource
+//! @param[out] size Optional pointer that receives the size of the resource in bytes
+//! @return A pointer to the resource data, or NULL if the resource is not memory-mapped
+const uint8_t *resource_get_mapped_data(ResHandle h, size_t *size);
+
 //! @} // group Resources
 
 //! @addtogroup App
@@ -2751,6 +4435,66 @@ size_t resource_load_byte_range(
 //! Will block until the app is ready to exit.
 void app_event_loop(void);
 
+//! Priority classes for idle callbacks. Callbacks of a higher class run before callbacks of a
+//! lower class; callbacks within the same class run in the order they were registered.
+typedef enum {
+  //! Work that should run as soon as the app is idle, e.g. preparing the next frame's data
+  AppIdlePriorityHigh = 0,
+  //! Default class for background work
+  AppIdlePriorityNormal,
+  //! Work that can wait, e.g. compacting storage or prefetching
+  AppIdlePriorityLow,
+} AppIdlePriority;
+
+struct AppIdle;
+typedef struct AppIdle AppIdle;
+
+//! The type of function which can be called when the app is idle.
+//! The argument will be the @p context passed to \ref app_idle_register().
+typedef void (*AppIdleCallback)(void *context);
+
+//! Registers a callback that is called once by \ref app_event_loop() when no input, render or
+//! AppMessage events are pending. Use this for expensive work that should not delay the UI, such
+//! as decoding the next image. Keep the callback short; to do more work, register it again from
+//! within the callback.
+//! @param priority The priority class of the callback
+//! @param callback The callback to call when the app is idle
+//! @param context The data that will be passed to callback
+//! @return A pointer to an `AppIdle` that can be used to cancel the callback, or NULL if there
+//! was not enough memory
+AppIdle *app_idle_register(AppIdlePriority priority, AppIdleCallback callback, void *context);
+
+//! Cancels a callback registered with \ref app_idle_register() that has not been called yet.
+//! Once cancelled or called, the handle may no longer be used for any purpose.
+//! @param idle The callback to cancel
+void app_idle_cancel(AppIdle *idle);
+
+//! The type of function that runs as a cooperative task.
+//! The argument will be the @p context passed to \ref app_task_spawn().
+typedef void (*AppTaskHandler)(void *context);
+
+//! Starts a cooperative task that runs on the app thread between events. The task's handler
+//! runs on its own stack, so long computations can be written as a plain loop that calls
+//! \ref app_task_yield() regularly, instead of being split up across timer callbacks.
+//! Each time the task is resumed it may run for up to `slice_ms` milliseconds before
+//! \ref app_task_yield() hands control back to \ref app_event_loop(). Tasks are resumed with
+//! the same priority as \ref AppIdlePriorityNormal idle callbacks, so pending input and render
+//! events are always handled first. The task ends and its stack is freed when the handler
+//! returns.
+//! @param handler The function to run as a task
+//! @param context The data that will be passed to handler
+//! @param stack_size The size in bytes of the task's stack, which is allocated on the app heap
+//! @param slice_ms The time budget in milliseconds of each slice of the task
+//! @return true if the task was started, false if there was not enough memory
+bool app_task_spawn(AppTaskHandler handler, void *context, size_t stack_size, uint16_t slice_ms);
+
+//! Called from within a task's handler to let the app process events. If the current slice's
+//! time budget has been used up, control returns to \ref app_event_loop() and this function
+//! returns once the task is resumed. Otherwise it returns immediately, so it is cheap enough to
+//! call on every iteration of a loop.
+//! @note Calling this outside of a task handler has no effect.
+void app_task_yield(void);
+
 //! @} // group App
 
 //! @addtogroup AppWorker
@@ -2814,6 +4558,103 @@ bool app_worker_message_unsubscribe(void);
 //! @param data the message data structure
 void app_worker_send_message(uint8_t type, AppWorkerMessage *data);
 
+//! The largest ring buffer that can be shared between an app and its worker, in bytes.
+#define APP_WORKER_RING_BUFFER_SIZE_MAXIMUM 4096
+
+struct AppWorkerRingBuffer;
+typedef struct AppWorkerRingBuffer AppWorkerRingBuffer;
+
+//! Callback type for ring buffer data notifications.
+//! @param ring_buffer The ring buffer that received data
+//! @param bytes_available The number of bytes that can currently be read from the ring buffer
+//! @param context The context passed to \ref app_worker_ring_buffer_open()
+typedef void (*AppWorkerRingBufferDataHandler)(AppWorkerRingBuffer *ring_buffer,
+                                               uint32_t bytes_available, void *context);
+
+//! Opens the ring buffer shared between the app and its worker, creating it if the other task
+//! has not opened it yet. The buffer lives in memory reserved by the system outside of the app
+//! and worker heaps, and stays valid while at least one of the two tasks has it open.
+//! The buffer is single-producer, single-consumer: one task writes and the other reads, without
+//! locking. This makes it suitable for streaming sensor batches from a worker to the foreground
+//! app without going through persistent storage.
+//! @param size The size of the buffer in bytes, up to \ref APP_WORKER_RING_BUFFER_SIZE_MAXIMUM.
+//! Ignored if the other task already created the buffer.
+//! @param handler The callback to be executed when the other task writes to the buffer while
+//! it was empty, or NULL for no notifications
+//! @param context The data that will be passed to handler
+//! @return A pointer to the ring buffer, or NULL if it could not be created
+AppWorkerRingBuffer *app_worker_ring_buffer_open(uint32_t size,
+                                                 AppWorkerRingBufferDataHandler handler,
+                                                 void *context);
+
+//! Closes the ring buffer for the calling task. The handle may no longer be used afterwards.
+//! @param ring_buffer The ring buffer to close
+void app_worker_ring_buffer_close(AppWorkerRingBuffer *ring_buffer);
+
+//! Writes data to the ring buffer. Only as many bytes as there is free space are written;
+//! data that is not read yet is never overwritten.
+//! @param ring_buffer The ring buffer to write to
+//! @param data The data to write
+//! @param length The number of bytes to write
+//! @return The number of bytes actually written
+uint32_t app_worker_ring_buffer_write(AppWorkerRingBuffer *ring_buffer, const void *data,
+                                      uint32_t length);
+
+//! Reads and consumes data from the ring buffer.
+//! @param ring_buffer The ring buffer to read from
+//! @param buffer The buffer to copy the data into
+//! @param length The maximum number of bytes to read
+//! @return The number of bytes actually read
+uint32_t app_worker_ring_buffer_read(AppWorkerRingBuffer *ring_buffer, void *buffer,
+                                     uint32_t length);
+
+//! Gets the number of bytes that can currently be read from the ring buffer.
+//! @param ring_buffer The ring buffer to query
+//! @return The number of bytes available to read
+uint32_t app_worker_ring_buffer_get_bytes_available(AppWorkerRingBuffer *ring_buffer);
+
+//! The largest value that can be stored in the area shared between an app and its worker, in
+//! bytes.
+#define APP_WORKER_SHARED_VALUE_MAX_LENGTH 64
+
+//! The total size of all values in the area shared between an app and its worker, in bytes.
+#define APP_WORKER_SHARED_SIZE_MAXIMUM 1024
+
+//! Writes a value to the key-value area shared between the app and its worker. The area lives
+//! in memory reserved by the system, so either task reads the latest values the other one wrote
+//! without accessing flash, for example the worker's daily aggregates for the app's UI. The
+//! values are saved to flash once both tasks have exited, and are loaded again when either one
+//! next reads or writes the area. The keys are separate from those of persistent storage.
+//! @param key The key of the value
+//! @param data The value, or NULL to delete the key
+//! @param size The size of the value in bytes, up to \ref APP_WORKER_SHARED_VALUE_MAX_LENGTH,
+//! or 0 to delete the key
+//! @return true on success, false if the value is too large or the area is full
+bool app_worker_shared_write(uint32_t key, const void *data, size_t size);
+
+//! Reads a value from the key-value area shared between the app and its worker.
+//! @param key The key of the value
+//! @param buffer The buffer to copy the value into
+//! @param buffer_size The size of the buffer in bytes
+//! @return The number of bytes copied into the buffer, or 0 if the key has no value
+int app_worker_shared_read(uint32_t key, void *buffer, size_t buffer_size);
+
+//! Callback type for changes to the area shared between an app and its worker.
+//! @param key The key whose value the other task wrote or deleted
+//! @param context The context passed to \ref app_worker_shared_subscribe()
+typedef void (*AppWorkerSharedChangedHandler)(uint32_t key, void *context);
+
+//! Subscribe to changes the other task makes to the area shared between the app and its worker.
+//! Writes of the calling task do not call the handler. Several writes of the same key before the
+//! handler runs call it once.
+//! @param handler A callback to be executed when the other task writes or deletes a value
+//! @param context The data that will be passed to handler
+//! @return true on success
+bool app_worker_shared_subscribe(AppWorkerSharedChangedHandler handler, void *context);
+
+//! Unsubscribe from changes to the area shared between the app and its worker.
+void app_worker_shared_unsubscribe(void);
+
 //! @} // group AppWorker
 
 //! @addtogroup AppComm App Communication
@@ -2842,6 +4683,11 @@ typedef enum {
   //! the expense of increasing Bluetooth energy consumption by a multiple of 2-5
   //! (very significant)
   SNIFF_INTERVAL_REDUCED = 1,
+  //! Let the OS switch between the reduced and the normal sniff interval: the interval is
+  //! reduced while there are pending \ref AppMessage Outbox messages or inbound messages have
+  //! been received recently, and goes back to normal once the link has been idle for the period
+  //! set with \ref app_comm_set_adaptive_idle_timeout()
+  SNIFF_INTERVAL_ADAPTIVE = 2,
 } SniffInterval;
 
 //! Set the Bluetooth module's sniff interval.
@@ -2854,10 +4700,20 @@ void app_comm_set_sniff_interval(const SniffInterval interval);
 //! @return The SniffInterval value corresponding to the current interval
 SniffInterval app_comm_get_sniff_interval(void);
 
+//! Set how long the Bluetooth link must be idle before the sniff interval goes back to normal
+//! when \ref SNIFF_INTERVAL_ADAPTIVE is used.
+//! @param idle_timeout_ms The idle period in milliseconds. The default is 1000ms.
+void app_comm_set_adaptive_idle_timeout(uint32_t idle_timeout_ms);
+
 //! @} // group AppComm
 
 //! @addtogroup Timer
 //!   \brief Can be used to execute some code at some point in the future.
+//!
+//! Timers are kept in a timer wheel, so registering, rescheduling and cancelling a timer takes
+//! constant time regardless of how many timers the app has running. Timers registered with a
+//! slack (see \ref app_timer_register_with_slack()) may be fired together with other timers
+//! whose deadlines fall within the slack, so that the system wakes up once for all of them.
 //! @{
 
 //! Waits for a certain amount of milliseconds
@@ -2888,6 +4744,19 @@ bool app_timer_reschedule(AppTimer *timer_handle, uint32_t new_timeout_ms);
 //! Once cancelled the handle may no longer be used for any purpose.
 void app_timer_cancel(AppTimer *timer_handle);
 
+//! Registers a timer like \ref app_timer_register(), but allows the system to fire it up to
+//! `slack_ms` milliseconds late. Timers whose deadlines fall within each other's slack are
+//! coalesced into a single wakeup, which saves power when an app runs many timers that do not
+//! need to be exact, such as display refreshes or polling.
+//! @param timeout_ms The expiry time in milliseconds from the current time
+//! @param slack_ms The maximum number of milliseconds the timer may fire after its expiry time
+//! @param callback The callback that gets called at expiry time
+//! @param callback_data The data that will be passed to callback
+//! @return A pointer to an `AppTimer` that can be used to later reschedule or cancel this timer
+//! @note Rescheduling the timer with \ref app_timer_reschedule() keeps its slack.
+AppTimer* app_timer_register_with_slack(uint32_t timeout_ms, uint32_t slack_ms,
+                                        AppTimerCallback callback, void* callback_data);
+
 //! @} // group Timer
 
 //! @addtogroup MemoryManagement Memory Management
@@ -2903,6 +4772,230 @@ size_t heap_bytes_free(void);
 //! @return The number of bytes on the heap currently being used.
 size_t heap_bytes_used(void);
 
+//! Number of buckets in \ref HeapStats.free_block_histogram
+#define HEAP_STATS_HISTOGRAM_BUCKETS 8
+
+//! Detailed statistics about the application's heap
+//! @see \ref heap_get_stats
+typedef struct {
+  //! The number of bytes on the heap not currently being used, see \ref heap_bytes_free
+  size_t bytes_free;
+  //! The number of bytes on the heap currently being used, see \ref heap_bytes_used
+  size_t bytes_used;
+  //! The size of the largest contiguous free block, which is the largest allocation that can
+  //! currently succeed
+  size_t largest_free_block;
+  //! The largest value of `bytes_used` since the application started
+  size_t high_water_mark;
+  //! The number of free blocks. Many free blocks with a small `largest_free_block` indicate
+  //! fragmentation.
+  uint16_t num_free_blocks;
+  //! Number of free blocks by size: bucket `i` counts the blocks of at least `16 << i` bytes and
+  //! less than `16 << (i + 1)` bytes, with the first bucket also counting smaller blocks and the
+  //! last bucket also counting larger blocks.
+  uint16_t free_block_histogram[HEAP_STATS_HISTOGRAM_BUCKETS];
+} HeapStats;
+
+//! Collects detailed statistics about the application's heap, including its fragmentation.
+//! @note This walks the whole heap and is considerably slower than \ref heap_bytes_free.
+//! @param[out] stats The statistics of the heap
+void heap_get_stats(HeapStats *stats);
+
+//! Enables or disables tracking of allocations by call site. While enabled, every allocation is
+//! tagged with the return address of its caller, so that \ref heap_log_allocations can report
+//! which code owns how much memory.
+//! @note Tracking uses a small amount of heap memory per call site and should only be enabled
+//! while debugging.
+//! @param enabled true to start tracking allocations, false to stop and discard the data
+void heap_set_allocation_tracking(bool enabled);
+
+//! Writes the number of live allocations and bytes per tracked call site, together with the
+//! statistics of \ref heap_get_stats, to the app log. Call site addresses can be resolved to
+//! source lines with `arm-none-eabi-addr2line` on the app's ELF file.
+void heap_log_allocations(void);
+
+//! Sets a threshold for `bytes_used` above which a new high water mark is written to the app log
+//! every time it is exceeded.
+//! @param threshold_bytes The threshold in bytes, 0 to disable logging
+void heap_set_high_water_mark_logging(size_t threshold_bytes);
+
+//! Levels of memory pressure on the heap of the application.
+//! @see memory_pressure_subscribe
+typedef enum {
+  //! The heap has more free memory than the low threshold again.
+  MemoryPressureLevelNormal = 0,
+  //! The free memory on the heap dropped below the low threshold. Release what is cheap to
+  //! recreate, such as prefetched data or decoded bitmaps that are not shown.
+  MemoryPressureLevelLow,
+  //! The free memory on the heap dropped below the critical threshold, or an allocation is about
+  //! to fail. Release everything that can be recreated later.
+  MemoryPressureLevelCritical,
+} MemoryPressureLevel;
+
+//! Callback type for memory pressure events
+//! @param level The new level of memory pressure
+//! @param context The context passed to \ref memory_pressure_subscribe
+typedef void (*MemoryPressureHandler)(MemoryPressureLevel level, void *context);
+
+//! Subscribe to memory pressure events, so that an app holding caches can release them before an
+//! allocation fails. The handler is called from the event loop when the free memory on the heap
+//! crosses one of the thresholds, in either direction. In addition, when an allocation cannot be
+//! satisfied, the handler is called with \ref MemoryPressureLevelCritical right away, before
+//! `malloc` returns, and the allocation is tried again once after it returns. The handler must
+//! therefore not allocate memory itself. The caches of the system, such as glyph caches and the
+//! row cache of \ref MenuLayer, are trimmed at the critical level before the handler is called.
+//! @param low_threshold_bytes The free heap in bytes below which \ref MemoryPressureLevelLow is
+//! reported
+//! @param critical_threshold_bytes The free heap in bytes below which
+//! \ref MemoryPressureLevelCritical is reported, at most `low_threshold_bytes`
+//! @param handler A callback to be executed on memory pressure events
+//! @param context A pointer passed to the handler
+//! @return true on success, false if the thresholds are invalid
+bool memory_pressure_subscribe(size_t low_threshold_bytes, size_t critical_threshold_bytes,
+                               MemoryPressureHandler handler, void *context);
+
+//! Unsubscribe from memory pressure events. Once unsubscribed, the previously registered handler
+//! will no longer be called.
+void memory_pressure_unsubscribe(void);
+
+//! Statistics about the stack of the calling task
+//! @see \ref stack_get_stats
+typedef struct {
+  //! The size of the stack in bytes
+  size_t size;
+  //! The number of bytes of the stack currently in use
+  size_t bytes_used;
+  //! The largest number of bytes of the stack that were in use since the task started
+  size_t high_water_mark;
+} StackStats;
+
+//! Collects statistics about the stack of the calling task, which is the app or the worker. The
+//! stack is filled with a known pattern when the task is launched, and the high water mark is
+//! found by scanning for the deepest byte that no longer holds the pattern. Compare it to the
+//! size after exercising the deepest code paths, such as recursive layouts or large local
+//! buffers, to learn how much headroom is left.
+//! @note Scanning takes time proportional to the unused part of the stack, so do not call this
+//! on every frame.
+//! @param[out] stats The statistics of the stack
+void stack_get_stats(StackStats *stats);
+
+//! Writes the statistics of \ref stack_get_stats to the log when the task exits, as a line of the
+//! form `stack: size <bytes> high water mark <bytes>`, which `pebble logs` shows for the app and
+//! its worker.
+//! @param enabled true to log the statistics at exit, false to stop (default)
+void stack_set_exit_logging(bool enabled);
+
+struct ArenaAllocator;
+typedef struct ArenaAllocator ArenaAllocator;
+
+//! Creates an arena on the heap. An arena hands out memory from a single block with no per
+//! allocation overhead, and all of it is released at once with \ref arena_allocator_reset or
+//! \ref arena_allocator_destroy. Use it for objects that share a lifetime, like everything that
+//! belongs to one window.
+//! @param size The number of bytes the arena can hand out
+//! @return A pointer to the arena, `NULL` if it could not be created
+ArenaAllocator *arena_allocator_create(size_t size);
+
+//! Destroys an arena and frees its memory, including all allocations made from it.
+//! @param arena The arena to destroy
+void arena_allocator_destroy(ArenaAllocator *arena);
+
+//! Allocates memory from an arena. The memory is aligned to 4 bytes and cannot be freed
+//! individually.
+//! @param arena The arena to allocate from
+//! @param size The number of bytes to allocate
+//! @return A pointer to the memory, `NULL` if the arena does not have enough space left
+void *arena_allocator_alloc(ArenaAllocator *arena, size_t size);
+
+//! Releases all allocations made from an arena at once, so that its full size can be used again.
+//! @param arena The arena to reset
+void arena_allocator_reset(ArenaAllocator *arena);
+
+//! Calculates the number of bytes that can still be allocated from an arena.
+//! @param arena The arena to query
+//! @return The number of bytes left in the arena
+size_t arena_allocator_bytes_free(const ArenaAllocator *arena);
+
+//! Makes an arena the target of all subsequent allocations of the calling code, including the
+//! memory allocated by system constructors like \ref layer_create_with_data,
+//! \ref text_layer_create or \ref gpath_create, until \ref arena_allocator_pop is called.
+//! Calls to `free` and the matching `_destroy` functions for such objects do not release any
+//! memory; it is reclaimed when the arena is reset or destroyed. Calls can be nested.
+//! @note Objects allocated from an arena must not be used after the arena is reset. Make sure to
+//! remove layers from the layer hierarchy before resetting the arena they were allocated from.
+//! @param arena The arena to allocate from
+void arena_allocator_push(ArenaAllocator *arena);
+
+//! Restores the allocation target that was active before the matching
+//! \ref arena_allocator_push call.
+void arena_allocator_pop(void);
+
+struct PoolAllocator;
+typedef struct PoolAllocator PoolAllocator;
+
+//! Creates a pool of fixed size blocks on the heap. Allocating and freeing blocks from a pool
+//! takes constant time and does not fragment the heap, which makes it well suited for many small
+//! objects of the same type.
+//! @param block_size The size of each block in bytes
+//! @param num_blocks The number of blocks in the pool
+//! @return A pointer to the pool, `NULL` if it could not be created
+PoolAllocator *pool_allocator_create(size_t block_size, uint16_t num_blocks);
+
+//! Destroys a pool and frees its memory, including all blocks allocated from it.
+//! @param pool The pool to destroy
+void pool_allocator_destroy(PoolAllocator *pool);
+
+//! Allocates a block from a pool. The memory is aligned to 4 bytes.
+//! @param pool The pool to allocate from
+//! @return A pointer to the block, `NULL` if all blocks of the pool are in use
+void *pool_allocator_alloc(PoolAllocator *pool);
+
+//! Returns a block to the pool it was allocated from.
+//! @param pool The pool that the block was allocated from
+//! @param block The block to free
+void pool_allocator_free(PoolAllocator *pool, void *block);
+
+//! Marks a function as cold code, such as a settings screen or a configuration parser that runs
+//! rarely. The compiler optimizes cold functions for size, never inlines them and treats the
+//! paths that call them as unlikely, which keeps the code around them compact.
+//! @note Struct version 0x12.0x00 of pebble_process_info.h reserves fields for a separate cold
+//! code section that is not loaded into the app's RAM. Neither the firmware nor the app linker
+//! script of this SDK supports that section yet, so cold functions are part of the loaded code.
+//! \code{.c}
+//! PBL_COLD static void prv_parse_config(DictionaryIterator *iter) {
+//!   ...
+//! }
+//! \endcode
+#define PBL_COLD __attribute__((__cold__, __noinline__))
+
+//! Marks a function as hot code, such as a layer's `.update_proc` or the helpers it calls on every
+//! frame. The compiler optimizes hot functions more aggressively and treats the paths that call
+//! them as likely. The call counts that \ref profiler_print_stats writes for \ref PROFILE_SCOPE
+//! sections are a good guide for which functions to mark.
+//! @note GCC emits hot functions in `.text.hot`, but the app linker script of this SDK does not
+//! group that section at the start of the app's code yet, so marking functions does not change
+//! where they are placed in the binary.
+//! \code{.c}
+//! PBL_HOT static void prv_draw_hands(Layer *layer, GContext *ctx) {
+//!   ...
+//! }
+//! \endcode
+#define PBL_HOT __attribute__((__hot__))
+
+//! Compiles a function with -O2, optimized for speed, while the rest of the app keeps the -Os
+//! that apps are built with to stay small. Use it on the few functions that run for every frame,
+//! usually together with \ref PBL_HOT. GCC only inlines functions into each other if they are
+//! optimized the same way, so mark the small helpers of such a function as well. To compile a
+//! whole file for speed, put `#pragma GCC optimize ("O2")` before its first function instead.
+//! `opt_profile.py suggest` in the SDK tools ranks \ref PROFILE_SCOPE sections by the cycles
+//! they take, and `opt_profile.py sizes` reports the code size this costs on each platform.
+//! \code{.c}
+//! PBL_HOT PBL_OPTIMIZE_SPEED static void prv_draw_hands(Layer *layer, GContext *ctx) {
+//!   ...
+//! }
+//! \endcode
+#define PBL_OPTIMIZE_SPEED __attribute__((__optimize__("O2")))
+
 //! Flushes the data cache and invalidates the instruction cache for the given region of memory,
 //! if necessary. This is only required when your app is loading or modifying code in memory and
 //! intends to execute it. On some platforms, code executed may be cached internally to improve
@@ -2935,6 +5028,11 @@ void memory_cache_flush(void *start, size_t size);
 //! In addition, it draws less power from the battery.
 //!
 //! Note that the size of all persisted values cannot exceed 4K per app.
+//!
+//! Recently read values are kept in a small in-RAM cache, so reading the same key repeatedly does
+//! not access flash every time. To restore many values at startup, use \ref persist_read_many() or
+//! \ref persist_iterate(), which read all requested keys in one pass. State that changes every
+//! few seconds is better saved as records of an append-only log, see \ref persist_log_open().
 //! @{
 
 //! The maximum size of a persist value in bytes
@@ -2943,6 +5041,10 @@ void memory_cache_flush(void *start, size_t size);
 //! The maximum size of a persist string in bytes including the NULL terminator
 #define PERSIST_STRING_MAX_LENGTH PERSIST_DATA_MAX_LENGTH
 
+//! The maximum size of a persist value in bytes before compression, for values written while
+//! compression is enabled, see \ref persist_set_compression()
+#define PERSIST_COMPRESSED_DATA_MAX_LENGTH 1024
+
 //! Status codes. See \ref status_t
 typedef enum StatusCode {
   //! Operation completed successfully.
@@ -3012,6 +5114,14 @@ bool persist_exists(const uint32_t key);
 //! if there is no field matching the given key.
 int persist_get_size(const uint32_t key);
 
+//! Gets the number of bytes a value takes in persistent storage, which is its compressed size if
+//! it was written with compression enabled, see \ref persist_set_compression(). These are the
+//! bytes that count towards the storage limit of the app.
+//! @param key The key of the field to lookup the stored size.
+//! @return The stored size of the value in bytes or \ref E_DOES_NOT_EXIST
+//! if there is no field matching the given key.
+int persist_get_stored_size(const uint32_t key);
+
 //! Reads a bool value for a given key from persistent storage.
 //! If the value has not yet been set, this will return false.
 //! @param key The key of the field to read from.
@@ -3044,6 +5154,43 @@ int persist_read_data(const uint32_t key, void *buffer, const size_t buffer_size
 //! if there is no field matching the given key.
 int persist_read_string(const uint32_t key, char *buffer, const size_t buffer_size);
 
+//! Callback type for \ref persist_iterate().
+//! @param key The key of the field
+//! @param data The value of the field. Only valid until the callback returns.
+//! @param size The size of the value in bytes
+//! @param context Pointer to application data as passed to \ref persist_iterate()
+//! @return true to continue iterating, false to stop
+typedef bool (*PersistIteratorCallback)(const uint32_t key, const void *data, const size_t size,
+                                        void *context);
+
+//! Calls a callback for every key of the app in persistent storage, reading all of them in one
+//! pass over flash. Keys are passed in no particular order.
+//! @param callback The callback to call for each key
+//! @param context Pointer to application data that is passed to the callback
+//! @return \ref S_SUCCESS if all keys were passed, \ref S_NO_MORE_ITEMS if the callback stopped the
+//! iteration, or a value from \ref StatusCode otherwise.
+status_t persist_iterate(PersistIteratorCallback callback, void *context);
+
+//! Describes one value to read with \ref persist_read_many().
+typedef struct {
+  //! The key of the field to read from.
+  uint32_t key;
+  //! The pointer to a buffer to be written to.
+  void *buffer;
+  //! The maximum size of the given buffer.
+  size_t buffer_size;
+  //! Out: the number of bytes written into the buffer or \ref E_DOES_NOT_EXIST if there is no field
+  //! matching the key, as \ref persist_read_data() would return.
+  int result;
+} PersistReadRequest;
+
+//! Reads the values of many keys from persistent storage in one pass over flash, instead of looking
+//! up each key separately.
+//! @param requests The values to read. The `.result` field of each request is set.
+//! @param num_requests The number of elements in `requests`
+//! @return \ref S_SUCCESS if the requests were processed, or a value from \ref StatusCode otherwise.
+status_t persist_read_many(PersistReadRequest *requests, const size_t num_requests);
+
 //! Writes a bool value flag for a given key into persistent storage.
 //! @param key The key of the field to write to.
 //! @param value The boolean value to write.
@@ -3058,7 +5205,8 @@ status_t persist_write_bool(const uint32_t key, const bool value);
 status_t persist_write_int(const uint32_t key, const int32_t value);
 
 //! Writes a blob of data of a specified size in bytes for a given key into persistent storage.
-//! The maximum size is \ref PERSIST_DATA_MAX_LENGTH
+//! The maximum size is \ref PERSIST_DATA_MAX_LENGTH, or \ref PERSIST_COMPRESSED_DATA_MAX_LENGTH
+//! while compression is enabled, see \ref persist_set_compression().
 //! @param key The key of the field to write to.
 //! @param data The pointer to the blob of data.
 //! @param size The size in bytes.
@@ -3076,6 +5224,158 @@ int persist_write_string(const uint32_t key, const char *cstring);
 //! @param key The key of the field to delete from.
 status_t persist_delete(const uint32_t key);
 
+//! Sets whether values are compressed when they are written to persistent storage. While
+//! compression is enabled, \ref persist_write_data(), \ref persist_write_string() and persist
+//! blobs store values LZ4 compressed if that makes them smaller, which typically halves the
+//! size of cached text. Values are decompressed by the read functions transparently, and
+//! \ref persist_get_size() keeps returning their uncompressed size, so code that reads values
+//! does not change. Writing fewer bytes also makes writes faster.
+//! @note Values written while compression is enabled may be up to
+//! \ref PERSIST_COMPRESSED_DATA_MAX_LENGTH bytes long, as long as they compress to at most
+//! \ref PERSIST_DATA_MAX_LENGTH bytes; otherwise \ref E_RANGE is returned. Integers and bools are
+//! never compressed. Compressed values can be read whether or not compression is enabled, so it
+//! can be turned on in an update of an app without migrating its existing values.
+//! @param enabled true to compress values written from now on, false to store them as they are
+//! (default)
+void persist_set_compression(const bool enabled);
+
+struct PersistBlob;
+typedef struct PersistBlob PersistBlob;
+
+//! Values that are used to indicate how a persist blob is opened.
+//! @see persist_blob_open
+typedef enum {
+  //! Open the existing value of the key for reading.
+  PersistBlobModeRead = 0,
+  //! Create a new value for the key, replacing the existing value when the blob is closed.
+  PersistBlobModeWrite,
+} PersistBlobMode;
+
+//! Opens the value of a key in persistent storage as a blob, for reading or writing values that
+//! are larger than \ref PERSIST_DATA_MAX_LENGTH in multiple steps. A blob that was opened for
+//! writing is committed with a single flash operation when it is closed, so cached data like
+//! forecasts does not have to be sharded across many keys.
+//! @note Blobs count towards the total size of all persisted values of the app.
+//! \ref persist_get_size() returns the size of a blob, and \ref persist_read_data() reads its first
+//! `buffer_size` bytes.
+//! @note Only one blob can be open for writing at a time.
+//! @param key The key of the field to open.
+//! @param mode Whether to open the blob for reading or writing
+//! @return A handle to the blob, or NULL if the key does not exist (when reading), another blob
+//! is already open for writing, or there is not enough memory.
+PersistBlob *persist_blob_open(const uint32_t key, const PersistBlobMode mode);
+
+//! Reads the next bytes of a blob that was opened with \ref PersistBlobModeRead.
+//! @param blob The blob to read from.
+//! @param buffer The pointer to a buffer to be written to.
+//! @param buffer_size The maximum number of bytes to read.
+//! @return The number of bytes written into the buffer, which is 0 at the end of the blob, or a
+//! value from \ref StatusCode otherwise.
+int persist_blob_read(PersistBlob *blob, void *buffer, const size_t buffer_size);
+
+//! Appends bytes to a blob that was opened with \ref PersistBlobModeWrite. The data is not visible
+//! to readers of the key until the blob is closed.
+//! @param blob The blob to write to.
+//! @param data The pointer to the data to append.
+//! @param size The size in bytes.
+//! @return The number of bytes written if successful, a value from \ref StatusCode otherwise,
+//! such as \ref E_OUT_OF_STORAGE.
+int persist_blob_write(PersistBlob *blob, const void *data, const size_t size);
+
+//! Closes a blob. If the blob was opened for writing, the written data replaces the value of the
+//! key atomically.
+//! @param blob The blob to close.
+//! @return \ref S_SUCCESS if successful, a value from \ref StatusCode otherwise.
+status_t persist_blob_close(PersistBlob *blob);
+
+//! Begins a transaction of persistent storage writes. Until \ref persist_transaction_commit() is
+//! called, the writes and deletes of the app are collected in memory instead of being written to
+//! flash one at a time. Reads during the transaction return the values that have been written in
+//! it. Saving many values on exit is faster this way and causes less flash wear.
+//! @note If the app exits before the transaction is committed, the transaction is discarded.
+//! Transactions cannot be nested.
+//! @return \ref S_SUCCESS if successful, or \ref E_INVALID_OPERATION if a transaction is already
+//! in progress.
+status_t persist_transaction_begin(void);
+
+//! Commits the current transaction of persistent storage writes with a single journaled flash
+//! operation. Either all writes of the transaction become visible or, if the watch resets during
+//! the commit, none of them do.
+//! @return \ref S_SUCCESS if successful, or a value from \ref StatusCode otherwise, such as
+//! \ref E_OUT_OF_STORAGE, in which case none of the writes are applied.
+status_t persist_transaction_commit(void);
+
+//! Discards the current transaction of persistent storage writes, without applying any of them.
+void persist_transaction_abort(void);
+
+struct PersistLog;
+typedef struct PersistLog PersistLog;
+
+//! Opens an append-only log in persistent storage, creating it if the key does not exist yet.
+//! Logs suit data that is saved often and read rarely, such as a journal of step counts or the
+//! moves of a game for a replay: appending a record only programs the bytes of that record
+//! instead of rewriting a whole value like \ref persist_write_data() does, and the log's pages
+//! are used in turn, so that saving every few seconds spreads the flash wear evenly. Records
+//! are numbered by a sequence number that starts at 0 and increases with each append.
+//! When the log is full, appending drops the oldest records to make room.
+//! @note Logs count towards the total size of all persisted values of the app with their
+//! capacity. The key of a log cannot be used with the other persist functions, except
+//! \ref persist_exists() and \ref persist_delete(), which deletes the whole log.
+//! @param key The key of the log
+//! @param capacity The number of bytes to keep records in, rounded up to a multiple of 256. Each
+//! record takes 4 bytes more than its data. Ignored if the log already exists.
+//! @return A handle to the log, or NULL if the key holds another kind of value, or there is not
+//! enough storage or memory.
+PersistLog *persist_log_open(const uint32_t key, const size_t capacity);
+
+//! Appends a record to a log. The record is on flash when the function returns, so it survives
+//! the app being killed or the watch resetting.
+//! @param log The log to append to
+//! @param data The data of the record
+//! @param size The size of the data, at most \ref PERSIST_DATA_MAX_LENGTH bytes
+//! @return \ref S_SUCCESS if successful, or a value from \ref StatusCode otherwise, such as
+//! \ref E_RANGE if `size` is too large.
+status_t persist_log_append(PersistLog *log, const void *data, const size_t size);
+
+//! Callback type for \ref persist_log_iterate().
+//! @param sequence The sequence number of the record
+//! @param data The data of the record, only valid during the callback
+//! @param size The size of the data
+//! @param context Pointer to application data as passed to \ref persist_log_iterate()
+//! @return true to read the next record, false to stop
+typedef bool (*PersistLogIteratorCallback)(uint32_t sequence, const void *data, size_t size,
+                                           void *context);
+
+//! Reads the records of a log in the order they were appended.
+//! @param log The log to read
+//! @param first_sequence The sequence number to start at. Older records are skipped, which
+//! makes it cheap to resume reading where an earlier iteration stopped.
+//! @param callback Called for each record
+//! @param context Pointer to application data that is passed to the callback
+//! @return \ref S_SUCCESS if all records were read or the callback stopped the iteration, or a
+//! value from \ref StatusCode otherwise.
+status_t persist_log_iterate(PersistLog *log, const uint32_t first_sequence,
+                             PersistLogIteratorCallback callback, void *context);
+
+//! Discards the records of a log up to and including a sequence number, for example once they
+//! have been uploaded to the phone. Discarding only marks the records; their flash pages are
+//! erased and reused by the next compaction.
+//! @param log The log to trim
+//! @param last_sequence The sequence number of the last record to discard
+//! @return \ref S_SUCCESS if successful, or a value from \ref StatusCode otherwise.
+status_t persist_log_trim(PersistLog *log, const uint32_t last_sequence);
+
+//! Compacts a log now, erasing the pages that only hold discarded records. The system compacts
+//! logs by itself while the watch is idle, so this only needs to be called before appending a
+//! burst of records that should not drop the oldest ones.
+//! @param log The log to compact
+//! @return \ref S_SUCCESS if successful, or a value from \ref StatusCode otherwise.
+status_t persist_log_compact(PersistLog *log);
+
+//! Closes a log. Records that were appended stay in storage.
+//! @param log The log to close
+void persist_log_close(PersistLog *log);
+
 //! @} // group Storage
 
 //! @addtogroup Wakeup
@@ -3109,6 +5409,26 @@ void wakeup_service_subscribe(WakeupHandler handler);
 //! E_INTERNAL if a system error occurred during scheduling.
 WakeupId wakeup_schedule(time_t timestamp, int32_t cookie, bool notify_if_missed);
 
+//! Registers a wakeup event that may trigger at any time within a window around the requested
+//! time. This lets the system batch the wakeup with other activity, such as phone sync or other
+//! apps' wakeups, instead of waking the watch and radio once for each. Use this for periodic
+//! refreshes that do not need to happen at an exact time.
+//! The 1 minute duration window of \ref wakeup_schedule() only applies to the part of the
+//! window that does not overlap with other flexible wakeup events, so flexible events are less
+//! likely to fail with E_RANGE.
+//! @param timestamp The requested time (UTC) for the wakeup event to occur
+//! @param window_before_s How many seconds before `timestamp` the wakeup event may occur
+//! @param window_after_s How many seconds after `timestamp` the wakeup event may occur
+//! @param cookie The application specific reason for the wakeup event
+//! @param notify_if_missed On powering on Pebble, will alert user when
+//! notifications were missed due to Pebble being off.
+//! @return negative values indicate errors (StatusCode), with the same meanings as for
+//! \ref wakeup_schedule(). \ref wakeup_query() reports the requested time until the event has
+//! occurred.
+WakeupId wakeup_schedule_with_window(time_t timestamp, uint16_t window_before_s,
+                                     uint16_t window_after_s, int32_t cookie,
+                                     bool notify_if_missed);
+
 //! Cancels a wakeup event.
 //! @param wakeup_id Wakeup event to cancel
 void wakeup_cancel(WakeupId wakeup_id);
@@ -3160,6 +5480,7 @@ typedef enum {
   APP_LAUNCH_QUICK_LAUNCH, //!< App launched by user using quick launch
   APP_LAUNCH_TIMELINE_ACTION,  //!< App launched by user opening it from a pin
   APP_LAUNCH_SMARTSTRAP,  //!< App launched by a smartstrap
+  APP_LAUNCH_RESUME,      //!< App relaunched with a snapshot to restore, see app_snapshot_save()
 } AppLaunchReason;
 
 //! Provides the method used to launch the current application.
@@ -3172,6 +5493,39 @@ AppLaunchReason launch_reason(void);
 //! @return The argument passed to the app, or 0 if the app wasn't launched from a Launch App action
 uint32_t launch_get_args(void);
 
+//! Timestamps of the phases of the current launch of the app, in milliseconds since the system
+//! started launching it, such as when the user selected it in the launcher.
+//! @see launch_get_timing
+typedef struct {
+  //! How the app was launched, as \ref launch_reason() returns
+  AppLaunchReason reason;
+  //! The app's binary was copied from flash into the app's RAM
+  uint16_t loaded_ms;
+  //! The binary was relocated and its data and bss sections initialized
+  uint16_t relocated_ms;
+  //! `main` was called
+  uint16_t main_ms;
+  //! The first window was pushed onto the window stack
+  uint16_t first_push_ms;
+  //! The first frame of the app was shown on the display, which is the time the user waits
+  uint16_t first_frame_ms;
+} LaunchTiming;
+
+//! Gets the timestamps of the phases of the current launch of the app, to find out where the
+//! time from the launch to the first frame goes. The gap between `main_ms` and `first_push_ms`
+//! is the app's own initialization, and the gap from `first_push_ms` to `first_frame_ms` is its
+//! first layout and render, while the phases before `main_ms` grow with the size of the binary.
+//! @param[out] timing The timestamps
+//! @return true if the first frame was shown and `timing` was filled in, false otherwise
+bool launch_get_timing(LaunchTiming *timing);
+
+//! Writes the timestamps of \ref launch_get_timing to the app log once the first frame is shown,
+//! as a line of the form `launch: reason <n> loaded <ms>ms relocated <ms>ms main <ms>ms
+//! push <ms>ms frame <ms>ms`. `pebble logs` shows the line, and the `launch_timing.py` tool in
+//! the SDK summarizes it over many launches. Call this in `main`, before the first frame.
+//! @param enabled true to log the timestamps of each launch, false to stop (default)
+void launch_set_timing_logging(bool enabled);
+
 //! @} // group LaunchReason
 
 //! @addtogroup ExitReason Exit Reason
@@ -3197,6 +5551,33 @@ typedef enum AppExitReason {
 //! @param reason The new app exit reason
 void exit_reason_set(AppExitReason exit_reason);
 
+//! The largest snapshot of its state that an app can save, in bytes.
+//! @see app_snapshot_save
+#define APP_SNAPSHOT_MAX_SIZE 2048
+
+//! Saves a snapshot of the state of the app for a fast resume, typically from the deinit code
+//! that runs after the event loop returns, next to \ref exit_reason_set(). The system keeps
+//! the snapshot in memory for a few minutes. If the user comes back to the app in that time, it is
+//! launched with \ref APP_LAUNCH_RESUME and can restore the snapshot with
+//! \ref app_snapshot_restore() instead of rebuilding its state, such as data synced from the
+//! phone, scroll positions or the windows that were open. Going back and forth between a
+//! watchface and the app then skips the full initialization.
+//! @note A snapshot is discarded when the app is updated, when the watch resets, and when
+//! another app's snapshot needs the memory, so apps must always be able to initialize without
+//! one. Store pointers as offsets or IDs; the heap is laid out differently after a resume.
+//! @param data The state to save
+//! @param size The size of the state in bytes, up to \ref APP_SNAPSHOT_MAX_SIZE
+//! @return true if the snapshot was saved, false if it is too large
+bool app_snapshot_save(const void *data, size_t size);
+
+//! Restores the snapshot the app saved with \ref app_snapshot_save() when it last exited. The
+//! snapshot is consumed, so a second call returns 0.
+//! @param buffer The buffer to copy the snapshot into
+//! @param buffer_size The size of the buffer in bytes
+//! @return The number of bytes copied into the buffer, or 0 if there is no snapshot, which is
+//! always the case unless \ref launch_reason() is \ref APP_LAUNCH_RESUME
+size_t app_snapshot_restore(void *buffer, size_t buffer_size);
+
 //! @} // group ExitReason
 
 //! @addtogroup AppGlance App Glance
@@ -3248,6 +5629,8 @@ typedef enum AppGlanceResult {
   APP_GLANCE_RESULT_EXPIRES_IN_THE_PAST = 1 << 4,
   //! The \ref AppGlanceReloadSession provided was invalid.
   APP_GLANCE_RESULT_INVALID_SESSION = 1 << 5,
+  //! No slice with the provided expiration_time exists in the app's glance.
+  APP_GLANCE_RESULT_SLICE_NOT_FOUND = 1 << 6,
 } AppGlanceResult;
 
 struct AppGlanceReloadSession;
@@ -3274,6 +5657,28 @@ typedef void (*AppGlanceReloadCallback)(AppGlanceReloadSession *session, size_t
 //! @param context User-provided context that will be passed to the callback
 void app_glance_reload(AppGlanceReloadCallback callback, void *context);
 
+//! Add a slice to the end of the app's glance without reloading the existing slices. Unlike
+//! \ref app_glance_add_slice, this can be called at any time and does not need an
+//! \ref AppGlanceReloadSession, which makes it cheap to keep frequently updated glances fresh.
+//! @param slice The slice to add to the app's glance
+//! @return The result of trying to add the slice to the app's glance
+AppGlanceResult app_glance_append_slice(AppGlanceSlice slice);
+
+//! Replace the slice in the app's glance that has the given expiration time, keeping its
+//! position in the glance. The other slices are left untouched.
+//! @param expiration_time The expiration_time of the slice to replace
+//! @param slice The new slice; its expiration_time may differ from the replaced slice's
+//! @return The result of trying to replace the slice, or
+//! \ref APP_GLANCE_RESULT_SLICE_NOT_FOUND if no slice has the given expiration time
+AppGlanceResult app_glance_replace_slice(time_t expiration_time, AppGlanceSlice slice);
+
+//! Remove the slice that has the given expiration time from the app's glance before it expires.
+//! The other slices are left untouched.
+//! @param expiration_time The expiration_time of the slice to remove
+//! @return \ref APP_GLANCE_RESULT_SUCCESS if the slice was removed, or
+//! \ref APP_GLANCE_RESULT_SLICE_NOT_FOUND if no slice has the given expiration time
+AppGlanceResult app_glance_remove_slice(time_t expiration_time);
+
 //! @} // group AppGlance
 
 //! @} // group Foundation
@@ -3310,6 +5715,70 @@ bool gcolor_equal(GColor8 x, GColor8 y);
 //! @return A legible color for the given background color
 GColor8 gcolor_legible_over(GColor8 background_color);
 
+//! Convert RGBA to the `argb` value of a GColor. Unlike \ref GColorFromRGBA, this is an integer
+//! constant expression when its arguments are, so it can be used in `case` labels, in the
+//! initializers of static tables of `uint8_t`, and as a `constexpr` value in C++ code, where the
+//! compound literal of \ref GColorFromRGBA is not valid. The channels are converted the same way.
+//! @param red Red value from 0 - 255
+//! @param green Green value from 0 - 255
+//! @param blue Blue value from 0 - 255
+//! @param alpha Alpha value from 0 - 255
+#define GColorARGB8FromRGBA(red, green, blue, alpha) \
+  ((uint8_t)((((alpha) & 0xff) >> 6) << 6 | (((red) & 0xff) >> 6) << 4 | \
+             (((green) & 0xff) >> 6) << 2 | (((blue) & 0xff) >> 6)))
+
+//! Convert RGB to the `argb` value of an opaque GColor, see \ref GColorARGB8FromRGBA.
+#define GColorARGB8FromRGB(red, green, blue) GColorARGB8FromRGBA(red, green, blue, 255)
+
+//! Convert a hex integer to the `argb` value of an opaque GColor, see \ref GColorARGB8FromRGBA.
+#define GColorARGB8FromHEX(v) GColorARGB8FromRGB((v) >> 16, (v) >> 8, (v))
+
+//! Converts an array of 24-bit colors, 3 bytes of red, green and blue per color as decoded
+//! images and most color pickers produce them, to opaque GColors. The colors are converted the
+//! same way as with \ref GColorFromRGB, but several at a time with word-sized loads, which is
+//! considerably faster than a loop over \ref GColorFromRGB for palettes and image rows.
+//! @param rgb The colors to convert, `3 * count` bytes
+//! @param[out] colors The converted colors, `count` entries. May not overlap `rgb`.
+//! @param count The number of colors to convert
+void gcolor_from_rgb888(const uint8_t *rgb, GColor8 *colors, size_t count);
+
+//! Converts an array of hex integers like `0x64ff46`, as settings pages send colors, to opaque
+//! GColors. The colors are converted the same way as with \ref GColorFromHEX.
+//! @param hex The colors to convert
+//! @param[out] colors The converted colors, `count` entries
+//! @param count The number of colors to convert
+void gcolor_from_hex(const uint32_t *hex, GColor8 *colors, size_t count);
+
+//! Number of entries in each of the blend tables returned by \ref gcolor_blend_table().
+#define GCOLOR_BLEND_TABLE_SIZE (64 * 64)
+
+//! Blends a color over another according to the alpha value of the source color, the same way
+//! \ref GBlendModeAlpha does when drawing.
+//! @param src_color The color to blend. Its alpha value selects how much of it is applied:
+//! fully (3), two thirds (2), one third (1) or not at all (0).
+//! @param dest_color The color to blend over. Its alpha value is ignored.
+//! @return The blended color, which is always opaque
+//! @note This is a lookup in the tables of \ref gcolor_blend_table() rather than a per-channel
+//! multiply.
+GColor8 gcolor_blend(GColor8 src_color, GColor8 dest_color);
+
+//! Returns the system's precomputed table for blending the 64 opaque colors over each other at
+//! the given alpha value. Use it to blend many pixels in your own drawing code without any
+//! arithmetic:
+//! \code{.c}
+//! const uint8_t *table = gcolor_blend_table(2);
+//! GColor8 blended = (GColor8) {
+//!   .argb = table[((src.argb & 0x3f) << 6) | (dest.argb & 0x3f)]
+//! };
+//! \endcode
+//! The table is stored in the firmware and costs no app memory.
+//! @param alpha The alpha value of the source color, 1 or 2. An alpha value of 0 leaves the
+//! destination color and 3 replaces it, so neither needs a table.
+//! @return A table of \ref GCOLOR_BLEND_TABLE_SIZE opaque colors in `argb` format, indexed by the
+//! six color bits of the source color followed by those of the destination color, or `NULL` if
+//! alpha is not 1 or 2
+const uint8_t *gcolor_blend_table(uint8_t alpha);
+
 //! Convenience macro allowing use of a fallback color for black and white platforms.
 //! On color platforms, the first expression will be chosen, the second otherwise.
 #define COLOR_FALLBACK(color, bw) (color)
@@ -3453,6 +5922,8 @@ typedef enum GBitmapFormat {
   GBitmapFormat2BitPalette,
   GBitmapFormat4BitPalette,
   GBitmapFormat8BitCircular,
+  GBitmapFormatRLESprite, //<! Read-only run-length encoded sprite, see \ref RLESpriteFileFormat.
+  GBitmapFormatCompressed, //<! Read-only compressed bitmap, see \ref CompressedBitmapFileFormat.
 } GBitmapFormat;
 
 struct GBitmap;
@@ -3480,7 +5951,9 @@ GBitmapFormat gbitmap_get_format(const GBitmap *bitmap);
 //! Get a pointer to the raw image data section of the given \ref GBitmap as specified by the format
 //! of the bitmap.
 //! @param bitmap A pointer to the GBitmap to get the data
-//! @return pointer to the raw image data for the GBitmap
+//! @return pointer to the raw image data for the GBitmap, `NULL` for bitmaps of the format
+//! \ref GBitmapFormatRLESprite whose encoded data remains in flash and for bitmaps of the format
+//! \ref GBitmapFormatCompressed
 //! @see \ref gbitmap_get_bytes_per_row
 //! @see \ref GBitmap
 uint8_t* gbitmap_get_data(const GBitmap *bitmap);
@@ -3522,6 +5995,11 @@ GColor* gbitmap_get_palette(const GBitmap *bitmap);
 //! bitmap's format.
 //! @param free_on_destroy Set whether the palette data should be freed when the GBitmap is
 //! destroyed or when another palette is set.
+//! @note For \ref GBitmapFormat1BitPalette, \ref GBitmapFormat2BitPalette and
+//! \ref GBitmapFormat4BitPalette bitmaps, an expansion table that maps each source byte to its
+//! 8 / 4 / 2 output pixels is built from the palette when it is first drawn, so that the blitter
+//! does not resolve the palette for every pixel. If you modify the colors of the palette in place,
+//! call this function again with the same palette to rebuild that table.
 //! @see \ref gbitmap_get_format
 //! @see \ref gbitmap_destroy
 //! @see \ref gbitmap_set_palette
@@ -3529,11 +6007,57 @@ void gbitmap_set_palette(GBitmap *bitmap, GColor *palette, bool free_on_destroy)
 
 //! Creates a new \ref GBitmap on the heap using a Pebble image file stored as a resource.
 //! The resulting GBitmap must be destroyed using \ref gbitmap_destroy().
+//! @note For resources of type "rle", the pixel data is not loaded into RAM. The resulting
+//! GBitmap has the format \ref GBitmapFormatRLESprite and is decoded from flash while drawing.
+//! Resources of type "compressed" are loaded into RAM as they are, as a bitmap of the format
+//! \ref GBitmapFormatCompressed that is decoded while drawing.
 //! @param resource_id The ID of the bitmap resource to load
 //! @return A pointer to the \ref GBitmap. `NULL` if the GBitmap could not
 //! be created
 GBitmap* gbitmap_create_with_resource(uint32_t resource_id);
 
+//! Creates a compressed copy of a bitmap on the heap, in the format described by
+//! \ref CompressedBitmapFileFormat. Use this to keep bitmaps that were generated at runtime, or
+//! loaded from PNG data, resident at a fraction of their size. The original bitmap can be
+//! destroyed afterwards. The resulting GBitmap must be destroyed using \ref gbitmap_destroy().
+//! @note Compressing takes a few milliseconds for a full-screen bitmap, so do it once after
+//! creating the bitmap rather than while drawing.
+//! @param bitmap The bitmap to compress. Supported formats are \ref GBitmapFormat1Bit and
+//! \ref GBitmapFormat8Bit.
+//! @return A pointer to the new bitmap of format \ref GBitmapFormatCompressed, or `NULL` if the
+//! format is not supported or there was not enough memory
+GBitmap* gbitmap_create_compressed(const GBitmap *bitmap);
+
+struct GBitmapLoad;
+typedef struct GBitmapLoad GBitmapLoad;
+
+//! Called when a bitmap requested with \ref gbitmap_create_with_resource_async() is ready.
+//! @param bitmap The loaded bitmap, which the handler takes ownership of and must eventually
+//! destroy with \ref gbitmap_destroy(), or `NULL` if it could not be loaded
+//! @param context The context passed to \ref gbitmap_create_with_resource_async()
+typedef void (*GBitmapLoadedHandler)(GBitmap *bitmap, void *context);
+
+//! Loads a bitmap resource without blocking the app. Reading and decoding the resource, which
+//! can take tens of milliseconds for large PNG images, happens in the background: PNG decoding
+//! runs in the system while the app keeps handling events and drawing, and other resource types
+//! are read in short slices while the app's event loop is idle. The handler is called from the
+//! app's event loop once the bitmap is ready. Loads are processed one at a time, in the order in
+//! which they were requested.
+//! @param resource_id The ID of the bitmap resource to load
+//! @param handler The handler to call with the bitmap
+//! @param context A pointer passed to the handler
+//! @return A handle for \ref gbitmap_load_cancel(), valid until the handler has been called.
+//! `NULL` if the load could not be started, in which case the handler is not called.
+//! @see \ref bitmap_layer_set_bitmap_with_resource_async
+GBitmapLoad* gbitmap_create_with_resource_async(uint32_t resource_id,
+                                                GBitmapLoadedHandler handler, void *context);
+
+//! Cancels a load started with \ref gbitmap_create_with_resource_async(). The handler of the load
+//! is not called and no bitmap is created. Cancel the loads of a window from its `.unload`
+//! handler if their handlers refer to the window.
+//! @param load The load to cancel. Must not be used after its handler has been called.
+void gbitmap_load_cancel(GBitmapLoad *load);
+
 //! Creates a new GBitmap on the heap initialized with the provided Pebble image data.
 //!
 //! The resulting \ref GBitmap must be destroyed using \ref gbitmap_destroy() but the image
@@ -3563,6 +6087,9 @@ GBitmap* gbitmap_create_with_data(const uint8_t *data);
 //! bounds of the base bitmap will be used to clip `sub_rect`.
 //! @return A pointer to the \ref GBitmap. `NULL` if the GBitmap could not
 //! be created
+//! @note Icons loaded as sub-bitmaps of one bitmap resource take a single resource load and heap
+//! block between them. The `sprite_atlas.py` tool in the SDK packs the icons listed in a bitmap
+//! resource's "sprites" into such a bitmap for each platform, and generates their `sub_rect`s.
 GBitmap* gbitmap_create_as_sub_bitmap(const GBitmap *base_bitmap, GRect sub_rect);
 
 //! Create a \ref GBitmap based on raw PNG data.
@@ -3601,6 +6128,42 @@ GBitmap* gbitmap_create_blank(GSize size, GBitmapFormat format);
 GBitmap* gbitmap_create_blank_with_palette(GSize size, GBitmapFormat format,
                                            GColor *palette, bool free_on_destroy);
 
+//! Number of bytes a \ref GBitmap header takes in the storage passed to
+//! \ref gbitmap_init_blank(), ahead of its pixel data.
+#define GBITMAP_HEADER_SIZE 32
+
+//! Calculates the storage \ref gbitmap_init_blank() needs for a bitmap: the \ref GBitmap header,
+//! the pixel data with rows padded as for \ref gbitmap_create_blank(), and the palette of
+//! palettized formats.
+//! @param size The Pebble image dimensions as a \ref GSize.
+//! @param format The \ref GBitmapFormat of the bitmap.
+//! @return The number of bytes needed, 0 if the format cannot be used with
+//! \ref gbitmap_init_blank()
+size_t gbitmap_get_blank_storage_size(GSize size, GBitmapFormat format);
+
+//! Creates a blank GBitmap, initialized to zeroes, inside caller-provided storage instead of on
+//! the heap. The \ref GBitmap header, the pixel data and the palette of palettized formats are
+//! all placed in `storage`, so creating and dropping temporary bitmaps, for example from an
+//! \ref ArenaAllocator or a static buffer reused every frame, never allocates or fragments the
+//! heap.
+//! \code{.c}
+//! static uint8_t s_scratch[GBITMAP_HEADER_SIZE + 64 * 64] __attribute__((aligned(4)));
+//! GBitmap *scratch = gbitmap_init_blank(s_scratch, sizeof(s_scratch), GSize(64, 64),
+//!                                       GBitmapFormat8Bit);
+//! \endcode
+//! The bitmap must not be passed to \ref gbitmap_destroy(). It is no longer valid once the
+//! storage is reused or freed.
+//! @param storage Memory for the bitmap, aligned to 4 bytes
+//! @param storage_size The size of `storage` in bytes, at least
+//! \ref gbitmap_get_blank_storage_size() for the same size and format
+//! @param size The Pebble image dimensions as a \ref GSize.
+//! @param format The \ref GBitmapFormat the created image should be in. Palettized formats get a
+//! palette of all black colors.
+//! @return A pointer to the \ref GBitmap, which is `storage`. `NULL` if `storage` is too small
+//! or not aligned, or the format cannot be used
+GBitmap* gbitmap_init_blank(void *storage, size_t storage_size, GSize size,
+                            GBitmapFormat format);
+
 //! Given a 1-bit GBitmap, create a new bitmap of format GBitmapFormat1BitPalette.
 //! The new data buffer is allocated on the heap, and a 2-color palette is allocated as well.
 //! @param src_bitmap A GBitmap of format GBitmapFormat1Bit which is to be copied into a newly
@@ -3620,6 +6183,32 @@ GBitmap* gbitmap_create_palettized_from_1bit(const GBitmap *src_bitmap);
 //! after calling gbitmap_destroy().
 void gbitmap_destroy(GBitmap* bitmap);
 
+//! Gets a shared \ref GBitmap for a bitmap resource, loading it only if it is not loaded yet.
+//! Bitmaps obtained with this function are reference counted and keyed by resource ID, so
+//! windows that use the same resource share a single decoded copy on the heap. Each call must be
+//! balanced with a call to \ref gbitmap_release(); the bitmap is freed when the last reference
+//! is released.
+//! Sub-bitmaps created with \ref gbitmap_create_as_sub_bitmap() from a shared bitmap hold a
+//! reference to it, so the shared bitmap stays available until all of its sub-bitmaps have been
+//! destroyed as well.
+//! @note The shared bitmap must not be modified, for example with \ref gbitmap_set_data() or
+//! \ref gbitmap_set_palette(), as other users see the same bitmap.
+//! @param resource_id The ID of the bitmap resource to load
+//! @return A pointer to the shared \ref GBitmap. `NULL` if the GBitmap could not
+//! be created
+GBitmap* gbitmap_acquire_with_resource(uint32_t resource_id);
+
+//! Adds a reference to a shared \ref GBitmap obtained with \ref gbitmap_acquire_with_resource().
+//! @param bitmap The shared bitmap
+//! @return The same bitmap, for convenience
+GBitmap* gbitmap_retain(GBitmap *bitmap);
+
+//! Releases a reference to a shared \ref GBitmap obtained with
+//! \ref gbitmap_acquire_with_resource() or \ref gbitmap_retain(). The bitmap is destroyed when
+//! the last reference is released. Shared bitmaps must not be passed to \ref gbitmap_destroy().
+//! @param bitmap The shared bitmap
+void gbitmap_release(GBitmap *bitmap);
+
 //! Creates a GBitmapSequence from the specified resource (APNG/PNG files)
 //! @param resource_id Resource to load and create GBitmapSequence from.
 //! @return GBitmapSequence pointer if the resource was loaded, NULL otherwise
@@ -3695,6 +6284,50 @@ void gbitmap_sequence_set_play_count(GBitmapSequence *bitmap_sequence, uint32_t
 //! @return Dimensions required to render the bitmap sequence to a GBitmap
 GSize gbitmap_sequence_get_bitmap_size(GBitmapSequence *bitmap_sequence);
 
+//! Values to specify how a buffered \ref GBitmapSequence catches up when decoding falls behind the
+//! elapsed time passed to \ref gbitmap_sequence_update_bitmap_by_elapsed.
+//! @see \ref gbitmap_sequence_set_frame_skip_policy
+typedef enum GBitmapSequenceFrameSkipPolicy {
+  //! Every frame is decoded and shown, even if this delays the animation. This is the default.
+  GBitmapSequenceFrameSkipPolicyNone = 0,
+  //! Frames whose display time has already passed once decoding could start are dropped, so the
+  //! animation stays in sync with the elapsed time at the cost of skipped frames.
+  GBitmapSequenceFrameSkipPolicyDropLate,
+} GBitmapSequenceFrameSkipPolicy;
+
+//! Enables decode-ahead for the bitmap sequence using a caller-provided pool of bitmaps.
+//! Once a pool is set, the system decodes upcoming frames into the free bitmaps of the pool while
+//! the app's event loop is idle, so the next frame is usually ready before it is needed.
+//! Use \ref gbitmap_sequence_get_next_frame to retrieve decoded frames.
+//! The pool is not copied and the bitmaps are not destroyed by the bitmap sequence; they must
+//! stay valid until the pool is cleared or the bitmap sequence is destroyed.
+//! @param bitmap_sequence Pointer to loaded bitmap sequence
+//! @param bitmaps Array of bitmaps, each large enough to accommodate the bitmap_sequence image
+//! (see \ref gbitmap_sequence_get_bitmap_size). Pass `NULL` to disable decode-ahead.
+//! @param num_bitmaps Number of bitmaps in the array, usually 2 (double buffering) or 3 (triple
+//! buffering).
+//! @return True if decode-ahead has been enabled (or disabled, for `bitmaps == NULL`)
+bool gbitmap_sequence_set_frame_pool(GBitmapSequence *bitmap_sequence, GBitmap **bitmaps,
+                                     uint8_t num_bitmaps);
+
+//! Returns the next decoded frame of a bitmap sequence with a frame pool set by
+//! \ref gbitmap_sequence_set_frame_pool. The bitmap returned by the previous call is handed back
+//! to the pool and must no longer be drawn. If the frame has not been decoded ahead yet, it is
+//! decoded synchronously.
+//! @param bitmap_sequence Pointer to loaded bitmap sequence
+//! @param[out] delay_ms If not NULL, returns the delay in milliseconds until the next frame.
+//! @return The bitmap from the pool containing the frame, or `NULL` if all frames (and loops)
+//! have been rendered, no frame pool has been set, or the frame could not be decoded.
+GBitmap *gbitmap_sequence_get_next_frame(GBitmapSequence *bitmap_sequence, uint32_t *delay_ms);
+
+//! Sets how the bitmap sequence catches up when frames are requested later than their display
+//! time, both for \ref gbitmap_sequence_update_bitmap_by_elapsed and for frames decoded ahead
+//! into a frame pool.
+//! @param bitmap_sequence Pointer to loaded bitmap sequence
+//! @param policy The frame skip policy to apply
+void gbitmap_sequence_set_frame_skip_policy(GBitmapSequence *bitmap_sequence,
+                                            GBitmapSequenceFrameSkipPolicy policy);
+
 //! Description of a single data row in the pixel data of a bitmap
 //! @note This data type describes the actual pixel data of a bitmap and does not respect the
 //!       bitmap's bounds.
@@ -3728,6 +6361,35 @@ typedef struct {
 //! @see \ref gbitmap_get_data
 GBitmapDataRowInfo gbitmap_get_data_row_info(const GBitmap *bitmap, uint16_t y);
 
+//! Provides information about a contiguous range of pixel data rows in a single call.
+//! This is equivalent to calling \ref gbitmap_get_data_row_info for every row in the range, but
+//! avoids the per-row function call when walking a whole frame buffer, which matters most for
+//! GBitmapFormat8BitCircular where every row has a different `min_x` and `max_x`.
+//! A typical use inside a layer's `.update_proc` looks like this:
+//! \code{.c}
+//! static GBitmapDataRowInfo s_rows[PBL_DISPLAY_HEIGHT];
+//! GBitmap *fb = graphics_capture_frame_buffer(ctx);
+//! const uint16_t num_rows = gbitmap_get_data_row_infos(fb, 0, PBL_DISPLAY_HEIGHT, s_rows);
+//! for (uint16_t y = 0; y < num_rows; y++) {
+//!   for (int16_t x = s_rows[y].min_x; x <= s_rows[y].max_x; x++) {
+//!     s_rows[y].data[x] = ...;
+//!   }
+//! }
+//! graphics_release_frame_buffer(ctx, fb);
+//! \endcode
+//! @param bitmap A pointer to the GBitmap to get row info
+//! @param y Absolute number of the first row in the pixel data, independent from the bitmap's
+//!        bounds
+//! @param num_rows The number of rows to describe
+//! @param[out] row_infos Caller-provided array with space for at least `num_rows` entries
+//! @return The number of entries written to `row_infos`. This is less than `num_rows` if the
+//!         range extends past the last row of the pixel data.
+//! @note Like \ref gbitmap_get_data_row_info, this function does not respect the bitmap's bounds.
+//! @see \ref gbitmap_get_data_row_info
+//! @see \ref graphics_capture_frame_buffer_format
+uint16_t gbitmap_get_data_row_infos(const GBitmap *bitmap, uint16_t y, uint16_t num_rows,
+                                    GBitmapDataRowInfo *row_infos);
+
 //! Values to specify how two things should be aligned relative to each other.
 //! ![](galign.png)
 //! @see \ref bitmap_layer_set_alignment()
@@ -3783,6 +6445,12 @@ typedef enum {
   //! Assign the pixel values of the source image to the destination pixels,
   //! effectively replacing the previous values for those pixels. For color displays, when drawing
   //! a palettized or 8-bit \ref GBitmap image, the opacity value is ignored.
+  //! @note When the source bitmap has the same format as the destination, which is
+  //!   GBitmapFormat8Bit for the frame buffer, and is neither tiled nor clipped within a row, each
+  //!   row is copied with a single memcpy instead of being composited pixel by pixel. For
+  //!   GBitmapFormat1Bit bitmaps the same applies when the destination x coordinate is a multiple
+  //!   of 8. Full-screen background images drawn with this mode, for example by a
+  //!   \ref BitmapLayer, therefore cost little more than copying their pixel data.
   GCompOpAssign,
   //! Assign the **inverted** pixel values of the source image to the destination pixels,
   //! effectively replacing the previous values for those pixels.
@@ -3814,6 +6482,10 @@ typedef enum {
   //! @note For bitmaps of the format GBitmapFormat1Bit, the visual result of this compositing
   //!   mode is that for the parts where the source image is black, the destination image will be
   //!   painted white. Other parts will be left untouched.
+  //! @note For GBitmapFormat8Bit bitmaps, pixels are composited four at a time: runs of fully
+  //!   opaque pixels are copied as whole words and runs of fully transparent pixels are skipped,
+  //!   so only partially transparent pixels are blended individually. Icons with hard edges
+  //!   therefore draw at close to the speed of \ref GCompOpAssign.
   GCompOpSet,
 } GCompOp;
 
@@ -3949,6 +6621,46 @@ void graphics_context_set_antialiased(GContext* ctx, bool enable);
 //! previous integral value when drawing. Default value is 1.
 void graphics_context_set_stroke_width(GContext* ctx, uint8_t stroke_width);
 
+//! Ways of combining the colors drawn by a graphics context with what is already there.
+//! @see \ref graphics_context_set_blend_mode()
+typedef enum {
+  //! Colors are drawn as they are. Pixels of bitmaps drawn with \ref GCompOpSet whose alpha
+  //! value is below 3 are skipped if transparent and otherwise drawn opaque. This is the default.
+  GBlendModeNone,
+  //! Colors that are partly transparent are blended over what is already drawn, using the
+  //! system's blend tables (see \ref gcolor_blend_table()). This applies to the stroke and fill
+  //! colors of the context in all filling and stroking operations, and to the pixels of bitmaps
+  //! drawn with \ref GCompOpSet. Use it for shadows, fades and translucent overlays.
+  GBlendModeAlpha,
+} GBlendMode;
+
+//! Sets how the graphics context combines partly transparent colors with what is already drawn.
+//! @param ctx The graphics context onto which to set the blend mode
+//! @param mode The new blend mode
+//! @note Blending costs one table lookup per pixel, so a fill with \ref GBlendModeAlpha is a few
+//! times slower than an opaque one. Opaque and fully transparent colors are drawn at the same
+//! speed in either mode.
+//! @see \ref GBlendMode
+void graphics_context_set_blend_mode(GContext* ctx, GBlendMode mode);
+
+//! Creates a graphics context on the heap that draws into the given bitmap instead of the
+//! frame buffer. Use this to render content that rarely changes once and then draw the resulting
+//! bitmap with \ref graphics_draw_bitmap_in_rect() or a \ref BitmapLayer.
+//! The drawing state of the new context is reset to the defaults and the clipping box covers the
+//! bounds of the bitmap.
+//! @param bitmap The bitmap to draw into, for example created with \ref gbitmap_create_blank().
+//! Supported formats are \ref GBitmapFormat1Bit and \ref GBitmapFormat8Bit. The bitmap must
+//! outlive the graphics context.
+//! @return A pointer to the graphics context, `NULL` if the bitmap format is not supported or the
+//! context could not be created
+//! @see \ref graphics_context_destroy()
+GContext *graphics_context_create_with_bitmap(GBitmap *bitmap);
+
+//! Destroys a graphics context previously created with \ref graphics_context_create_with_bitmap().
+//! The bitmap it draws into is not destroyed.
+//! @param ctx The graphics context to destroy
+void graphics_context_destroy(GContext *ctx);
+
 //! @} // group GraphicsContext
 
 //! @addtogroup Drawing Drawing Primitives
@@ -3967,6 +6679,15 @@ void graphics_context_set_stroke_width(GContext* ctx, uint8_t stroke_width);
 //! * \ref TextDrawing
 //! * \ref PathDrawing
 //! * \ref GraphicsTypes
+//!
+//! On round displays, the frame buffer is a \ref GBitmapFormat8BitCircular bitmap whose rows only
+//! hold the pixels inside the visible circle. Every drawing primitive, including fills, strokes,
+//! text and bitmap blits, clips each row against that row's visible span (see
+//! \ref gbitmap_get_data_row_info) together with the clipping box before touching any pixels.
+//! Filling the whole screen therefore writes only the roughly 78% of the bounding square that is
+//! visible, and shapes that lie entirely outside the circle cost nothing to draw. Bitmaps drawn
+//! from a \ref GBitmapFormat8BitCircular source are clipped the same way against the source's
+//! rows.
 //! @{
 
 //! Bit mask values to specify the corners of a rectangle.
@@ -4007,6 +6728,16 @@ void graphics_draw_pixel(GContext* ctx, GPoint point);
 //! @param p1 The ending point of the line
 void graphics_draw_line(GContext* ctx, GPoint p0, GPoint p1);
 
+//! Draws a batch of independent line segments in the current stroke color, current stroke width
+//! and AA flag. This produces the same result as calling \ref graphics_draw_line() for every
+//! segment, but the graphics context state and clipping box are only evaluated once for the
+//! whole batch, which makes it considerably cheaper for drawing many tick marks or chart lines.
+//! @param ctx The destination graphics context in which to draw
+//! @param points Array of `2 * num_segments` points, where `points[2 * i]` and
+//! `points[2 * i + 1]` are the starting and ending point of the i-th segment
+//! @param num_segments The number of line segments to draw
+void graphics_draw_lines(GContext* ctx, const GPoint *points, uint16_t num_segments);
+
 //! Draws a 1-pixel wide rectangle outline in the current stroke color
 //! @param ctx The destination graphics context in which to draw
 //! @param rect The rectangle for which to draw the outline
@@ -4022,6 +6753,36 @@ void graphics_draw_rect(GContext *ctx, GRect rect);
 void graphics_fill_rect(GContext *ctx, GRect rect, uint16_t corner_radius,
                                        GCornerMask corner_mask);
 
+//! Width and height in pixels of the ordered dither pattern of \ref graphics_fill_rect_dithered().
+#define GDITHER_PATTERN_SIZE 4
+
+//! Number of pixels in the dither pattern. Shades go from 0 (fill color only) to
+//! \ref GDITHER_SHADES (stroke color only), one more than this in all.
+#define GDITHER_SHADES (GDITHER_PATTERN_SIZE * GDITHER_PATTERN_SIZE)
+
+//! Fills a rectangle with a mix of the current fill and stroke colors, using an ordered dither
+//! pattern of \ref GDITHER_PATTERN_SIZE by \ref GDITHER_PATTERN_SIZE pixels. This simulates
+//! shades of gray on black and white displays without drawing individual pixels. The pattern is
+//! aligned to the frame buffer, so adjacent fills and fills in consecutive
+//! frames line up seamlessly. It matches the bayer4 method of the dither.py resource tool.
+//! @param ctx The destination graphics context in which to draw
+//! @param rect The rectangle to fill
+//! @param shade How many of every \ref GDITHER_SHADES pixels are drawn in the stroke color rather
+//! than the fill color
+//! @note Each row of the pattern is drawn a word at a time, about as fast as
+//! \ref graphics_fill_rect().
+void graphics_fill_rect_dithered(GContext *ctx, GRect rect, uint8_t shade);
+
+//! Fills a rectangle with an ordered dither gradient between two shades, as drawn by
+//! \ref graphics_fill_rect_dithered().
+//! @param ctx The destination graphics context in which to draw
+//! @param rect The rectangle to fill
+//! @param from_shade The shade at the left or top edge of the rectangle
+//! @param to_shade The shade at the right or bottom edge of the rectangle
+//! @param vertical True if the shade changes from top to bottom, false for left to right
+void graphics_fill_gradient_dithered(GContext *ctx, GRect rect, uint8_t from_shade,
+                                     uint8_t to_shade, bool vertical);
+
 //! Draws the outline of a circle in the current stroke color
 //! @param ctx The destination graphics context in which to draw
 //! @param p The center point of the circle
@@ -4053,6 +6814,35 @@ void graphics_draw_round_rect(GContext *ctx, GRect rect, uint16_t radius);
 //! @see GContext
 void graphics_draw_bitmap_in_rect(GContext *ctx, const GBitmap *bitmap, GRect rect);
 
+//! Filters for scaling bitmaps with \ref graphics_draw_bitmap_scaled().
+typedef enum {
+  //! Each destination pixel takes the value of the nearest source pixel. This is the fastest
+  //! filter and keeps hard edges, which suits pixel art and integer scale factors.
+  GBitmapScaleFilterNearest,
+  //! Each destination pixel is the average of the 2x2 source pixels nearest to it. This smooths
+  //! photos and anti-aliased art at non-integer scale factors and when shrinking. On black and
+  //! white displays, and for palettized bitmaps, the average is mapped back to the nearest
+  //! available color.
+  GBitmapScaleFilterBox,
+} GBitmapScaleFilter;
+
+//! Draws a bitmap into the graphics context, scaled to fill the specified rectangle. This lets
+//! one set of resources serve displays of different sizes, for example scaling artwork made for
+//! Basalt by 4/3 on Emery, without a second copy of the images in the app bundle.
+//! The scale factors are computed once per call as 16.16 fixed point values, and source
+//! positions are stepped incrementally along each row, so no division happens per pixel. Rows
+//! that come out identical when scaling up vertically are copied instead of computed again.
+//! The current compositing mode is applied to the scaled pixels, as with
+//! \ref graphics_draw_bitmap_in_rect().
+//! @param ctx The destination graphics context in which to draw the bitmap
+//! @param bitmap The bitmap to draw. Supported formats are \ref GBitmapFormat1Bit,
+//! \ref GBitmapFormat8Bit and the palettized formats.
+//! @param rect The rectangle the bounds of the bitmap are scaled to
+//! @param filter The filter used to compute the scaled pixels
+//! @see \ref GBitmapScaleFilter
+void graphics_draw_bitmap_scaled(GContext *ctx, const GBitmap *bitmap, GRect rect,
+                                 GBitmapScaleFilter filter);
+
 //! A shortcut to capture the framebuffer in the native format of the watch.
 //! @see graphics_capture_frame_buffer_format
 GBitmap* graphics_capture_frame_buffer(GContext* ctx);
@@ -4098,10 +6888,35 @@ bool graphics_release_frame_buffer(GContext* ctx, GBitmap* buffer);
 //! @return True if the frame buffer has been captured
 bool graphics_frame_buffer_is_captured(GContext* ctx);
 
+//! Enables or disables double buffering of the frame buffer. Without double buffering, the
+//! display is updated from the same buffer the app draws into, so pixels written through
+//! \ref graphics_capture_frame_buffer() while a previous frame is still being transferred can
+//! show up as tearing. With double buffering, the app draws into a back buffer while the display
+//! is updated from the front buffer, and the two are swapped once all layers have been drawn.
+//! The display transfer and the rendering of the next frame then no longer overlap.
+//!
+//! The back buffer is allocated from the app's heap, so enabling double buffering costs the size
+//! of one frame buffer: about 24 KB on Basalt and Chalk and 45 KB on Emery. Enable it once, for
+//! example before pushing the first window, and check the result.
+//! @note After a swap, the back buffer holds the frame before the one currently shown, not the
+//! current one. Windows are redrawn completely for every frame, so this only matters to code
+//! that writes to the frame buffer and expects to find pixels from the previous frame.
+//! @param enabled True to draw into a back buffer, false to draw into the display's buffer
+//! @return True if the mode was changed, false if there was not enough memory for the back buffer
+bool graphics_frame_buffer_set_double_buffered(bool enabled);
+
+//! Whether the frame buffer is double buffered.
+//! @return True if \ref graphics_frame_buffer_set_double_buffered() enabled double buffering
+bool graphics_frame_buffer_is_double_buffered(void);
+
 //! Draws a rotated bitmap with a memory-sensitive 2x anti-aliasing technique
 //! (using ray-finding instead of super-sampling), which is thresholded into a b/w bitmap for 1-bit
 //! and color blended for 8-bit.
+//! The source coordinates are stepped incrementally along each destination row, so the sine and
+//! cosine of the rotation are only looked up once per call rather than once per pixel.
 //! @note This API has performance limitations that can degrade user experience. Use sparingly.
+//! To show a bitmap at many angles repeatedly, consider
+//! \ref rot_bitmap_layer_prerender_angle_steps().
 //! @param ctx The destination graphics context in which to draw
 //! @param src The source bitmap to draw
 //! @param src_ic Instance center (single point unaffected by rotation) relative to source bitmap
@@ -4138,6 +6953,29 @@ typedef enum {
 void graphics_draw_arc(GContext *ctx, GRect rect, GOvalScaleMode scale_mode,
                        int32_t angle_start, int32_t angle_end);
 
+//! Describes a single arc of a batch drawn with \ref graphics_draw_arcs().
+typedef struct GArc {
+  //! The reference rectangle to derive the center point and radius (see scale_mode).
+  GRect rect;
+  //! Radial starting angle. Use \ref DEG_TO_TRIGANGLE to easily convert degrees to the
+  //! appropriate value.
+  int32_t angle_start;
+  //! Radial finishing angle. If smaller than `angle_start`, this arc will not be drawn.
+  int32_t angle_end;
+} GArc;
+
+//! Draws a batch of line arcs that share the same scale mode, using the current stroke color,
+//! stroke width and antialiasing setting. This produces the same result as calling
+//! \ref graphics_draw_arc() for every arc, but the graphics context state and clipping box are
+//! only evaluated once for the whole batch.
+//! @param ctx The destination graphics context in which to draw
+//! @param scale_mode Determines how the rect of each arc will be used to derive its center point
+//! and radius.
+//! @param arcs Array of arcs to draw
+//! @param num_arcs The number of arcs in the array
+void graphics_draw_arcs(GContext *ctx, GOvalScaleMode scale_mode, const GArc *arcs,
+                        uint16_t num_arcs);
+
 //! Fills a circle clockwise between `angle_start` and `angle_end`, where 0° is
 //! the top of the circle. If the difference between `angle_start` and `angle_end` is greater
 //! than 360°, a full circle will be drawn and filled. If `angle_start` is greater than
@@ -4181,6 +7019,56 @@ GPoint gpoint_from_polar(GRect rect, GOvalScaleMode scale_mode, int32_t angle);
 //! @return The rectangle centered on the circle's perimeter.
 GRect grect_centered_from_polar(GRect rect, GOvalScaleMode scale_mode, int32_t angle, GSize size);
 
+//! Calculates the points located at the given angles on the perimeter of a circle defined by the
+//! provided GRect. This is equivalent to calling \ref gpoint_from_polar() for every angle, but the
+//! center point and radius are only derived once.
+//! @param rect The reference rectangle to derive the center point and radius (see scale_mode).
+//! @param scale_mode Determines how rect will be used to derive the center point and radius.
+//! @param angles Array of angles at which the points should be calculated.
+//! @param[out] points Array that receives the points on the circle's perimeter.
+//! @param num_points The number of angles to process.
+void gpoint_from_polar_batch(GRect rect, GOvalScaleMode scale_mode, const int32_t *angles,
+                             GPoint *points, uint16_t num_points);
+
+//! The value representing 1.0 in the 16.16 fixed point format used by \ref GTransform.
+#define GTRANSFORM_FIXED_ONE (1 << 16)
+
+//! A 2D affine transformation in 16.16 fixed point format. A point (x, y) is transformed to
+//! (a * x + c * y + tx, b * x + d * y + ty).
+//! @see \ref gtransform_from_rotation
+//! @see \ref gpoint_transform_batch
+typedef struct GTransform {
+  int32_t a;
+  int32_t b;
+  int32_t c;
+  int32_t d;
+  //! Horizontal translation, in 16.16 fixed point format
+  int32_t tx;
+  //! Vertical translation, in 16.16 fixed point format
+  int32_t ty;
+} GTransform;
+
+//! Convenience macro for a transformation that leaves all points unchanged.
+#define GTransformIdentity() \
+  ((GTransform){GTRANSFORM_FIXED_ONE, 0, 0, GTRANSFORM_FIXED_ONE, 0, 0})
+
+//! Creates a transformation that scales points around the origin, rotates them clockwise and then
+//! translates them, which is what \ref gpath_rotate_to() and \ref gpath_move_to() do for paths.
+//! @param angle The angle of the rotation. See \ref TRIG_MAX_ANGLE for more information.
+//! @param scale The scale factor in 16.16 fixed point format, \ref GTRANSFORM_FIXED_ONE for none.
+//! @param offset The translation applied after scaling and rotation.
+//! @return The transformation
+GTransform gtransform_from_rotation(int32_t angle, int32_t scale, GPoint offset);
+
+//! Applies a transformation to an array of points. The results are rounded to the nearest pixel.
+//! @param transform The transformation to apply
+//! @param points_in The points to transform
+//! @param[out] points_out Array that receives the transformed points. May be the same array as
+//! `points_in`.
+//! @param num_points The number of points to transform
+void gpoint_transform_batch(const GTransform *transform, const GPoint *points_in,
+                            GPoint *points_out, uint32_t num_points);
+
 //! @} // group Drawing
 
 //! @addtogroup DrawCommand Draw Commands
@@ -4373,6 +7261,18 @@ uint32_t gdraw_command_frame_get_duration(GDrawCommandFrame *frame);
 //! @return GDrawCommandImage pointer if the resource was loaded, NULL otherwise
 GDrawCommandImage *gdraw_command_image_create_with_resource(uint32_t resource_id);
 
+//! Creates a GDrawCommandImage that draws directly from the specified resource (PDC file) without
+//! copying the command data to the heap, similar to how system fonts are used. Only a small
+//! header is allocated, which makes vector images affordable on platforms with little heap.
+//! The image data is copied to the heap the first time one of the `gdraw_command_set_*`
+//! functions or \ref gdraw_command_image_set_bounds_size() is used on the image. Pointers to
+//! \ref GDrawCommand or \ref GDrawCommandList obtained from the image before that point must not
+//! be used afterwards and should be retrieved again.
+//! @param resource_id Resource containing the data of the GDrawCommandImage.
+//! @return GDrawCommandImage pointer if the resource could be mapped, NULL otherwise
+//! @see \ref gdraw_command_image_create_with_resource
+GDrawCommandImage *gdraw_command_image_create_with_resource_mapped(uint32_t resource_id);
+
 //! Creates a GDrawCommandImage as a copy from a given image
 //! @param image Image to copy.
 //! @return cloned image or NULL if the operation failed
@@ -4405,6 +7305,25 @@ void gdraw_command_image_set_bounds_size(GDrawCommandImage *image, GSize size);
 //! @return command list
 GDrawCommandList *gdraw_command_image_get_command_list(GDrawCommandImage *image);
 
+//! Enables or disables a rasterization cache for an image. While enabled, the first call to
+//! \ref gdraw_command_image_draw() renders the image into a heap allocated bitmap of the image's
+//! bounds size, and subsequent calls draw that bitmap instead of processing every command again.
+//! The cache is invalidated automatically when the bounds size of the image changes or when one
+//! of the `gdraw_command_set_*` functions is called for a command of the image.
+//! @note Drawing from the cache ignores the antialiasing setting and stroke color of the
+//! destination graphics context, which never affect draw commands. If the cached bitmap cannot be
+//! allocated, the image is drawn as if caching was disabled.
+//! @param image \ref GDrawCommandImage for which to set the caching property
+//! @param cached true to enable the rasterization cache, false to disable it and free the cached
+//! bitmap
+void gdraw_command_image_set_cached(GDrawCommandImage *image, bool cached);
+
+//! Return whether the rasterization cache is enabled for an image
+//! @param image \ref GDrawCommandImage from which to get the caching property
+//! @return true if the rasterization cache is enabled
+//! @see \ref gdraw_command_image_set_cached
+bool gdraw_command_image_get_cached(GDrawCommandImage *image);
+
 //! Iterate over all commands in a command list
 //! @param command_list \ref GDrawCommandList over which to iterate
 //! @param handle_command iterator callback
@@ -4434,6 +7353,14 @@ uint32_t gdraw_command_list_get_num_commands(GDrawCommandList *command_list);
 //! @return GDrawCommandSequence pointer if the resource was loaded, NULL otherwise
 GDrawCommandSequence *gdraw_command_sequence_create_with_resource(uint32_t resource_id);
 
+//! Creates a \ref GDrawCommandSequence that draws directly from the specified resource (PDC file)
+//! without copying the frame data to the heap. The same copy-on-write rules as for
+//! \ref gdraw_command_image_create_with_resource_mapped apply.
+//! @param resource_id Resource containing the data of the GDrawCommandSequence.
+//! @return GDrawCommandSequence pointer if the resource could be mapped, NULL otherwise
+//! @see \ref gdraw_command_sequence_create_with_resource
+GDrawCommandSequence *gdraw_command_sequence_create_with_resource_mapped(uint32_t resource_id);
+
 //! Creates a \ref GDrawCommandSequence as a copy from a given sequence
 //! @param sequence Sequence to copy
 //! @return cloned sequence or NULL if the operation failed
@@ -4458,6 +7385,29 @@ GDrawCommandFrame *gdraw_command_sequence_get_frame_by_elapsed(GDrawCommandSeque
 GDrawCommandFrame *gdraw_command_sequence_get_frame_by_index(GDrawCommandSequence *sequence,
                                                              uint32_t index);
 
+//! Return whether a sequence was loaded from a keyframed PDC file. In a keyframed sequence, only
+//! the first frame stores a complete command list; every other frame only stores the points and
+//! colors that differ from the previous keyframe, which makes the resource much smaller.
+//! @param sequence \ref GDrawCommandSequence to check
+//! @return true if the sequence is keyframed
+//! @see \ref gdraw_command_sequence_get_interpolated_frame
+bool gdraw_command_sequence_is_keyframed(GDrawCommandSequence *sequence);
+
+//! Get a frame that is interpolated between the two keyframes surrounding the specified elapsed
+//! time. Points are tweened linearly with sub-pixel precision, while colors, stroke widths and
+//! the hidden state switch at the later keyframe. For non-keyframed sequences this behaves like
+//! \ref gdraw_command_sequence_get_frame_by_elapsed.
+//! To ease the motion, drive `elapsed_ms` from the update handler of an \ref Animation with the
+//! desired curve instead of using the wall clock.
+//! @note The returned frame is owned by the sequence and is overwritten by the next call to this
+//! function. It must not be modified.
+//! @param sequence \ref GDrawCommandSequence from which to get the frame
+//! @param elapsed_ms elapsed time in milliseconds
+//! @return pointer to \ref GDrawCommandFrame that should be displayed at the elapsed time, or
+//! NULL if the interpolated frame could not be allocated
+GDrawCommandFrame *gdraw_command_sequence_get_interpolated_frame(GDrawCommandSequence *sequence,
+                                                                 uint32_t elapsed_ms);
+
 //! Get the size of the bounding box surrounding all draw commands in the sequence. This bounding
 //! box can be used to set the graphics context or layer bounds when drawing the frames in the
 //! sequence.
@@ -4570,11 +7520,42 @@ typedef struct GPath {
 //! be created
 GPath* gpath_create(const GPathInfo *init);
 
-//! Free a dynamically allocated gpath created with \ref gpath_create()
+//! Initializes a GPath in caller-provided storage, such as a static variable or a struct field,
+//! instead of allocating it on the heap. Like \ref gpath_create(), it does not copy the points,
+//! so the points of `init` must stay available while the path is used.
+//!
+//! Values after initialization are the same as with \ref gpath_create().
+//! @note Do not pass the path to \ref gpath_destroy().
+//! @param path The path to initialize
+//! @param init The points of the path
+void gpath_init(GPath *path, const GPathInfo *init);
+
+//! Creates a new GPath from a path resource, see \ref PathFileFormat.
+//! Only the GPath itself is allocated on the heap. On platforms where resources are in
+//! memory-mapped flash, `points` refers to the resource data directly (see
+//! \ref resource_get_mapped_data), so the points must not be modified; otherwise they are
+//! copied to the heap. If the resource contains triangles, \ref gpath_draw_filled() uses them.
+//!
+//! Values after initialization:
+//! * `num_points` and `points` pointer: from the resource.
+//! * `rotation`: 0
+//! * `offset`: (0, 0)
+//! @param resource_id The ID of the path resource to load
+//! @return A pointer to the GPath, to be destroyed with \ref gpath_destroy(). `NULL` if the
+//! resource is not a path resource or there was not enough memory
+GPath* gpath_create_with_resource(uint32_t resource_id);
+
+//! Free a dynamically allocated gpath created with \ref gpath_create() or
+//! \ref gpath_create_with_resource()
 void gpath_destroy(GPath* gpath);
 
 //! Draws the fill of a path into a graphics context, using the current fill color,
 //! relative to the drawing area as set up by the layering system.
+//! The path is rasterized scanline by scanline using a sorted table of active edges with
+//! fixed-point incremental stepping, so the cost grows with the number of edges and rows covered
+//! rather than with the product of both.
+//! @note The rotation and offset of the path are applied to every point on each call. To draw the
+//! same path several times per frame, transform it once with \ref gpath_transform_points().
 //! @param ctx The graphics context to draw into
 //! @param path The path to fill
 //! @see \ref graphics_context_set_fill_color()
@@ -4617,6 +7598,27 @@ void gpath_move_to(GPath *path, GPoint point);
 //! @see \ref gpath_draw_outline()
 void gpath_draw_outline_open(GContext* ctx, GPath* path);
 
+//! Applies the current rotation and offset of a path to its points and writes the result to the
+//! given array. The path itself is not modified.
+//! This allows a path that is drawn several times, e.g. in multiple layers, to be transformed once
+//! and then drawn with a GPath that uses the transformed points and has no rotation or offset,
+//! in which case the drawing functions skip the per-point transformation entirely.
+//! \code{.c}
+//! static GPoint s_hand_points[4];
+//! static GPath s_hand_transformed = { .num_points = 4, .points = s_hand_points };
+//!
+//! gpath_rotate_to(s_hand_path, angle);
+//! gpath_transform_points(s_hand_path, s_hand_points, ARRAY_LENGTH(s_hand_points));
+//! // in any number of .update_procs:
+//! gpath_draw_filled(ctx, &s_hand_transformed);
+//! \endcode
+//! @param path The path to transform
+//! @param[out] points Array that receives the transformed points
+//! @param max_points The number of points that fit into `points`
+//! @return The number of points written, which is the smaller of `path->num_points` and
+//! `max_points`
+uint32_t gpath_transform_points(const GPath *path, GPoint *points, uint32_t max_points);
+
 //! @} // group PathDrawing
 
 //! @addtogroup Fonts
@@ -4642,6 +7644,10 @@ typedef FontInfo* GFont;
 //! @return An opaque pointer to the loaded font, or, a pointer to the default
 //! (fallback) font if the specified font cannot be loaded.
 //! @note This may load a font from the flash peripheral into RAM.
+//! @note Glyphs of system fonts are kept in a glyph cache in system memory that is shared by all
+//! apps and the system UI, so glyphs drawn recently by anyone, such as the digits of the time,
+//! are drawn without reading flash. The cache does not count against the app's heap. Use
+//! \ref fonts_preload_glyphs() to keep the glyphs an app draws constantly in the cache.
 GFont fonts_get_system_font(const char *font_key);
 
 //! Loads a custom font.
@@ -4661,6 +7667,32 @@ GFont fonts_load_custom_font(ResHandle handle);
 //! @param font The font to unload.
 void fonts_unload_custom_font(GFont font);
 
+//! Sets the amount of app heap that a custom font may use to cache decoded glyph bitmaps.
+//! By default, glyphs of custom fonts are read from resource storage every time they are drawn.
+//! With a cache budget, recently drawn glyphs are kept in RAM and the least recently used glyphs
+//! are evicted once the budget is exceeded. The cache is also released automatically when the
+//! app would otherwise run out of heap memory.
+//! @param font The custom font, as returned by \ref fonts_load_custom_font()
+//! @param budget_bytes The maximum number of heap bytes to use for the glyph cache of this font.
+//! Pass 0 to disable caching and free all cached glyphs.
+//! @return True if the budget was applied, false if `font` is not a custom font
+//! @see \ref fonts_preload_glyphs()
+bool fonts_set_glyph_cache_budget(GFont font, size_t budget_bytes);
+
+//! Decodes the glyphs of the given characters into the glyph cache of a font ahead of time, for
+//! example `"0123456789:"` for a watchface showing large digits.
+//!
+//! For system fonts, the glyphs are loaded into the shared system glyph cache and pinned there
+//! until the app exits, so drawing them never reads flash. Each app can pin a limited number of
+//! glyphs, enough for the digits and separators of a few fonts.
+//! @param font A system font returned by \ref fonts_get_system_font(), or a custom font with a
+//! glyph cache budget set with \ref fonts_set_glyph_cache_budget()
+//! @param characters Zero terminated UTF-8 string of the characters to preload
+//! @return The number of glyphs that are in the cache after preloading. This can be less than the
+//! number of characters if the budget, or the limit of pinned system glyphs, does not allow for
+//! all of them.
+size_t fonts_preload_glyphs(GFont font, const char *characters);
+
 //! @} // group Fonts
 
 //! @addtogroup TextDrawing Drawing Text
@@ -4724,6 +7756,11 @@ void graphics_text_attributes_restore_default_text_flow(GTextAttributes *text_at
 //! @param text_attributes The attributes for which text flow should be enabled
 //! @param inset Additional amount of pixels to inset to the inside of the screen for text flow
 //! calculation. Can be zero.
+//! @note The width available to each line depends only on the line's position on the screen, the
+//! inset and the font's line height. The attributes cache these widths the first time they are
+//! needed and reuse them for every later draw with the same content origin, so text flow costs
+//! no more per line than rectangular layout once the cache is filled. Changing the inset or the
+//! content origin set with \ref graphics_text_attributes_enable_paging clears the cache.
 //! @see graphics_text_attributes_restore_default_text_flow
 //! @see text_layer_enable_screen_text_flow_and_paging
 void graphics_text_attributes_enable_screen_text_flow(GTextAttributes *text_attributes,
@@ -4742,6 +7779,10 @@ void graphics_text_attributes_restore_default_paging(GTextAttributes *text_attri
 //!     in screen coordinates.
 //! @param paging_on_screen Rectangle in absolute coordinates on the screen that describes where
 //!     text content pages. Usually the container's absolute frame in screen coordinates.
+//! @note With paging, every page has the same line widths. The line breaks of a page are cached
+//! in the attributes, and in a \ref GTextLayout that uses them, so scrolling by whole pages
+//! reuses them instead of laying out the text again. Only scrolling by fractions of a page,
+//! during the scroll animation, moves lines to positions that have not been cached yet.
 //! @see graphics_text_attributes_restore_default_paging
 //! @see graphics_text_attributes_enable_screen_text_flow
 //! @see text_layer_enable_screen_text_flow_and_paging
@@ -4762,6 +7803,8 @@ void graphics_text_attributes_enable_paging(GTextAttributes *text_attributes,
 //! the box.
 //! @param alignment The horizontal alignment of the text
 //! @param text_attributes Optional text attributes to describe the characteristics of the text
+//! @note Layout stops once the box is full, so drawing a long text truncated to a few lines
+//! costs about as much as drawing those lines.
 void graphics_draw_text(GContext *ctx, const char *text, GFont const font, const GRect box,
                         const GTextOverflowMode overflow_mode, const GTextAlignment alignment,
                         GTextAttributes *text_attributes);
@@ -4795,6 +7838,68 @@ GSize graphics_text_layout_get_content_size_with_attributes(
   const char *text, GFont const font, const GRect box, const GTextOverflowMode overflow_mode,
   const GTextAlignment alignment, GTextAttributes *text_attributes);
 
+//! Checks whether a text with given font, overflow mode and alignment fits entirely within a
+//! given rectangular constraint. Layout stops as soon as a line does not fit, so this is much
+//! cheaper than comparing the result of \ref graphics_text_layout_get_content_size_with_attributes
+//! with the box for texts that are much longer than what fits.
+//! @param text The zero terminated UTF-8 string to check
+//! @param font The font in which the text should be set while checking
+//! @param box The bounding box in which the text should be constrained
+//! @param overflow_mode The overflow behavior, in case the text is larger than what fits
+//! inside the box.
+//! @param alignment The horizontal alignment of the text
+//! @param text_attributes Optional text attributes to describe the characteristics of the text
+//! @return `true` if the whole text fits inside the box without being truncated
+bool graphics_text_fits_in_box(const char *text, GFont const font, const GRect box,
+                               const GTextOverflowMode overflow_mode,
+                               const GTextAlignment alignment, GTextAttributes *text_attributes);
+
+struct GTextLayout;
+typedef struct GTextLayout GTextLayout;
+
+//! Creates a text layout object that caches the line breaks, glyph positions and content size of
+//! a text, so that drawing the same text repeatedly does not repeat the layout work.
+//! @return New instance of GTextLayout, `NULL` if it could not be created
+//! @see \ref graphics_text_layout_set_text
+//! @see \ref graphics_draw_text_layout
+GTextLayout *graphics_text_layout_create(void);
+
+//! Destroys a previously created instance of GTextLayout
+void graphics_text_layout_destroy(GTextLayout *text_layout);
+
+//! Sets the text and parameters of a text layout. The cached layout is only invalidated if any of
+//! the parameters differ from the ones set previously, so it is cheap to call this on every
+//! redraw with unchanged values. The string, font and text attributes are referenced, not copied,
+//! and must remain valid as long as the text layout uses them.
+//! @param text_layout The text layout to configure
+//! @param text The zero terminated UTF-8 string to lay out. Changes to the contents of the string
+//! are detected as well.
+//! @param font The font in which the text should be set
+//! @param box The bounding box in which to lay out the text
+//! @param overflow_mode The overflow behavior, in case the text is larger than what fits inside
+//! the box.
+//! @param alignment The horizontal alignment of the text
+//! @param text_attributes Optional text attributes to describe the characteristics of the text
+//! @see \ref graphics_draw_text
+void graphics_text_layout_set_text(GTextLayout *text_layout, const char *text, GFont const font,
+                                   const GRect box, const GTextOverflowMode overflow_mode,
+                                   const GTextAlignment alignment,
+                                   GTextAttributes *text_attributes);
+
+//! Obtain the maximum size that the text of a text layout occupies, computing the layout only if
+//! it is not cached yet.
+//! @param text_layout The text layout for which to get the size
+//! @return The maximum size occupied by the text
+//! @see \ref graphics_text_layout_get_content_size_with_attributes
+GSize graphics_text_layout_get_cached_content_size(GTextLayout *text_layout);
+
+//! Draw the text of a text layout into the current graphics context, using the context's current
+//! text color. The result is the same as calling \ref graphics_draw_text with the parameters of
+//! the text layout, but the cached layout is reused.
+//! @param ctx The destination graphics context in which to draw
+//! @param text_layout The text layout to draw
+void graphics_draw_text_layout(GContext *ctx, GTextLayout *text_layout);
+
 //! @} // group TextDrawing
 
 //! @} // group Graphics
@@ -4811,6 +7916,13 @@ GSize graphics_text_layout_get_content_size_with_attributes(
 //! The attribute_id to specify in order to read/write raw data to the smartstrap.
 #define SMARTSTRAP_RAW_DATA_ATTRIBUTE_ID 0
 
+//! The baud rate used for the smartstrap connection until a different rate is negotiated
+//! (see \ref smartstrap_set_baud_rate).
+#define SMARTSTRAP_BAUD_RATE_DEFAULT 9600
+
+//! The highest baud rate which may be requested with \ref smartstrap_set_baud_rate.
+#define SMARTSTRAP_BAUD_RATE_MAXIMUM 1000000
+
 //! Convenience macro to switch between two expressions depending on smartstrap support.
 //! On platforms with a smartstrap the first expression will be chosen, the second otherwise.
 #define PBL_IF_SMARTSTRAP_ELSE(if_true, if_false) (if_true)
@@ -4974,6 +8086,70 @@ SmartstrapResult smartstrap_attribute_begin_write(SmartstrapAttribute *attribute
 SmartstrapResult smartstrap_attribute_end_write(SmartstrapAttribute *attribute,
                                                     size_t write_length, bool request_read);
 
+//! The maximum number of requests which may be combined by \ref smartstrap_batch_send.
+#define SMARTSTRAP_BATCH_REQUESTS_MAXIMUM 8
+
+//! A single request within a batched smartstrap transaction (see \ref smartstrap_batch_send).
+typedef struct {
+  //! The attribute to perform the request on.
+  SmartstrapAttribute *attribute;
+  //! The length of the data to write, which must have been written into the buffer obtained from
+  //! \ref smartstrap_attribute_begin_write, or 0 to not write to the attribute.
+  size_t write_length;
+  //! Whether the attribute should be read after it has been written, or read only if
+  //! `write_length` is 0.
+  bool request_read;
+} SmartstrapBatchRequest;
+
+//! Sends several read and write requests to the smartstrap in a single framed transaction,
+//! instead of one round trip per attribute. The `did_write` and `did_read` handlers are called
+//! for each attribute in the order of the requests once the smartstrap has responded to the
+//! whole batch. The timeout set with \ref smartstrap_set_timeout applies to the transaction as a
+//! whole.
+//! @param requests The requests to send.
+//! @param num_requests The number of requests, up to \ref SMARTSTRAP_BATCH_REQUESTS_MAXIMUM.
+//! @returns `SmartstrapResultOk` if the transaction was started, `SmartstrapResultBusy` if a
+//! request is already pending on one of the attributes, or another error otherwise. If an error
+//! is returned, none of the requests were sent.
+SmartstrapResult smartstrap_batch_send(const SmartstrapBatchRequest *requests,
+                                       uint8_t num_requests);
+
+//! Starts streaming reads on the specified attribute. Instead of one response per
+//! \ref smartstrap_attribute_read() request, the smartstrap sends data continuously and each
+//! filled buffer is passed to the `did_read` handler while the next one is being received.
+//! A second buffer of the attribute's buffer length is allocated on the app's heap for this.
+//! The watch uses notifications for flow control: if both buffers are full because the app has
+//! not returned from `did_read` yet, the smartstrap is notified to pause and is notified again
+//! to resume once a buffer is free, so no data is dropped.
+//! @note The data passed to `did_read` is only valid until the handler returns.
+//! @param attribute The attribute to stream from.
+//! @returns `SmartstrapResultOk` if streaming was started, `SmartstrapResultBusy` if a request is
+//! pending on the attribute, or another error otherwise.
+//! @see smartstrap_attribute_stream_stop
+SmartstrapResult smartstrap_attribute_stream_start(SmartstrapAttribute *attribute);
+
+//! Stops streaming reads on the specified attribute and frees the second buffer. Data which has
+//! already been received is still delivered to the `did_read` handler.
+//! @param attribute The attribute to stop streaming from.
+//! @returns `SmartstrapResultOk` if streaming was stopped, or `SmartstrapResultInvalidArgs` if the
+//! attribute was not streaming.
+SmartstrapResult smartstrap_attribute_stream_stop(SmartstrapAttribute *attribute);
+
+//! Requests that the connection to the smartstrap switch to a different baud rate. The watch
+//! negotiates the new rate with the smartstrap and falls back to the current rate if the
+//! smartstrap does not acknowledge it. Higher rates allow higher sustained throughput when
+//! streaming.
+//! @param baud_rate The baud rate to request, up to \ref SMARTSTRAP_BAUD_RATE_MAXIMUM.
+//! @returns `SmartstrapResultOk` if the negotiation was started. The `availability_did_change`
+//! handler is called for \ref SMARTSTRAP_RAW_DATA_SERVICE_ID once the connection is available
+//! again at the negotiated rate.
+//! @see smartstrap_get_baud_rate
+SmartstrapResult smartstrap_set_baud_rate(uint32_t baud_rate);
+
+//! Gets the baud rate currently used for the connection to the smartstrap.
+//! @returns The current baud rate.
+uint32_t smartstrap_get_baud_rate(void);
+
 //! @} // group Smartstrap
 
 //! @addtogroup UI
@@ -5015,6 +8191,8 @@ typedef void (*ClickConfigProvider)(void *context);
 //! and (repeated) click events.
 //! @param recognizer The click recognizer for which to get the click count
 //! @return The number of consecutive clicks, and for auto-repeating the number of repetitions.
+//! If repeats are coalesced, see \ref window_set_click_repeat_options(), this is the number of
+//! repetitions that were accumulated since the handler was last called.
 uint8_t click_number_of_clicks_counted(ClickRecognizerRef recognizer);
 
 //! Gets the button identifier.
@@ -5029,6 +8207,18 @@ ButtonId click_recognizer_get_button_id(ClickRecognizerRef recognizer);
 //! @return true if this is a repeating click.
 bool click_recognizer_is_repeating(ClickRecognizerRef recognizer);
 
+//! Values that are used to indicate how the repeat interval of a repeating click changes while
+//! the button is held down.
+//! @see window_set_click_repeat_options
+typedef enum {
+  //! The repeat interval stays constant (default).
+  ClickRepeatAccelerationNone = 0,
+  //! The repeat interval halves every 10 repetitions, down to the minimum of 30ms.
+  ClickRepeatAccelerationLinear,
+  //! The repeat interval halves every 4 repetitions, down to the minimum of 30ms.
+  ClickRepeatAccelerationFast,
+} ClickRepeatAcceleration;
+
 //! @} // group Clicks
 
 //! @addtogroup Layer Layers
@@ -5112,6 +8302,62 @@ Layer* layer_create_with_data(GRect frame, size_t data_size);
 //! Destroys a layer previously created by layer_create
 void layer_destroy(Layer* layer);
 
+struct LayerPool;
+typedef struct LayerPool LayerPool;
+
+//! The kinds of layers a \ref LayerPool can hold.
+typedef enum {
+  //! Plain \ref Layer objects, as created by \ref layer_create_with_data()
+  LayerPoolTypeLayer,
+  //! \ref TextLayer objects, as created by \ref text_layer_create()
+  LayerPoolTypeTextLayer,
+  //! \ref BitmapLayer objects, as created by \ref bitmap_layer_create()
+  LayerPoolTypeBitmapLayer,
+} LayerPoolType;
+
+//! Creates a pool of reusable layers of one type. Windows that rebuild their views whenever new
+//! data arrives can acquire their layers from a pool and release them again instead of
+//! creating and destroying them, so a rebuild neither allocates nor fragments the heap. The
+//! memory for all layers of the pool is allocated at once, in a single block.
+//! @param type The type of the layers in the pool
+//! @param capacity The maximum number of layers that can be acquired at the same time
+//! @param data_size The size (in bytes) of callback data for each layer, as with
+//! \ref layer_create_with_data(). Must be 0 for types other than \ref LayerPoolTypeLayer.
+//! @return A pointer to the pool, `NULL` if it could not be created
+LayerPool *layer_pool_create(LayerPoolType type, uint16_t capacity, size_t data_size);
+
+//! Destroys a pool and all of its layers. Layers acquired from the pool must not be used
+//! afterwards.
+//! @param pool The pool to destroy
+void layer_pool_destroy(LayerPool *pool);
+
+//! Acquires a layer from a pool and sets its frame. The layer is in the same state as a newly
+//! created layer of the pool's type, but only the properties that were changed since it was
+//! released are reset, which is cheaper than creating a new layer. For layers with callback
+//! data, the data is not cleared.
+//! \code{.c}
+//! TextLayer *label = layer_pool_acquire(s_label_pool, GRect(0, y, 144, 20));
+//! text_layer_set_text(label, s_names[i]);
+//! layer_add_child(root, text_layer_get_layer(label));
+//! \endcode
+//! @param pool The pool to acquire the layer from
+//! @param frame The frame of the layer
+//! @return A pointer to a \ref Layer, \ref TextLayer or \ref BitmapLayer, depending on the type of
+//! the pool, or `NULL` if all layers of the pool are in use
+void *layer_pool_acquire(LayerPool *pool, GRect frame);
+
+//! Returns a layer to the pool it was acquired from. The layer is removed from its parent, and
+//! its children are removed from it. A released \ref TextLayer no longer references its text,
+//! nor a \ref BitmapLayer its bitmap, so those can be freed afterwards.
+//! @param pool The pool the layer was acquired from
+//! @param layer The layer to release, as returned by \ref layer_pool_acquire()
+void layer_pool_release(LayerPool *pool, void *layer);
+
+//! Returns all acquired layers to the pool at once, as if \ref layer_pool_release() was called
+//! for each of them. Use it at the start of a view rebuild.
+//! @param pool The pool to reset
+void layer_pool_release_all(LayerPool *pool);
+
 //! Marks the complete layer as "dirty", awaiting to be asked by the system to redraw itself.
 //! Typically, this function is called whenever state has changed that affects what the layer
 //! is displaying.
@@ -5123,6 +8369,23 @@ void layer_destroy(Layer* layer);
 //! @param layer The layer to mark dirty
 void layer_mark_dirty(Layer *layer);
 
+//! Marks a sub-rectangle of the layer as "dirty", awaiting to be asked by the system to redraw
+//! only that region.
+//! Use this instead of \ref layer_mark_dirty() when only a small part of what the layer displays
+//! has changed, for example the seconds digits of a watchface.
+//! * Dirty rectangles of all layers in a window's hierarchy are converted to screen coordinates and
+//! merged into their union before the next re-render.
+//! * During that re-render, the clipping box of the `GContext` passed to each `.update_proc` is
+//! intersected with the dirty region, and layers that do not overlap it are skipped entirely.
+//! * Only the rows of the framebuffer touched by the dirty region are sent to the display.
+//! * A subsequent call to \ref layer_mark_dirty() within the same frame promotes the request to a
+//! full re-render.
+//! @param layer The layer of which a region should be marked dirty
+//! @param rect The region to mark dirty, in the coordinate system (bounds) of the layer. The region
+//! is clipped to the layer's bounds; an empty rectangle is a no-op.
+//! @see \ref layer_mark_dirty()
+void layer_mark_dirty_rect(Layer *layer, GRect rect);
+
 //! Sets the layer's render function.
 //! The system will call the `update_proc` automatically when the layer needs to redraw itself, see
 //! also \ref layer_mark_dirty().
@@ -5170,6 +8433,9 @@ GRect layer_get_unobstructed_bounds(const Layer *layer);
 
 //! Converts a point from the layer's local coordinate system to screen coordinates.
 //! @note If the layer isn't part of the view hierarchy the result is undefined.
+//! @note The layer's frame in screen coordinates is cached and invalidated by
+//! \ref layer_set_frame() and \ref layer_set_bounds() on the layer or any of its ancestors, so
+//! repeated conversions do not walk the layer hierarchy.
 //! @param layer The view whose coordinate system will be used to convert the value to the screen.
 //! @param point A point specified in the local coordinate system (bounds) of the layer.
 //! @return The point converted to the coordinate system of the screen.
@@ -5264,6 +8530,41 @@ void layer_set_clips(Layer *layer, bool clips);
 //! the layer.
 bool layer_get_clips(const Layer *layer);
 
+//! Sets whether the rendered output of the layer _and its children_ is cached in an offscreen
+//! bitmap. While caching is enabled, the subtree is only rendered again after
+//! \ref layer_mark_dirty() has been called on the layer or one of its children; otherwise the
+//! cached bitmap is drawn into the parent directly. This is beneficial for complex content that
+//! rarely changes, like detailed watchface backgrounds, at the cost of a heap allocated bitmap the
+//! size of the layer's frame.
+//! @note If the bitmap cannot be allocated, the layer is rendered as if caching was disabled.
+//! @param layer The layer for which to set the caching property
+//! @param cached Supply `true` to cache the rendered output of the layer, or `false` to render
+//! it on every redraw and free the cached bitmap.
+void layer_set_cached(Layer *layer, bool cached);
+
+//! Gets whether the rendered output of the layer is cached.
+//! @param layer The layer for which to get the caching property
+//! @return True if caching is enabled for the layer, false if it is not enabled.
+//! @see \ref layer_set_cached()
+bool layer_get_cached(const Layer *layer);
+
+//! Sets whether the children of the layer are kept in a spatial index. The index divides the
+//! layer's bounds into a grid of `cell_size` buckets and records which children's frames
+//! intersect each bucket. When rendering, the children that do not intersect the dirty area or
+//! that are hidden are skipped without visiting their subtrees. This is beneficial for layers
+//! with many children, like grids of 100 or more cells, at the cost of a heap allocated index.
+//! The index is updated when children are added or removed and when their frames change.
+//! @note If the index cannot be allocated, the children are traversed as if it was disabled.
+//! @param layer The parent layer for which to set the spatial index
+//! @param cell_size The size of a grid bucket, or \ref GSizeZero to disable the index and free it
+void layer_set_spatial_index(Layer *layer, GSize cell_size);
+
+//! Gets the bucket size of the layer's spatial index.
+//! @param layer The layer for which to get the bucket size of the spatial index
+//! @return The size of a grid bucket, or \ref GSizeZero if the index is disabled.
+//! @see \ref layer_set_spatial_index()
+GSize layer_get_spatial_index(const Layer *layer);
+
 //! Gets the data from a layer that has been created with an extra data region.
 //! @param layer The layer to get the data region from.
 //! @return A void pointer to the data region.
@@ -5325,8 +8626,8 @@ typedef struct WindowHandlers {
   //! to the window.
   WindowHandler disappear;
 
-  //! Called when the window is deinited, but could be used in the future to
-  //! free resources bound to windows that are not on screen.
+  //! Called when the window is deinited, and when it hibernates while other windows cover it
+  //! (see \ref window_set_hibernation_handlers()), to free resources bound to the window.
   WindowHandler unload;
 } WindowHandlers;
 
@@ -5391,6 +8692,30 @@ struct Layer* window_get_root_layer(const Window *window);
 //! @see \ref window_get_root_layer()
 void window_set_background_color(Window *window, GColor background_color);
 
+//! Sets whether the window is drawn over the windows below it on the window stack instead of
+//! replacing them, for dialogs and menus that only cover part of the screen. Wherever the
+//! window's layers do not draw, including its root layer if its background color is
+//! \ref GColorClear, the window below shows through.
+//! While a transparent window is the topmost window, the windows below it are not drawn on every
+//! frame: they are rendered once into a bitmap the size of the screen, and each frame starts from
+//! that bitmap, so only the layers of the topmost window are drawn. A covered window is only
+//! rendered into the bitmap again where one of its layers has been marked dirty, with
+//! \ref layer_mark_dirty() or \ref layer_mark_dirty_rect(), and only that region of the screen
+//! is composited again, so a dialog over a static view costs about as much as the dialog alone.
+//! Covered windows stay loaded and do not hibernate, see
+//! \ref window_stack_set_hibernation_depth(), since they are still visible.
+//! @note If the bitmap cannot be allocated, the covered windows are drawn on every frame.
+//! @param window The window for which to set the transparency
+//! @param transparent Supply `true` to draw the window over the windows below it, or `false`
+//! (default) to cover the whole screen with it and free the bitmap of the windows below.
+void window_set_transparent(Window *window, bool transparent);
+
+//! Gets whether the window is drawn over the windows below it.
+//! @param window The window for which to get the transparency
+//! @return true if the window is transparent, false if it is not.
+//! @see \ref window_set_transparent()
+bool window_get_transparent(const Window *window);
+
 //! Gets whether the window has been loaded.
 //! If a window is loaded, its `.load` handler has been called (and the `.unload` handler
 //! has not been called since).
@@ -5399,6 +8724,71 @@ void window_set_background_color(Window *window, GColor background_color);
 //! @see \ref WindowHandlers
 bool window_is_loaded(Window *window);
 
+//! Preloads the window ahead of pushing it onto the window stack. When the app's event loop is
+//! idle, the window's `.load` handler is called and the window is rendered into an offscreen
+//! bitmap, so that a later \ref window_stack_push() of the window can start its transition
+//! immediately. Calling this on a window that is loaded or already preloading is a no-op.
+//! @note A preloaded window that has not been pushed yet is unloaded again, calling its `.unload`
+//! handler, when the app runs low on memory. The least recently preloaded windows are unloaded
+//! first. Use \ref window_is_loaded() to check whether a preloaded window is still loaded.
+//! @param window The window to preload
+//! @see window_cancel_preload
+void window_preload(Window *window);
+
+//! Cancels the preloading of a window that has not been pushed onto the window stack. If the
+//! window has already been loaded ahead of time, its `.unload` handler is called and the
+//! offscreen bitmap is released.
+//! @param window The window for which to cancel the preloading
+//! @see window_preload
+void window_cancel_preload(Window *window);
+
+//! Called before a window hibernates, to save the state that its view hierarchy cannot be
+//! rebuilt from, such as a scroll offset or the selected row of a menu.
+//! @param window The window that is about to hibernate
+//! @param[out] buffer Buffer to write the state into
+//! @param buffer_size The size of `buffer`, as passed to \ref window_set_hibernation_handlers()
+//! @return The number of bytes written to `buffer`
+typedef size_t (*WindowSaveStateHandler)(struct Window *window, void *buffer,
+                                         size_t buffer_size);
+
+//! Called after a hibernated window has been loaded again, with the state that was saved when it
+//! hibernated.
+//! @param window The window that woke up from hibernation
+//! @param buffer The state returned by the \ref WindowSaveStateHandler
+//! @param size The number of bytes of state
+typedef void (*WindowRestoreStateHandler)(struct Window *window, const void *buffer,
+                                          size_t size);
+
+//! Handlers for saving and restoring the state of a window across hibernation.
+//! @see \ref window_set_hibernation_handlers()
+typedef struct WindowHibernationHandlers {
+  //! Called before the window's `.unload` handler when it hibernates. Optional.
+  WindowSaveStateHandler save_state;
+  //! Called after the window's `.load` handler when it wakes up. Optional.
+  WindowRestoreStateHandler restore_state;
+} WindowHibernationHandlers;
+
+//! Allows a window to hibernate while other windows cover it. A hibernating window stays on the
+//! window stack but releases its view hierarchy: its state is saved with the
+//! \ref WindowSaveStateHandler and its `.unload` handler is called, which should destroy its
+//! layers and bitmaps as usual. When the window is about to be revealed again, its `.load`
+//! handler and then the \ref WindowRestoreStateHandler are called before it appears, so deep
+//! navigation only keeps the top few windows in memory without any extra unload or reload logic
+//! in the app. See \ref window_stack_set_hibernation_depth() for which windows hibernate.
+//! @note The window itself and its user data are kept, so state can also be kept there instead
+//! of in the saved state buffer.
+//! @param window The window to allow to hibernate
+//! @param handlers The handlers to save and restore the window's state
+//! @param state_size The maximum size of the window's saved state, which the system allocates
+//! while the window hibernates. Can be 0 if no state needs to be saved.
+void window_set_hibernation_handlers(Window *window, WindowHibernationHandlers handlers,
+                                     size_t state_size);
+
+//! Gets whether a window is currently hibernating.
+//! @param window The window to query
+//! @return true if the window's view hierarchy has been released by hibernation
+bool window_is_hibernating(Window *window);
+
 //! Sets a pointer to developer-supplied data that the window uses, to
 //! provide a means to access the data at later times in one of the window event handlers.
 //! @see window_get_user_data
@@ -5471,6 +8861,20 @@ void window_raw_click_subscribe(ButtonId button_id, ClickHandler down_handler, C
 //! @param context Set the context that will be passed to handlers for the given button's events.
 void window_set_click_context(ButtonId button_id, void *context);
 
+//! Configures the repeating click subscription of the given button.
+//! When repeats are coalesced, the repetitions that occur while the app is busy are accumulated and
+//! the handler is called at most once per rendered frame; use
+//! \ref click_number_of_clicks_counted() in the handler to get the accumulated count. This keeps
+//! handlers that redraw on every repetition from queuing up faster than the app can render.
+//! @note Must be called from within the \ref ClickConfigProvider, after
+//! \ref window_single_repeating_click_subscribe() has been called for the button.
+//! @param button_id The button to configure
+//! @param acceleration How the repeat interval changes while the button is held down
+//! @param coalesce Supply `true` to coalesce repetitions, or `false` to call the handler once for
+//! every repetition (default).
+void window_set_click_repeat_options(ButtonId button_id, ClickRepeatAcceleration acceleration,
+                                     bool coalesce);
+
 //! @} // group Window
 
 //! @addtogroup WindowStack Window Stack
@@ -5501,6 +8905,9 @@ void window_set_click_context(ButtonId button_id, void *context);
 //! @param window The window to push on top
 //! @param animated Pass in `true` to animate the push using a sliding animation,
 //! or `false` to skip the animation.
+//! @note During an animated transition, the outgoing window is rendered once into a snapshot
+//! bitmap and the incoming window is only rendered again when one of its layers is marked
+//! dirty, instead of fully redrawing both windows on every frame of the transition.
 void window_stack_push(Window *window, bool animated);
 
 //! Pops the topmost window on the navigation stack
@@ -5536,6 +8943,66 @@ Window* window_stack_get_top_window(void);
 //! @return true if the window is currently on the window stack.
 bool window_stack_contains_window(Window *window);
 
+//! Sets how many windows below the topmost window stay loaded. Windows further down the stack
+//! that have \ref window_set_hibernation_handlers() set hibernate once they are covered, and
+//! wake up when they are about to become the topmost window again. Windows a push or pop
+//! transition reveals are woken before the transition starts.
+//! When the app runs low on memory, covered windows within the depth hibernate as well,
+//! starting with the lowest.
+//! @param depth The number of covered windows that stay loaded. The default is 1, so the window
+//! revealed by popping the top window is always ready.
+void window_stack_set_hibernation_depth(uint8_t depth);
+
+//! Pointer to function that renders a frame of a custom window transition.
+//! @param ctx The destination graphics context of the frame
+//! @param from_snapshot The snapshot of the outgoing window, rendered once at the start of the
+//! transition
+//! @param to_snapshot The snapshot of the incoming window. It is only rendered again when one of
+//! the window's layers is marked dirty during the transition.
+//! @param distance_normalized The current normalized distance of the transition, from
+//! \ref ANIMATION_NORMALIZED_MIN to \ref ANIMATION_NORMALIZED_MAX, with the ease-in-out curve
+//! applied
+//! @param context The pointer to custom, application specific data, as passed to
+//! \ref window_stack_push_with_transition() or \ref window_stack_remove_with_transition()
+typedef void (*WindowTransitionRenderProc)(GContext *ctx, const GBitmap *from_snapshot,
+                                           const GBitmap *to_snapshot,
+                                           uint32_t distance_normalized, void *context);
+
+//! Data structure describing a custom window transition.
+//! @see window_stack_push_with_transition
+typedef struct WindowTransitionImplementation {
+  //! The duration of the transition in milliseconds.
+  uint32_t duration_ms;
+  //! Called for every frame of the transition. This callback is mandatory and should not be left
+  //! `NULL`.
+  WindowTransitionRenderProc render;
+} WindowTransitionImplementation;
+
+//! Pushes the given window on the window navigation stack using a custom transition.
+//! The transition is built on the same snapshots as the system transitions, see the note with
+//! \ref window_stack_push().
+//! @note If the snapshot bitmaps cannot be allocated, the window is pushed without a transition.
+//! @param window The window to push on top
+//! @param transition The transition to use. In most cases, it makes sense to pass in a
+//! `static const` struct pointer.
+//! @param context A pointer to application specific data that is passed to the transition's
+//! `.render` callback
+void window_stack_push_with_transition(Window *window,
+                                       const WindowTransitionImplementation *transition,
+                                       void *context);
+
+//! Removes a given window from the window stack using a custom transition. The transition is
+//! only used in case the window happens to be on top of the window stack (thus visible).
+//! See \ref window_stack_remove() for notes.
+//! @param window The window to remove
+//! @param transition The transition to use to reveal the next window
+//! @param context A pointer to application specific data that is passed to the transition's
+//! `.render` callback
+//! @return True if window was successfully removed, false otherwise.
+bool window_stack_remove_with_transition(Window *window,
+                                         const WindowTransitionImplementation *transition,
+                                         void *context);
+
 //! @} // group WindowStack
 
 //! @addtogroup Animation
@@ -5548,6 +9015,12 @@ bool window_stack_contains_window(Window *window);
 //!
 //! Refer to the \htmlinclude UiFramework.html (chapter "Animation") for a conceptual overview
 //! of the animation framework and on how to write custom animations.
+//!
+//! All scheduled animations are advanced together by a single frame clock that is aligned with
+//! the display refresh. During a frame, the values that property animations write onto the same
+//! layer are coalesced and the layer is marked dirty once, so running many animations
+//! concurrently does not cause redundant redraws. Custom animations can use
+//! \ref animation_get_frame_time() to keep their own state in sync with the frame clock.
 //! @{
 
 struct Animation;
@@ -5573,8 +9046,9 @@ typedef enum {
   AnimationCurveCustomFunction = 4,
   //! User-provided interpolation function
   AnimationCurveCustomInterpolationFunction = 5,
-  // Two more Reserved for forward-compatibility use.
-  AnimationCurve_Reserved1 = 6,
+  //! Sampled curve table, see \ref animation_set_curve_table()
+  AnimationCurveCustomTable = 6,
+  // One more Reserved for forward-compatibility use.
   AnimationCurve_Reserved2 = 7,
 } AnimationCurve;
 
@@ -5768,6 +9242,55 @@ bool animation_set_custom_curve(Animation *animation, AnimationCurveFunction cur
 //! @return The custom animation curve function for the given animation. NULL if not set.
 AnimationCurveFunction animation_get_custom_curve(Animation *animation);
 
+//! A sampled animation curve. The animation system evaluates the curve by linearly
+//! interpolating between the two samples around the linear normalized distance, which is much
+//! cheaper than calling an \ref AnimationCurveFunction on every frame.
+//! @see animation_set_curve_table
+typedef struct AnimationCurveTable {
+  //! The number of samples in the table, at least 2. A power of two (for example 64) is the
+  //! fastest to evaluate.
+  uint16_t num_samples;
+  //! The curved distances, sampled at evenly spaced linear normalized distances from
+  //! \ref ANIMATION_NORMALIZED_MIN (first sample) to \ref ANIMATION_NORMALIZED_MAX (last sample).
+  //! Values outside that range can be used for overshooting curves.
+  const AnimationProgress *samples;
+} AnimationCurveTable;
+
+//! Built-in curve tables for common easings that are not covered by \ref AnimationCurve.
+//! @see animation_get_builtin_curve_table
+typedef enum {
+  AnimationCurveTableEaseInSine = 0, //!< Sinusoidal ease-in
+  AnimationCurveTableEaseOutSine,    //!< Sinusoidal ease-out
+  AnimationCurveTableEaseInOutSine,  //!< Sinusoidal ease-in-out
+  AnimationCurveTableEaseInBack,     //!< Pulls back slightly before accelerating
+  AnimationCurveTableEaseOutBack,    //!< Overshoots the end slightly before settling
+  AnimationCurveTableEaseOutElastic, //!< Oscillates around the end before settling
+  AnimationCurveTableEaseOutBounce,  //!< Bounces against the end before settling
+  NumAnimationCurveTables
+} AnimationBuiltinCurveTable;
+
+//! Sets a sampled curve table as the animation curve, and sets the curve of the animation to
+//! \ref AnimationCurveCustomTable.
+//! @note Trying to set an attribute when an animation is immutable will return false (failure). An
+//! animation is immutable once it has been added to a sequence or spawn animation or has been
+//! scheduled.
+//! @note The table is not copied and must remain valid while the animation exists.
+//! @param animation The animation for which to set the curve.
+//! @param table The curve table.
+//! @see AnimationCurveTable
+//! @return true if successful, false on failure
+bool animation_set_curve_table(Animation *animation, const AnimationCurveTable *table);
+
+//! Gets the sampled curve table for the animation.
+//! @param animation The animation for which to get the curve.
+//! @return The curve table for the given animation. NULL if not set.
+const AnimationCurveTable *animation_get_curve_table(Animation *animation);
+
+//! Gets one of the built-in curve tables, to be used with \ref animation_set_curve_table().
+//! @param curve The built-in curve to get
+//! @return The curve table, or NULL if `curve` is not a valid built-in curve.
+const AnimationCurveTable *animation_get_builtin_curve_table(AnimationBuiltinCurveTable curve);
+
 //! The function pointer type of the handler that will be called when an animation is started,
 //! just before updating the first frame of the animation.
 //! @param animation The animation that was started.
@@ -5946,6 +9469,19 @@ bool animation_set_implementation(Animation *animation,
 //! @return NULL if animation implementation has not been setup.
 const AnimationImplementation* animation_get_implementation(Animation *animation);
 
+//! Gets the time of the current frame of the animation frame clock. All scheduled animations are
+//! updated with the same frame time, so it can be used by the `.update` implementation of a
+//! custom animation to advance other state, like a physics simulation, in lockstep with the
+//! animations that run alongside it.
+//! @return The time of the current frame in milliseconds, relative to an arbitrary epoch.
+//! @see animation_get_frame_interval
+uint32_t animation_get_frame_time(void);
+
+//! Gets the interval at which the animation frame clock advances the scheduled animations.
+//! @return The duration of one animation frame in milliseconds.
+//! @see animation_get_frame_time
+uint32_t animation_get_frame_interval(void);
+
 //! @addtogroup PropertyAnimation
 //! \brief A ProperyAnimation animates the value of a "property" of a "subject" over time.
 //!
@@ -6053,6 +9589,64 @@ PropertyAnimation *property_animation_create_bounds_origin(struct Layer *layer,
 PropertyAnimation* property_animation_create(const PropertyAnimationImplementation *implementation,
                       void *subject, void *from_value, void *to_value);
 
+//! Types of fields that can be animated with \ref property_animation_create_with_fields().
+typedef enum {
+  PropertyAnimationFieldTypeInt16 = 0, //!< The field is of type int16_t
+  PropertyAnimationFieldTypeUInt32,    //!< The field is of type uint32_t
+  PropertyAnimationFieldTypeGPoint,    //!< The field is of type GPoint
+  PropertyAnimationFieldTypeGRect,     //!< The field is of type GRect
+  PropertyAnimationFieldTypeGColor8,   //!< The field is of type GColor8
+} PropertyAnimationFieldType;
+
+//! Describes a field of the subject that is animated by
+//! \ref property_animation_create_with_fields().
+typedef struct PropertyAnimationField {
+  //! The offset of the field within the subject, as returned by `offsetof()`.
+  uint16_t offset;
+  //! The type of the field.
+  PropertyAnimationFieldType type;
+  //! Pointer to the value that the field should animate from, or `NULL` to use the field's
+  //! current value.
+  const void *from_value;
+  //! Pointer to the value that the field should animate to, or `NULL` to use the field's
+  //! current value.
+  const void *to_value;
+} PropertyAnimationField;
+
+//! Creates a new PropertyAnimation on the heap that animates one or more fields of a subject
+//! struct directly. Instead of calling setter and getter accessors, the animation writes the
+//! interpolated values straight into the fields at the given offsets, which avoids an indirect
+//! call per frame per property and lets one animation drive many fields at once.
+//! The same defaults are used as with \ref animation_create().
+//! \code{.c}
+//! typedef struct {
+//!   GPoint position;
+//!   GColor8 color;
+//! } Particle;
+//! static Particle s_particle;
+//! static const GPoint s_to_position = {100, 20};
+//! static const GColor8 s_to_color = {.argb = GColorRedARGB8};
+//! ...
+//! const PropertyAnimationField fields[] = {
+//!   { offsetof(Particle, position), PropertyAnimationFieldTypeGPoint, NULL, &s_to_position },
+//!   { offsetof(Particle, color), PropertyAnimationFieldTypeGColor8, NULL, &s_to_color },
+//! };
+//! PropertyAnimation *animation = property_animation_create_with_fields(
+//!     &s_particle, fields, ARRAY_LENGTH(fields), s_particle_layer);
+//! animation_schedule(property_animation_get_animation(animation));
+//! \endcode
+//! @param subject Pointer to the struct whose fields are animated. The value of this pointer
+//! will be copied into the `.subject` field of the PropertyAnimation struct.
+//! @param fields The fields to animate. The descriptors and the values they point to are copied,
+//! so they do not need to remain valid after this call.
+//! @param num_fields The number of elements in `fields`
+//! @param dirty_layer A layer to mark dirty on every frame in which the fields changed, or `NULL`
+//! @return A handle to the property animation. `NULL` if animation could not be created
+PropertyAnimation *property_animation_create_with_fields(void *subject,
+                                                         const PropertyAnimationField *fields,
+                                                         uint16_t num_fields,
+                                                         struct Layer *dirty_layer);
+
 //! Destroy a property animation allocated by property_animation_create() or relatives.
 //! @param property_animation the return value from property_animation_create
 void property_animation_destroy(PropertyAnimation* property_animation);
@@ -6376,6 +9970,84 @@ bool property_animation_to(PropertyAnimation *property_animation, void *to, size
 
 //! @} // group PropertyAnimation
 
+//! @addtogroup PaletteAnimation
+//! \brief Animating the colors of a palettized bitmap without redrawing it
+//!
+//! Color effects on palettized bitmaps, such as a glowing status icon or rain running down a
+//! weather icon, only need the bitmap's palette to change from frame to frame, not its pixels.
+//! A PaletteAnimation changes the entries of the palette of a \ref GBitmapFormat1BitPalette,
+//! \ref GBitmapFormat2BitPalette or \ref GBitmapFormat4BitPalette bitmap as its \ref Animation
+//! runs, and only on the frames where an entry actually changes does it rebuild the bitmap's
+//! expansion table (see \ref gbitmap_set_palette()) and mark the region of the layer where the
+//! bitmap is drawn dirty with \ref layer_mark_dirty_rect(). If that region is all that changes
+//! on screen, nothing else of the window is drawn and only its rows are sent to the display.
+//!
+//! Code example:
+//! \code{.c}
+//! // Cycle palette entries 1 to 6 of the icon once per second, forever.
+//! s_cycle = palette_animation_create_cycle(s_icon, 1, 6);
+//! palette_animation_set_layer(s_cycle, s_icon_layer, GRect(8, 8, 48, 48));
+//! Animation *animation = palette_animation_get_animation(s_cycle);
+//! animation_set_duration(animation, 1000);
+//! animation_set_curve(animation, AnimationCurveLinear);
+//! animation_set_play_count(animation, ANIMATION_PLAY_COUNT_INFINITE);
+//! animation_schedule(animation);
+//! \endcode
+//!
+//! The palette is changed in place, so it must be writable and be the palette the bitmap was
+//! created with or set to; bitmaps shared with \ref gbitmap_acquire() change for every user.
+//! @{
+
+//! Opaque handle to a palette animation.
+typedef struct PaletteAnimation PaletteAnimation;
+
+//! Creates a palette animation that fades the palette of a bitmap to other colors.
+//! Each entry is interpolated from its color when the animation is created to the entry of the
+//! same index in `to_palette`, channel by channel. Channels have four levels, so each channel of
+//! an entry steps at most three times in the whole animation. Channels that move by different
+//! amounts step at different times, and frames in which no entry changes cost nothing.
+//! @param bitmap The palettized bitmap to animate
+//! @param to_palette The colors at the end of the animation, with as many entries as the palette
+//! of the bitmap. The colors are copied.
+//! @return A handle to the palette animation, or `NULL` if the bitmap is not palettized or there
+//! was not enough memory.
+PaletteAnimation *palette_animation_create(GBitmap *bitmap, const GColor *to_palette);
+
+//! Creates a palette animation that rotates a range of palette entries, the classic color
+//! cycling effect. Over the whole animation the colors of entries `first_index` to
+//! `first_index + count - 1` each move one entry up, `count` times, and the last color wraps
+//! around to the first entry, so the palette is back where it started at the end and the
+//! animation can be repeated seamlessly with \ref animation_set_play_count().
+//! @param bitmap The palettized bitmap to animate
+//! @param first_index The first palette entry to rotate
+//! @param count The number of entries to rotate, at least 2
+//! @return A handle to the palette animation, or `NULL` if the bitmap is not palettized, the range
+//! is outside of its palette or there was not enough memory.
+PaletteAnimation *palette_animation_create_cycle(GBitmap *bitmap, uint8_t first_index,
+                                                 uint8_t count);
+
+//! Sets the layer that draws the bitmap, and where. Without a layer the palette still changes,
+//! but nothing is marked dirty, for example when the app redraws the window on every frame anyway.
+//! @param palette_animation The palette animation
+//! @param layer The layer that draws the bitmap
+//! @param rect The region of the layer that the bitmap covers, in the coordinate system (bounds)
+//! of the layer. Only this region is marked dirty when the palette changes.
+void palette_animation_set_layer(PaletteAnimation *palette_animation, Layer *layer, GRect rect);
+
+//! Convenience function to retrieve an animation instance from a palette animation instance,
+//! to set its duration, curve and play count and to schedule it.
+//! @param palette_animation The palette animation
+//! @return The \ref Animation within this palette animation
+Animation *palette_animation_get_animation(PaletteAnimation *palette_animation);
+
+//! Destroys a palette animation. This unschedules its animation; the palette keeps the colors it
+//! had at that moment. Like property animations, palette animations are also destroyed when
+//! their \ref Animation is, which happens automatically after it has finished playing.
+//! @param palette_animation The palette animation to destroy
+void palette_animation_destroy(PaletteAnimation *palette_animation);
+
+//! @} // group PaletteAnimation
+
 //! @} // group Animation
 
 //! @addtogroup UnobstructedArea
@@ -6420,6 +10092,21 @@ void unobstructed_area_service_subscribe(UnobstructedAreaHandlers handlers, void
 //! Unsubscribe from notifications about changes to the app's unobstructed area.
 void unobstructed_area_service_unsubscribe(void);
 
+//! Register a layer whose frame should follow changes of the unobstructed area automatically.
+//! While the unobstructed area is fully visible, the layer uses the frame it has when this is
+//! called; while it is fully obstructed, the layer uses `obstructed_frame`. On every step of an
+//! unobstructed area change, the system interpolates the frame of each registered layer from the
+//! progress and marks only the registered layers (and the area they move across) dirty, so the
+//! app does not need to recompute its whole layout in the `change` handler.
+//! @param layer The layer to move with the unobstructed area.
+//! @param obstructed_frame The frame of the layer while the unobstructed area is fully obstructed.
+//! @return true if the layer was registered, false if there was not enough memory.
+bool unobstructed_area_layout_add_layer(Layer *layer, GRect obstructed_frame);
+
+//! Stop moving a layer with the unobstructed area. The layer keeps its current frame.
+//! @param layer The layer that was registered with \ref unobstructed_area_layout_add_layer.
+void unobstructed_area_layout_remove_layer(Layer *layer);
+
 //! @} // group UnobstructedArea
 
 //! @addtogroup Layer
@@ -6434,6 +10121,10 @@ void unobstructed_area_service_unsubscribe(void);
 //! other properties that influence how the text is drawn. Most important of these properties are:
 //! a pointer to the string to draw itself, the font, the text color, the background color of the
 //! layer, the overflow mode and alignment of the text inside the layer.
+//!
+//! A TextLayer keeps the layout of its text cached and only computes it again when the text,
+//! font, frame, overflow mode, alignment or text flow settings change, so redrawing a static
+//! label is no more expensive than drawing its glyphs.
 //! @see Layer
 //! @see TextDrawing
 //! @see Fonts
@@ -6497,6 +10188,8 @@ void text_layer_set_text_color(TextLayer *text_layer, GColor color);
 //! Sets the line break mode of the TextLayer
 //! @param text_layer The TextLayer of which to set the overflow mode
 //! @param line_mode The new \ref GTextOverflowMode to set
+//! @note With \ref GTextOverflowModeTrailingEllipsis and \ref GTextOverflowModeFill, only the
+//! lines that fit inside the frame are laid out; the rest of the text is not measured.
 void text_layer_set_overflow_mode(TextLayer *text_layer, GTextOverflowMode line_mode);
 
 //! Sets the font of the TextLayer
@@ -6520,6 +10213,10 @@ void text_layer_set_text_alignment(TextLayer *text_layer, GTextAlignment text_al
 //!   Otherwise it has no effect.
 //! @param text_layer The TextLayer for which to enable text flow and paging
 //! @param inset Additional amount of pixels to inset to the inside of the screen for text flow
+//! @note The line widths and line breaks are cached as described for
+//! \ref graphics_text_attributes_enable_screen_text_flow and
+//! \ref graphics_text_attributes_enable_paging, so a long TextLayer in a \ref ScrollLayer only
+//! lays out its text again when the text, font or frame changes.
 //! @see text_layer_restore_default_text_flow_and_paging
 //! @see graphics_text_attributes_enable_screen_text_flow
 //! @see graphics_text_attributes_enable_paging
@@ -6537,6 +10234,13 @@ void text_layer_restore_default_text_flow_and_paging(TextLayer *text_layer);
 //! @return The size occupied by the current text of the TextLayer
 GSize text_layer_get_content_size(TextLayer *text_layer);
 
+//! Checks whether the text of the TextLayer fits entirely within its frame, without laying out
+//! the lines that would be truncated.
+//! @param text_layer The TextLayer to check
+//! @return `true` if the whole text is displayed, `false` if it is truncated
+//! @see graphics_text_fits_in_box
+bool text_layer_text_fits(TextLayer *text_layer);
+
 //! Update the size of the text layer
 //! This is a convenience function to update the frame of the TextLayer.
 //! @param text_layer The TextLayer of which to set the size
@@ -6733,6 +10437,8 @@ void scroll_layer_scroll_down_click_handler(ClickRecognizerRef recognizer, void
 //! @param scroll_layer The scroll layer for which to set the shadow visibility
 //! @param hidden Supply `true` to make the shadow hidden, or `false` to make it
 //! non-hidden.
+//! @note The shadows are rendered once into cached bitmaps and copied on top of the content, and
+//! each shadow is only redrawn when it appears or retracts, not on every scroll offset change.
 void scroll_layer_set_shadow_hidden(ScrollLayer *scroll_layer, bool hidden);
 
 //! Gets the visibility of the scroll layer shadow.
@@ -6751,6 +10457,29 @@ void scroll_layer_set_paging(ScrollLayer *scroll_layer, bool paging_enabled);
 //! @return True, if paging is enabled; false otherwise.
 bool scroll_layer_get_paging(ScrollLayer *scroll_layer);
 
+//! Enables or disables tiled rendering of the ScrollLayer's content (default: disabled). When
+//! enabled, the content is split into horizontal tiles of `tile_height` pixels and the child
+//! layers added with \ref scroll_layer_add_child() are indexed by the tiles their frames
+//! intersect. Each redraw then only visits the children that intersect the visible viewport,
+//! instead of traversing and clipping every child, which keeps very tall content (long articles,
+//! maps) scrolling at full frame rate. The rendered output of up to `num_cached_tiles` tiles
+//! next to the viewport is kept in offscreen bitmaps, so scrolling onto them only has to blit.
+//! @note The index is updated when children are added or removed and when their frames change.
+//! A cached tile is rendered again after \ref layer_mark_dirty() has been called on a child
+//! that intersects it.
+//! @note If the tile bitmaps cannot be allocated, fewer tiles are cached.
+//! @param scroll_layer The scroll layer for which to configure tiled rendering
+//! @param tile_height The height of a tile in pixels, or 0 to disable tiled rendering
+//! @param num_cached_tiles The number of rendered tiles that are kept around the viewport
+void scroll_layer_set_tiled_rendering(ScrollLayer *scroll_layer, int16_t tile_height,
+                                      uint8_t num_cached_tiles);
+
+//! Gets the tile height used for tiled rendering of the ScrollLayer's content.
+//! @param scroll_layer The scroll layer for which to get the tile height
+//! @return The tile height in pixels, or 0 if tiled rendering is disabled.
+//! @see \ref scroll_layer_set_tiled_rendering()
+int16_t scroll_layer_get_tile_height(const ScrollLayer *scroll_layer);
+
 struct ContentIndicator;
 typedef struct ContentIndicator ContentIndicator;
 
@@ -6812,6 +10541,9 @@ bool content_indicator_get_content_available(ContentIndicator *content_indicator
 //! @param available Whether or not content is available.
 //! @note If times_out is enabled, calling this function resets any previously scheduled timeout
 //! timer for the ContentIndicator.
+//! @note The arrow is rendered once into a small cached bitmap when the direction is configured,
+//! and the direction's layer is only marked dirty when the availability actually changes, so
+//! this function can be called on every scroll offset change.
 void content_indicator_set_content_available(ContentIndicator *content_indicator,
                                              ContentIndicatorDirection direction,
                                              bool available);
@@ -7281,6 +11013,61 @@ MenuIndex menu_layer_get_selected_index(const MenuLayer *menu_layer);
 //! @param menu_layer The \ref MenuLayer for which to reload the data.
 void menu_layer_reload_data(MenuLayer *menu_layer);
 
+//! Enables or disables virtualized layout for the menu. By default, \ref menu_layer_reload_data()
+//! calls the `.get_cell_height` callback for every row in the menu, which becomes slow for
+//! menus with thousands of rows. In virtualized mode the menu caches each row's height once it
+//! has been measured and only requests heights (and draws) rows that are visible plus a small
+//! lookahead window around them. Rows that scroll out of the window have their draw state
+//! recycled for the rows that scroll into it. Until a row has been measured, its height is
+//! estimated using the most recently measured row height.
+//! @note In virtualized mode the `.get_cell_height` callback must return the same height for a
+//! given row until that row is reloaded with \ref menu_layer_reload_rows() or
+//! \ref menu_layer_reload_data().
+//! @param menu_layer The \ref MenuLayer to configure
+//! @param virtualized true to enable virtualized layout, false to measure every row (default)
+//! @param lookahead_rows The number of rows above and below the visible rows that are measured
+//! ahead of time, so that scrolling does not have to wait for the callbacks
+void menu_layer_set_virtualized(MenuLayer *menu_layer, bool virtualized, uint16_t lookahead_rows);
+
+//! Reloads a range of rows in one section of the menu. Only the rows in the range are
+//! re-requested with the relevant callbacks and have their cached heights invalidated, so
+//! appending data to a long menu does not re-measure the whole list. The number of sections and
+//! the number of rows in each section are re-requested as well, so this can be used after rows
+//! are appended to the end of a section.
+//! The current selection and scroll position will not be changed.
+//! @param menu_layer The \ref MenuLayer for which to reload the rows.
+//! @param first_index The \ref MenuIndex of the first row to reload
+//! @param num_rows The number of rows to reload, starting at `first_index.row`
+void menu_layer_reload_rows(MenuLayer *menu_layer, MenuIndex first_index, uint16_t num_rows);
+
+//! Inserts rows into one section of the menu. The data source must already contain the new
+//! rows when this is called. Only the inserted rows are requested with the relevant callbacks;
+//! the rows after them are shifted down, animating into place. If the inserted rows are above
+//! the visible rows, the scroll offset is adjusted so the visible content stays in place, and
+//! the selection stays on the same row.
+//! @param menu_layer The \ref MenuLayer to update
+//! @param first_index The \ref MenuIndex at which the first new row is inserted
+//! @param num_rows The number of rows that were inserted
+void menu_layer_insert_rows(MenuLayer *menu_layer, MenuIndex first_index, uint16_t num_rows);
+
+//! Deletes rows from one section of the menu. The data source must already have removed the
+//! rows when this is called. The rows after them are shifted up, animating into place, and the
+//! scroll offset is adjusted so the visible content stays in place. If the selected row is
+//! deleted, the selection moves to the row that takes its place, or to the last row of the
+//! section if no such row exists.
+//! @param menu_layer The \ref MenuLayer to update
+//! @param first_index The \ref MenuIndex of the first row that was deleted
+//! @param num_rows The number of rows that were deleted
+void menu_layer_delete_rows(MenuLayer *menu_layer, MenuIndex first_index, uint16_t num_rows);
+
+//! Updates rows in one section of the menu whose contents changed. The rows are requested again
+//! with the relevant callbacks and redrawn; if their heights changed, the rows after them are
+//! moved, animating into place, while the scroll position is kept stable.
+//! @param menu_layer The \ref MenuLayer to update
+//! @param first_index The \ref MenuIndex of the first row that changed
+//! @param num_rows The number of rows that changed
+void menu_layer_update_rows(MenuLayer *menu_layer, MenuIndex first_index, uint16_t num_rows);
+
 //! Returns whether or not the given cell layer is highlighted.
 //! Using this for determining highlight behaviour is preferable to using
 //! \ref menu_layer_get_selected_index. Row drawing callbacks may be invoked multiple
@@ -7312,6 +11099,28 @@ void menu_layer_set_normal_colors(MenuLayer *menu_layer, GColor background, GCol
 //! @see \ref menu_layer_set_normal_colors
 void menu_layer_set_highlight_colors(MenuLayer *menu_layer, GColor background, GColor foreground);
 
+//! Enables caching of rendered rows as bitmaps, up to the given amount of heap. With a cache,
+//! the `.draw_row` callback of a row is only called the first time the row is drawn in a given
+//! state, normal or highlighted, and the row is blitted from the cache after that. Scrolling a
+//! menu of static rows, such as a settings menu drawn with \ref menu_cell_basic_draw(), then
+//! costs one blit per visible row. During the selection animation, partially highlighted rows are
+//! composed from both cached variants. Rows are evicted least recently drawn first when the
+//! budget is exceeded, and the whole cache is released if the app runs low on heap.
+//!
+//! Cached rows are rendered again after \ref menu_layer_reload_data(),
+//! \ref menu_layer_reload_rows() or \ref menu_layer_update_rows() cover them, after changes to
+//! the normal or highlight colors, and whenever their height changes, for example when rows are
+//! focused on round displays. Header and separator drawing is not cached.
+//! @note Only enable the cache if `.draw_row` draws the same content for a row every time it is
+//! called with the same highlight state. Rows with animated content must be reloaded with
+//! \ref menu_layer_update_rows() when they change.
+//! @param menu_layer The \ref MenuLayer for which to cache rows
+//! @param budget_bytes The maximum number of heap bytes to use for cached rows. A full-width row
+//! of 44 pixels takes about 6 KB per variant on Basalt. Pass 0 to disable the cache and free all
+//! cached rows (default).
+//! @return True if the budget was applied, false if not even one row fits into it
+bool menu_layer_set_row_cache_budget(MenuLayer *menu_layer, size_t budget_bytes);
+
 //! This enables or disables padding at the bottom of the \ref MenuLayer.
 //! Padding at the bottom of the layer keeps the bottom item from being at the very bottom of the
 //! screen.
@@ -7415,6 +11224,35 @@ typedef struct {
 SimpleMenuLayer* simple_menu_layer_create(GRect frame, Window *window,
     const SimpleMenuSection *sections, int32_t num_sections, void *callback_context);
 
+//! Function signature for the callback to handle the SELECT button in a SimpleMenuLayer created
+//! with \ref simple_menu_layer_create_with_resource.
+//! @param section The section index of the item
+//! @param row The row index of the item within its section
+//! @param item_id The item_id of the item in the menu resource
+//! @param context The callback context
+typedef void (*SimpleMenuLayerResourceSelectCallback)(uint16_t section, uint16_t row,
+                                                      uint32_t item_id, void *context);
+
+//! Creates a new SimpleMenuLayer on the heap that displays a menu resource, see
+//! \ref MenuFileFormat. Only the menu's small state is allocated. Titles and subtitles are read
+//! from flash when their rows are drawn, and icons are loaded from their resources when their
+//! rows become visible and released again when they scroll out of view.
+//! It also sets the internal click configuration provider onto given window.
+//! @param frame The frame at which to initialize the menu
+//! @param window The window onto which to set the click configuration provider
+//! @param resource_id The ID of the menu resource
+//! @param callback The callback for the SELECT button on any of the items. Optional, pass
+//! `NULL` if unused.
+//! @param callback_context Pointer to application specific data, that is passed
+//! into the callback.
+//! @note This function does not add the menu's layer to the window.
+//! @return A pointer to the SimpleMenuLayer, to be destroyed with
+//! \ref simple_menu_layer_destroy(). `NULL` if the resource is not a menu resource or the
+//! SimpleMenuLayer could not be created
+SimpleMenuLayer* simple_menu_layer_create_with_resource(GRect frame, Window *window,
+    uint32_t resource_id, SimpleMenuLayerResourceSelectCallback callback,
+    void *callback_context);
+
 //! Destroys a SimpleMenuLayer previously created by simple_menu_layer_create.
 void simple_menu_layer_destroy(SimpleMenuLayer* menu_layer);
 
@@ -7747,6 +11585,16 @@ void status_bar_layer_set_colors(StatusBarLayer *status_bar_layer, GColor backgr
 void status_bar_layer_set_separator_mode(StatusBarLayer *status_bar_layer,
                                          StatusBarLayerSeparatorMode mode);
 
+//! Enables or disables the shared render cache of a StatusBarLayer. When enabled, the status bar
+//! is drawn from a system-owned render that is shared by all StatusBarLayers in the app with the
+//! same colors, separator mode and width. The shared render is only updated when the displayed
+//! clock or battery state changes, so pushing and popping windows that each have a status bar
+//! does not render the status bar again. Enabled by default.
+//! @param status_bar_layer The StatusBarLayer of which to set the caching mode
+//! @param enabled true to draw from the shared render cache, false to render the status bar
+//! every time it is drawn
+void status_bar_layer_set_shared_rendering(StatusBarLayer *status_bar_layer, bool enabled);
+
 //! @} // group StatusBarLayer
 
 //! @addtogroup BitmapLayer
@@ -7802,10 +11650,29 @@ const GBitmap* bitmap_layer_get_bitmap(BitmapLayer *bitmap_layer);
 //! in memory.
 //!
 //! The bitmap layer is automatically marked dirty after this operation.
+//! @note With the default \ref GCompOpAssign compositing mode, a bitmap that fills the layer is
+//! drawn by copying whole rows, see \ref GCompOpAssign.
 //! @param bitmap_layer The BitmapLayer for which to set the bitmap image
 //! @param bitmap The new \ref GBitmap to set onto the BitmapLayer
 void bitmap_layer_set_bitmap(BitmapLayer *bitmap_layer, const GBitmap *bitmap);
 
+//! Shows a placeholder in the BitmapLayer right away and loads a bitmap resource in the
+//! background, as \ref gbitmap_create_with_resource_async() does. Once the bitmap is loaded, it
+//! is set onto the layer as with \ref bitmap_layer_set_bitmap(), so a window full of images can
+//! appear immediately and fill in its images as they become ready.
+//!
+//! Unlike bitmaps set with \ref bitmap_layer_set_bitmap(), the loaded bitmap is owned by the
+//! layer. It is destroyed when another bitmap is set onto the layer or when the layer is
+//! destroyed, and a pending load is canceled in both cases as well.
+//! @param bitmap_layer The BitmapLayer to load the bitmap into
+//! @param resource_id The ID of the bitmap resource to load
+//! @param placeholder The bitmap to show until the resource is loaded, or when it cannot be
+//! loaded. Optional, pass `NULL` to show only the background color. The placeholder is set by
+//! reference and is not destroyed by the layer.
+//! @return true if the load was started
+bool bitmap_layer_set_bitmap_with_resource_async(BitmapLayer *bitmap_layer, uint32_t resource_id,
+                                                 const GBitmap *placeholder);
+
 //! Sets the alignment of the image to draw with in frame of the BitmapLayer.
 //! The aligment parameter specifies which edges of the bitmap should overlap
 //! with the frame of the BitmapLayer.
@@ -7921,6 +11788,22 @@ void rot_bitmap_set_src_ic(RotBitmapLayer *bitmap, GPoint ic);
 //! @see \ref GCompOp for visual examples of the different compositing modes.
 void rot_bitmap_set_compositing_mode(RotBitmapLayer *bitmap, GCompOp mode);
 
+//! Pre-renders the bitmap of a RotBitmapLayer at a fixed number of evenly spaced angles into a
+//! heap allocated sprite sheet. Afterwards, the layer draws the pre-rendered step closest to its
+//! current angle with a plain bitmap blit instead of rotating the bitmap on every redraw, which
+//! makes fast rotating content like seconds hands affordable.
+//! The sprite sheet is rendered again when the source bitmap's instance center is changed with
+//! \ref rot_bitmap_set_src_ic(), and it is freed when the layer is destroyed.
+//! @note The memory required is `num_steps` times the size of the layer's frame in the bitmap's
+//! format. Angles are snapped to the nearest step, so choose `num_steps` according to the
+//! smallest angle change that must be visible, for example 60 for a seconds hand.
+//! @param bitmap The RotBitmapLayer to pre-render
+//! @param num_steps The number of angles to pre-render over a full rotation. Pass 0 to free the
+//! sprite sheet and return to rotating on every redraw.
+//! @return True if the sprite sheet was rendered (or freed, for `num_steps == 0`), false if it
+//! could not be allocated
+bool rot_bitmap_layer_prerender_angle_steps(RotBitmapLayer *bitmap, uint16_t num_steps);
+
 //! @} // group RotBitmapLayer
 
 //! @} // group Layer
@@ -8116,6 +11999,42 @@ ActionMenuItem *action_menu_level_add_child(ActionMenuLevel *level,
                                             ActionMenuLevel *child,
                                             const char *label);
 
+//! Callback executed when the user navigates into a lazily built child level.
+//! @param action_menu the action menu currently on screen
+//! @param item the item of the parent level which leads to the child level
+//! @param context the context passed to the action menu
+//! @return the newly created child level, NULL to leave the user on the parent level
+//! @see action_menu_level_add_lazy_child
+typedef ActionMenuLevel *(*ActionMenuLevelBuildCb)(ActionMenu *action_menu,
+                                                   const ActionMenuItem *item,
+                                                   void *context);
+
+//! Callback executed when the user leaves a lazily built child level or the ActionMenu closes
+//! while it is shown, so its memory may be freed.
+//! @param action_menu the action menu currently on screen
+//! @param level the child level returned by the \ref ActionMenuLevelBuildCb
+//! @param context the context passed to the action menu
+//! @note Typical implementations call \ref action_menu_hierarchy_destroy on the level.
+typedef void (*ActionMenuLevelReleaseCb)(ActionMenu *action_menu,
+                                         ActionMenuLevel *level,
+                                         void *context);
+
+//! Add a child to this ActionMenuLevel that is only built when the user navigates into it and is
+//! released again when the user leaves it. This keeps memory bounded for large hierarchies and
+//! makes opening the ActionMenu faster, since only the levels on screen are allocated.
+//! @param level the parent level
+//! @param label the text to display in the action menu for this level
+//! @param build_cb the callback that will be triggered to build the child level
+//! @param release_cb the callback that will be triggered to release the child level
+//! @param child_data data which can be retrieved from the item with
+//! \ref action_menu_item_get_action_data in the callbacks
+//! @return a reference to the new \ref ActionMenuItem on success, NULL if the level is full
+ActionMenuItem *action_menu_level_add_lazy_child(ActionMenuLevel *level,
+                                                 const char *label,
+                                                 ActionMenuLevelBuildCb build_cb,
+                                                 ActionMenuLevelReleaseCb release_cb,
+                                                 void *child_data);
+
 //! Destroy a hierarchy of ActionMenuLevels
 //! @param root the root level in the hierarchy
 //! @param each_cb a callback to call on every \ref ActionMenuItem in every level
@@ -8233,6 +12152,54 @@ void vibes_double_pulse(void);
 //! @see VibePattern
 void vibes_enqueue_custom_pattern(VibePattern pattern);
 
+//! The maximum amplitude of a \ref VibeEnvelopeSegment, which is the motor's full strength.
+#define VIBE_AMPLITUDE_MAX 100
+
+//! Data structure describing one segment of a vibration envelope. During the segment the motor
+//! strength ramps linearly from `amplitude_start` to `amplitude_end`. Use the same value for both
+//! for a constant strength, and 0 for a pause.
+//! @see vibes_compile_envelope
+typedef struct {
+  //! The duration of the segment in milliseconds. The maximum allowed duration is 10000ms.
+  uint16_t duration_ms;
+  //! The motor strength at the start of the segment, from 0 to \ref VIBE_AMPLITUDE_MAX.
+  uint8_t amplitude_start;
+  //! The motor strength at the end of the segment, from 0 to \ref VIBE_AMPLITUDE_MAX.
+  uint8_t amplitude_end;
+} VibeEnvelopeSegment;
+
+struct CompiledVibePattern;
+typedef struct CompiledVibePattern CompiledVibePattern;
+
+//! Validates a vibration pattern and converts it to the motor driver's format once, so that it
+//! can be emitted any number of times with \ref vibes_enqueue_compiled_pattern() without being
+//! copied and validated again.
+//! @param pattern An arbitrary vibration pattern. The durations are copied, so the array does not
+//! need to stay valid after this call.
+//! @return A pointer to the compiled pattern, or NULL if the pattern is invalid or there was not
+//! enough memory
+CompiledVibePattern *vibes_compile_pattern(VibePattern pattern);
+
+//! Compiles a vibration envelope with varying motor strength. Amplitudes are realized by
+//! modulating the motor's drive, computed once here rather than on every vibration.
+//! @param segments An array of envelope segments. The array is copied, so it does not need to stay
+//! valid after this call.
+//! @param num_segments The length of the array of segments
+//! @return A pointer to the compiled pattern, or NULL if the envelope is invalid or there was not
+//! enough memory
+CompiledVibePattern *vibes_compile_envelope(const VibeEnvelopeSegment *segments,
+                                            uint32_t num_segments);
+
+//! Makes the watch emit a pattern compiled with \ref vibes_compile_pattern() or
+//! \ref vibes_compile_envelope().
+//! @param pattern The compiled pattern to emit
+void vibes_enqueue_compiled_pattern(const CompiledVibePattern *pattern);
+
+//! Destroys a compiled pattern. If the pattern is currently being emitted, the vibration is
+//! completed first.
+//! @param pattern The compiled pattern to destroy
+void vibes_destroy_compiled_pattern(CompiledVibePattern *pattern);
+
 //! @} // group Vibes
 
 //! @addtogroup Light Light
@@ -8296,8 +12263,214 @@ bool quiet_time_is_active(void);
 //! @} // group UI
 
 //! @addtogroup Profiling
+//! \brief Measuring where an app spends its frame budget
+//!
+//! The frame profiler measures how long rendering takes on the watch itself, broken down into the
+//! time spent in each layer's `.update_proc`, the time to render the whole window and the time
+//! until the frame appears on the display. It also tracks how long events wait in the app's event
+//! queue and how long their handlers run.
+//!
+//! Profiling adds a small overhead to every frame and is disabled by default.
+//! Code example:
+//! \code{.c}
+//! static void prv_init(void) {
+//!   profiler_set_enabled(true);
+//!   // Print the stats of every 30th frame to the app log, visible with `pebble logs`
+//!   profiler_set_log_interval(30);
+//! }
+//! \endcode
 //! @{
 
+//! Returns the value of a free-running counter that is incremented with every CPU clock cycle.
+//! Use the difference between two values to measure code that runs much shorter than the
+//! resolution of \ref time_ms. The counter wraps around, so always compute differences with
+//! unsigned arithmetic.
+//! On platforms without a hardware cycle counter, the value is derived from the system tick timer
+//! and has a lower resolution.
+//! @return The current cycle count
+//! @see \ref profiler_cycles_per_second
+uint32_t profiler_cycles(void);
+
+//! Returns the frequency at which \ref profiler_cycles increments, which is the CPU clock
+//! frequency on platforms with a hardware cycle counter.
+//! @return The number of cycles per second
+uint32_t profiler_cycles_per_second(void);
+
+//! Aggregated timing of a code section measured with \ref PROFILE_SCOPE. All fields are
+//! maintained by the system and should be treated as read-only.
+typedef struct ProfilerNode {
+  //! Label of the measured code section
+  const char *name;
+  //! Cycle count at the start of the current measurement
+  uint32_t start_cycles;
+  //! Number of completed measurements
+  uint32_t count;
+  //! Sum of the cycles of all measurements
+  uint64_t total_cycles;
+  //! Fewest cycles of a single measurement
+  uint32_t min_cycles;
+  //! Most cycles of a single measurement
+  uint32_t max_cycles;
+  //! Next registered node, for internal use
+  struct ProfilerNode *next;
+} ProfilerNode;
+
+//! Starts a measurement for a node. The node is registered on first use, and the minimum,
+//! average and maximum of all registered nodes are written to the app log when the app exits.
+//! @param node The node to start measuring, usually with static storage duration
+//! @return The node that was passed in
+ProfilerNode *profiler_node_start(ProfilerNode *node);
+
+//! Stops the current measurement of a node and adds it to the node's statistics.
+//! @param node The node to stop measuring
+void profiler_node_stop(ProfilerNode *node);
+
+//! Cleanup handler used by \ref PROFILE_SCOPE. Equivalent to calling \ref profiler_node_stop.
+//! @param node Pointer to the node to stop measuring
+void profiler_node_stop_scope(ProfilerNode **node);
+
+//! Writes the statistics of all registered nodes to the app log immediately, one line per node
+//! of the form `profile <name>: count <n> min <cycles> avg <cycles> max <cycles>`.
+void profiler_print_stats(void);
+
+#define PROFILER_CONCAT_(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_(a, b)
+#define PROFILE_SCOPE_(label, id) \
+  static ProfilerNode PROFILER_CONCAT(s_profiler_node_, id) = { .name = (label) }; \
+  ProfilerNode *PROFILER_CONCAT(profiler_scope_, id) \
+      __attribute__((cleanup(profiler_node_stop_scope), unused)) = \
+      profiler_node_start(&PROFILER_CONCAT(s_profiler_node_, id))
+
+//! Measures the time from this statement to the end of the enclosing block, aggregating the
+//! results of all executions under the given label. For example:
+//! \code{.c}
+//! static void prv_draw_hands(Layer *layer, GContext *ctx) {
+//!   PROFILE_SCOPE("draw_hands");
+//!   ...
+//! }
+//! \endcode
+//! @param label String literal identifying the measured code section
+#define PROFILE_SCOPE(label) PROFILE_SCOPE_(label, __COUNTER__)
+
+//! Timing statistics of the most recently displayed frame
+typedef struct {
+  //! Time in microseconds spent rendering the window, including all `.update_proc` callbacks
+  uint32_t render_time_us;
+  //! Time in microseconds from the end of rendering until the frame was shown on the display
+  uint32_t display_latency_us;
+  //! Longest time in microseconds that an event waited in the event queue before its handler was
+  //! called, since the previous frame
+  uint32_t max_event_latency_us;
+  //! Longest time in microseconds that a single event handler ran, since the previous frame
+  uint32_t max_handler_time_us;
+  //! Number of frames rendered since profiling was enabled
+  uint32_t frame_count;
+} ProfilerFrameStats;
+
+//! Enables or disables the frame profiler. Enabling the profiler resets all statistics.
+//! @param enabled true to start collecting statistics, false to stop
+void profiler_set_enabled(bool enabled);
+
+//! Gets the timing statistics of the most recently displayed frame.
+//! @param[out] stats The statistics of the last frame
+//! @return true if statistics are available, false if the profiler is disabled or no frame has
+//! been rendered since it was enabled
+bool profiler_get_frame_stats(ProfilerFrameStats *stats);
+
+//! Gets the time that the `.update_proc` of a layer took during the most recent frame. This does
+//! not include the time spent rendering the children of the layer.
+//! @param layer The layer for which to get the render time
+//! @return The render time in microseconds, 0 if the layer was not rendered in the last frame or
+//! the profiler is disabled
+uint32_t profiler_get_layer_render_time_us(const Layer *layer);
+
+//! Sets how often the frame statistics are written to the app log, where they can be viewed with
+//! `pebble logs`. Each log entry also lists the layers with the longest render times, in the form
+//! `frame <n>: render <us>us display <us>us wait <us>us handler <us>us layers <addr>=<us>us ...`
+//! where wait and handler are the max_event_latency_us and max_handler_time_us statistics.
+//! In the emulator, all times depend on the speed of the computer running it. The
+//! `emu_cycles.py` tool in the SDK estimates the equivalent on watch hardware from them.
+//! @param num_frames Log the statistics of every `num_frames`-th frame, 0 to disable logging
+void profiler_set_log_interval(uint16_t num_frames);
+
+//! Flags for \ref profiler_frame_stream_start
+typedef enum {
+  //! Send only the rows of each frame that changed since the previous frame was sent
+  FrameStreamFlagDamagedRows = 1 << 0,
+  //! Drop frames instead of delaying rendering when the connection cannot keep up. Dropped frames
+  //! show up as gaps in the frame numbers of the stream.
+  FrameStreamFlagAllowDrops = 1 << 1,
+} FrameStreamFlags;
+
+//! Starts streaming every frame the app renders to the developer connection, for tools that
+//! measure animation smoothness, such as `frame_stream.py` in the SDK. Each frame is sent with its
+//! number and the time it appeared on the display, compressed on the watch with PackBits run
+//! length encoding. Streaming costs time and Bluetooth bandwidth for every frame, so use it only
+//! in test builds.
+//! @param flags A combination of \ref FrameStreamFlags
+//! @return true if streaming started, false if no developer connection is active
+bool profiler_frame_stream_start(FrameStreamFlags flags);
+
+//! Stops streaming frames started with \ref profiler_frame_stream_start.
+void profiler_frame_stream_stop(void);
+
+//! Counters sent by \ref profiler_telemetry_start
+typedef enum {
+  //! Render and display time of the last frame and the number of frames rendered, see
+  //! \ref ProfilerFrameStats
+  TelemetryCounterFrameTime = 1 << 0,
+  //! Free bytes and largest free block of the app heap, see \ref HeapStats
+  TelemetryCounterHeap = 1 << 1,
+  //! Messages waiting in the AppMessage outbox and inbox
+  TelemetryCounterAppMessageQueue = 1 << 2,
+  //! Longest time an event waited in the app's event queue and longest handler run since the
+  //! previous record
+  TelemetryCounterEventLatency = 1 << 3,
+  //! All of the above
+  TelemetryCounterAll = 0xf,
+} TelemetryCounter;
+
+//! Starts sending a record with the selected counters to the developer connection every
+//! `interval_ms` milliseconds, for live dashboards such as `telemetry_dashboard.py` in the SDK.
+//! Records are small and sent from the system, so this can stay enabled while using the app, but
+//! the heap counter walks the heap for every record; keep the interval at 100 ms or more.
+//! Counters that are not selected are sent as 0.
+//! @param interval_ms Time between two records, at least 100 ms
+//! @param counters A combination of \ref TelemetryCounter
+//! @return true if sending started, false if no developer connection is active
+bool profiler_telemetry_start(uint16_t interval_ms, TelemetryCounter counters);
+
+//! Stops sending records started with \ref profiler_telemetry_start.
+void profiler_telemetry_stop(void);
+
+//! Kinds of events for \ref profiler_event_record_start
+typedef enum {
+  //! Button presses and releases, before click recognition
+  EventRecordClicks = 1 << 0,
+  //! Tick timer events, with the time and the units that changed
+  EventRecordTicks = 1 << 1,
+  //! Messages received by the AppMessage inbox, with their contents
+  EventRecordAppMessage = 1 << 2,
+  //! Accelerometer data batches and taps
+  EventRecordAccel = 1 << 3,
+  //! All of the above
+  EventRecordAll = 0xf,
+} EventRecordKinds;
+
+//! Starts sending the selected events to the developer connection as the app's event loop
+//! delivers them, each with the time it was delivered, so that a session on a watch can be
+//! recorded and replayed later, for example to profile the app against the exact sequence of
+//! inputs that made it slow. `event_replay.py` in the SDK records the events to a file and
+//! feeds them back to an app in the emulator with their original timing. Recording does not
+//! change what the app receives; AppMessage contents and accelerometer batches cost Bluetooth
+//! bandwidth, so use it only in test builds.
+//! @param kinds A combination of \ref EventRecordKinds
+//! @return true if recording started, false if no developer connection is active
+bool profiler_event_record_start(EventRecordKinds kinds);
+
+//! Stops sending events started with \ref profiler_event_record_start.
+void profiler_event_record_stop(void);
+
 //! @} // group Profiling
 
 //! @addtogroup StandardC Standard C
@@ -8409,5 +12582,101 @@ time_t time_start_of_today(void);
 
 //! @} // group StandardTime
 
+//! @addtogroup StandardMemory Memory
+//! \brief Standard memory copy, fill and compare functions
+//!
+//! These functions are provided by the firmware rather than linked into each app, and use an
+//! implementation tuned for the watch's Cortex-M core. Once the start of the destination is
+//! word aligned, data is moved with LDM/STM bursts of eight words, with a word-at-a-time loop
+//! for the remainder and byte accesses only for the unaligned head and tail. Copies run at
+//! full speed when the source and destination have the same alignment modulo 4, which is
+//! always the case for rows of a \ref GBitmap with the same format and row size. When the
+//! alignments differ, the source is read a word at a time and shifted into place.
+//!
+//! Clearing a framebuffer or bitmap with \ref memset therefore costs about one cycle per
+//! word, and is considerably faster than setting pixels or bytes in a loop.
+//! The functions behave as documented at https://sourceware.org/newlib/libc.html#Strings
+//! @{
+
+//! Compares the first n bytes of two blocks of memory.
+//! @param s1 The first block of memory
+//! @param s2 The second block of memory
+//! @param n The number of bytes to compare
+//! @return 0 if the blocks are equal, otherwise the difference between the first differing
+//!   bytes, interpreted as unsigned char
+int memcmp(const void *s1, const void *s2, size_t n);
+
+//! Copies n bytes between two blocks of memory, which must not overlap.
+//! @param dest The destination
+//! @param src The source
+//! @param n The number of bytes to copy
+//! @return dest
+void *memcpy(void *dest, const void *src, size_t n);
+
+//! Copies n bytes between two blocks of memory, which may overlap. Non-overlapping copies and
+//! copies to a lower address run as fast as \ref memcpy.
+//! @param dest The destination
+//! @param src The source
+//! @param n The number of bytes to copy
+//! @return dest
+void *memmove(void *dest, const void *src, size_t n);
+
+//! Sets n bytes of a block of memory to a value.
+//! @param s The block of memory
+//! @param c The value, converted to unsigned char
+//! @param n The number of bytes to set
+//! @return s
+void *memset(void *s, int c, size_t n);
+
+//! @} // group StandardMemory
+
+//! @addtogroup StandardFormat Integer Formatting
+//! \brief Small, integer-only replacements for snprintf
+//!
+//! The newlib snprintf linked into apps supports every conversion, including floating point,
+//! and adds several kilobytes of code and a noticeable per-call cost. Apps that only format
+//! integers and strings, such as a watchface drawing the time and step count on every tick, can
+//! use \ref int_snprintf instead. It is implemented in the firmware, so it adds nothing to the
+//! app binary, and it does not take the reentrancy lock that newlib uses.
+//!
+//! To route all calls to snprintf in a source file to \ref int_snprintf, define
+//! `PBL_INT_SNPRINTF` before including pebble.h:
+//! \code{.c}
+//! #define PBL_INT_SNPRINTF
+//! #include <pebble.h>
+//! \endcode
+//! @{
+
+//! Formats a string like snprintf, with support for integer and string conversions only.
+//! The supported conversions are `%d`, `%i`, `%u`, `%x`, `%X`, `%c`, `%s`, `%p` and `%%`, with
+//! the `-`, `0`, `+` and space flags, a field width, a precision, the `l`, `ll`, `h` and `z`
+//! length modifiers and `*` for width and precision. Floating point conversions are not
+//! supported and are written to the output unchanged.
+//! The format string is checked at compile time as for printf, so mismatched arguments produce
+//! a warning.
+//! @param str The buffer to write to, which is always NUL terminated if size is not 0
+//! @param size The size of the buffer in bytes
+//! @param format The format string
+//! @return The number of characters that would have been written if the buffer were large
+//!   enough, not counting the terminating NUL
+int int_snprintf(char *str, size_t size, const char *format, ...)
+    __attribute__((__format__(__printf__, 3, 4)));
+
+//! Writes a signed integer in decimal, without a terminating NUL. This is the fastest way to
+//! format a single number, for example when building a label piece by piece.
+//! @param buffer The buffer to write to
+//! @param size The size of the buffer in bytes
+//! @param value The integer to write
+//! @param min_digits The minimum number of digits, padded with leading zeros, for example 2
+//!   for minutes
+//! @return The number of characters written, or 0 if the buffer is too small
+size_t int_format(char *buffer, size_t size, int32_t value, uint8_t min_digits);
+
+#if defined(PBL_INT_SNPRINTF)
+#define snprintf int_snprintf
+#endif
+
+//! @} // group StandardFormat
+
 //! @} // group StandardC
 
@@ -0,0 +1,242 @@
+// SDK benchmark app.
+//
+// Times common drawing, text, serialization, storage, animation and AppMessage operations and
+// logs one line per benchmark:
+//   BENCH <name> <iterations> <total cycles> <cycles per second>
+// followed by BENCH_DONE. common/tools/run_benchmarks.py installs the app, collects these lines
+// and writes the results as JSON.
+//
+// The app also builds with older SDKs, so that run_benchmarks.py --sdk can compare SDKs. Those
+// have no cycle counter, so the milliseconds clock is used instead, and no message keys, so the
+// AppMessage benchmark is skipped.
+
+#include <pebble.h>
+
+#define PERSIST_KEY_BASE 0x4200
+#define PERSIST_KEY_COUNT 8
+#define APP_MESSAGE_ROUND_TRIPS 20
+
+typedef void (*BenchmarkFn)(void *context, uint32_t iteration);
+
+static Window *s_window;
+static Layer *s_canvas_layer;
+static bool s_graphics_done;
+
+static GPath *s_path;
+static GBitmap *s_bitmap;
+
+static uint32_t s_round_trips;
+static uint32_t s_round_trip_start;
+static uint32_t s_round_trip_cycles;
+
+#ifdef _PBL_API_EXISTS_profiler_cycles
+#define prv_cycles() profiler_cycles()
+#define prv_cycles_per_second() profiler_cycles_per_second()
+#else
+static uint32_t prv_cycles(void) {
+  time_t seconds;
+  const uint16_t ms = time_ms(&seconds, NULL);
+  return (uint32_t)seconds * 1000 + ms;
+}
+#define prv_cycles_per_second() 1000
+#endif
+
+static const GPathInfo s_path_info = {
+  .num_points = 6,
+  .points = (GPoint []) { {10, 10}, {60, 0}, {110, 30}, {100, 90}, {40, 110}, {0, 60} },
+};
+
+static void prv_run(const char *name, uint32_t iterations, BenchmarkFn fn, void *context) {
+  const uint32_t start = prv_cycles();
+  for (uint32_t i = 0; i < iterations; i++) {
+    fn(context, i);
+  }
+  const uint32_t cycles = prv_cycles() - start;
+  APP_LOG(APP_LOG_LEVEL_INFO, "BENCH %s %lu %lu %lu", name, (unsigned long)iterations,
+          (unsigned long)cycles, (unsigned long)prv_cycles_per_second());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Graphics
+
+static void prv_draw_text(void *context, uint32_t iteration) {
+  GContext *ctx = context;
+  graphics_draw_text(ctx, "The quick brown fox jumps over the lazy dog 0123456789",
+                     fonts_get_system_font(FONT_KEY_GOTHIC_18), GRect(0, 0, 144, 80),
+                     GTextOverflowModeWordWrap, GTextAlignmentLeft, NULL);
+}
+
+static void prv_draw_path(void *context, uint32_t iteration) {
+  GContext *ctx = context;
+  gpath_draw_filled(ctx, s_path);
+}
+
+static void prv_draw_bitmap(void *context, uint32_t iteration) {
+  GContext *ctx = context;
+  graphics_draw_bitmap_in_rect(ctx, s_bitmap, GRect(0, 0, 144, 168));
+}
+
+static void prv_fill_rect(void *context, uint32_t iteration) {
+  GContext *ctx = context;
+  graphics_fill_rect(ctx, GRect(0, 0, 144, 168), 0, GCornerNone);
+}
+
+static void prv_canvas_update_proc(Layer *layer, GContext *ctx) {
+  if (s_graphics_done) {
+    return;
+  }
+  s_graphics_done = true;
+  graphics_context_set_fill_color(ctx, GColorBlack);
+  graphics_context_set_text_color(ctx, GColorBlack);
+  prv_run("graphics_draw_text", 50, prv_draw_text, ctx);
+  prv_run("gpath_draw_filled", 100, prv_draw_path, ctx);
+  prv_run("graphics_draw_bitmap_in_rect", 100, prv_draw_bitmap, ctx);
+  prv_run("graphics_fill_rect", 100, prv_fill_rect, ctx);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Dictionary and storage
+
+static void prv_dict_write(void *context, uint32_t iteration) {
+  uint8_t buffer[128];
+  DictionaryIterator iter;
+  dict_write_begin(&iter, buffer, sizeof(buffer));
+  for (uint32_t key = 0; key < 8; key++) {
+    dict_write_int32(&iter, key, (int32_t)(iteration + key));
+  }
+  dict_write_end(&iter);
+}
+
+static void prv_persist_write(void *context, uint32_t iteration) {
+  persist_write_int(PERSIST_KEY_BASE + iteration % PERSIST_KEY_COUNT, (int32_t)iteration);
+}
+
+static void prv_persist_read(void *context, uint32_t iteration) {
+  persist_read_int(PERSIST_KEY_BASE + iteration % PERSIST_KEY_COUNT);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Animation
+
+// Creating, scheduling, unscheduling and destroying an animation, which is what apps pay for each
+// transition they start. The animation is unscheduled before its first frame.
+static void prv_animation_schedule(void *context, uint32_t iteration) {
+  Layer *layer = context;
+  GRect from = GRect(0, 0, 20, 20);
+  GRect to = GRect(100, 100, 20, 20);
+  PropertyAnimation *animation = property_animation_create_layer_frame(layer, &from, &to);
+#if defined(PBL_SDK_2)
+  animation_schedule(&animation->animation);
+  animation_unschedule(&animation->animation);
+  property_animation_destroy(animation);
+#else
+  // Unscheduling destroys the animation.
+  animation_schedule(property_animation_get_animation(animation));
+  animation_unschedule(property_animation_get_animation(animation));
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// AppMessage
+
+static void prv_finish(void) {
+  for (uint32_t i = 0; i < PERSIST_KEY_COUNT; i++) {
+    persist_delete(PERSIST_KEY_BASE + i);
+  }
+  APP_LOG(APP_LOG_LEVEL_INFO, "BENCH_DONE");
+}
+
+static void prv_send_round_trip(void) {
+  // message_keys.auto.h defines the key as a macro; older SDKs have no message keys.
+#ifndef MESSAGE_KEY_echo
+  APP_LOG(APP_LOG_LEVEL_WARNING, "BENCH_SKIPPED app_message_round_trip (no message keys)");
+  prv_finish();
+#else
+  DictionaryIterator *iter;
+  if (app_message_outbox_begin(&iter) != APP_MSG_OK) {
+    APP_LOG(APP_LOG_LEVEL_WARNING, "BENCH_SKIPPED app_message_round_trip");
+    prv_finish();
+    return;
+  }
+  dict_write_int32(iter, MESSAGE_KEY_echo, (int32_t)s_round_trips);
+  s_round_trip_start = prv_cycles();
+  app_message_outbox_send();
+#endif
+}
+
+static void prv_inbox_received(DictionaryIterator *iter, void *context) {
+  s_round_trip_cycles += prv_cycles() - s_round_trip_start;
+  if (++s_round_trips < APP_MESSAGE_ROUND_TRIPS) {
+    prv_send_round_trip();
+    return;
+  }
+  APP_LOG(APP_LOG_LEVEL_INFO, "BENCH app_message_round_trip %lu %lu %lu",
+          (unsigned long)s_round_trips, (unsigned long)s_round_trip_cycles,
+          (unsigned long)prv_cycles_per_second());
+  prv_finish();
+}
+
+static void prv_outbox_failed(DictionaryIterator *iter, AppMessageResult reason, void *context) {
+  APP_LOG(APP_LOG_LEVEL_WARNING, "BENCH_SKIPPED app_message_round_trip (%d)", (int)reason);
+  prv_finish();
+}
+
+static void prv_run_non_graphics(void *data) {
+  prv_run("dict_write_int32", 200, prv_dict_write, NULL);
+  prv_run("persist_write_int", 40, prv_persist_write, NULL);
+  prv_run("persist_read_int", 200, prv_persist_read, NULL);
+
+  Layer *animated = layer_create(GRect(0, 0, 20, 20));
+  prv_run("property_animation_schedule", 100, prv_animation_schedule, animated);
+  layer_destroy(animated);
+
+  app_message_register_inbox_received(prv_inbox_received);
+  app_message_register_outbox_failed(prv_outbox_failed);
+  app_message_open(64, 64);
+  prv_send_round_trip();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// App
+
+static void prv_window_load(Window *window) {
+  Layer *root = window_get_root_layer(window);
+  s_canvas_layer = layer_create(layer_get_bounds(root));
+  layer_set_update_proc(s_canvas_layer, prv_canvas_update_proc);
+  layer_add_child(root, s_canvas_layer);
+}
+
+static void prv_window_unload(Window *window) {
+  layer_destroy(s_canvas_layer);
+}
+
+static void prv_init(void) {
+  s_path = gpath_create(&s_path_info);
+#if defined(PBL_SDK_2)
+  s_bitmap = gbitmap_create_blank(GSize(144, 168));
+#elif defined(PBL_COLOR)
+  s_bitmap = gbitmap_create_blank(GSize(144, 168), GBitmapFormat8Bit);
+#else
+  s_bitmap = gbitmap_create_blank(GSize(144, 168), GBitmapFormat1Bit);
+#endif
+  s_window = window_create();
+  window_set_window_handlers(s_window, (WindowHandlers) {
+    .load = prv_window_load,
+    .unload = prv_window_unload,
+  });
+  window_stack_push(s_window, false);
+  // Let the first frame, and with it the graphics benchmarks, run before the rest.
+  app_timer_register(500, prv_run_non_graphics, NULL);
+}
+
+static void prv_deinit(void) {
+  window_destroy(s_window);
+  gbitmap_destroy(s_bitmap);
+  gpath_destroy(s_path);
+}
+
+int main(void) {
+  prv_init();
+  app_event_loop();
+  prv_deinit();
+}
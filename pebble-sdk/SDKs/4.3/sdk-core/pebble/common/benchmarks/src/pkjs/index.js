@@ -0,0 +1,4 @@
+// Echo every message straight back, so the watch can time AppMessage round trips.
+Pebble.addEventListener('appmessage', function(e) {
+  Pebble.sendAppMessage(e.payload);
+});
@@ -0,0 +1,87 @@
+/*
+ * Compressed AppMessage values for PebbleKit JS.
+ *
+ * compress() deflates the large string and byte array values of a message with pako, so text
+ * heavy payloads such as news or notification lists take a fraction of the transfer time. Each
+ * compressed value is sent as a byte array starting with the header that
+ * app_message_set_inbox_inflate() describes: 'P', 'Z', the original TupleType, the window size
+ * and the inflated length. With app_message_set_inbox_inflate(true) on the watch, the system
+ * inflates those values back into normal strings and byte arrays in its Inbox buffer.
+ *
+ * Add pako to the project's dependencies in package.json and use it like this:
+ *
+ *   var compressedTransport = require('./compressed_transport');
+ *   Pebble.sendAppMessage(compressedTransport.compress({headlines: text}), onSent, onFailed);
+ *
+ * Only values of at least minSize bytes that actually get smaller are compressed. The watch
+ * needs room for the inflated message in its Inbox, so size app_message_open() for that.
+ */
+
+var pako = require('pako');
+
+var TUPLE_BYTE_ARRAY = 0;
+var TUPLE_CSTRING = 1;
+
+// The decoder on the watch uses the Inbox as its window, so a small window costs nothing
+// there, and values are at most a few kilobytes anyway.
+var DEFAULT_WINDOW_BITS = 12;
+var DEFAULT_MIN_SIZE = 64;
+var MAX_INFLATED_SIZE = 0xffff;
+
+function utf8Bytes(text) {
+  var encoded = unescape(encodeURIComponent(text));
+  var bytes = new Uint8Array(encoded.length + 1);
+  for (var i = 0; i < encoded.length; i++) {
+    bytes[i] = encoded.charCodeAt(i);
+  }
+  // C strings are sent with their terminating NUL.
+  bytes[encoded.length] = 0;
+  return bytes;
+}
+
+function compressValue(value, options) {
+  var type;
+  var bytes;
+  if (typeof value === 'string') {
+    type = TUPLE_CSTRING;
+    bytes = utf8Bytes(value);
+  } else if (value instanceof ArrayBuffer) {
+    type = TUPLE_BYTE_ARRAY;
+    bytes = new Uint8Array(value);
+  } else if (value instanceof Uint8Array || Array.isArray(value)) {
+    type = TUPLE_BYTE_ARRAY;
+    bytes = value instanceof Uint8Array ? value : new Uint8Array(value);
+  } else {
+    return value;
+  }
+  if (bytes.length < options.minSize || bytes.length > MAX_INFLATED_SIZE) {
+    return value;
+  }
+  var deflated = pako.deflateRaw(bytes, {level: 9, windowBits: options.windowBits});
+  if (deflated.length + 6 >= bytes.length) {
+    return value;
+  }
+  var out = [0x50, 0x5a, type, options.windowBits, bytes.length & 0xff, bytes.length >> 8];
+  for (var i = 0; i < deflated.length; i++) {
+    out.push(deflated[i]);
+  }
+  return out;
+}
+
+// Returns a copy of message with its large values compressed. options.minSize and
+// options.windowBits (9 to 15) override the defaults.
+function compress(message, options) {
+  options = {
+    minSize: options && options.minSize || DEFAULT_MIN_SIZE,
+    windowBits: options && options.windowBits || DEFAULT_WINDOW_BITS
+  };
+  var result = {};
+  for (var key in message) {
+    if (Object.prototype.hasOwnProperty.call(message, key)) {
+      result[key] = compressValue(message[key], options);
+    }
+  }
+  return result;
+}
+
+module.exports.compress = compress;
@@ -0,0 +1,164 @@
+/*
+ * Coalescing message queue for PebbleKit JS.
+ *
+ * Pebble.sendAppMessage() sends one AppMessage per call and fails while an earlier message is
+ * still waiting for its acknowledgement, so companions that send many small updates end up
+ * either dropping them or waiting a full round trip per update. A message queue keeps at most
+ * one message in flight. Everything posted while it is busy is merged into a single pending
+ * message, key by key with later values replacing earlier ones, and sent as soon as the
+ * previous message is acknowledged. This suits state updates, where only the latest value of
+ * each key matters; use separate keys for values that must all arrive.
+ *
+ * Values can be numbers, strings, arrays of bytes, or ArrayBuffers and typed arrays. Binary
+ * values are sent as byte array tuples, which the watch reads with dict_find() as TUPLE_BYTE_ARRAY
+ * without any JSON step.
+ *
+ *   var messageQueue = require('./message_queue');
+ *   var queue = messageQueue.create();
+ *   queue.post({temperature: 21});
+ *   queue.post({icon: new Uint8Array([1, 2, 3])});
+ *
+ * Small, latency sensitive messages such as button actions can be posted with
+ * post(message, {priority: 'high'}). They are merged into a separate pending message that is
+ * sent before the regular one, so they never wait behind more than the message in flight.
+ *
+ * Rocky.js apps can use the same coalescing with create({transport: 'postMessage'}). Posts made
+ * in the same turn of the event loop are then merged into one Pebble.postMessage() call. Binary
+ * values are not supported there, since postMessage carries JSON.
+ */
+
+var DEFAULT_MAX_RETRIES = 2;
+
+function toBytes(value) {
+  if (typeof ArrayBuffer !== 'undefined') {
+    if (value instanceof ArrayBuffer) {
+      value = new Uint8Array(value);
+    } else if (ArrayBuffer.isView && ArrayBuffer.isView(value) && !(value instanceof Uint8Array)) {
+      value = new Uint8Array(value.buffer, value.byteOffset, value.byteLength);
+    }
+    if (value instanceof Uint8Array) {
+      return Array.prototype.slice.call(value);
+    }
+  }
+  return value;
+}
+
+function merge(target, message) {
+  for (var key in message) {
+    if (Object.prototype.hasOwnProperty.call(message, key)) {
+      target[key] = message[key];
+    }
+  }
+}
+
+// Removes the keys of message from target, and returns null if that leaves target empty.
+function without(target, message) {
+  if (!target) {
+    return null;
+  }
+  for (var key in message) {
+    if (Object.prototype.hasOwnProperty.call(message, key)) {
+      delete target[key];
+    }
+  }
+  for (key in target) {
+    return target;
+  }
+  return null;
+}
+
+function MessageQueue(options) {
+  options = options || {};
+  this._transport = options.transport || 'appmessage';
+  this._maxRetries = options.maxRetries === undefined ? DEFAULT_MAX_RETRIES : options.maxRetries;
+  this._onError = options.onError || null;
+  this._pending = null;
+  this._pendingHigh = null;
+  this._inFlight = false;
+  this._retries = 0;
+  this.sentCount = 0;
+  this.coalescedCount = 0;
+}
+
+// Queues a message, merging it into the one waiting to be sent if there is one. With
+// options.priority 'high', it is merged into the high priority message instead, and its keys
+// are dropped from the regular one, which is sent later and would otherwise overwrite them.
+MessageQueue.prototype.post = function(message, options) {
+  var high = options && options.priority === 'high' && this._transport !== 'postMessage';
+  var slot = high ? '_pendingHigh' : '_pending';
+  if (high) {
+    this._pending = without(this._pending, message);
+  }
+  if (this[slot]) {
+    this.coalescedCount++;
+  } else {
+    this[slot] = {};
+  }
+  merge(this[slot], message);
+  if (this._transport === 'postMessage') {
+    if (!this._inFlight) {
+      this._inFlight = true;
+      var self = this;
+      setTimeout(function() { self._flushPostMessage(); }, 0);
+    }
+    return;
+  }
+  if (!this._inFlight) {
+    this._sendNext();
+  }
+};
+
+// Returns whether messages are waiting to be sent or acknowledged.
+MessageQueue.prototype.busy = function() {
+  return this._inFlight || this._pending !== null || this._pendingHigh !== null;
+};
+
+MessageQueue.prototype._flushPostMessage = function() {
+  var message = this._pending;
+  this._pending = null;
+  this._inFlight = false;
+  this.sentCount++;
+  Pebble.postMessage(message);
+};
+
+MessageQueue.prototype._sendNext = function() {
+  var slot = this._pendingHigh ? '_pendingHigh' : '_pending';
+  var message = this[slot];
+  this[slot] = null;
+  if (!message) {
+    this._inFlight = false;
+    return;
+  }
+  var payload = {};
+  for (var key in message) {
+    payload[key] = toBytes(message[key]);
+  }
+  this._inFlight = true;
+  var self = this;
+  Pebble.sendAppMessage(payload, function() {
+    self.sentCount++;
+    self._retries = 0;
+    self._sendNext();
+  }, function(e) {
+    if (self._retries < self._maxRetries) {
+      self._retries++;
+      // Keep newer values that were posted while this message was in flight. High priority
+      // values posted meanwhile are newer too, and are sent before a regular retry.
+      var retry = message;
+      if (self[slot]) {
+        merge(retry, self[slot]);
+      }
+      self[slot] = slot === '_pending' ? without(retry, self._pendingHigh || {}) : retry;
+    } else {
+      self._retries = 0;
+      if (self._onError) {
+        self._onError(message, e);
+      }
+    }
+    self._sendNext();
+  });
+};
+
+module.exports.create = function(options) {
+  return new MessageQueue(options);
+};
@@ -0,0 +1,33 @@
+/*
+ * Packed integer arrays for PebbleKit JS.
+ *
+ * Array message keys such as "values[10]" in package.json are sent as a single tuple holding all
+ * elements, which the watch reads with dict_read_int32_array(). packInt32() turns an array of
+ * numbers into that tuple's value, and unpackInt32() reads one sent by
+ * dict_write_int32_array():
+ *
+ *   var packedArray = require('./packed_array');
+ *   Pebble.sendAppMessage({values: packedArray.packInt32([1, -2, 300])});
+ */
+
+// Returns the little endian bytes of values as 32-bit signed integers.
+function packInt32(values) {
+  var bytes = [];
+  for (var i = 0; i < values.length; i++) {
+    var v = values[i] | 0;
+    bytes.push(v & 0xff, v >> 8 & 0xff, v >> 16 & 0xff, v >> 24 & 0xff);
+  }
+  return bytes;
+}
+
+// Returns the integers of a byte array received from dict_write_int32_array().
+function unpackInt32(bytes) {
+  var values = [];
+  for (var i = 0; i + 3 < bytes.length; i += 4) {
+    values.push(bytes[i] | bytes[i + 1] << 8 | bytes[i + 2] << 16 | bytes[i + 3] << 24);
+  }
+  return values;
+}
+
+module.exports.packInt32 = packInt32;
+module.exports.unpackInt32 = unpackInt32;
@@ -0,0 +1,212 @@
+/*
+ * Batched timeline pin updates for PebbleKit JS.
+ *
+ * The public timeline API takes one pin per HTTP request, and every pin it receives is synced
+ * to the watch again, even if it did not change. Schedule-type apps that push their whole
+ * schedule on every refresh therefore pay one round trip per event and make the watch sync pins
+ * it already has. A batch sync takes the complete list of pins the app wants on a user's
+ * timeline and only sends the difference to what the last sync sent from this phone: pins that
+ * are new or changed are put, pins that are gone are deleted and unchanged pins are skipped.
+ * The requests run several at a time rather than one after the other.
+ *
+ *   var timelineBatch = require('./timeline_batch');
+ *   timelineBatch.sync(pins, {
+ *     scope: 'schedule',
+ *     onDone: function(result) { console.log(result.put + ' pins updated'); }
+ *   });
+ *
+ * The pins of a scope are those passed to the last sync() with that scope; pins that the app
+ * puts in other ways or under another scope are never deleted by it. What was sent is kept in
+ * localStorage under a hash per pin, so a sync that was interrupted, or a pin that failed,
+ * is sent again by the next sync. Pins rejected with 429 or a 5xx status are retried after a
+ * delay, up to maxRetries times. Call forget(scope) if the pins may have been changed elsewhere,
+ * so that the next sync sends all of them again.
+ */
+
+var DEFAULT_API_URL = 'https://timeline-api.getpebble.com/v1/user/pins/';
+var DEFAULT_CONCURRENCY = 4;
+var DEFAULT_MAX_RETRIES = 2;
+var RETRY_DELAY_MS = 1000;
+var STORAGE_PREFIX = 'timelineBatch:';
+// The sent-state entry of a pin whose put failed. It matches no hash, so the next sync sends
+// the pin again, or deletes it if the sync no longer lists it, since the failed put may still
+// have reached the timeline.
+var DIRTY = 'dirty';
+
+// JSON with object keys in sorted order, so that equal pins always give the same text.
+function canonicalJson(value) {
+  if (value === null || typeof value !== 'object') {
+    return JSON.stringify(value);
+  }
+  if (Array.isArray(value)) {
+    return '[' + value.map(canonicalJson).join(',') + ']';
+  }
+  return '{' + Object.keys(value).sort().filter(function(key) {
+    return value[key] !== undefined;
+  }).map(function(key) {
+    return JSON.stringify(key) + ':' + canonicalJson(value[key]);
+  }).join(',') + '}';
+}
+
+// 32-bit FNV-1a of the pin's canonical JSON, as 8 hex digits.
+function pinHash(pin) {
+  var text = canonicalJson(pin);
+  var hash = 0x811c9dc5;
+  for (var i = 0; i < text.length; i++) {
+    hash ^= text.charCodeAt(i);
+    hash = (hash * 0x01000193) >>> 0;
+  }
+  return ('0000000' + hash.toString(16)).slice(-8);
+}
+
+function loadSent(scope) {
+  try {
+    return JSON.parse(localStorage.getItem(STORAGE_PREFIX + scope)) || {};
+  } catch (e) {
+    return {};
+  }
+}
+
+function Batch(options) {
+  this._apiUrl = options.apiUrl || DEFAULT_API_URL;
+  this._concurrency = options.concurrency || DEFAULT_CONCURRENCY;
+  this._maxRetries = options.maxRetries === undefined ? DEFAULT_MAX_RETRIES : options.maxRetries;
+  this._scope = options.scope || 'default';
+  this._onDone = options.onDone || null;
+  this._sent = loadSent(this._scope);
+  this._jobs = [];
+  this._active = 0;
+  this._token = null;
+  this.result = {put: 0, deleted: 0, unchanged: 0, failed: []};
+}
+
+Batch.prototype._save = function() {
+  localStorage.setItem(STORAGE_PREFIX + this._scope, JSON.stringify(this._sent));
+};
+
+Batch.prototype._request = function(job) {
+  var xhr = new XMLHttpRequest();
+  var self = this;
+  xhr.open(job.pin ? 'PUT' : 'DELETE', this._apiUrl + encodeURIComponent(job.id), true);
+  xhr.setRequestHeader('X-User-Token', this._token);
+  if (job.pin) {
+    xhr.setRequestHeader('Content-Type', 'application/json');
+  }
+  xhr.onreadystatechange = function() {
+    if (xhr.readyState !== 4) {
+      return;
+    }
+    // A pin that is already gone counts as deleted.
+    if ((xhr.status >= 200 && xhr.status < 300) || (!job.pin && xhr.status === 404)) {
+      if (job.pin) {
+        self._sent[job.id] = job.hash;
+        self.result.put++;
+      } else {
+        delete self._sent[job.id];
+        self.result.deleted++;
+      }
+      self._save();
+    } else if ((xhr.status === 429 || xhr.status >= 500 || xhr.status === 0) &&
+               job.retries < self._maxRetries) {
+      job.retries++;
+      self._active++;
+      setTimeout(function() {
+        self._active--;
+        self._jobs.unshift(job);
+        self._next();
+      }, RETRY_DELAY_MS << (job.retries - 1));
+    } else {
+      if (job.pin) {
+        self._sent[job.id] = DIRTY;
+        self._save();
+      }
+      self.result.failed.push({id: job.id, status: xhr.status});
+    }
+    self._active--;
+    self._next();
+  };
+  xhr.send(job.pin ? JSON.stringify(job.pin) : null);
+};
+
+Batch.prototype._next = function() {
+  while (this._active < this._concurrency && this._jobs.length) {
+    this._active++;
+    this._request(this._jobs.shift());
+  }
+  if (this._active === 0 && this._jobs.length === 0 && this._onDone) {
+    var onDone = this._onDone;
+    this._onDone = null;
+    onDone(this.result);
+  }
+};
+
+Batch.prototype._start = function() {
+  var self = this;
+  Pebble.getTimelineToken(function(token) {
+    self._token = token;
+    self._next();
+  }, function(error) {
+    self._jobs.forEach(function(job) {
+      self.result.failed.push({id: job.id, status: 0, error: error});
+    });
+    self._jobs = [];
+    self._next();
+  });
+};
+
+Batch.prototype.put = function(pins) {
+  var self = this;
+  pins.forEach(function(pin) {
+    var hash = pinHash(pin);
+    if (self._sent[pin.id] === hash) {
+      self.result.unchanged++;
+    } else {
+      self._jobs.push({id: pin.id, pin: pin, hash: hash, retries: 0});
+    }
+  });
+  return this;
+};
+
+Batch.prototype.remove = function(ids) {
+  var self = this;
+  ids.forEach(function(id) {
+    self._jobs.push({id: id, pin: null, retries: 0});
+  });
+  return this;
+};
+
+// Makes the pins of options.scope exactly the given pins: puts those that are new or changed
+// since the last sync and deletes those that were sent before but are not in the list.
+// options.onDone(result) is called when all requests have finished, with the numbers of pins
+// put, deleted and left unchanged and the pins that failed as {id, status}. Other options are
+// concurrency (4), maxRetries (2) and apiUrl, for the sandbox timeline API.
+module.exports.sync = function(pins, options) {
+  var batch = new Batch(options || {});
+  var ids = {};
+  pins.forEach(function(pin) {
+    ids[pin.id] = true;
+  });
+  batch.put(pins).remove(Object.keys(batch._sent).filter(function(id) {
+    return !ids[id];
+  }))._start();
+  return batch;
+};
+
+// Puts the pins that changed since they were last sent in options.scope, without deleting any.
+module.exports.put = function(pins, options) {
+  var batch = new Batch(options || {});
+  batch.put(pins)._start();
+  return batch;
+};
+
+// Deletes pins by id and drops them from the state of options.scope.
+module.exports.remove = function(ids, options) {
+  var batch = new Batch(options || {});
+  batch.remove(ids)._start();
+  return batch;
+};
+
+// Forgets what was sent in a scope, so that the next sync sends all of its pins.
+module.exports.forget = function(scope) {
+  localStorage.removeItem(STORAGE_PREFIX + (scope || 'default'));
+};
@@ -0,0 +1,204 @@
+/*
+ * Streaming XMLHttpRequest responses to the watch for PebbleKit JS.
+ *
+ * The usual pattern of waiting for an XMLHttpRequest to load and then sending the whole response
+ * leaves the watch showing a loading screen for the full download plus the full transfer. A
+ * stream forwards the response in chunks as it arrives on the phone, so the watch can start
+ * rendering the first items while the rest are still downloading.
+ *
+ * Each chunk is sent as one AppMessage with the new UTF-8 bytes of the response under dataKey
+ * and their byte offset within the response under offsetKey. Chunks are sent one at a time and
+ * in order, so the watch can append each one to what it has. A last message sets doneKey to the
+ * HTTP status, or to 0 if the request failed. This mirrors the .data and .finished handlers of
+ * app_transfer_open(), whose phone side is in PebbleKit rather than PebbleKit JS.
+ *
+ *   var xhrStream = require('./xhr_stream');
+ *   xhrStream.get('https://example.com/items.ndjson', {
+ *     dataKey: 'itemData', offsetKey: 'itemOffset', doneKey: 'itemDone', splitOn: '\n'
+ *   });
+ *
+ * With splitOn, chunks only ever end after the delimiter, so every message holds whole items
+ * such as lines of newline-delimited JSON that the watch can parse without buffering. Keep
+ * maxChunkSize below the Inbox size given to app_message_open(), less the other two tuples.
+ */
+
+var DEFAULT_MAX_CHUNK_SIZE = 512;
+var DEFAULT_MAX_RETRIES = 2;
+
+function utf8Bytes(text) {
+  var encoded = unescape(encodeURIComponent(text));
+  var bytes = new Array(encoded.length);
+  for (var i = 0; i < encoded.length; i++) {
+    bytes[i] = encoded.charCodeAt(i);
+  }
+  return bytes;
+}
+
+function XhrStream(options) {
+  options = options || {};
+  this._dataKey = options.dataKey || 'streamData';
+  this._offsetKey = options.offsetKey || 'streamOffset';
+  this._doneKey = options.doneKey || 'streamDone';
+  this._maxChunkSize = options.maxChunkSize || DEFAULT_MAX_CHUNK_SIZE;
+  this._maxRetries = options.maxRetries === undefined ? DEFAULT_MAX_RETRIES : options.maxRetries;
+  this._splitOn = options.splitOn || null;
+  this._onDone = options.onDone || null;
+  this._onError = options.onError || null;
+  // Characters of responseText already taken into _bytes.
+  this._consumed = 0;
+  this._bytes = [];
+  this._offset = 0;
+  this._status = null;
+  this._inFlight = false;
+  this._retries = 0;
+  this._finished = false;
+  this.sentCount = 0;
+}
+
+// Takes the part of text past what was already read. Partial items are left in responseText
+// until their delimiter arrives, or until the response is complete.
+XhrStream.prototype._take = function(text, complete) {
+  var end = text.length;
+  if (!complete) {
+    if (this._splitOn) {
+      var last = text.lastIndexOf(this._splitOn);
+      end = last < this._consumed ? this._consumed : last + this._splitOn.length;
+    } else if (end > this._consumed && (text.charCodeAt(end - 1) & 0xfc00) === 0xd800) {
+      // Wait for the other half of a surrogate pair.
+      end--;
+    }
+  }
+  if (end <= this._consumed) {
+    return;
+  }
+  var bytes = utf8Bytes(text.substring(this._consumed, end));
+  this._consumed = end;
+  this._bytes = this._bytes.concat(bytes);
+};
+
+// Returns the next chunk to send, or null if none should be sent yet.
+XhrStream.prototype._nextChunk = function() {
+  var length = Math.min(this._bytes.length, this._maxChunkSize);
+  if (length === 0) {
+    return null;
+  }
+  if (this._splitOn && length < this._bytes.length) {
+    // Bytes only get here ending on a delimiter, so cut the chunk after the last whole item in it.
+    var delimiter = utf8Bytes(this._splitOn);
+    for (var i = length - delimiter.length; i >= 0; i--) {
+      var match = true;
+      for (var j = 0; j < delimiter.length && match; j++) {
+        match = this._bytes[i + j] === delimiter[j];
+      }
+      if (match) {
+        length = i + delimiter.length;
+        break;
+      }
+    }
+    // An item larger than a chunk has to be split anyway.
+  }
+  return this._bytes.slice(0, length);
+};
+
+XhrStream.prototype._sendNext = function() {
+  if (this._inFlight || this._finished) {
+    return;
+  }
+  var message = {};
+  var chunk = this._nextChunk();
+  if (chunk) {
+    message[this._dataKey] = chunk;
+    message[this._offsetKey] = this._offset;
+  } else if (this._status !== null) {
+    message[this._doneKey] = this._status;
+  } else {
+    return;
+  }
+  this._inFlight = true;
+  var self = this;
+  Pebble.sendAppMessage(message, function() {
+    self._inFlight = false;
+    self._retries = 0;
+    self.sentCount++;
+    if (chunk) {
+      self._bytes = self._bytes.slice(chunk.length);
+      self._offset += chunk.length;
+    } else {
+      self._finished = true;
+      if (self._onDone) {
+        self._onDone(self._status, self._offset);
+      }
+      return;
+    }
+    self._sendNext();
+  }, function(e) {
+    self._inFlight = false;
+    if (self._retries < self._maxRetries) {
+      self._retries++;
+      self._sendNext();
+      return;
+    }
+    // The watch would see a gap in the offsets, so give up on the whole stream.
+    self._finished = true;
+    if (self._onError) {
+      self._onError(e, self._offset);
+    }
+  });
+};
+
+XhrStream.prototype._progress = function(xhr, complete) {
+  var text;
+  try {
+    text = xhr.responseText || '';
+  } catch (e) {
+    // Some implementations throw while the response is still loading.
+    return;
+  }
+  this._take(text, complete);
+  this._sendNext();
+};
+
+// Stops the download. The watch is then sent a doneKey of 0 once the chunks already read are
+// through.
+XhrStream.prototype.abort = function() {
+  if (this._status === null) {
+    this._status = 0;
+    this._xhr.abort();
+    this._sendNext();
+  }
+};
+
+XhrStream.prototype.open = function(method, url, body) {
+  var xhr = new XMLHttpRequest();
+  var self = this;
+  this._xhr = xhr;
+  xhr.open(method, url, true);
+  xhr.onprogress = function() {
+    self._progress(xhr, false);
+  };
+  xhr.onreadystatechange = function() {
+    if (self._status !== null) {
+      return;
+    }
+    if (xhr.readyState === 3) {
+      self._progress(xhr, false);
+    } else if (xhr.readyState === 4) {
+      self._progress(xhr, true);
+      self._status = xhr.status;
+      self._sendNext();
+    }
+  };
+  xhr.send(body === undefined ? null : body);
+  return this;
+};
+
+// Requests url and streams its response to the watch. Returns the stream, which has an abort()
+// method. options.onDone(status, size) is called once the watch has acknowledged everything,
+// and options.onError(error, offset) if a chunk could not be sent.
+module.exports.get = function(url, options) {
+  return new XhrStream(options).open('GET', url);
+};
+
+module.exports.request = function(method, url, body, options) {
+  return new XhrStream(options).open(method, url, body);
+};
@@ -0,0 +1,235 @@
+/*
+ * Display lists for Rocky.js watchfaces.
+ *
+ * Every canvas call a Rocky app makes in its 'draw' handler crosses from JavaScript into the
+ * native graphics code, which costs far more than the drawing itself for simple shapes. A
+ * display list records a frame's canvas calls into a flat array instead, outside the 'draw'
+ * handler, and replays them in one pass when the frame is drawn:
+ *
+ *   - Setting fillStyle, strokeStyle, lineWidth, font or textAlign to the value it already has
+ *     is skipped.
+ *   - fillRect calls with the same fill style that continue each other horizontally or
+ *     vertically are merged into one.
+ *   - If a newly recorded frame is identical to the previous one, no redraw is requested at all,
+ *     and the previous frame stays on the display.
+ *
+ * Copy this file into src/rocky/ and use it like this:
+ *
+ *   var rocky = require('rocky');
+ *   var displayList = require('./display_list');
+ *   var list = displayList.create();
+ *
+ *   rocky.on('minutechange', function(event) {
+ *     list.begin();
+ *     list.fillStyle('black');
+ *     list.fillRect(0, 0, 144, 168);
+ *     ...
+ *     list.end();  // Calls rocky.requestDraw() if the frame changed
+ *   });
+ *
+ *   rocky.on('draw', function(event) {
+ *     list.draw(event.context);
+ *   });
+ *
+ * Rocky clears the canvas before every 'draw' event, so a list has to hold the whole frame.
+ */
+
+var OP_FILL_STYLE = 1;
+var OP_STROKE_STYLE = 2;
+var OP_LINE_WIDTH = 3;
+var OP_FONT = 4;
+var OP_TEXT_ALIGN = 5;
+var OP_FILL_RECT = 6;
+var OP_STROKE_RECT = 7;
+var OP_CLEAR_RECT = 8;
+var OP_FILL_TEXT = 9;
+var OP_BEGIN_PATH = 10;
+var OP_MOVE_TO = 11;
+var OP_LINE_TO = 12;
+var OP_RECT = 13;
+var OP_ARC = 14;
+var OP_CLOSE_PATH = 15;
+var OP_FILL = 16;
+var OP_STROKE = 17;
+var OP_FILL_RADIAL = 18;
+
+// Number of arguments that follow each opcode.
+var ARGC = [];
+ARGC[OP_FILL_STYLE] = 1;
+ARGC[OP_STROKE_STYLE] = 1;
+ARGC[OP_LINE_WIDTH] = 1;
+ARGC[OP_FONT] = 1;
+ARGC[OP_TEXT_ALIGN] = 1;
+ARGC[OP_FILL_RECT] = 4;
+ARGC[OP_STROKE_RECT] = 4;
+ARGC[OP_CLEAR_RECT] = 4;
+ARGC[OP_FILL_TEXT] = 4;
+ARGC[OP_BEGIN_PATH] = 0;
+ARGC[OP_MOVE_TO] = 2;
+ARGC[OP_LINE_TO] = 2;
+ARGC[OP_RECT] = 4;
+ARGC[OP_ARC] = 6;
+ARGC[OP_CLOSE_PATH] = 0;
+ARGC[OP_FILL] = 0;
+ARGC[OP_STROKE] = 0;
+ARGC[OP_FILL_RADIAL] = 6;
+
+var STATE_PROPERTIES = [];
+STATE_PROPERTIES[OP_FILL_STYLE] = 'fillStyle';
+STATE_PROPERTIES[OP_STROKE_STYLE] = 'strokeStyle';
+STATE_PROPERTIES[OP_LINE_WIDTH] = 'lineWidth';
+STATE_PROPERTIES[OP_FONT] = 'font';
+STATE_PROPERTIES[OP_TEXT_ALIGN] = 'textAlign';
+
+function DisplayList(rocky) {
+  this._rocky = rocky;
+  this._ops = [];
+  this._previous = null;
+  this._recording = false;
+  this._state = [];
+  this._lastFillRect = -1;
+}
+
+DisplayList.prototype.begin = function() {
+  this._ops = [];
+  this._state = [];
+  this._lastFillRect = -1;
+  this._recording = true;
+};
+
+// Finishes recording and requests a redraw if the frame differs from the last one drawn.
+// Returns whether a redraw was requested.
+DisplayList.prototype.end = function() {
+  this._recording = false;
+  if (this._previous && sameOps(this._previous, this._ops)) {
+    this._ops = this._previous;
+    return false;
+  }
+  this._rocky.requestDraw();
+  return true;
+};
+
+// Forces the next end() to request a redraw, for example after the canvas was drawn by other
+// code.
+DisplayList.prototype.invalidate = function() {
+  this._previous = null;
+};
+
+DisplayList.prototype.draw = function(ctx) {
+  var ops = this._ops;
+  var i = 0;
+  while (i < ops.length) {
+    var op = ops[i];
+    var a = ops[i + 1], b = ops[i + 2], c = ops[i + 3], d = ops[i + 4];
+    switch (op) {
+      case OP_FILL_STYLE: ctx.fillStyle = a; break;
+      case OP_STROKE_STYLE: ctx.strokeStyle = a; break;
+      case OP_LINE_WIDTH: ctx.lineWidth = a; break;
+      case OP_FONT: ctx.font = a; break;
+      case OP_TEXT_ALIGN: ctx.textAlign = a; break;
+      case OP_FILL_RECT: ctx.fillRect(a, b, c, d); break;
+      case OP_STROKE_RECT: ctx.strokeRect(a, b, c, d); break;
+      case OP_CLEAR_RECT: ctx.clearRect(a, b, c, d); break;
+      case OP_FILL_TEXT:
+        if (d === undefined) {
+          ctx.fillText(a, b, c);
+        } else {
+          ctx.fillText(a, b, c, d);
+        }
+        break;
+      case OP_BEGIN_PATH: ctx.beginPath(); break;
+      case OP_MOVE_TO: ctx.moveTo(a, b); break;
+      case OP_LINE_TO: ctx.lineTo(a, b); break;
+      case OP_RECT: ctx.rect(a, b, c, d); break;
+      case OP_ARC: ctx.arc(a, b, c, d, ops[i + 5], ops[i + 6]); break;
+      case OP_CLOSE_PATH: ctx.closePath(); break;
+      case OP_FILL: ctx.fill(); break;
+      case OP_STROKE: ctx.stroke(); break;
+      case OP_FILL_RADIAL: ctx.rockyFillRadial(a, b, c, d, ops[i + 5], ops[i + 6]); break;
+      default: throw new Error('display list: bad opcode ' + op);
+    }
+    i += 1 + ARGC[op];
+  }
+  this._previous = ops;
+};
+
+DisplayList.prototype._push = function(op, args) {
+  if (!this._recording) {
+    throw new Error('display list: call begin() before recording');
+  }
+  this._ops.push(op);
+  for (var i = 0; i < ARGC[op]; i++) {
+    this._ops.push(args[i]);
+  }
+};
+
+DisplayList.prototype._setState = function(op, value) {
+  if (this._state[op] === value) {
+    return;
+  }
+  this._state[op] = value;
+  this._push(op, [value]);
+  if (op === OP_FILL_STYLE) {
+    this._lastFillRect = -1;
+  }
+};
+
+DisplayList.prototype.fillStyle = function(value) { this._setState(OP_FILL_STYLE, value); };
+DisplayList.prototype.strokeStyle = function(value) { this._setState(OP_STROKE_STYLE, value); };
+DisplayList.prototype.lineWidth = function(value) { this._setState(OP_LINE_WIDTH, value); };
+DisplayList.prototype.font = function(value) { this._setState(OP_FONT, value); };
+DisplayList.prototype.textAlign = function(value) { this._setState(OP_TEXT_ALIGN, value); };
+
+DisplayList.prototype.fillRect = function(x, y, w, h) {
+  var ops = this._ops;
+  var last = this._lastFillRect;
+  // Merge with the previous op if it was a fillRect that this one continues exactly.
+  if (last >= 0 && last === ops.length - 5) {
+    var lx = ops[last + 1], ly = ops[last + 2], lw = ops[last + 3], lh = ops[last + 4];
+    if (ly === y && lh === h && lx + lw === x) {
+      ops[last + 3] = lw + w;
+      return;
+    }
+    if (lx === x && lw === w && ly + lh === y) {
+      ops[last + 4] = lh + h;
+      return;
+    }
+  }
+  this._lastFillRect = ops.length;
+  this._push(OP_FILL_RECT, arguments);
+};
+
+function recorder(op) {
+  return function() {
+    this._push(op, arguments);
+  };
+}
+
+DisplayList.prototype.strokeRect = recorder(OP_STROKE_RECT);
+DisplayList.prototype.clearRect = recorder(OP_CLEAR_RECT);
+DisplayList.prototype.fillText = recorder(OP_FILL_TEXT);
+DisplayList.prototype.beginPath = recorder(OP_BEGIN_PATH);
+DisplayList.prototype.moveTo = recorder(OP_MOVE_TO);
+DisplayList.prototype.lineTo = recorder(OP_LINE_TO);
+DisplayList.prototype.rect = recorder(OP_RECT);
+DisplayList.prototype.arc = recorder(OP_ARC);
+DisplayList.prototype.closePath = recorder(OP_CLOSE_PATH);
+DisplayList.prototype.fill = recorder(OP_FILL);
+DisplayList.prototype.stroke = recorder(OP_STROKE);
+DisplayList.prototype.rockyFillRadial = recorder(OP_FILL_RADIAL);
+
+function sameOps(a, b) {
+  if (a.length !== b.length) {
+    return false;
+  }
+  for (var i = 0; i < a.length; i++) {
+    if (a[i] !== b[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+module.exports.create = function(rocky) {
+  return new DisplayList(rocky || require('rocky'));
+};
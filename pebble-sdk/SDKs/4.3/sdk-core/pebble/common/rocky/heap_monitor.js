@@ -0,0 +1,146 @@
+/*
+ * Pause histograms and allocation pools for Rocky.js apps.
+ *
+ * The Rocky heap is small, and when it fills up the engine stops the app to collect garbage.
+ * Those pauses show up as dropped frames in animations. A heap monitor makes them visible: it
+ * runs a short timer and records how late each tick fires, minus the time spent in event
+ * handlers wrapped with monitor.wrap(). What remains is time the app was not running any of its
+ * own code, which is mostly garbage collection. It also counts the 'memorypressure' events the
+ * system sends.
+ *
+ * The best way to shorten the pauses is to allocate less per frame. createPool() keeps objects
+ * that are needed every frame, such as points or state records, for reuse instead of leaving
+ * them to the collector.
+ *
+ *   var heapMonitor = require('./heap_monitor');
+ *   var monitor = heapMonitor.create();
+ *   rocky.on('draw', monitor.wrap('draw', function(event) { ... }));
+ *   rocky.on('minutechange', function() { monitor.log(); });
+ *
+ * The monitor's own timer keeps the app awake, so only use it while measuring.
+ */
+
+var rocky = require('rocky');
+
+var DEFAULT_INTERVAL_MS = 50;
+// Upper bounds of the pause histogram buckets, in milliseconds.
+var DEFAULT_BUCKETS_MS = [5, 10, 20, 50, 100, 200];
+
+function HeapMonitor(options) {
+  options = options || {};
+  this.intervalMs = options.intervalMs || DEFAULT_INTERVAL_MS;
+  this.bucketsMs = options.bucketsMs || DEFAULT_BUCKETS_MS;
+  this.reset();
+
+  var self = this;
+  this._expected = Date.now() + this.intervalMs;
+  this._timer = setInterval(function() { self._tick(); }, this.intervalMs);
+  this._onMemoryPressure = function(event) {
+    self.memoryPressure[event.level] = (self.memoryPressure[event.level] || 0) + 1;
+  };
+  rocky.on('memorypressure', this._onMemoryPressure);
+}
+
+HeapMonitor.prototype.reset = function() {
+  // counts[i] is the number of pauses up to bucketsMs[i], the last entry counts longer ones.
+  this.counts = [];
+  for (var i = 0; i <= this.bucketsMs.length; i++) {
+    this.counts.push(0);
+  }
+  this.maxPauseMs = 0;
+  this.totalPauseMs = 0;
+  this.handlerMs = {};
+  this.memoryPressure = {};
+  this._handlerTimeSinceTick = 0;
+};
+
+HeapMonitor.prototype._tick = function() {
+  var now = Date.now();
+  var pause = now - this._expected - this._handlerTimeSinceTick;
+  this._expected = now + this.intervalMs;
+  this._handlerTimeSinceTick = 0;
+  // Ticks are never early, and lateness of a few ms is normal timer jitter.
+  if (pause <= 1) {
+    return;
+  }
+  var bucket = 0;
+  while (bucket < this.bucketsMs.length && pause > this.bucketsMs[bucket]) {
+    bucket++;
+  }
+  this.counts[bucket]++;
+  this.totalPauseMs += pause;
+  if (pause > this.maxPauseMs) {
+    this.maxPauseMs = pause;
+  }
+};
+
+// Returns a function that calls handler and excludes its run time from the pauses. The longest
+// run time of each name is kept in handlerMs.
+HeapMonitor.prototype.wrap = function(name, handler) {
+  var self = this;
+  return function() {
+    var start = Date.now();
+    try {
+      return handler.apply(this, arguments);
+    } finally {
+      var elapsed = Date.now() - start;
+      self._handlerTimeSinceTick += elapsed;
+      if (!(self.handlerMs[name] >= elapsed)) {
+        self.handlerMs[name] = elapsed;
+      }
+    }
+  };
+};
+
+HeapMonitor.prototype.report = function() {
+  var histogram = {};
+  for (var i = 0; i < this.bucketsMs.length; i++) {
+    histogram['<=' + this.bucketsMs[i] + 'ms'] = this.counts[i];
+  }
+  histogram['>' + this.bucketsMs[this.bucketsMs.length - 1] + 'ms'] =
+      this.counts[this.bucketsMs.length];
+  return {
+    pauses: histogram,
+    maxPauseMs: this.maxPauseMs,
+    totalPauseMs: this.totalPauseMs,
+    handlerMs: this.handlerMs,
+    memoryPressure: this.memoryPressure
+  };
+};
+
+// Writes the report to the app log as a single line, visible with `pebble logs`.
+HeapMonitor.prototype.log = function() {
+  console.log('heap_monitor ' + JSON.stringify(this.report()));
+};
+
+HeapMonitor.prototype.stop = function() {
+  clearInterval(this._timer);
+  rocky.off('memorypressure', this._onMemoryPressure);
+};
+
+// A free list of objects made by factory. acquire() returns a pooled object or a new one,
+// release() returns an object to the pool. Objects are not reset, so reinitialize them after
+// acquiring.
+function Pool(factory, maxSize) {
+  this._factory = factory;
+  this._maxSize = maxSize || 32;
+  this._free = [];
+}
+
+Pool.prototype.acquire = function() {
+  return this._free.length ? this._free.pop() : this._factory();
+};
+
+Pool.prototype.release = function(object) {
+  if (this._free.length < this._maxSize) {
+    this._free.push(object);
+  }
+};
+
+module.exports.create = function(options) {
+  return new HeapMonitor(options);
+};
+
+module.exports.createPool = function(factory, maxSize) {
+  return new Pool(factory, maxSize);
+};
@@ -0,0 +1,171 @@
+/*
+ * Pixel buffers for Rocky.js apps.
+ *
+ * The Rocky canvas has no way to draw precomputed pixels, so per-pixel effects end up as one
+ * fillRect call per pixel. An image data buffer lets an app write pixels into an array instead,
+ * and putImageData() then draws it with as few canvas calls as possible: each horizontal run of
+ * equal pixels becomes one rectangle, runs that repeat on the following rows are merged into
+ * taller rectangles, fully transparent pixels are skipped and the fill style is only set when
+ * it changes.
+ *
+ * Pixels are GColor8 values, the same as in a C app's frame buffer: two bits each of alpha,
+ * red, green and blue, from the most significant bits down. image.color(r, g, b) encodes an
+ * opaque color from 0-255 components.
+ *
+ * A buffer created with {circular: true} is laid out like GBitmapFormat8BitCircular, the frame
+ * buffer format of chalk's round display: it is 180x180, only the visible pixels of each row are
+ * stored, and the rows follow each other without gaps. image.rowInfo(y) describes a row the way
+ * gbitmap_get_data_row_info() does, so code that walks a captured frame buffer in C carries over:
+ *
+ *   var imageData = require('./image_data');
+ *   var image = imageData.create(180, 180, {circular: true});
+ *   for (var y = 0; y < image.height; y++) {
+ *     var row = image.rowInfo(y);
+ *     for (var x = row.minX; x <= row.maxX; x++) {
+ *       image.data[row.offset + x] = image.color(x, y, 255 - x);
+ *     }
+ *   }
+ *
+ *   rocky.on('draw', function(event) {
+ *     imageData.putImageData(event.context, image, 0, 0);
+ *   });
+ */
+
+function allocate(size) {
+  if (typeof Uint8Array !== 'undefined') {
+    return new Uint8Array(size);
+  }
+  var data = [];
+  for (var i = 0; i < size; i++) {
+    data.push(0);
+  }
+  return data;
+}
+
+// The first visible pixel of each row in the top half of chalk's frame buffer, the only
+// GBitmapFormat8BitCircular layout. Row y ends at 179 - minX, and the bottom half mirrors the top
+// one, which adds up to the 25944 bytes of the frame buffer.
+var CIRCULAR_SIZE = 180;
+var CIRCULAR_MIN_X = [
+  76, 71, 67, 63, 60, 57, 55, 52, 50, 48, 46, 45, 43, 41, 40, 38, 37, 35, 34, 33,
+  31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 19, 18, 17, 16, 16, 15, 14,
+  13, 13, 12, 12, 11, 10, 10, 9, 9, 8, 8, 7, 7, 6, 6, 5, 5, 5, 4, 4,
+  3, 3, 3, 2, 2, 2, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+];
+
+// Returns [minX, maxX] for each row of a circular buffer.
+function circularRows(width, height) {
+  if (width !== CIRCULAR_SIZE || height !== CIRCULAR_SIZE) {
+    throw new Error('circular image data has to be ' + CIRCULAR_SIZE + 'x' + CIRCULAR_SIZE);
+  }
+  var rows = [];
+  for (var y = 0; y < height; y++) {
+    var minX = CIRCULAR_MIN_X[Math.min(y, height - 1 - y)];
+    rows.push([minX, width - 1 - minX]);
+  }
+  return rows;
+}
+
+function ImageData(width, height, options) {
+  this.width = width;
+  this.height = height;
+  this._rows = [];
+  var size = 0;
+  var spans = options && options.circular ? circularRows(width, height) : null;
+  for (var y = 0; y < height; y++) {
+    var minX = spans ? spans[y][0] : 0;
+    var maxX = spans ? spans[y][1] : width - 1;
+    // As in GBitmapDataRowInfo, offset + x addresses pixel x, starting at minX.
+    this._rows.push({offset: size - minX, minX: minX, maxX: maxX});
+    size += maxX - minX + 1;
+  }
+  this.data = allocate(size);
+}
+
+ImageData.prototype.rowInfo = function(y) {
+  return this._rows[y];
+};
+
+ImageData.prototype.color = function(r, g, b) {
+  return 0xc0 | (r >> 6) << 4 | (g >> 6) << 2 | (b >> 6);
+};
+
+ImageData.prototype.getPixel = function(x, y) {
+  var row = this._rows[y];
+  return x < row.minX || x > row.maxX ? 0 : this.data[row.offset + x];
+};
+
+ImageData.prototype.setPixel = function(x, y, value) {
+  var row = this._rows[y];
+  if (x >= row.minX && x <= row.maxX) {
+    this.data[row.offset + x] = value;
+  }
+};
+
+var HEX = '0123456789abcdef';
+var STYLES = [];
+for (var c = 0; c < 64; c++) {
+  var style = '#';
+  for (var shift = 4; shift >= 0; shift -= 2) {
+    var v = (c >> shift & 3) * 0x55;
+    style += HEX.charAt(v >> 4) + HEX.charAt(v & 15);
+  }
+  STYLES.push(style);
+}
+
+// Draws an image data buffer with its top left corner at (dx, dy). Pixels with any alpha are
+// drawn opaque, since the canvas does not blend fill colors.
+function putImageData(ctx, image, dx, dy) {
+  var data = image.data;
+  var currentStyle = null;
+  // Rectangles that may still grow downwards, keyed by "x,width,color".
+  var open = {};
+
+  function flush(rect) {
+    var fill = STYLES[rect.color & 0x3f];
+    if (fill !== currentStyle) {
+      ctx.fillStyle = fill;
+      currentStyle = fill;
+    }
+    ctx.fillRect(dx + rect.x, dy + rect.y, rect.w, rect.h);
+  }
+
+  for (var y = 0; y < image.height; y++) {
+    var row = image.rowInfo(y);
+    var next = {};
+    var x = row.minX;
+    while (x <= row.maxX) {
+      var value = data[row.offset + x];
+      var end = x + 1;
+      while (end <= row.maxX && data[row.offset + end] === value) {
+        end++;
+      }
+      if (value & 0xc0) {
+        var key = x + ',' + (end - x) + ',' + value;
+        var rect = open[key];
+        if (rect) {
+          rect.h++;
+          delete open[key];
+        } else {
+          rect = {x: x, y: y, w: end - x, h: 1, color: value};
+        }
+        next[key] = rect;
+      }
+      x = end;
+    }
+    for (var k in open) {
+      flush(open[k]);
+    }
+    open = next;
+  }
+  for (k in open) {
+    flush(open[k]);
+  }
+}
+
+module.exports.create = function(width, height, options) {
+  return new ImageData(width, height, options);
+};
+
+module.exports.putImageData = putImageData;
@@ -0,0 +1,37 @@
+/*
+ * Checks the row layout of image data buffers against chalk's frame buffer.
+ *
+ *   node image_data_test.js
+ */
+
+var assert = require('assert');
+var imageData = require('./image_data');
+
+function lastByte(image) {
+  var row = image.rowInfo(image.height - 1);
+  return row.offset + row.maxX;
+}
+
+var round = imageData.create(180, 180, {circular: true});
+assert.strictEqual(round.data.length, 25944);
+assert.deepEqual(round.rowInfo(0), {offset: -76, minX: 76, maxX: 103});
+assert.deepEqual(round.rowInfo(179), {offset: 25916 - 76, minX: 76, maxX: 103});
+assert.strictEqual(round.rowInfo(90).minX, 0);
+assert.strictEqual(round.rowInfo(90).maxX, 179);
+assert.strictEqual(lastByte(round), round.data.length - 1);
+for (var y = 1; y < 180; y++) {
+  var prev = round.rowInfo(y - 1);
+  var row = round.rowInfo(y);
+  assert.strictEqual(row.offset + row.minX, prev.offset + prev.maxX + 1, 'row ' + y);
+  assert.strictEqual(row.minX, round.rowInfo(179 - y).minX, 'row ' + y);
+}
+
+var rect = imageData.create(144, 168);
+assert.strictEqual(rect.data.length, 144 * 168);
+assert.deepEqual(rect.rowInfo(167), {offset: 144 * 167, minX: 0, maxX: 143});
+
+assert.throws(function() {
+  imageData.create(144, 168, {circular: true});
+});
+
+console.log('ok');
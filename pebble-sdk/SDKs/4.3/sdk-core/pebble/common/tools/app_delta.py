@@ -0,0 +1,180 @@
+#!/usr/bin/env python
+"""
+Compute and apply block-level deltas between two builds of a pbw.
+
+During development most rebuilds only change a few functions or a single resource, yet every
+install sends the complete app binary, worker and resource pack over Bluetooth. A delta holds
+only the fixed-size blocks of each part that changed since the pbw that is already installed.
+The install can then send just those blocks and rebuild the part on the receiving side.
+
+A delta is tied to the build it was made against. Each part records the crc of its base, taken
+from the crc or resource_crc field of the PebbleProcessInfo in the base app binary. apply
+refuses to patch any other base. After patching, each part is checked against its SHA-1 in
+the target build, and each app binary also against the crc it should carry.
+
+Usage:
+    app_delta.py make OLD.pbw NEW.pbw DELTA.pbd [--block-size BYTES]
+    app_delta.py apply OLD.pbw DELTA.pbd NEW.pbw
+
+A .pbd file is a zip with a delta.json index and, for each part, a blob holding the changed
+blocks in index order. Files that are not app binaries or resource packs are stored whole.
+"""
+
+from __future__ import print_function
+
+import argparse
+import hashlib
+import json
+import posixpath
+import struct
+import sys
+import zipfile
+
+DEFAULT_BLOCK_SIZE = 1024
+DELTA_VERSION = 1
+
+APP_BINARIES = ('pebble-app.bin', 'pebble-worker.bin')
+RESOURCE_PACK = 'app_resources.pbpack'
+
+# The fixed start of PebbleProcessInfo, up to and including resource_crc.
+PROCESS_INFO_FORMAT = '<8sBBBBBBHII32s32sIIII16sI'
+PROCESS_INFO_HEADER = b'PBLAPP'
+
+
+def process_info(data):
+    fields = struct.unpack_from(PROCESS_INFO_FORMAT, data)
+    if not fields[0].startswith(PROCESS_INFO_HEADER):
+        raise ValueError("not a Pebble process binary")
+    return {'crc': fields[9], 'resource_crc': fields[17]}
+
+
+def part_crc(name, data, app_info):
+    """Return the crc PebbleProcessInfo records for a part, or None if it has none."""
+    base = posixpath.basename(name)
+    if base in APP_BINARIES:
+        return process_info(data)['crc']
+    if base == RESOURCE_PACK and app_info is not None:
+        return app_info['resource_crc']
+    return None
+
+
+def app_infos(z):
+    infos = {}
+    for name in z.namelist():
+        if posixpath.basename(name) == 'pebble-app.bin':
+            infos[posixpath.dirname(name)] = process_info(z.read(name))
+    return infos
+
+
+def changed_blocks(old, new, block_size):
+    blocks = []
+    for offset in range(0, len(new), block_size):
+        chunk = new[offset:offset + block_size]
+        if old[offset:offset + block_size] != chunk:
+            if blocks and blocks[-1][0] + blocks[-1][1] == offset:
+                blocks[-1][1] += len(chunk)
+            else:
+                blocks.append([offset, len(chunk)])
+    return blocks
+
+
+def make(old_path, new_path, delta_path, block_size):
+    with zipfile.ZipFile(old_path) as zold, zipfile.ZipFile(new_path) as znew:
+        old_infos = app_infos(zold)
+        new_infos = app_infos(znew)
+        old_names = set(zold.namelist())
+        index = {'version': DELTA_VERSION, 'block_size': block_size, 'parts': []}
+        sent = total = 0
+        with zipfile.ZipFile(delta_path, 'w', zipfile.ZIP_DEFLATED) as zd:
+            for name in znew.namelist():
+                new = znew.read(name)
+                pdir = posixpath.dirname(name)
+                new_crc = part_crc(name, new, new_infos.get(pdir))
+                part = {'name': name, 'size': len(new), 'sha1': hashlib.sha1(new).hexdigest()}
+                total += len(new)
+                old = zold.read(name) if name in old_names else None
+                old_crc = part_crc(name, old, old_infos.get(pdir)) if old is not None else None
+                if new_crc is None or old_crc is None:
+                    zd.writestr('whole/' + name, new)
+                    part['whole'] = True
+                    sent += len(new)
+                elif old_crc == new_crc and old == new:
+                    part['unchanged'] = True
+                    part['base_crc'] = old_crc
+                else:
+                    blocks = changed_blocks(old, new, block_size)
+                    zd.writestr('blocks/' + name, b''.join(new[o:o + n] for o, n in blocks))
+                    part.update({'base_crc': old_crc, 'crc': new_crc, 'blocks': blocks})
+                    sent += sum(n for _, n in blocks)
+                index['parts'].append(part)
+            zd.writestr('delta.json', json.dumps(index, indent=2))
+    return sent, total
+
+
+def apply(old_path, delta_path, new_path):
+    with zipfile.ZipFile(old_path) as zold, zipfile.ZipFile(delta_path) as zd:
+        index = json.loads(zd.read('delta.json').decode('utf-8'))
+        if index.get('version') != DELTA_VERSION:
+            raise ValueError("unsupported delta version {}".format(index.get('version')))
+        old_infos = app_infos(zold)
+        with zipfile.ZipFile(new_path, 'w', zipfile.ZIP_DEFLATED) as znew:
+            for part in index['parts']:
+                name = part['name']
+                if part.get('whole'):
+                    data = zd.read('whole/' + name)
+                else:
+                    old = zold.read(name)
+                    base_crc = part_crc(name, old, old_infos.get(posixpath.dirname(name)))
+                    if base_crc != part['base_crc']:
+                        raise ValueError("{}: installed build does not match the delta's base "
+                                         "(crc {:08x}, expected {:08x})"
+                                         .format(name, base_crc, part['base_crc']))
+                    if part.get('unchanged'):
+                        data = old
+                    else:
+                        data = bytearray(old[:part['size']].ljust(part['size'], b'\0'))
+                        blob = zd.read('blocks/' + name)
+                        pos = 0
+                        for offset, length in part['blocks']:
+                            data[offset:offset + length] = blob[pos:pos + length]
+                            pos += length
+                        data = bytes(data)
+                if (part.get('crc') is not None and posixpath.basename(name) in APP_BINARIES
+                        and process_info(data)['crc'] != part['crc']):
+                    raise ValueError("{}: patched binary has the wrong crc".format(name))
+                if hashlib.sha1(data).hexdigest() != part['sha1']:
+                    raise ValueError("{}: patched data does not match".format(name))
+                znew.writestr(name, data)
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    sub = parser.add_subparsers(dest='command')
+    p = sub.add_parser('make', help="compute the delta from OLD to NEW")
+    p.add_argument('old')
+    p.add_argument('new')
+    p.add_argument('delta')
+    p.add_argument('--block-size', type=int, default=DEFAULT_BLOCK_SIZE)
+    p = sub.add_parser('apply', help="rebuild NEW from OLD and a delta")
+    p.add_argument('old')
+    p.add_argument('delta')
+    p.add_argument('new')
+    args = parser.parse_args(argv)
+
+    try:
+        if args.command == 'make':
+            sent, total = make(args.old, args.new, args.delta, args.block_size)
+            print("delta carries {} of {} bytes".format(sent, total))
+        elif args.command == 'apply':
+            apply(args.old, args.delta, args.new)
+        else:
+            parser.print_usage()
+            return 2
+    except ValueError as e:
+        print("error: {}".format(e), file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,148 @@
+#!/usr/bin/env python
+"""
+Summarize the AppMessage counters an app writes to its log.
+
+An app that calls app_message_set_stats_log_interval() logs a line with its AppMessage counters
+at that interval, see AppMessageStats in pebble.h. This tool reads `pebble logs` output of such
+an app from LOG, or from stdin, and prints the totals of the session: messages and bytes in both
+directions, the send rate, retries, failures by result, and percentiles of the time messages
+spent queued and waiting for their acknowledgement. Percentiles are the upper bounds of the
+histogram buckets they fall in, so "< 200ms" means some time between 100 and 200 ms.
+
+Usage:
+    appmsg_stats.py [LOG] [--json]
+
+The logged counters are totals since launch, so the last line of a session has all of them.
+When the counters go down, the app was restarted or called app_message_reset_stats(), and the
+line before is added to the totals as a session of its own.
+"""
+
+from __future__ import print_function
+
+import argparse
+import json
+import re
+import sys
+
+BUCKETS = 8
+BUCKET_LIMITS_MS = [25 << i for i in range(BUCKETS - 1)]
+
+STATS_LINE = re.compile(r'\bappmsg: sent (\d+) failed (\d+) retries (\d+) received (\d+) '
+                        r'dropped (\d+) tx (\d+)B rx (\d+)B rate (\d+)B/s timeouts (\d+) '
+                        r'rejected (\d+) not_connected (\d+) other (\d+) '
+                        r'queue ([\d,]+) ack ([\d,]+) max (\d+)ms\s*$')
+COUNTERS = ['sent', 'failed', 'retries', 'received', 'dropped', 'bytes_sent',
+            'bytes_received', 'peak_rate', 'timeouts', 'rejected', 'not_connected', 'other']
+
+
+def parse_line(line):
+    m = STATS_LINE.search(line.rstrip('\n'))
+    if not m:
+        return None
+    groups = m.groups()
+    stats = dict(zip(COUNTERS, (int(g) for g in groups[:len(COUNTERS)])))
+    for key, text in zip(('queue', 'ack'), groups[len(COUNTERS):len(COUNTERS) + 2]):
+        histogram = [int(v) for v in text.split(',')]
+        if len(histogram) != BUCKETS:
+            return None
+        stats[key] = histogram
+    stats['max_ms'] = int(groups[-1])
+    return stats
+
+
+def add(total, stats):
+    if total is None:
+        return dict((k, list(v) if isinstance(v, list) else v) for k, v in stats.items())
+    for key, value in stats.items():
+        if key in ('peak_rate', 'max_ms'):
+            total[key] = max(total[key], value)
+        elif isinstance(value, list):
+            total[key] = [a + b for a, b in zip(total[key], value)]
+        else:
+            total[key] += value
+    return total
+
+
+def parse_log(lines):
+    """Return the counters of all sessions in the log added up, or None if there are none."""
+    total = None
+    last = None
+    for line in lines:
+        stats = parse_line(line)
+        if stats is None:
+            continue
+        if last is not None and (stats['sent'] < last['sent'] or
+                                 stats['received'] < last['received']):
+            total = add(total, last)
+        last = stats
+    if last is not None:
+        total = add(total, last)
+    return total
+
+
+def percentile(histogram, fraction):
+    """Return the upper bound in ms of the bucket holding the given fraction, None if open."""
+    count = sum(histogram)
+    if count == 0:
+        return 0
+    seen = 0
+    for limit, n in zip(BUCKET_LIMITS_MS + [None], histogram):
+        seen += n
+        if seen >= count * fraction:
+            return limit
+    return None
+
+
+def summarize(stats):
+    summary = dict(stats)
+    for key in ('queue', 'ack'):
+        summary[key + '_ms'] = dict((name, percentile(stats[key], fraction))
+                                    for name, fraction in (('p50', 0.5), ('p95', 0.95),
+                                                           ('p99', 0.99)))
+    attempts = stats['sent'] + stats['failed']
+    summary['failure_rate'] = round(float(stats['failed']) / attempts, 4) if attempts else 0.0
+    return summary
+
+
+def format_ms(limit):
+    return ">= {}ms".format(BUCKET_LIMITS_MS[-1]) if limit is None else "< {}ms".format(limit)
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument('log', nargs='?', help="pebble logs output (default: stdin)")
+    parser.add_argument('--json', action='store_true', help="write the summary as JSON")
+    args = parser.parse_args(argv)
+
+    try:
+        stream = open(args.log) if args.log else sys.stdin
+    except IOError as e:
+        print("error: {}".format(e), file=sys.stderr)
+        return 1
+    stats = parse_log(stream)
+    if stats is None:
+        print("error: no appmsg lines found; call app_message_set_stats_log_interval() in the app",
+              file=sys.stderr)
+        return 1
+    summary = summarize(stats)
+    if args.json:
+        print(json.dumps(summary, indent=2, sort_keys=True, separators=(',', ': ')))
+        return 0
+    print("sent      {sent:>8} messages {bytes_sent:>10} bytes, peak {peak_rate} B/s"
+          .format(**summary))
+    print("received  {received:>8} messages {bytes_received:>10} bytes, {dropped} dropped"
+          .format(**summary))
+    print("retries   {retries:>8}".format(**summary))
+    print("failed    {failed:>8} ({failure_rate:.1%}): {timeouts} timeouts, {rejected} rejected, "
+          "{not_connected} not connected, {other} other".format(**summary))
+    for key, label in (('queue', 'queued'), ('ack', 'to ACK')):
+        ms = summary[key + '_ms']
+        print("{:<9} p50 {:>9}  p95 {:>9}  p99 {:>9}".format(label, format_ms(ms['p50']),
+                                                             format_ms(ms['p95']),
+                                                             format_ms(ms['p99'])))
+    print("slowest   {max_ms} ms".format(**summary))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
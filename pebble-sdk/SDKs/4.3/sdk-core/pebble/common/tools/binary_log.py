@@ -0,0 +1,132 @@
+#!/usr/bin/env python
+"""
+Format messages logged with APP_LOG_BINARY using the app's ELF file.
+
+APP_LOG_BINARY keeps the format string, file name and line number of each message in the
+.pbl_log_fmt section of the app's ELF file. That is a non-alloc section at address 0, so it is
+not part of the app binary. The watch sends only a record per message, all fields little endian:
+
+    uint32_t fmt_id       offset of the message's entry in .pbl_log_fmt
+    uint32_t time_ms      milliseconds since the app started, wrapping
+    uint8_t  level        the AppLogLevel
+    uint8_t  num_args     number of argument words that follow
+    uint16_t dropped      messages dropped on the watch just before this one
+    uint32_t args[num_args]
+
+Each .pbl_log_fmt entry is three NUL-terminated strings: file name, line number and format.
+
+Usage:
+    binary_log.py APP.elf [RECORDS]
+
+Records are read from the RECORDS file, or from stdin, and the formatted messages are written
+to stdout. The same decoding is available to other tools as BinaryLogDecoder.
+"""
+
+from __future__ import print_function
+
+import argparse
+import re
+import struct
+import sys
+
+SECTION = '.pbl_log_fmt'
+RECORD_HEADER = struct.Struct('<IIBBH')
+
+LEVEL_NAMES = {1: 'E', 50: 'W', 100: 'I', 200: 'D', 255: 'V'}
+
+CONVERSION = re.compile(r'%([-+ #0]*)(\d*)(?:\.(\d+))?(?:hh|h|l|z)?([diuxXc%])')
+
+
+def read_section(elf_path, section_name):
+    """Return (address, data) of a section in a 32-bit little-endian ELF file."""
+    with open(elf_path, 'rb') as f:
+        elf = f.read()
+    if elf[:4] != b'\x7fELF' or elf[4:5] != b'\x01' or elf[5:6] != b'\x01':
+        raise ValueError("{} is not a 32-bit little-endian ELF file".format(elf_path))
+    shoff, = struct.unpack_from('<I', elf, 0x20)
+    shentsize, shnum, shstrndx = struct.unpack_from('<HHH', elf, 0x2e)
+
+    def header(i):
+        # name, type, flags, addr, offset, size
+        return struct.unpack_from('<IIIIII', elf, shoff + i * shentsize)
+
+    strtab = header(shstrndx)
+    names = elf[strtab[4]:strtab[4] + strtab[5]]
+    for i in range(shnum):
+        name, _, _, addr, offset, size = header(i)
+        end = names.index(b'\0', name)
+        if names[name:end].decode('ascii') == section_name:
+            return addr, elf[offset:offset + size]
+    raise ValueError("{} has no {} section; was it built with APP_LOG_BINARY?"
+                     .format(elf_path, section_name))
+
+
+def format_message(fmt, args):
+    args = list(args)
+
+    def convert(m):
+        flags, width, precision, conv = m.groups()
+        if conv == '%':
+            return '%'
+        value = args.pop(0) if args else 0
+        if conv in 'di':
+            value = value - (1 << 32) if value & 0x80000000 else value
+            conv = 'd'
+        elif conv == 'u':
+            conv = 'd'
+        elif conv == 'c':
+            value = chr(value & 0xff)
+        spec = '%' + flags + width + ('.' + precision if precision else '') + conv
+        return spec % value
+
+    return CONVERSION.sub(convert, fmt)
+
+
+class BinaryLogDecoder(object):
+    def __init__(self, elf_path):
+        self.base, self.strings = read_section(elf_path, SECTION)
+
+    def lookup(self, fmt_id):
+        start = fmt_id - self.base
+        if not 0 <= start < len(self.strings):
+            return '?', '?', '<unknown message 0x{:08x}>'.format(fmt_id)
+        fields = self.strings[start:].split(b'\0', 3)
+        return tuple(f.decode('utf-8', 'replace') for f in fields[:3])
+
+    def records(self, stream):
+        """Yield (time_ms, level, dropped, filename, line, message) for each record."""
+        while True:
+            head = stream.read(RECORD_HEADER.size)
+            if len(head) < RECORD_HEADER.size:
+                return
+            fmt_id, time_ms, level, num_args, dropped = RECORD_HEADER.unpack(head)
+            raw = stream.read(4 * num_args)
+            if len(raw) < 4 * num_args:
+                return
+            args = struct.unpack('<{}I'.format(num_args), raw)
+            filename, line, fmt = self.lookup(fmt_id)
+            yield time_ms, level, dropped, filename, line, format_message(fmt, args)
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument('elf', help="the app's ELF file (build/<platform>/pebble-app.elf)")
+    parser.add_argument('records', nargs='?', help="binary records (default: stdin)")
+    args = parser.parse_args(argv)
+
+    try:
+        decoder = BinaryLogDecoder(args.elf)
+    except ValueError as e:
+        print("error: {}".format(e), file=sys.stderr)
+        return 1
+    stream = open(args.records, 'rb') if args.records else getattr(sys.stdin, 'buffer', sys.stdin)
+    for time_ms, level, dropped, filename, line, message in decoder.records(stream):
+        if dropped:
+            print("[{:>10}] ... {} messages dropped".format(time_ms, dropped))
+        print("[{:>10}] [{}] {}:{}> {}".format(time_ms, LEVEL_NAMES.get(level, level),
+                                              filename, line, message))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
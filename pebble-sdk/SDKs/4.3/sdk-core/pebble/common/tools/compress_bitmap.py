@@ -0,0 +1,189 @@
+#!/usr/bin/env python
+"""
+Convert a PNG image to a compressed bitmap resource, for resources of type "compressed".
+
+Compressed bitmaps stay LZ4 compressed in RAM and are decoded a few rows at a time while
+drawing, see the Compressed Bitmap File Format in pebble.h. This tool writes that format from a
+PNG image: 8-bit GColor8 pixels for color platforms with --format 8bit, or 1-bit pixels for
+black and white ones with --format 1bit. Dither color art with dither.py first for the latter.
+Like dither.py, it can run as a resource_cache.py job.
+
+Usage:
+    compress_bitmap.py [--format 8bit|1bit] [--rows-per-block N] INPUT OUTPUT
+
+The compressed size and the size the pixels would take uncompressed are printed, which is the
+heap the resource saves.
+"""
+
+from __future__ import print_function
+
+import argparse
+import struct
+import sys
+import zlib
+
+from dither import read_png
+
+VERSION = 1
+# Values of GBitmapFormat
+FORMAT_1BIT = 0
+FORMAT_8BIT = 1
+
+HEADER = struct.Struct('<BBBBHH')
+
+MIN_MATCH = 4
+# The LZ4 block format requires the last 5 bytes to be literals and the last match to start at
+# least 12 bytes before the end.
+LAST_LITERALS = 5
+MF_LIMIT = 12
+MAX_OFFSET = 0xffff
+
+
+def _length_bytes(n):
+    out = bytearray()
+    while n >= 255:
+        out.append(255)
+        n -= 255
+    out.append(n)
+    return out
+
+
+def _sequence(out, literals, match_length):
+    token_literals = min(len(literals), 15)
+    token_match = 0 if match_length is None else min(match_length - MIN_MATCH, 15)
+    out.append(token_literals << 4 | token_match)
+    if len(literals) >= 15:
+        out += _length_bytes(len(literals) - 15)
+    out += literals
+
+
+def lz4_compress(data):
+    """Return data compressed as a single LZ4 raw block."""
+    data = bytes(data)
+    out = bytearray()
+    table = {}
+    anchor = 0
+    i = 0
+    limit = len(data) - MF_LIMIT
+    while i < limit:
+        key = data[i:i + MIN_MATCH]
+        candidate = table.get(key)
+        table[key] = i
+        if candidate is None or i - candidate > MAX_OFFSET:
+            i += 1
+            continue
+        length = MIN_MATCH
+        end = len(data) - LAST_LITERALS
+        while i + length < end and data[candidate + length] == data[i + length]:
+            length += 1
+        _sequence(out, bytearray(data[anchor:i]), length)
+        offset = i - candidate
+        out += struct.pack('<H', offset)
+        if length - MIN_MATCH >= 15:
+            out += _length_bytes(length - MIN_MATCH - 15)
+        i += length
+        anchor = i
+    _sequence(out, bytearray(data[anchor:]), None)
+    return out
+
+
+def lz4_decompress(block, size):
+    block = bytearray(block)
+    out = bytearray()
+    i = 0
+    while i < len(block):
+        token = block[i]
+        i += 1
+        n = token >> 4
+        if n == 15:
+            while True:
+                n += block[i]
+                i += 1
+                if block[i - 1] != 255:
+                    break
+        out += block[i:i + n]
+        i += n
+        if i >= len(block):
+            break
+        offset = block[i] | block[i + 1] << 8
+        i += 2
+        n = (token & 15) + MIN_MATCH
+        if token & 15 == 15:
+            while True:
+                n += block[i]
+                i += 1
+                if block[i - 1] != 255:
+                    break
+        for _ in range(n):
+            out.append(out[-offset])
+    if len(out) != size:
+        raise ValueError("corrupt block")
+    return out
+
+
+def pixel_rows(pixels, fmt):
+    """Return the rows of a PNG image in the row layout of a PBI."""
+    rows = []
+    for row in pixels:
+        if fmt == FORMAT_8BIT:
+            rows.append(bytearray((a >> 6) << 6 | (r >> 6) << 4 | (g >> 6) << 2 | b >> 6
+                                  for r, g, b, a in row))
+        else:
+            # Rows of 1-bit PBIs are padded to whole words, and store the leftmost pixel in the
+            # least significant bit.
+            out = bytearray((len(row) + 31) // 32 * 4)
+            for x, (r, g, b, a) in enumerate(row):
+                if a >= 128 and 0.299 * r + 0.587 * g + 0.114 * b >= 128:
+                    out[x // 8] |= 1 << (x % 8)
+            rows.append(out)
+    return rows
+
+
+def encode(width, height, rows, fmt, rows_per_block):
+    blocks = []
+    for y in range(0, height, rows_per_block):
+        raw = bytearray().join(rows[y:y + rows_per_block])
+        block = lz4_compress(raw)
+        # Check every block here, since the watch has no way to report corrupt pixels.
+        if lz4_decompress(block, len(raw)) != raw:
+            raise AssertionError("block at row {} does not decompress".format(y))
+        blocks.append(block)
+    offsets = [0]
+    for block in blocks:
+        offsets.append(offsets[-1] + len(block))
+    out = bytearray(HEADER.pack(VERSION, fmt, rows_per_block, 0, width, height))
+    out += struct.pack('<{}I'.format(len(offsets)), *offsets)
+    for block in blocks:
+        out += block
+    return out
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument('input')
+    parser.add_argument('output')
+    parser.add_argument('--format', default='8bit', choices=['8bit', '1bit'])
+    parser.add_argument('--rows-per-block', type=int, default=8,
+                        help="rows compressed together; more compress better but cost more stack "
+                             "while drawing (default: 8)")
+    args = parser.parse_args(argv)
+    if not 1 <= args.rows_per_block <= 255:
+        parser.error("--rows-per-block must be between 1 and 255")
+
+    try:
+        width, height, pixels = read_png(args.input)
+    except (IOError, ValueError, KeyError, zlib.error) as e:
+        print("error: {}: {}".format(args.input, e), file=sys.stderr)
+        return 1
+    fmt = FORMAT_8BIT if args.format == '8bit' else FORMAT_1BIT
+    rows = pixel_rows(pixels, fmt)
+    data = encode(width, height, rows, fmt, args.rows_per_block)
+    with open(args.output, 'wb') as f:
+        f.write(data)
+    print("{}: {} bytes, {} uncompressed".format(args.output, len(data),
+                                                 sum(len(r) for r in rows)))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
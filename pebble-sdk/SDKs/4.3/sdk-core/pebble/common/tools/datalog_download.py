@@ -0,0 +1,357 @@
+#!/usr/bin/env python
+"""
+Download data logging sessions from watches directly and export them to CSV or Parquet.
+
+The phone app forwards data logging sessions only as fast as the phone application consumes
+them. This tool connects to the watch through the developer connection instead, the way
+pebble-tool does, turns off sending to the phone while it runs and drains the sessions of the
+watch itself. The targets are drained in parallel, and the items of each session are decoded
+and written on another thread while the next session is downloaded.
+
+Targets are given as KIND:ADDRESS:
+    phone:192.168.1.20        a phone running the Pebble app with the developer connection on
+    serial:/dev/ttyUSB0       a watch connected over a serial console
+    qemu:localhost:12344      a running emulator or QEMU instance
+
+Usage:
+    datalog_download.py TARGET... [--output-dir DIR] [--format csv|parquet] [--app UUID]
+                        [--tag TAG] [--fields TAG=NAME:TYPE,...]
+
+Each session is written to DIR/<watch>_<app uuid>_<tag>_<timestamp>.csv, with one row per item,
+where <watch> is the serial number of the watch. Integer
+sessions have a single column `value`, byte arrays a column `hex`. Sessions created with
+data_logging_create_with_schema() are exported as byte arrays unless their schema is given with
+--fields, where TYPE is one of u8, u16, u32, i8, i16, i32 or bytesN, for example
+`--fields 0x1234=x:i16,y:i16,z:i16,time:u32`. With --format parquet, which needs pyarrow, each
+download of a session is written to a file of its own, numbered from 1.
+
+Downloaded data is removed from the watch as it is acknowledged. DIR/datalog_state.json records
+what was written for each session, so running the tool again resumes: sessions that are still
+being logged to continue in the same files, and data of a session that was downloaded but not
+exported, because the tool was interrupted, is exported from the DIR/raw copy first. The state
+also records the length of each CSV file, and rows written after it by an interrupted run are
+dropped before the data is exported again, so no row is written twice.
+"""
+
+from __future__ import print_function
+
+import argparse
+import binascii
+import json
+import os
+import struct
+import sys
+import threading
+
+try:
+    import Queue as queue
+except ImportError:
+    import queue
+
+DATA_LOGGING_BYTE_ARRAY = 0
+DATA_LOGGING_UINT = 2
+DATA_LOGGING_INT = 3
+
+FIELD_TYPES = {'u8': 'B', 'u16': 'H', 'u32': 'I', 'i8': 'b', 'i16': 'h', 'i32': 'i'}
+INT_FORMATS = {
+    (DATA_LOGGING_UINT, 1): 'B', (DATA_LOGGING_UINT, 2): 'H', (DATA_LOGGING_UINT, 4): 'I',
+    (DATA_LOGGING_INT, 1): 'b', (DATA_LOGGING_INT, 2): 'h', (DATA_LOGGING_INT, 4): 'i',
+}
+STATE_FILE = 'datalog_state.json'
+
+
+def parse_fields(spec):
+    """Parse TAG=NAME:TYPE,... into (tag, [(name, struct format or byte count)])."""
+    tag, sep, fields = spec.partition('=')
+    if not sep or not fields:
+        raise ValueError("bad --fields '{}', expected TAG=NAME:TYPE,...".format(spec))
+    result = []
+    for field in fields.split(','):
+        name, _, kind = field.partition(':')
+        if kind in FIELD_TYPES:
+            result.append((name, FIELD_TYPES[kind]))
+        elif kind.startswith('bytes') and kind[5:].isdigit():
+            result.append((name, int(kind[5:])))
+        else:
+            raise ValueError("bad field '{}' in --fields, TYPE must be one of {} or bytesN"
+                             .format(field, ', '.join(sorted(FIELD_TYPES))))
+    return int(tag, 0), result
+
+
+class SessionInfo(object):
+    """The attributes of a session that libpebble2 reports, as saved in the state file."""
+
+    def __init__(self, watch, session_id, app_uuid, log_tag, timestamp, data_item_type,
+                 data_item_size):
+        self.watch = watch
+        self.session_id = session_id
+        self.app_uuid = app_uuid
+        self.log_tag = log_tag
+        self.timestamp = timestamp
+        self.data_item_type = data_item_type
+        self.data_item_size = data_item_size
+
+
+def session_field(info, name):
+    """Return a field of a session from libpebble2, which may be an object or a dict."""
+    if isinstance(info, dict):
+        return info[name]
+    return getattr(info, name)
+
+
+class Session(object):
+    """A data logging session as reported by the watch, and how its items are decoded."""
+
+    def __init__(self, watch, info, fields):
+        self.watch = watch
+        self.session_id = session_field(info, 'session_id')
+        self.app_uuid = str(session_field(info, 'app_uuid'))
+        self.tag = session_field(info, 'log_tag')
+        self.timestamp = session_field(info, 'timestamp')
+        self.item_type = int(session_field(info, 'data_item_type'))
+        self.item_size = session_field(info, 'data_item_size')
+        self.key = '{}_{}_{:x}_{}'.format(watch, self.app_uuid, self.tag, self.timestamp)
+        if self.tag in fields:
+            self.columns = [name for name, _ in fields[self.tag]]
+            self.format = '<' + ''.join(f if isinstance(f, str) else '{}s'.format(f)
+                                        for _, f in fields[self.tag])
+            if struct.calcsize(self.format) != self.item_size:
+                raise ValueError("--fields for tag 0x{:x} describe {} bytes, but its items have "
+                                 "{}".format(self.tag, struct.calcsize(self.format),
+                                             self.item_size))
+        elif (self.item_type, self.item_size) in INT_FORMATS:
+            self.columns = ['value']
+            self.format = '<' + INT_FORMATS[(self.item_type, self.item_size)]
+        else:
+            self.columns = ['hex']
+            self.format = '<{}s'.format(self.item_size)
+
+    def info(self):
+        return {'watch': self.watch, 'session_id': self.session_id, 'app_uuid': self.app_uuid,
+                'log_tag': self.tag, 'timestamp': self.timestamp, 'data_item_type': self.item_type,
+                'data_item_size': self.item_size}
+
+    def rows(self, data):
+        if len(data) % self.item_size:
+            raise ValueError("session {}: {} bytes is not a whole number of {}-byte items"
+                             .format(self.key, len(data), self.item_size))
+        for pos in range(0, len(data), self.item_size):
+            yield [binascii.hexlify(v).decode('ascii') if isinstance(v, bytes) else v
+                   for v in struct.unpack_from(self.format, data, pos)]
+
+
+class Exporter(object):
+    """Writes downloaded session data to the output directory on a thread of its own."""
+
+    def __init__(self, args):
+        self.args = args
+        self.raw_dir = os.path.join(args.output_dir, 'raw')
+        self.state_path = os.path.join(args.output_dir, STATE_FILE)
+        self.state = {}
+        if os.path.exists(self.state_path):
+            with open(self.state_path) as f:
+                self.state = json.load(f)
+        for path in (args.output_dir, self.raw_dir):
+            if not os.path.isdir(path):
+                os.makedirs(path)
+        self.lock = threading.Lock()
+        self.jobs = queue.Queue(maxsize=4)
+        self.errors = []
+        self.thread = threading.Thread(target=self._run)
+        self.thread.daemon = True
+        self.thread.start()
+
+    def _save_state(self):
+        with open(self.state_path + '.tmp', 'w') as f:
+            json.dump(self.state, f, indent=2, sort_keys=True, separators=(',', ': '))
+            f.write('\n')
+        if os.name == 'nt' and os.path.exists(self.state_path):
+            os.remove(self.state_path)
+        os.rename(self.state_path + '.tmp', self.state_path)
+
+    def received(self, session, data):
+        """Keep the downloaded data of a session before it is exported."""
+        with self.lock:
+            entry = self.state.setdefault(session.key, {'items': 0, 'raw_bytes': 0,
+                                                        'exported_bytes': 0, 'parts': 0})
+            with open(os.path.join(self.raw_dir, session.key + '.bin'), 'ab') as f:
+                f.write(data)
+                f.flush()
+                os.fsync(f.fileno())
+            entry['raw_bytes'] += len(data)
+            entry['session'] = session.info()
+            self._save_state()
+        self.jobs.put(session)
+
+    def resume(self, fields):
+        """Export the data that an earlier run downloaded but did not export."""
+        for entry in self.state.values():
+            if entry['exported_bytes'] < entry['raw_bytes']:
+                info = SessionInfo(**entry['session'])
+                self.jobs.put(Session(info.watch, info, fields))
+
+    def _run(self):
+        while True:
+            session = self.jobs.get()
+            if session is None:
+                return
+            try:
+                self._export(session)
+            except (IOError, OSError, ValueError, ImportError) as e:
+                self.errors.append("session {}: {}".format(session.key, e))
+
+    def _export(self, session):
+        with self.lock:
+            entry = dict(self.state[session.key])
+        start, end = entry['exported_bytes'], entry['raw_bytes']
+        if start >= end:
+            return
+        with open(os.path.join(self.raw_dir, session.key + '.bin'), 'rb') as f:
+            f.seek(start)
+            data = f.read(end - start)
+        rows = list(session.rows(data))
+        base = os.path.join(self.args.output_dir, session.key)
+        if self.args.format == 'parquet':
+            import pyarrow
+            import pyarrow.parquet
+            table = pyarrow.Table.from_arrays([pyarrow.array([row[i] for row in rows])
+                                               for i in range(len(session.columns))],
+                                              names=session.columns)
+            pyarrow.parquet.write_table(table, '{}.{}.parquet'.format(base, entry['parts'] + 1))
+            csv_bytes = None
+        else:
+            csv_bytes = self._append_csv(base + '.csv', entry.get('csv_bytes'), session, rows)
+        with self.lock:
+            entry = self.state[session.key]
+            if csv_bytes is not None:
+                entry['csv_bytes'] = csv_bytes
+            entry['exported_bytes'] = end
+            entry['items'] += len(rows)
+            entry['parts'] += 1
+            self._save_state()
+
+    def _append_csv(self, path, length, session, rows):
+        """Append rows to a CSV file that the state says is length bytes long.
+
+        Rows after that length were written by a run that stopped before saving the state, and
+        are exported again now, so they are dropped first. Returns the new length.
+        """
+        if os.path.exists(path) and length is not None:
+            with open(path, 'r+b') as f:
+                f.truncate(length)
+        with open(path, 'ab') as f:
+            if f.tell() == 0:
+                f.write((','.join(session.columns) + '\n').encode('utf-8'))
+            for row in rows:
+                f.write((','.join(str(v) for v in row) + '\n').encode('utf-8'))
+            f.flush()
+            os.fsync(f.fileno())
+            return f.tell()
+
+    def close(self):
+        self.jobs.put(None)
+        self.thread.join()
+
+
+def connect(spec):
+    kind, sep, address = spec.partition(':')
+    if kind not in ('phone', 'serial', 'qemu') or not address:
+        raise ValueError("bad target '{}', expected phone:, serial: or qemu: with an address"
+                         .format(spec))
+    from libpebble2.communication import PebbleConnection
+    if kind == 'phone':
+        from libpebble2.communication.transports.websocket import WebsocketTransport
+        transport = WebsocketTransport('ws://{}:9000/'.format(address))
+    elif kind == 'serial':
+        from libpebble2.communication.transports.serial import SerialTransport
+        transport = SerialTransport(address)
+    else:
+        from libpebble2.communication.transports.qemu import QemuTransport
+        host, _, port = address.rpartition(':')
+        transport = QemuTransport(host or 'localhost', int(port))
+    pebble = PebbleConnection(transport)
+    pebble.connect()
+    pebble.run_async()
+    return pebble
+
+
+def drain(target, args, fields, exporter, log):
+    pebble = connect(target)
+    from libpebble2.services.data_logging import DataLoggingService
+    watch = pebble.watch_info.serial
+    service = DataLoggingService(pebble)
+    send_enabled = service.get_send_enable()
+    service.set_send_enable(False)
+    try:
+        sessions = [Session(watch, info, fields) for info in service.list()]
+        sessions = [s for s in sessions
+                    if (not args.app or s.app_uuid == args.app) and
+                    (args.tag is None or s.tag == args.tag)]
+        for session in sessions:
+            _, data = service.download(session.session_id)
+            data = bytes(data or b'')
+            log("{}: session {}: {} bytes".format(target, session.key, len(data)))
+            if data:
+                exporter.received(session, data)
+    finally:
+        service.set_send_enable(send_enabled)
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument('targets', nargs='+', metavar='TARGET')
+    parser.add_argument('--output-dir', default='datalogging',
+                        help="directory the sessions are written to (default: datalogging)")
+    parser.add_argument('--format', choices=('csv', 'parquet'), default='csv')
+    parser.add_argument('--app', help="only download the sessions of the app with this UUID")
+    parser.add_argument('--tag', type=lambda s: int(s, 0), help="only download this tag")
+    parser.add_argument('--fields', action='append', default=[],
+                        help="schema of the sessions with a tag, TAG=NAME:TYPE,...")
+    args = parser.parse_args(argv)
+
+    try:
+        fields = dict(parse_fields(spec) for spec in args.fields)
+        if args.format == 'parquet':
+            import pyarrow.parquet  # noqa: F401
+        exporter = Exporter(args)
+        exporter.resume(fields)
+    except ImportError:
+        print("error: --format parquet needs pyarrow (pip install pyarrow)", file=sys.stderr)
+        return 1
+    except (IOError, OSError, ValueError) as e:
+        print("error: {}".format(e), file=sys.stderr)
+        return 1
+
+    print_lock = threading.Lock()
+
+    def log(line):
+        with print_lock:
+            print(line, file=sys.stderr)
+
+    failed = []
+
+    def run(target):
+        try:
+            drain(target, args, fields, exporter, log)
+        except ImportError:
+            failed.append("{}: needs libpebble2, run the tool with pebble-tool's Python"
+                          .format(target))
+        except Exception as e:
+            failed.append("{}: {}".format(target, e))
+
+    threads = [threading.Thread(target=run, args=(target,)) for target in args.targets]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    exporter.close()
+    for message in failed + exporter.errors:
+        print("error: {}".format(message), file=sys.stderr)
+    for key in sorted(exporter.state):
+        entry = exporter.state[key]
+        print("{}: {} items".format(key, entry['items']))
+    return 1 if failed or exporter.errors else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
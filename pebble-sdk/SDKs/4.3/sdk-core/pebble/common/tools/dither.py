@@ -0,0 +1,242 @@
+#!/usr/bin/env python
+"""
+Dither color or grayscale PNG images down to 1-bit for aplite and other black and white targets.
+
+Converting color art to GBitmapFormat1Bit by thresholding loses every midtone, so artwork for
+black and white platforms is usually dithered by hand. This tool does that conversion as a
+resource build step. It writes a 1-bit grayscale PNG that the normal bitmap conversion then
+packs as it is, so it can run as a resource_cache.py job for the black and white platforms:
+
+    {"platform": "aplite", "inputs": ["resources/images/photo.png"],
+     "output": "build/aplite/photo~bw.png",
+     "command": ["dither.py", "--method", "atkinson", "{inputs}", "{output}"]}
+
+Methods:
+    bayer4, bayer8     ordered dithering with a 4x4 or 8x8 Bayer matrix. Flat areas get a
+                       regular pattern that stays the same from frame to frame, matching what
+                       graphics_fill_rect_dithered() draws at runtime.
+    floyd-steinberg    error diffusion. Best for photos and smooth gradients.
+    atkinson           error diffusion that drops a quarter of the error, keeping highlights
+                       and shadows clean. Best for icons and line art with shading.
+    threshold          no dithering.
+
+Transparent pixels are composited over the --background color first.
+
+Usage:
+    dither.py [--method METHOD] [--background white|black] [--contrast C] INPUT OUTPUT
+"""
+
+from __future__ import print_function
+
+import argparse
+import struct
+import sys
+import zlib
+
+PNG_SIGNATURE = b'\x89PNG\r\n\x1a\n'
+
+BAYER4 = [
+    [0, 8, 2, 10],
+    [12, 4, 14, 6],
+    [3, 11, 1, 9],
+    [15, 7, 13, 5],
+]
+
+
+def bayer_matrix(size):
+    if size == 4:
+        return BAYER4
+    half = bayer_matrix(size // 2)
+    n = len(half)
+    return [[4 * half[y % n][x % n] + [0, 2, 3, 1][(y // n) * 2 + x // n]
+             for x in range(size)] for y in range(size)]
+
+
+def read_chunks(data):
+    if data[:8] != PNG_SIGNATURE:
+        raise ValueError("not a PNG file")
+    pos = 8
+    while pos + 8 <= len(data):
+        length, kind = struct.unpack('>I4s', data[pos:pos + 8])
+        yield kind, data[pos + 8:pos + 8 + length]
+        pos += 12 + length
+
+
+def unfilter(raw, height, stride, bpp):
+    rows = []
+    prev = bytearray(stride)
+    pos = 0
+    for _ in range(height):
+        kind = raw[pos]
+        row = bytearray(raw[pos + 1:pos + 1 + stride])
+        pos += 1 + stride
+        for i in range(stride):
+            a = row[i - bpp] if i >= bpp else 0
+            b = prev[i]
+            c = prev[i - bpp] if i >= bpp else 0
+            if kind == 1:
+                row[i] = (row[i] + a) & 0xff
+            elif kind == 2:
+                row[i] = (row[i] + b) & 0xff
+            elif kind == 3:
+                row[i] = (row[i] + (a + b) // 2) & 0xff
+            elif kind == 4:
+                p = a + b - c
+                pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+                pred = a if pa <= pb and pa <= pc else b if pb <= pc else c
+                row[i] = (row[i] + pred) & 0xff
+        rows.append(row)
+        prev = row
+    return rows
+
+
+def read_png(path):
+    """Return (width, height, rows of (r, g, b, a) tuples)."""
+    with open(path, 'rb') as f:
+        data = f.read()
+    idat = b''
+    palette = []
+    alphas = b''
+    for kind, body in read_chunks(data):
+        if kind == b'IHDR':
+            width, height, depth, color_type, _, _, interlace = struct.unpack('>IIBBBBB', body)
+        elif kind == b'PLTE':
+            palette = [tuple(bytearray(body[i:i + 3])) for i in range(0, len(body), 3)]
+        elif kind == b'tRNS':
+            alphas = bytearray(body)
+        elif kind == b'IDAT':
+            idat += body
+    if interlace:
+        raise ValueError("interlaced PNGs are not supported")
+    channels = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}[color_type]
+    if depth == 16:
+        raise ValueError("16-bit PNGs are not supported")
+    stride = (width * channels * depth + 7) // 8
+    rows = unfilter(bytearray(zlib.decompress(idat)), height, stride,
+                    max(1, channels * depth // 8))
+    pixels = []
+    for row in rows:
+        if depth < 8:
+            per_byte = 8 // depth
+            mask = (1 << depth) - 1
+            values = [row[x // per_byte] >> (8 - depth * (x % per_byte + 1)) & mask
+                      for x in range(width)]
+        else:
+            values = list(row)
+        out = []
+        for x in range(width):
+            if color_type == 3:
+                i = values[x]
+                out.append(palette[i] + (alphas[i] if i < len(alphas) else 255,))
+            elif color_type in (0, 4):
+                v = values[x * channels] * 255 // ((1 << depth) - 1)
+                out.append((v, v, v, values[x * 2 + 1] if color_type == 4 else 255))
+            else:
+                p = values[x * channels:x * channels + channels]
+                out.append((p[0], p[1], p[2], p[3] if color_type == 6 else 255))
+        pixels.append(out)
+    return width, height, pixels
+
+
+def write_1bit_png(path, width, height, bits):
+    raw = bytearray()
+    for y in range(height):
+        raw.append(0)
+        row = bytearray((width + 7) // 8)
+        for x in range(width):
+            if bits[y][x]:
+                row[x // 8] |= 0x80 >> (x % 8)
+        raw += row
+
+    def chunk(kind, body):
+        return (struct.pack('>I', len(body)) + kind + body +
+                struct.pack('>I', zlib.crc32(kind + body) & 0xffffffff))
+
+    with open(path, 'wb') as f:
+        f.write(PNG_SIGNATURE)
+        f.write(chunk(b'IHDR', struct.pack('>IIBBBBB', width, height, 1, 0, 0, 0, 0)))
+        f.write(chunk(b'IDAT', zlib.compress(bytes(raw), 9)))
+        f.write(chunk(b'IEND', b''))
+
+
+def luminance(pixels, background, contrast):
+    """Return rows of gray levels from 0.0 (black) to 1.0 (white)."""
+    gray = []
+    for row in pixels:
+        out = []
+        for r, g, b, a in row:
+            v = (0.299 * r + 0.587 * g + 0.114 * b) / 255.0
+            v = (v * a + background * (255 - a)) / 255.0
+            out.append(min(1.0, max(0.0, (v - 0.5) * contrast + 0.5)))
+        gray.append(out)
+    return gray
+
+
+def dither_ordered(gray, size):
+    matrix = bayer_matrix(size)
+    levels = float(size * size)
+    return [[v > (matrix[y % size][x % size] + 0.5) / levels for x, v in enumerate(row)]
+            for y, row in enumerate(gray)]
+
+
+# (dx, dy, weight) of the neighbours the error of a pixel is spread to.
+DIFFUSION = {
+    'floyd-steinberg': [(1, 0, 7 / 16.0), (-1, 1, 3 / 16.0), (0, 1, 5 / 16.0),
+                        (1, 1, 1 / 16.0)],
+    'atkinson': [(1, 0, 1 / 8.0), (2, 0, 1 / 8.0), (-1, 1, 1 / 8.0), (0, 1, 1 / 8.0),
+                 (1, 1, 1 / 8.0), (0, 2, 1 / 8.0)],
+}
+
+
+def dither_diffusion(gray, weights):
+    height = len(gray)
+    width = len(gray[0]) if height else 0
+    work = [list(row) for row in gray]
+    bits = []
+    for y in range(height):
+        row = []
+        for x in range(width):
+            v = work[y][x]
+            on = v >= 0.5
+            row.append(on)
+            error = v - (1.0 if on else 0.0)
+            for dx, dy, w in weights:
+                nx, ny = x + dx, y + dy
+                if 0 <= nx < width and ny < height:
+                    work[ny][nx] += error * w
+        bits.append(row)
+    return bits
+
+
+def dither(gray, method):
+    if method == 'threshold':
+        return [[v >= 0.5 for v in row] for row in gray]
+    if method.startswith('bayer'):
+        return dither_ordered(gray, int(method[5:]))
+    return dither_diffusion(gray, DIFFUSION[method])
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument('input')
+    parser.add_argument('output')
+    parser.add_argument('--method', default='floyd-steinberg',
+                        choices=['bayer4', 'bayer8', 'floyd-steinberg', 'atkinson', 'threshold'])
+    parser.add_argument('--background', default='white', choices=['white', 'black'],
+                        help="color that transparent pixels are composited over")
+    parser.add_argument('--contrast', type=float, default=1.0,
+                        help="scale contrast around middle gray before dithering")
+    args = parser.parse_args(argv)
+
+    try:
+        width, height, pixels = read_png(args.input)
+    except (IOError, ValueError, KeyError, zlib.error) as e:
+        print("error: {}: {}".format(args.input, e), file=sys.stderr)
+        return 1
+    gray = luminance(pixels, 1.0 if args.background == 'white' else 0.0, args.contrast)
+    write_1bit_png(args.output, width, height, dither(gray, args.method))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,219 @@
+#!/usr/bin/env python
+"""
+Estimate the CPU cost on watch hardware of frames and event handlers measured in the emulator.
+
+The emulator runs apps at the speed of the computer hosting it, so the times that the frame
+profiler and PROFILE_SCOPE report there say little about how an app performs on a watch. This
+tool scales them by a per-platform calibration factor, measured by running the SDK benchmark
+app (common/benchmarks, see run_benchmarks.py) both on a watch and in the emulator on the same
+machine that runs the app under test.
+
+Usage:
+    emu_cycles.py calibrate PLATFORM HARDWARE.json EMULATOR.json [-c CALIBRATION.json]
+    emu_cycles.py report PLATFORM [LOG] [-c CALIBRATION.json] [--json] [--max-frame-us US]
+
+calibrate compares two run_benchmarks.py results for PLATFORM and stores the median ratio of
+their per-iteration times in the calibration file, next to those of other platforms. The
+results of each file are taken from its only entry or from the one named after PLATFORM.
+
+report reads `pebble logs --emulator PLATFORM` output from LOG, or from stdin, of an app that
+enables the frame profiler (profiler_set_enabled() and profiler_set_log_interval()) or prints
+PROFILE_SCOPE statistics with profiler_print_stats(). It prints the estimated hardware time and
+cycles per frame and per profiled section. With --max-frame-us, the exit status is nonzero if
+the estimated render time of any frame exceeds the limit, so performance can be checked in CI
+without a watch.
+"""
+
+from __future__ import print_function
+
+import argparse
+import json
+import os
+import re
+import sys
+
+DEFAULT_CALIBRATION = 'emu_calibration.json'
+
+FRAME_LINE = re.compile(r'\bframe (\d+): render (\d+)us display (\d+)us wait (\d+)us '
+                        r'handler (\d+)us(?: layers (.*))?$')
+LAYER_ENTRY = re.compile(r'(0x[0-9a-fA-F]+)=(\d+)us')
+PROFILE_LINE = re.compile(r'\bprofile (.+): count (\d+) min (\d+) avg (\d+) max (\d+)\s*$')
+
+
+def cycles_per_second(result):
+    return result['cycles'] * 1e6 / (result['us_per_iteration'] * result['iterations'])
+
+
+def platform_results(path, platform):
+    with open(path) as f:
+        report = json.load(f)
+    for key in (platform, 'emulator:' + platform):
+        if key in report:
+            return report[key]
+    if len(report) == 1:
+        return list(report.values())[0]
+    raise ValueError("{} has no results for {}".format(path, platform))
+
+
+def median(values):
+    values = sorted(values)
+    mid = len(values) // 2
+    return values[mid] if len(values) % 2 else (values[mid - 1] + values[mid]) / 2.0
+
+
+def calibrate(platform, hardware_path, emulator_path):
+    hardware = platform_results(hardware_path, platform)
+    emulator = platform_results(emulator_path, platform)
+    # Round trips depend on the phone connection rather than the CPU, so leave them out.
+    names = [n for n in sorted(set(hardware) & set(emulator))
+             if not n.startswith('app_message') and hardware[n].get('us_per_iteration')
+             and emulator[n].get('us_per_iteration')]
+    if not names:
+        raise ValueError("no benchmarks in common for {}".format(platform))
+    ratios = [hardware[n]['us_per_iteration'] / emulator[n]['us_per_iteration'] for n in names]
+    return {
+        'factor': round(median(ratios), 4),
+        'cycles_per_second': int(cycles_per_second(hardware[names[0]])),
+        'emulator_cycles_per_second': int(cycles_per_second(emulator[names[0]])),
+        'benchmarks': names,
+    }
+
+
+def percentile(values, fraction):
+    values = sorted(values)
+    return values[min(len(values) - 1, int(len(values) * fraction))]
+
+
+class Estimator(object):
+    def __init__(self, calibration):
+        self.factor = calibration['factor']
+        self.cps = calibration['cycles_per_second']
+        self.emulator_cps = calibration['emulator_cycles_per_second']
+
+    def us(self, emulator_us):
+        return int(emulator_us * self.factor)
+
+    def cycles(self, emulator_us):
+        return int(emulator_us * self.factor * self.cps / 1e6)
+
+    def scope_cycles(self, emulator_cycles):
+        return int(emulator_cycles * self.factor * self.cps / self.emulator_cps)
+
+
+def parse_log(lines, estimator):
+    frames = []
+    scopes = {}
+    for line in lines:
+        m = FRAME_LINE.search(line.rstrip('\n'))
+        if m:
+            # The display latency depends on the emulated display, not the CPU, so it is dropped.
+            frame, render, _, wait, handler = (int(g) for g in m.groups()[:5])
+            frames.append({
+                'frame': frame,
+                'render_us': estimator.us(render),
+                'render_cycles': estimator.cycles(render),
+                'wait_us': estimator.us(wait),
+                'handler_us': estimator.us(handler),
+                'handler_cycles': estimator.cycles(handler),
+                'layers': dict((addr, estimator.cycles(int(us)))
+                               for addr, us in LAYER_ENTRY.findall(m.group(6) or '')),
+            })
+            continue
+        m = PROFILE_LINE.search(line)
+        if m:
+            count, low, avg, high = (int(g) for g in m.groups()[1:])
+            # Later lines hold the totals up to that point and replace earlier ones.
+            scopes[m.group(1)] = {
+                'count': count,
+                'min_cycles': estimator.scope_cycles(low),
+                'avg_cycles': estimator.scope_cycles(avg),
+                'max_cycles': estimator.scope_cycles(high),
+            }
+    return frames, scopes
+
+
+def summarize(frames):
+    if not frames:
+        return {}
+    summary = {'frames': len(frames)}
+    for key in ('render_us', 'render_cycles', 'handler_us', 'handler_cycles'):
+        values = [f[key] for f in frames]
+        summary[key] = {'avg': sum(values) // len(values), 'p95': percentile(values, 0.95),
+                        'max': max(values)}
+    return summary
+
+
+def load_calibration(path):
+    if not os.path.exists(path):
+        return {}
+    with open(path) as f:
+        return json.load(f)
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    sub = parser.add_subparsers(dest='command')
+    p = sub.add_parser('calibrate', help="measure a platform's emulator to hardware factor")
+    p.add_argument('platform')
+    p.add_argument('hardware', help="run_benchmarks.py results from a watch")
+    p.add_argument('emulator', help="run_benchmarks.py results from the emulator")
+    p.add_argument('-c', '--calibration', default=DEFAULT_CALIBRATION)
+    p = sub.add_parser('report', help="estimate hardware cost from emulator logs")
+    p.add_argument('platform')
+    p.add_argument('log', nargs='?', help="pebble logs output (default: stdin)")
+    p.add_argument('-c', '--calibration', default=DEFAULT_CALIBRATION)
+    p.add_argument('--json', action='store_true', help="write the estimates as JSON")
+    p.add_argument('--max-frame-us', type=int,
+                   help="fail if a frame's estimated render time exceeds this")
+    args = parser.parse_args(argv)
+
+    try:
+        calibration = load_calibration(args.calibration)
+        if args.command == 'calibrate':
+            calibration[args.platform] = calibrate(args.platform, args.hardware, args.emulator)
+            with open(args.calibration, 'w') as f:
+                json.dump(calibration, f, indent=2, sort_keys=True, separators=(',', ': '))
+                f.write('\n')
+            print("{}: hardware takes {} times as long as the emulator"
+                  .format(args.platform, calibration[args.platform]['factor']))
+            return 0
+        if args.command != 'report':
+            parser.print_usage()
+            return 2
+        if args.platform not in calibration:
+            raise ValueError("{} has no calibration for {}; run calibrate first"
+                             .format(args.calibration, args.platform))
+        estimator = Estimator(calibration[args.platform])
+    except ValueError as e:
+        print("error: {}".format(e), file=sys.stderr)
+        return 1
+
+    stream = open(args.log) if args.log else sys.stdin
+    frames, scopes = parse_log(stream, estimator)
+    summary = summarize(frames)
+    if args.json:
+        print(json.dumps({'platform': args.platform, 'summary': summary, 'frames': frames,
+                          'scopes': scopes}, indent=2, sort_keys=True, separators=(',', ': ')))
+    else:
+        for frame in frames:
+            print("frame {frame:>6}: render {render_us:>7}us {render_cycles:>10} cycles  "
+                  "handler {handler_us:>7}us {handler_cycles:>10} cycles".format(**frame))
+        for name, scope in sorted(scopes.items()):
+            print("{}: count {count} min {min_cycles} avg {avg_cycles} max {max_cycles} cycles"
+                  .format(name, **scope))
+        if summary:
+            render = summary['render_us']
+            print("{} frames, estimated render time avg {}us p95 {}us max {}us"
+                  .format(summary['frames'], render['avg'], render['p95'], render['max']))
+
+    if args.max_frame_us is not None:
+        slow = [f['frame'] for f in frames if f['render_us'] > args.max_frame_us]
+        if slow:
+            print("{} frame(s) over {}us, first frame {}".format(len(slow), args.max_frame_us,
+                                                                slow[0]), file=sys.stderr)
+            return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
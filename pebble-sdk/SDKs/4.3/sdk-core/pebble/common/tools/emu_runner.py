@@ -0,0 +1,294 @@
+#!/usr/bin/env python
+"""
+Run an app on many headless emulators in parallel, drive it with a script and check the results.
+
+For each platform, and --instances times per platform, this starts an emulator without a
+window (`pebble install --emulator PLATFORM --vnc`), installs the app built in the current
+project, collects the app's logs and runs the steps of the script against it. All instances run
+at the same time. Each instance gets a temporary directory of its own, where the pebble tool
+keeps track of its running emulators, so instances of the same platform run in separate
+emulators; they do share the emulator's stored watch state, such as persistent storage.
+
+The script is a text file with one step per line, and # comments:
+    wait SECONDS                    do nothing for a while
+    click BUTTON [COUNT]            press and release back, up, select or down
+    hold BUTTON MILLISECONDS        press a button for a while
+    tap [x+|x-|y+|y-|z+|z-]         send an accelerometer tap
+    expect REGEX [SECONDS]          wait until a log line matches, 10 seconds at most by default
+    screenshot NAME                 save the screen as OUTPUT/<instance>/NAME.png
+
+Usage:
+    emu_runner.py SCRIPT [PLATFORM...] [--instances N] [--output-dir DIR] [--timeout SECONDS]
+                  [--fail-on REGEX] [--sdk VERSION] [--json]
+
+Without platforms, every platform in the project's package.json is run. The logs of each
+instance are saved as DIR/<platform>-<n>/app.log. An instance fails when a step fails, when a
+log line matches --fail-on ("App fault" by default), or when the whole run takes longer than
+--timeout. If the app calls profiler_set_log_interval(), its frame timings are summarized in
+the report; emu_cycles.py converts them to the equivalent on watch hardware. The exit status is
+nonzero if any instance failed.
+
+An expect step searches the log lines from the line after the one the previous expect step
+matched, so it also finds lines logged while earlier steps ran.
+"""
+
+from __future__ import print_function
+
+import argparse
+import json
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+
+from emu_cycles import FRAME_LINE, percentile
+
+BUTTONS = ('back', 'up', 'select', 'down')
+TAP_DIRECTIONS = ('x+', 'x-', 'y+', 'y-', 'z+', 'z-')
+INSTALL_DONE = re.compile(r'App install succeeded')
+INSTALL_FAILED = re.compile(r'App install failed|Failed to install|Error:')
+
+
+def parse_script(path):
+    """Return the steps of a script as (line number, command, arguments)."""
+    steps = []
+    with open(path) as f:
+        for number, line in enumerate(f, 1):
+            words = line.split('#', 1)[0].split()
+            if not words:
+                continue
+            command, params = words[0], words[1:]
+            try:
+                if command == 'wait' and len(params) == 1:
+                    params = [float(params[0])]
+                elif command == 'click' and 1 <= len(params) <= 2 and params[0] in BUTTONS:
+                    params = [params[0], int(params[1]) if len(params) == 2 else 1]
+                elif command == 'hold' and len(params) == 2 and params[0] in BUTTONS:
+                    params = [params[0], int(params[1])]
+                elif command == 'tap' and len(params) <= 1 and set(params) <= set(TAP_DIRECTIONS):
+                    pass
+                elif command == 'expect' and 1 <= len(params) <= 2:
+                    params = [re.compile(params[0]), float(params[1]) if len(params) == 2 else 10]
+                elif command == 'screenshot' and len(params) == 1:
+                    pass
+                else:
+                    raise ValueError
+            except (ValueError, re.error):
+                raise ValueError("{}:{}: bad step '{}'".format(path, number, line.strip()))
+            steps.append((number, command, params))
+    return steps
+
+
+def frame_summary(lines):
+    frames = [tuple(int(g) for g in m.groups()[1:5])
+              for m in (FRAME_LINE.search(line) for line in lines) if m]
+    if not frames:
+        return None
+    summary = {'frames_logged': len(frames)}
+    for i, key in enumerate(('render_us', 'display_us', 'wait_us', 'handler_us')):
+        values = [f[i] for f in frames]
+        summary[key] = {'avg': sum(values) // len(values), 'p95': percentile(values, 0.95),
+                        'max': max(values)}
+    return summary
+
+
+class Instance(object):
+    def __init__(self, args, platform, number):
+        self.args = args
+        self.platform = platform
+        self.label = '{}-{}'.format(platform, number)
+        self.output_dir = os.path.join(args.output_dir, self.label)
+        self.tmp_dir = tempfile.mkdtemp(prefix='emu_runner-')
+        self.env = dict(os.environ, TMPDIR=self.tmp_dir, TEMP=self.tmp_dir, TMP=self.tmp_dir)
+        self.lines = []
+        self.cond = threading.Condition()
+        self.installed = False
+        # Lines before this index were already searched by an expect step.
+        self.cursor = 0
+        self.error = None
+        self.process = None
+
+    def pebble(self, *params):
+        cmd = [self.args.pebble] + list(params) + ['--emulator', self.platform]
+        if self.args.sdk:
+            cmd += ['--sdk', self.args.sdk]
+        return cmd
+
+    def fail(self, message):
+        with self.cond:
+            if self.error is None:
+                self.error = message
+            self.cond.notify_all()
+
+    def _pump(self, log):
+        for line in iter(self.process.stdout.readline, ''):
+            log.write(line)
+            log.flush()
+            line = line.rstrip('\n')
+            with self.cond:
+                self.lines.append(line)
+                if not self.installed and INSTALL_DONE.search(line):
+                    self.installed = True
+                elif not self.installed and INSTALL_FAILED.search(line):
+                    self.fail("install failed: {}".format(line))
+                elif self.installed and self.args.fail_on.search(line):
+                    self.fail("log line matched --fail-on: {}".format(line))
+                self.cond.notify_all()
+        self.process.wait()
+        self.fail("the pebble tool exited with status {}".format(self.process.returncode))
+
+    def _wait_for(self, predicate, deadline):
+        with self.cond:
+            while not predicate() and self.error is None:
+                remaining = deadline - time.time()
+                if remaining <= 0:
+                    return False
+                self.cond.wait(min(remaining, 1))
+            return self.error is None
+
+    def _call(self, *params):
+        with open(os.devnull, 'w') as devnull:
+            status = subprocess.call(self.pebble(*params), env=self.env, stdout=devnull,
+                                     stderr=subprocess.STDOUT)
+        if status != 0:
+            raise RuntimeError("pebble {} failed".format(' '.join(params)))
+
+    def _run_step(self, command, params, deadline):
+        if command == 'wait':
+            self._wait_for(lambda: False, min(deadline, time.time() + params[0]))
+        elif command == 'click':
+            self._call('emu-button', 'click', params[0], '--repeat', str(params[1]))
+        elif command == 'hold':
+            self._call('emu-button', 'click', params[0], '--duration', str(params[1]))
+        elif command == 'tap':
+            self._call('emu-tap', *(['--direction', params[0]] if params else []))
+        elif command == 'expect':
+            pattern = params[0]
+
+            def matched():
+                for i in range(self.cursor, len(self.lines)):
+                    if pattern.search(self.lines[i]):
+                        self.cursor = i + 1
+                        return True
+                self.cursor = len(self.lines)
+                return False
+
+            if not self._wait_for(matched, min(deadline, time.time() + params[1])):
+                raise RuntimeError("no log line matched '{}' within {}s"
+                                   .format(pattern.pattern, params[1]))
+        elif command == 'screenshot':
+            self._call('screenshot', '--no-open',
+                       os.path.join(self.output_dir, params[0] + '.png'))
+
+    def run(self, steps):
+        deadline = time.time() + self.args.timeout
+        if not os.path.isdir(self.output_dir):
+            os.makedirs(self.output_dir)
+        log = open(os.path.join(self.output_dir, 'app.log'), 'w')
+        try:
+            self.process = subprocess.Popen(self.pebble('install', '--vnc', '--logs'),
+                                            cwd=self.args.project, env=self.env,
+                                            stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                                            universal_newlines=True)
+            pump = threading.Thread(target=self._pump, args=(log,))
+            pump.daemon = True
+            pump.start()
+        except OSError as e:
+            self.fail("cannot run {}: {}".format(self.args.pebble, e))
+        try:
+            if not self._wait_for(lambda: self.installed, deadline):
+                self.fail(self.error or "app was not installed within {}s"
+                          .format(self.args.timeout))
+            for number, command, params in steps:
+                if self.error is not None:
+                    break
+                try:
+                    self._run_step(command, params, deadline)
+                except RuntimeError as e:
+                    self.fail("step on line {}: {}".format(number, e))
+                if self.error is None and time.time() > deadline:
+                    self.fail("did not finish within {}s".format(self.args.timeout))
+        finally:
+            passed = self.error is None
+            if self.process and self.process.poll() is None:
+                self.process.terminate()
+                self.process.wait()
+            try:
+                self._call('kill')
+            except (OSError, RuntimeError):
+                pass
+            log.close()
+            shutil.rmtree(self.tmp_dir, ignore_errors=True)
+        return passed
+
+    def report(self, passed):
+        result = {'platform': self.platform, 'passed': passed, 'log_lines': len(self.lines)}
+        if not passed:
+            result['error'] = self.error
+        frames = frame_summary(self.lines)
+        if frames:
+            result['frames'] = frames
+        return result
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument('script', help="the steps to run on every instance")
+    parser.add_argument('platforms', nargs='*', metavar='PLATFORM')
+    parser.add_argument('--instances', type=int, default=1,
+                        help="emulators to run per platform (default: 1)")
+    parser.add_argument('--project', default='.', help="the app project (default: .)")
+    parser.add_argument('--output-dir', default='emu_runner',
+                        help="where logs and screenshots are written (default: emu_runner)")
+    parser.add_argument('--timeout', type=float, default=300,
+                        help="seconds each instance may take in total (default: 300)")
+    parser.add_argument('--fail-on', type=re.compile, default=re.compile(r'\bApp fault\b'),
+                        help="fail instances that log a line matching this")
+    parser.add_argument('--pebble', default='pebble', help="the pebble tool to run")
+    parser.add_argument('--sdk', help="run with this installed SDK")
+    parser.add_argument('--json', action='store_true', help="write the report as JSON")
+    args = parser.parse_args(argv)
+
+    try:
+        steps = parse_script(args.script)
+        platforms = args.platforms
+        if not platforms:
+            with open(os.path.join(args.project, 'package.json')) as f:
+                platforms = json.load(f)['pebble']['targetPlatforms']
+    except (IOError, ValueError, KeyError) as e:
+        print("error: {}".format(e), file=sys.stderr)
+        return 1
+
+    instances = [Instance(args, platform, n + 1)
+                 for platform in platforms for n in range(args.instances)]
+    results = {}
+
+    def run(instance):
+        results[instance.label] = instance.report(instance.run(steps))
+
+    threads = [threading.Thread(target=run, args=(instance,)) for instance in instances]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+
+    if args.json:
+        print(json.dumps(results, indent=2, sort_keys=True, separators=(',', ': ')))
+    else:
+        for label in sorted(results):
+            result = results[label]
+            line = "{}: {}".format(label, "passed" if result['passed'] else
+                                   "FAILED, " + result['error'])
+            if 'frames' in result:
+                line += ", render avg {}us max {}us".format(result['frames']['render_us']['avg'],
+                                                           result['frames']['render_us']['max'])
+            print(line)
+    return 0 if all(result['passed'] for result in results.values()) else 1
+
+
+if __name__ == '__main__':
+    sys.exit(main())
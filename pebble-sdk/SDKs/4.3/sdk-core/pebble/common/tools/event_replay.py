@@ -0,0 +1,301 @@
+#!/usr/bin/env python
+"""
+Record the events an app receives with profiler_event_record_start() and replay them later.
+
+Performance problems often only show up with a particular sequence of clicks, messages and
+sensor data. An app that calls profiler_event_record_start() sends each event its event loop
+delivers to the developer connection; this tool saves them to a recording, shows what a
+recording holds and feeds a recording back to the app in an emulator with the original timing,
+so that the same session can be profiled again and again.
+
+A recording is the sequence of records the watch sends, all fields little endian:
+
+    uint32_t time_ms    time the event was delivered, in ms since recording started
+    uint8_t  kind       1 button, 2 tick, 3 AppMessage, 4 accelerometer data, 5 tap
+    uint8_t  reserved
+    uint16_t size       size of the data that follows
+    uint8_t  data[size]
+
+The data of each kind is:
+
+    button      uint8_t button (ButtonId), uint8_t pressed (1) or released (0)
+    tick        uint32_t time (UTC seconds), uint8_t units_changed (TimeUnits)
+    AppMessage  the received dictionary: uint8_t count, then for each tuple uint32_t key,
+                uint8_t type (TupleType), uint16_t length and the value
+    accel data  int16_t x, y and z of each sample of the batch, in mG
+    tap         uint8_t axis (AccelAxisType), int8_t direction
+
+Usage:
+    event_replay.py record TARGET OUTPUT
+    event_replay.py show RECORDING
+    event_replay.py replay RECORDING qemu:HOST:PORT [--speed FACTOR] [--app UUID]
+
+record connects to TARGET, given as phone:ADDRESS, serial:DEVICE or qemu:HOST:PORT as for
+datalog_download.py, and appends the records it receives to OUTPUT until Ctrl-C.
+
+replay needs the app to be running in the emulator already, for example after `pebble install
+--emulator basalt`. Buttons, taps and accelerometer samples are injected into the emulator the
+way `pebble emu-button`, `emu-tap` and `emu-accel` do, and AppMessages are sent to the app as
+if from the phone; their UUID is the app's, from --app or the package.json in the current
+directory. Ticks cannot be injected, as the emulator's clock produces them: they are counted,
+and set the timing of the events around them. --speed 2 replays twice as fast. At the end the
+latest any event was injected compared to its recorded time is reported, which should stay well
+below the intervals that matter to the profile.
+"""
+
+from __future__ import print_function
+
+import argparse
+import json
+import struct
+import sys
+import time
+import uuid
+
+from datalog_download import connect
+
+RECORD = struct.Struct('<IBBH')
+KIND_BUTTON = 1
+KIND_TICK = 2
+KIND_APP_MESSAGE = 3
+KIND_ACCEL = 4
+KIND_TAP = 5
+KIND_NAMES = {KIND_BUTTON: 'button', KIND_TICK: 'tick', KIND_APP_MESSAGE: 'appmessage',
+              KIND_ACCEL: 'accel', KIND_TAP: 'tap'}
+
+# The developer connection endpoint the watch sends event records on.
+EVENT_RECORD_ENDPOINT = 0x2711
+
+BUTTONS = ('back', 'up', 'select', 'down')
+AXES = ('x', 'y', 'z')
+TUPLE_BYTE_ARRAY = 0
+TUPLE_CSTRING = 1
+TUPLE_UINT = 2
+TUPLE_INT = 3
+# Samples in one QEMU accelerometer packet.
+MAX_ACCEL_SAMPLES = 255
+
+
+def records(data):
+    """Yield (time_ms, kind, data) for each complete record of a recording."""
+    pos = 0
+    while pos + RECORD.size <= len(data):
+        time_ms, kind, _, size = RECORD.unpack_from(data, pos)
+        body = data[pos + RECORD.size:pos + RECORD.size + size]
+        if len(body) < size:
+            return
+        yield time_ms, kind, body
+        pos += RECORD.size + size
+
+
+def dictionary(data):
+    """Return the tuples of a serialized dictionary as [(key, type, value bytes)]."""
+    count = struct.unpack_from('<B', data)[0]
+    pos = 1
+    tuples = []
+    for _ in range(count):
+        key, kind, length = struct.unpack_from('<IBH', data, pos)
+        pos += 7
+        tuples.append((key, kind, data[pos:pos + length]))
+        pos += length
+    return tuples
+
+
+def tuple_value(kind, value):
+    if kind in (TUPLE_UINT, TUPLE_INT) and len(value) in (1, 2, 4):
+        fmt = {1: 'b', 2: 'h', 4: 'i'}[len(value)]
+        return struct.unpack('<' + (fmt.upper() if kind == TUPLE_UINT else fmt), value)[0]
+    if kind == TUPLE_CSTRING:
+        return value.split(b'\0', 1)[0].decode('utf-8', 'replace')
+    return value
+
+
+def accel_samples(data):
+    return [struct.unpack_from('<hhh', data, i) for i in range(0, len(data) - 5, 6)]
+
+
+def describe(kind, data):
+    if kind == KIND_BUTTON:
+        button, pressed = struct.unpack_from('<BB', data)
+        return "{} {}".format(BUTTONS[button] if button < len(BUTTONS) else button,
+                              'pressed' if pressed else 'released')
+    if kind == KIND_TICK:
+        utc, units = struct.unpack_from('<IB', data)
+        return "{} units 0x{:02x}".format(utc, units)
+    if kind == KIND_APP_MESSAGE:
+        return ' '.join('{}={!r}'.format(key, tuple_value(tuple_kind, value))
+                        for key, tuple_kind, value in dictionary(data))
+    if kind == KIND_ACCEL:
+        samples = accel_samples(data)
+        return "{} samples, first {}".format(len(samples), samples[0] if samples else None)
+    if kind == KIND_TAP:
+        axis, direction = struct.unpack_from('<Bb', data)
+        return "{}{}".format(AXES[axis] if axis < len(AXES) else axis,
+                             '+' if direction > 0 else '-')
+    return "{} bytes".format(len(data))
+
+
+def record(target, output):
+    pebble = connect(target)
+    header = struct.Struct('>HH')
+    count = [0]
+    with open(output, 'ab') as f:
+        def received(message):
+            length, endpoint = header.unpack_from(message)
+            if endpoint == EVENT_RECORD_ENDPOINT:
+                f.write(message[header.size:header.size + length])
+                f.flush()
+                count[0] += 1
+
+        pebble.register_raw_inbound_handler(received)
+        print("recording to {}, Ctrl-C to stop".format(output), file=sys.stderr)
+        try:
+            while pebble.connected:
+                time.sleep(0.5)
+        except KeyboardInterrupt:
+            pass
+    print("{} events recorded".format(count[0]), file=sys.stderr)
+
+
+class Replayer(object):
+    def __init__(self, target, app_uuid):
+        if target.partition(':')[0] != 'qemu':
+            raise ValueError("events can only be replayed into an emulator, not '{}'"
+                             .format(target))
+        self.pebble = connect(target)
+        self.app_uuid = app_uuid
+        self.buttons = 0
+        self.appmessage = None
+
+    def _send_qemu(self, packet):
+        from libpebble2.communication.transports.qemu import MessageTargetQemu
+        self.pebble.transport.send_packet(packet, target=MessageTargetQemu())
+
+    def _send_message(self, data):
+        from libpebble2.services import appmessage
+        if self.appmessage is None:
+            self.appmessage = appmessage.AppMessageService(self.pebble)
+        types = {(TUPLE_UINT, 1): appmessage.Uint8, (TUPLE_UINT, 2): appmessage.Uint16,
+                 (TUPLE_UINT, 4): appmessage.Uint32, (TUPLE_INT, 1): appmessage.Int8,
+                 (TUPLE_INT, 2): appmessage.Int16, (TUPLE_INT, 4): appmessage.Int32}
+        message = {}
+        for key, kind, value in dictionary(data):
+            if (kind, len(value)) in types:
+                message[key] = types[kind, len(value)](tuple_value(kind, value))
+            elif kind == TUPLE_CSTRING:
+                message[key] = appmessage.CString(tuple_value(kind, value))
+            else:
+                message[key] = appmessage.ByteArray(bytes(value))
+        self.appmessage.send_message(self.app_uuid, message)
+
+    def inject(self, kind, data):
+        """Send an event to the emulator; return False for events that cannot be injected."""
+        from libpebble2.communication.transports.qemu import protocol
+        if kind == KIND_BUTTON:
+            button, pressed = struct.unpack_from('<BB', data)
+            if pressed:
+                self.buttons |= 1 << button
+            else:
+                self.buttons &= ~(1 << button)
+            self._send_qemu(protocol.QemuButton(state=self.buttons))
+        elif kind == KIND_TAP:
+            axis, direction = struct.unpack_from('<Bb', data)
+            self._send_qemu(protocol.QemuTap(axis=axis, direction=direction))
+        elif kind == KIND_ACCEL:
+            samples = accel_samples(data)
+            for i in range(0, len(samples), MAX_ACCEL_SAMPLES):
+                self._send_qemu(protocol.QemuAccel(samples=[
+                    protocol.QemuAccelSample(x=x, y=y, z=z)
+                    for x, y, z in samples[i:i + MAX_ACCEL_SAMPLES]]))
+        elif kind == KIND_APP_MESSAGE:
+            self._send_message(data)
+        else:
+            return False
+        return True
+
+
+def replay(events, target, app_uuid, speed):
+    """Inject events with their original timing.
+
+    Returns the events injected per kind, the number of events that were not, such as ticks,
+    and the latest an event was injected, in ms.
+    """
+    replayer = Replayer(target, app_uuid)
+    counts = {}
+    skipped = 0
+    late_ms = 0
+    start = time.time()
+    for time_ms, kind, data in events:
+        due = start + time_ms / 1000.0 / speed
+        now = time.time()
+        if due > now:
+            time.sleep(due - now)
+        else:
+            late_ms = max(late_ms, int((now - due) * 1000))
+        if replayer.inject(kind, data):
+            counts[KIND_NAMES[kind]] = counts.get(KIND_NAMES[kind], 0) + 1
+        else:
+            skipped += 1
+    return counts, skipped, late_ms
+
+
+def app_uuid_from_package():
+    with open('package.json') as f:
+        return json.load(f)['pebble']['uuid']
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    sub = parser.add_subparsers(dest='command')
+    p = sub.add_parser('record', help="save the events an app sends to a file")
+    p.add_argument('target', help="phone:ADDRESS, serial:DEVICE or qemu:HOST:PORT")
+    p.add_argument('output', help="the recording to append to")
+    p = sub.add_parser('show', help="list the events of a recording")
+    p.add_argument('recording')
+    p = sub.add_parser('replay', help="feed a recording to the app in an emulator")
+    p.add_argument('recording')
+    p.add_argument('target', help="the emulator, as qemu:HOST:PORT")
+    p.add_argument('--speed', type=float, default=1.0,
+                   help="replay this many times faster than recorded (default: 1)")
+    p.add_argument('--app', help="UUID of the app (default: from package.json)")
+    args = parser.parse_args(argv)
+
+    if args.command == 'record':
+        try:
+            record(args.target, args.output)
+        except (IOError, OSError, ValueError) as e:
+            print("error: {}".format(e), file=sys.stderr)
+            return 1
+        return 0
+    if args.command not in ('show', 'replay'):
+        parser.print_usage()
+        return 2
+    try:
+        with open(args.recording, 'rb') as f:
+            events = list(records(f.read()))
+        if not events:
+            raise ValueError("{} holds no events".format(args.recording))
+        if args.command == 'show':
+            for time_ms, kind, data in events:
+                print("{:>10.3f}s {:<10} {}".format(time_ms / 1000.0, KIND_NAMES.get(kind, kind),
+                                                   describe(kind, data)))
+            return 0
+        if args.speed <= 0:
+            raise ValueError("--speed must be positive")
+        app_uuid = uuid.UUID(args.app or app_uuid_from_package())
+        counts, skipped, late_ms = replay(events, args.target, app_uuid, args.speed)
+    except (IOError, OSError, ValueError, KeyError, struct.error) as e:
+        print("error: {}".format(e), file=sys.stderr)
+        return 1
+    except KeyboardInterrupt:
+        return 1
+    print("replayed {} in {:.1f}s, latest event {} ms late".format(
+        ', '.join('{} {}'.format(counts[name], name) for name in sorted(counts)) or "no events",
+        events[-1][0] / 1000.0 / args.speed, late_ms))
+    if skipped:
+        print("{} events could not be injected, such as ticks".format(skipped))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,168 @@
+#!/usr/bin/env python
+"""
+Decode the frames an app streams with profiler_frame_stream_start() and measure smoothness.
+
+While streaming, the watch sends one record per frame it sends, all fields little endian:
+
+    uint32_t frame          number of the frame since streaming started
+    uint32_t time_ms        time the frame appeared on the display, in ms since streaming started
+    uint16_t width          display width in pixels
+    uint16_t height         display height in pixels
+    uint16_t first_row      first row contained in the record
+    uint16_t num_rows       number of rows contained in the record
+    uint8_t  bpp            bits per pixel: 1 (GBitmapFormat1Bit) or 8 (GColor8)
+    uint8_t  flags          bit 0 set if the record holds the complete frame
+    uint16_t reserved
+    uint32_t size           size of the compressed rows that follow
+    uint8_t  data[size]     the rows, PackBits run length encoded
+
+Rows always span the full display width, (width * bpp + 7) / 8 bytes each, even on round
+displays. 1-bit pixels are stored least significant bit first. With FrameStreamFlagDamagedRows
+a record only holds the rows that changed, and the other rows are taken from the previous frame.
+Frame numbers that are missing from the stream were rendered but dropped because the connection
+could not keep up (FrameStreamFlagAllowDrops).
+
+Usage:
+    frame_stream.py [STREAM] [--fps FPS] [--png-dir DIR] [--json]
+
+The stream is read from the STREAM file, or from stdin. The report lists how often the frame
+interval exceeded the target frame rate, which counts the frames a transition dropped. With
+--png-dir, each frame is also written as DIR/frame_<number>.png.
+"""
+
+from __future__ import print_function
+
+import argparse
+import json
+import os
+import struct
+import sys
+import zlib
+
+RECORD_HEADER = struct.Struct('<IIHHHHBBHI')
+FLAG_KEYFRAME = 1 << 0
+
+
+def unpack_bits(data, expected):
+    out = bytearray()
+    data = bytearray(data)
+    i = 0
+    while i < len(data) and len(out) < expected:
+        n = data[i]
+        i += 1
+        if n < 128:
+            out += data[i:i + n + 1]
+            i += n + 1
+        elif n > 128:
+            out += data[i:i + 1] * (257 - n)
+            i += 1
+    if len(out) != expected:
+        raise ValueError("corrupt frame data")
+    return out
+
+
+def records(stream):
+    """Yield (header fields, decoded rows) for each record of a stream."""
+    while True:
+        head = stream.read(RECORD_HEADER.size)
+        if len(head) < RECORD_HEADER.size:
+            return
+        fields = RECORD_HEADER.unpack(head)
+        frame, time_ms, width, height, first_row, num_rows, bpp, flags, _, size = fields
+        data = stream.read(size)
+        if len(data) < size:
+            return
+        stride = (width * bpp + 7) // 8
+        yield fields, unpack_bits(data, stride * num_rows)
+
+
+def pixel_rgb(row, x, bpp):
+    if bpp == 1:
+        return (255, 255, 255) if row[x // 8] >> (x % 8) & 1 else (0, 0, 0)
+    c = row[x]
+    return ((c >> 4 & 3) * 85, (c >> 2 & 3) * 85, (c & 3) * 85)
+
+
+def write_png(path, width, height, bpp, pixels):
+    stride = (width * bpp + 7) // 8
+    raw = bytearray()
+    for y in range(height):
+        row = pixels[y * stride:(y + 1) * stride]
+        raw.append(0)
+        for x in range(width):
+            raw.extend(pixel_rgb(row, x, bpp))
+
+    def chunk(kind, body):
+        return (struct.pack('>I', len(body)) + kind + body +
+                struct.pack('>I', zlib.crc32(kind + body) & 0xffffffff))
+
+    with open(path, 'wb') as f:
+        f.write(b'\x89PNG\r\n\x1a\n')
+        f.write(chunk(b'IHDR', struct.pack('>IIBBBBB', width, height, 8, 2, 0, 0, 0)))
+        f.write(chunk(b'IDAT', zlib.compress(bytes(raw))))
+        f.write(chunk(b'IEND', b''))
+
+
+def decode(stream, png_dir=None):
+    """Return a list of {frame, time_ms, rows} for the frames in a stream."""
+    frames = []
+    screen = None
+    for fields, rows in records(stream):
+        frame, time_ms, width, height, first_row, num_rows, bpp, flags, _, _ = fields
+        stride = (width * bpp + 7) // 8
+        if flags & FLAG_KEYFRAME or screen is None or len(screen) != stride * height:
+            screen = bytearray(stride * height)
+        screen[first_row * stride:(first_row + num_rows) * stride] = rows
+        frames.append({'frame': frame, 'time_ms': time_ms, 'rows': num_rows})
+        if png_dir:
+            write_png(os.path.join(png_dir, 'frame_{:06d}.png'.format(frame)), width, height, bpp,
+                      screen)
+    return frames
+
+
+def analyze(frames, fps):
+    report = {'frames': len(frames), 'target_interval_ms': round(1000.0 / fps, 2)}
+    if len(frames) < 2:
+        return report
+    target = 1000.0 / fps
+    intervals = [b['time_ms'] - a['time_ms'] for a, b in zip(frames, frames[1:])]
+    # An interval of about two target intervals means one frame was not shown in time.
+    dropped = sum(max(0, int(round(i / target)) - 1) for i in intervals)
+    report.update({
+        'duration_ms': frames[-1]['time_ms'] - frames[0]['time_ms'],
+        'avg_interval_ms': round(sum(intervals) / float(len(intervals)), 2),
+        'max_interval_ms': max(intervals),
+        'dropped_frames': dropped,
+        'stream_gaps': sum(b['frame'] - a['frame'] - 1 for a, b in zip(frames, frames[1:])),
+        'avg_rows_sent': round(sum(f['rows'] for f in frames) / float(len(frames)), 1),
+    })
+    return report
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument('stream', nargs='?', help="the captured stream (default: stdin)")
+    parser.add_argument('--fps', type=float, default=30, help="the frame rate the app aims for")
+    parser.add_argument('--png-dir', help="write each frame as a PNG into this directory")
+    parser.add_argument('--json', action='store_true', help="write the report as JSON")
+    args = parser.parse_args(argv)
+
+    if args.png_dir and not os.path.isdir(args.png_dir):
+        os.makedirs(args.png_dir)
+    stream = open(args.stream, 'rb') if args.stream else getattr(sys.stdin, 'buffer', sys.stdin)
+    try:
+        frames = decode(stream, args.png_dir)
+    except ValueError as e:
+        print("error: {}".format(e), file=sys.stderr)
+        return 1
+    report = analyze(frames, args.fps)
+    if args.json:
+        print(json.dumps(report, indent=2, sort_keys=True, separators=(',', ': ')))
+    else:
+        for key in sorted(report):
+            print("{}: {}".format(key, report[key]))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,395 @@
+/* GCC plugin that checks Pebble app code for stack and heap misuse.
+
+   The plugin adds three diagnostics to an app or worker build:
+
+   - A warning for every local array or aggregate larger than
+     frame-limit bytes, and for every variable-length array.
+   - A warning for every call to malloc, calloc, realloc, strdup or an
+     SDK *_create function from a LayerUpdateProc, that is any function
+     taking (Layer *, GContext *) and returning void.  Allocating while
+     drawing costs time on every frame and fragments the heap.
+   - The worst-case stack depth of every function whose address is
+     taken (event handlers and other callbacks) and of main, from the
+     frame sizes GCC computes and the call graph of the translation
+     unit.  Functions over stack-limit bytes get a warning.  The depth
+     is a lower bound, reported as "at least", when the function calls
+     through a pointer, calls a function defined elsewhere, recurses or
+     uses alloca.
+
+   Build with the host compiler against the toolchain's plugin headers:
+
+     gcc -shared -fPIC -O2 \
+       -I"$(arm-none-eabi-gcc -print-file-name=plugin)/include" \
+       -o pebble_check.so pebble_check.c
+
+   and enable it for a build with:
+
+     arm-none-eabi-gcc -fplugin=./pebble_check.so \
+       -fplugin-arg-pebble_check-frame-limit=256 \
+       -fplugin-arg-pebble_check-stack-limit=2048 \
+       -fplugin-arg-pebble_check-report ...
+
+   The limits above are the defaults.  "report" prints the stack depth
+   of every handler rather than only those over the limit.  */
+
+#include "gcc-plugin.h"
+#include "coretypes.h"
+#include "tree.h"
+#include "function.h"
+#include "basic-block.h"
+#include "gimple.h"
+#include "tree-pass.h"
+#include "diagnostic-core.h"
+#include "pointer-set.h"
+#include "plugin-version.h"
+
+int plugin_is_GPL_compatible;
+
+static HOST_WIDE_INT frame_limit = 256;
+static HOST_WIDE_INT stack_limit = 2048;
+static bool report_all;
+
+enum visit_state { UNVISITED, VISITING, DONE };
+
+/* What the plugin records about each function defined in the
+   translation unit.  */
+typedef struct fn_info
+{
+  tree decl;
+  /* Frame size from the prologue, or -1 if not compiled.  */
+  HOST_WIDE_INT frame;
+  bool dynamic;
+  bool indirect;
+  VEC(tree,heap) *callees;
+  enum visit_state state;
+  HOST_WIDE_INT depth;
+  bool partial;
+} fn_info;
+
+static struct pointer_map_t *fn_infos;
+
+static fn_info *
+get_fn_info (tree decl, bool create)
+{
+  void **slot;
+  fn_info *info;
+
+  if (!create)
+    {
+      slot = pointer_map_contains (fn_infos, decl);
+      return slot ? (fn_info *) *slot : NULL;
+    }
+  slot = pointer_map_insert (fn_infos, decl);
+  if (!*slot)
+    {
+      info = XCNEW (fn_info);
+      info->decl = decl;
+      info->frame = -1;
+      *slot = info;
+    }
+  return (fn_info *) *slot;
+}
+
+/* Whether T, ignoring typedefs and qualifiers, is the struct NAME.  */
+
+static bool
+type_named_p (tree t, const char *name)
+{
+  tree n = TYPE_NAME (TYPE_MAIN_VARIANT (t));
+  if (n && TREE_CODE (n) == TYPE_DECL)
+    n = DECL_NAME (n);
+  return n && TREE_CODE (n) == IDENTIFIER_NODE
+	 && strcmp (IDENTIFIER_POINTER (n), name) == 0;
+}
+
+static bool
+pointer_to_named_p (tree t, const char *name)
+{
+  return POINTER_TYPE_P (t) && type_named_p (TREE_TYPE (t), name);
+}
+
+/* Whether FNDECL has the signature of a LayerUpdateProc.  */
+
+static bool
+layer_update_proc_p (tree fndecl)
+{
+  tree type = TREE_TYPE (fndecl);
+  tree args = TYPE_ARG_TYPES (type);
+
+  if (!VOID_TYPE_P (TREE_TYPE (type))
+      || !args || !TREE_CHAIN (args)
+      || TREE_CHAIN (TREE_CHAIN (args)) != void_list_node)
+    return false;
+  return pointer_to_named_p (TREE_VALUE (args), "Layer")
+	 && pointer_to_named_p (TREE_VALUE (TREE_CHAIN (args)), "GContext");
+}
+
+/* Whether a call to FNDECL allocates heap memory.  The SDK names every
+   constructor *_create or *_create_with_*.  */
+
+static bool
+allocator_p (tree fndecl)
+{
+  const char *name;
+  size_t len;
+
+  if (!DECL_NAME (fndecl))
+    return false;
+  name = IDENTIFIER_POINTER (DECL_NAME (fndecl));
+  len = strlen (name);
+  return strcmp (name, "malloc") == 0
+	 || strcmp (name, "calloc") == 0
+	 || strcmp (name, "realloc") == 0
+	 || strcmp (name, "strdup") == 0
+	 || (len > 7 && strcmp (name + len - 7, "_create") == 0)
+	 || strstr (name, "_create_with_") != NULL;
+}
+
+static void
+check_local (tree var)
+{
+  tree size;
+
+  if (TREE_CODE (var) != VAR_DECL || TREE_STATIC (var)
+      || DECL_EXTERNAL (var) || DECL_ARTIFICIAL (var))
+    return;
+  size = DECL_SIZE_UNIT (var);
+  if (!size || !host_integerp (size, 1))
+    {
+      if (TREE_CODE (TREE_TYPE (var)) == ARRAY_TYPE)
+	warning_at (DECL_SOURCE_LOCATION (var), 0,
+		    "variable-length array %qD on the stack", var);
+      return;
+    }
+  if (AGGREGATE_TYPE_P (TREE_TYPE (var))
+      && tree_low_cst (size, 1) > frame_limit)
+    warning_at (DECL_SOURCE_LOCATION (var), 0,
+		"%qD uses %wd bytes of stack; consider a static or heap "
+		"buffer", var, tree_low_cst (size, 1));
+}
+
+/* GIMPLE pass: check locals and calls, and record the callees.  */
+
+static unsigned int
+execute_check_body (void)
+{
+  fn_info *info = get_fn_info (current_function_decl, true);
+  bool draw_proc = layer_update_proc_p (current_function_decl);
+  basic_block bb;
+  unsigned ix;
+  tree var;
+
+  FOR_EACH_LOCAL_DECL (cfun, ix, var)
+    check_local (var);
+
+  FOR_EACH_BB (bb)
+    {
+      gimple_stmt_iterator gsi;
+      for (gsi = gsi_start_bb (bb); !gsi_end_p (gsi); gsi_next (&gsi))
+	{
+	  gimple stmt = gsi_stmt (gsi);
+	  tree callee;
+
+	  if (!is_gimple_call (stmt))
+	    continue;
+	  callee = gimple_call_fndecl (stmt);
+	  if (!callee)
+	    {
+	      info->indirect = true;
+	      continue;
+	    }
+	  if (draw_proc && allocator_p (callee))
+	    warning_at (gimple_location (stmt), 0,
+			"%qD allocates memory inside layer update procedure "
+			"%qD", callee, current_function_decl);
+	  if (!DECL_BUILT_IN (callee))
+	    VEC_safe_push (tree, heap, info->callees, callee);
+	}
+    }
+  return 0;
+}
+
+/* RTL pass, after the prologue is generated: record the frame size.  */
+
+static unsigned int
+execute_record_frame (void)
+{
+  fn_info *info = get_fn_info (current_function_decl, true);
+  info->frame = current_function_static_stack_size;
+  info->dynamic = current_function_allocates_dynamic_stack_space;
+  return 0;
+}
+
+static HOST_WIDE_INT
+compute_depth (fn_info *info)
+{
+  HOST_WIDE_INT deepest = 0;
+  unsigned ix;
+  tree callee;
+
+  if (info->state == DONE)
+    return info->depth;
+  if (info->state == VISITING)
+    {
+      /* Recursion: the depth cannot be bounded.  */
+      info->partial = true;
+      return 0;
+    }
+  info->state = VISITING;
+
+  FOR_EACH_VEC_ELT (tree, info->callees, ix, callee)
+    {
+      fn_info *ci = get_fn_info (callee, false);
+      HOST_WIDE_INT d;
+
+      if (!ci || ci->frame < 0)
+	{
+	  info->partial = true;
+	  continue;
+	}
+      d = compute_depth (ci);
+      if (ci->partial)
+	info->partial = true;
+      if (d > deepest)
+	deepest = d;
+    }
+  if (info->indirect || info->dynamic || info->frame < 0)
+    info->partial = true;
+
+  info->depth = MAX (info->frame, 0) + deepest;
+  info->state = DONE;
+  return info->depth;
+}
+
+static bool
+report_fn (const void *key ATTRIBUTE_UNUSED, void **value,
+	   void *data ATTRIBUTE_UNUSED)
+{
+  fn_info *info = (fn_info *) *value;
+  tree decl = info->decl;
+  HOST_WIDE_INT depth;
+
+  if (!TREE_ADDRESSABLE (decl) && !MAIN_NAME_P (DECL_NAME (decl)))
+    return true;
+  depth = compute_depth (info);
+  if (depth > stack_limit)
+    warning_at (DECL_SOURCE_LOCATION (decl), 0,
+		"worst-case stack usage of %qD is %s%wd bytes, over the "
+		"limit of %wd", decl, info->partial ? "at least " : "",
+		depth, stack_limit);
+  else if (report_all)
+    inform (DECL_SOURCE_LOCATION (decl),
+	    "worst-case stack usage of %qD is %s%wd bytes", decl,
+	    info->partial ? "at least " : "", depth);
+  return true;
+}
+
+static bool
+free_fn (const void *key ATTRIBUTE_UNUSED, void **value,
+	 void *data ATTRIBUTE_UNUSED)
+{
+  fn_info *info = (fn_info *) *value;
+  VEC_free (tree, heap, info->callees);
+  free (info);
+  return true;
+}
+
+static void
+finish_unit (void *gcc_data ATTRIBUTE_UNUSED, void *user_data ATTRIBUTE_UNUSED)
+{
+  pointer_map_traverse (fn_infos, report_fn, NULL);
+  pointer_map_traverse (fn_infos, free_fn, NULL);
+  pointer_map_destroy (fn_infos);
+  fn_infos = NULL;
+}
+
+static struct gimple_opt_pass pass_check_body =
+{
+ {
+  GIMPLE_PASS,
+  "*pebble_check_body",			/* name */
+  NULL,					/* gate */
+  execute_check_body,			/* execute */
+  NULL,					/* sub */
+  NULL,					/* next */
+  0,					/* static_pass_number */
+  TV_NONE,				/* tv_id */
+  PROP_cfg,				/* properties_required */
+  0,					/* properties_provided */
+  0,					/* properties_destroyed */
+  0,					/* todo_flags_start */
+  0					/* todo_flags_finish */
+ }
+};
+
+static struct rtl_opt_pass pass_record_frame =
+{
+ {
+  RTL_PASS,
+  "*pebble_record_frame",		/* name */
+  NULL,					/* gate */
+  execute_record_frame,			/* execute */
+  NULL,					/* sub */
+  NULL,					/* next */
+  0,					/* static_pass_number */
+  TV_NONE,				/* tv_id */
+  0,					/* properties_required */
+  0,					/* properties_provided */
+  0,					/* properties_destroyed */
+  0,					/* todo_flags_start */
+  0					/* todo_flags_finish */
+ }
+};
+
+int
+plugin_init (struct plugin_name_args *plugin_info,
+	     struct plugin_gcc_version *version)
+{
+  struct register_pass_info body_info;
+  struct register_pass_info frame_info;
+  int i;
+
+  if (!plugin_default_version_check (version, &gcc_version))
+    {
+      error ("%s: built for GCC %s", plugin_info->base_name,
+	     gcc_version.basever);
+      return 1;
+    }
+
+  for (i = 0; i < plugin_info->argc; i++)
+    {
+      const char *key = plugin_info->argv[i].key;
+      const char *value = plugin_info->argv[i].value;
+
+      if (strcmp (key, "frame-limit") == 0 && value)
+	frame_limit = atoi (value);
+      else if (strcmp (key, "stack-limit") == 0 && value)
+	stack_limit = atoi (value);
+      else if (strcmp (key, "report") == 0)
+	report_all = true;
+      else
+	warning (0, "%s: unknown argument %qs", plugin_info->base_name, key);
+    }
+
+  /* Make the prologue record the frame size, as for -fstack-usage.  */
+  flag_stack_usage_info = true;
+  fn_infos = pointer_map_create ();
+
+  body_info.pass = &pass_check_body.pass;
+  body_info.reference_pass_name = "cfg";
+  body_info.ref_pass_instance_number = 1;
+  body_info.pos_op = PASS_POS_INSERT_AFTER;
+  register_callback (plugin_info->base_name, PLUGIN_PASS_MANAGER_SETUP,
+		     NULL, &body_info);
+
+  frame_info.pass = &pass_record_frame.pass;
+  frame_info.reference_pass_name = "pro_and_epilogue";
+  frame_info.ref_pass_instance_number = 1;
+  frame_info.pos_op = PASS_POS_INSERT_AFTER;
+  register_callback (plugin_info->base_name, PLUGIN_PASS_MANAGER_SETUP,
+		     NULL, &frame_info);
+
+  register_callback (plugin_info->base_name, PLUGIN_FINISH_UNIT,
+		     finish_unit, NULL);
+  return 0;
+}
@@ -0,0 +1,119 @@
+#!/usr/bin/env python
+"""
+Summarize the launch timing lines an app writes to its log.
+
+An app that calls launch_set_timing_logging() logs the timestamps of the phases of each launch
+once its first frame is shown, see LaunchTiming in pebble.h. This tool reads `pebble logs`
+output of such an app from LOG, or from stdin, and prints the median and the slowest duration
+of each phase over all launches, by launch reason:
+
+    loaded     copying the binary from flash into RAM
+    relocated  relocating the binary and initializing its data and bss sections
+    main       starting the app up to main
+    push       the app's initialization, up to its first window_stack_push()
+    frame      the first layout and render, up to the first frame on the display
+
+Usage:
+    launch_timing.py [LOG] [--json] [--max-first-frame-ms MS]
+
+With --max-first-frame-ms, the exit status is nonzero if the median time to the first frame of
+any launch reason exceeds the limit, so that cold start times can be checked in CI.
+"""
+
+from __future__ import print_function
+
+import argparse
+import json
+import re
+import sys
+
+LAUNCH_LINE = re.compile(r'\blaunch: reason (\d+) loaded (\d+)ms relocated (\d+)ms main (\d+)ms '
+                         r'push (\d+)ms frame (\d+)ms\s*$')
+PHASES = ['loaded', 'relocated', 'main', 'push', 'frame']
+
+# Values of AppLaunchReason
+REASONS = ['system', 'user', 'phone', 'wakeup', 'worker', 'quick_launch', 'timeline_action',
+           'smartstrap', 'resume']
+
+
+def reason_name(value):
+    return REASONS[value] if value < len(REASONS) else str(value)
+
+
+def parse_log(lines):
+    """Return the phase durations of each launch in the log, grouped by launch reason."""
+    launches = {}
+    for line in lines:
+        m = LAUNCH_LINE.search(line.rstrip('\n'))
+        if not m:
+            continue
+        values = [int(g) for g in m.groups()]
+        # The log has timestamps since the launch started; turn them into durations.
+        stamps = [0] + values[1:]
+        durations = dict((phase, max(0, stamps[i + 1] - stamps[i]))
+                         for i, phase in enumerate(PHASES))
+        durations['total'] = stamps[-1]
+        launches.setdefault(reason_name(values[0]), []).append(durations)
+    return launches
+
+
+def median(values):
+    values = sorted(values)
+    mid = len(values) // 2
+    return values[mid] if len(values) % 2 else (values[mid - 1] + values[mid]) // 2
+
+
+def summarize(launches):
+    summary = {}
+    for reason, entries in launches.items():
+        summary[reason] = {'launches': len(entries)}
+        for key in PHASES + ['total']:
+            values = [e[key] for e in entries]
+            summary[reason][key] = {'median_ms': median(values), 'max_ms': max(values)}
+    return summary
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument('log', nargs='?', help="pebble logs output (default: stdin)")
+    parser.add_argument('--json', action='store_true', help="write the summary as JSON")
+    parser.add_argument('--max-first-frame-ms', type=int,
+                        help="fail if the median time to the first frame exceeds this")
+    args = parser.parse_args(argv)
+
+    try:
+        stream = open(args.log) if args.log else sys.stdin
+    except IOError as e:
+        print("error: {}".format(e), file=sys.stderr)
+        return 1
+    launches = parse_log(stream)
+    if not launches:
+        print("error: no launch lines found; call launch_set_timing_logging() in the app",
+              file=sys.stderr)
+        return 1
+    summary = summarize(launches)
+    if args.json:
+        print(json.dumps(summary, indent=2, sort_keys=True, separators=(',', ': ')))
+    else:
+        print("{:<16} {:>8}".format('reason', 'launches') +
+              ''.join(" {:>13}".format(phase) for phase in PHASES + ['total']))
+        for reason in sorted(summary):
+            row = summary[reason]
+            print("{:<16} {:>8}".format(reason, row['launches']) +
+                  ''.join(" {:>6}/{:>4}ms".format(row[key]['median_ms'], row[key]['max_ms'])
+                          for key in PHASES + ['total']))
+        print("(median/slowest)")
+    if args.max_first_frame_ms is not None:
+        slow = [r for r in sorted(summary)
+                if summary[r]['total']['median_ms'] > args.max_first_frame_ms]
+        for reason in slow:
+            print("error: {} launches take {}ms to the first frame, more than {}ms"
+                  .format(reason, summary[reason]['total']['median_ms'],
+                          args.max_first_frame_ms), file=sys.stderr)
+        if slow:
+            return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,141 @@
+#!/usr/bin/env python
+"""
+Check that object files, archives and Pebble packages can take part in link-time optimization.
+
+With link-time optimization, GCC keeps its intermediate representation of each translation unit
+in the object file and optimizes the whole program again when linking. Helpers from a Pebble
+package can then be inlined into the app's hot paths and package code the app never calls is
+dropped, which it otherwise is not. The bundled GCC 4.7.2 supports this with its linker plugin:
+
+    packages   compile with -flto -ffat-lto-objects, and create the archive with
+               arm-none-eabi-gcc-ar so that its symbol index covers the LTO objects
+    apps       compile with -flto, and link with -flto -fuse-linker-plugin and the same
+               optimization flags, since the code is generated at link time
+
+Fat LTO objects also contain regular machine code, so a package built this way still links
+into apps that do not use LTO. An app only gains from LTO for the packages that were built
+with it, so this tool reports which are not.
+
+Usage:
+    lto_check.py [--require] PATH...
+
+Each PATH is an object file, an archive, or a package's dist.zip. Every object in it is listed as
+"fat lto", "lto only" or "no lto". With --require, the exit status is nonzero if any object has
+no LTO data, for use as a check in CI.
+"""
+
+from __future__ import print_function
+
+import argparse
+import io
+import struct
+import sys
+import zipfile
+
+LTO_SECTION_PREFIX = b'.gnu.lto_'
+AR_MAGIC = b'!<arch>\n'
+
+
+def section_names(elf):
+    """Return the names and sizes of the sections of a little-endian ELF file."""
+    if elf[:4] != b'\x7fELF' or elf[5:6] != b'\x01':
+        raise ValueError("not a little-endian ELF file")
+    if elf[4:5] == b'\x01':
+        shoff, = struct.unpack_from('<I', elf, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from('<HHH', elf, 0x2e)
+        fmt = '<IIIIII'
+    elif elf[4:5] == b'\x02':
+        shoff, = struct.unpack_from('<Q', elf, 0x28)
+        shentsize, shnum, shstrndx = struct.unpack_from('<HHH', elf, 0x3a)
+        fmt = '<IIQQQQ'
+    else:
+        raise ValueError("unknown ELF class")
+
+    def header(i):
+        # name, type, flags, addr, offset, size
+        return struct.unpack_from(fmt, elf, shoff + i * shentsize)
+
+    strtab = header(shstrndx)
+    names = elf[strtab[4]:strtab[4] + strtab[5]]
+    sections = []
+    for i in range(shnum):
+        name, kind, _, _, _, size = header(i)
+        end = names.index(b'\0', name)
+        # SHT_NOBITS sections such as .bss take no space in the file.
+        sections.append((names[name:end], size if kind != 8 else 0))
+    return sections
+
+
+def classify(elf):
+    sections = section_names(elf)
+    lto = any(name.startswith(LTO_SECTION_PREFIX) for name, _ in sections)
+    code = any(size and (name == b'.text' or name.startswith(b'.text.'))
+               for name, size in sections)
+    if lto:
+        return 'fat lto' if code else 'lto only'
+    return 'no lto'
+
+
+def archive_members(data):
+    """Yield (name, data) of the members of a System V / GNU ar archive."""
+    pos = len(AR_MAGIC)
+    long_names = b''
+    while pos + 60 <= len(data):
+        header = data[pos:pos + 60]
+        name = header[:16].rstrip(b' ')
+        size = int(header[48:58])
+        body = data[pos + 60:pos + 60 + size]
+        pos += 60 + size + (size & 1)
+        if name == b'//':
+            long_names = body
+            continue
+        if name in (b'/', b'/SYM64/'):
+            continue
+        if name.startswith(b'/') and long_names:
+            start = int(name[1:])
+            name = long_names[start:long_names.index(b'/\n', start)]
+        yield name.rstrip(b'/').decode('utf-8', 'replace'), body
+
+
+def objects(path, data):
+    """Yield (display name, ELF data) of every object in a file."""
+    if data.startswith(AR_MAGIC):
+        for name, body in archive_members(data):
+            yield '{}({})'.format(path, name), body
+    elif data.startswith(b'PK'):
+        with zipfile.ZipFile(io.BytesIO(data)) as bundle:
+            for name in bundle.namelist():
+                if name.endswith(('.a', '.o')):
+                    for entry in objects('{}:{}'.format(path, name), bundle.read(name)):
+                        yield entry
+    else:
+        yield path, data
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument('paths', metavar='PATH', nargs='+')
+    parser.add_argument('--require', action='store_true',
+                        help="fail if any object has no LTO data")
+    args = parser.parse_args(argv)
+
+    missing = 0
+    for path in args.paths:
+        try:
+            with open(path, 'rb') as f:
+                data = f.read()
+            for name, elf in objects(path, data):
+                kind = classify(elf)
+                missing += kind == 'no lto'
+                print("{:<9} {}".format(kind, name))
+        except (IOError, ValueError, zipfile.BadZipfile, struct.error) as e:
+            print("error: {}: {}".format(path, e), file=sys.stderr)
+            return 1
+    if args.require and missing:
+        print("error: {} objects have no LTO data".format(missing), file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,155 @@
+#!/usr/bin/env python
+"""
+Generate lookup tables on the build host, for resources of type "raw".
+
+Apps that compute gamma curves, easing curves, sprite offsets or trigonometry for custom angles
+in their init code pay for it in launch time and heap on every launch. This tool runs the table
+generator on the build host instead and packs the tables into one raw resource. On platforms
+with memory-mapped flash, resource_get_mapped_data() then returns a pointer to the tables in
+flash, so the app neither computes nor copies them; elsewhere a ResourceReader reads them.
+
+The generator is a Python script that sets TABLES to a list of (name, type, values), where type
+is one of int8, uint8, int16, uint16, int32 and uint32:
+
+    import math
+    TABLES = [
+        ('GAMMA', 'uint8', [int(round(255 * (i / 255.0) ** 2.2)) for i in range(256)]),
+        ('SIN_360', 'int16', [int(round(32767 * math.sin(math.radians(a)))) for a in range(360)]),
+    ]
+
+Each table starts at a multiple of 4 bytes in the resource, so it can be used in place with the
+C type of its elements. With --header, a C header is written alongside that defines the offset
+and length of each table and a macro to get a pointer to it:
+
+    const uint8_t *base = resource_get_mapped_data(resource_get_handle(RESOURCE_ID_TABLES), NULL);
+    const int16_t *sin_360 = LUT_SIN_360(base);
+
+Usage:
+    lut_gen.py [--header HEADER] [-D NAME=VALUE ...] GENERATOR OUTPUT
+
+-D sets a variable of the generator script, as a number if it parses as one. Like the other
+converters it can run as a resource_cache.py job with the generator as its input.
+"""
+
+from __future__ import print_function
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+TYPES = {
+    'int8': ('b', 'int8_t'),
+    'uint8': ('B', 'uint8_t'),
+    'int16': ('h', 'int16_t'),
+    'uint16': ('H', 'uint16_t'),
+    'int32': ('i', 'int32_t'),
+    'uint32': ('I', 'uint32_t'),
+}
+NAME = re.compile(r'^[A-Z_][A-Z0-9_]*$')
+
+
+class TableError(Exception):
+    pass
+
+
+def parse_define(text):
+    name, _, value = text.partition('=')
+    for convert in (int, float):
+        try:
+            return name, convert(value)
+        except ValueError:
+            pass
+    return name, value
+
+
+def run_generator(path, defines):
+    scope = {'__file__': path, '__name__': '__lut_gen__'}
+    scope.update(defines)
+    with open(path) as f:
+        code = compile(f.read(), path, 'exec')
+    try:
+        exec(code, scope)
+    except Exception as e:
+        raise TableError("the generator failed: {}: {}".format(type(e).__name__, e))
+    tables = scope.get('TABLES')
+    if not isinstance(tables, (list, tuple)) or not tables:
+        raise TableError("the generator does not set TABLES to a list of tables")
+    return tables
+
+
+def pack_tables(tables):
+    """Return the resource data and a list of (name, type, offset, count) of its tables."""
+    data = bytearray()
+    layout = []
+    names = set()
+    for entry in tables:
+        if len(entry) != 3:
+            raise TableError("tables must be (name, type, values), not {!r}".format(entry))
+        name, kind, values = entry
+        if not NAME.match(name) or name in names:
+            raise TableError("table name '{}' is invalid or used twice".format(name))
+        if kind not in TYPES:
+            raise TableError("table '{}' has unknown type '{}'".format(name, kind))
+        names.add(name)
+        data += bytearray(-len(data) % 4)
+        values = list(values)
+        if any(isinstance(v, float) and v != int(v) for v in values):
+            raise TableError("table '{}' has fractional values; round them in the generator"
+                             .format(name))
+        try:
+            packed = struct.pack('<{}{}'.format(len(values), TYPES[kind][0]),
+                                 *[int(v) for v in values])
+        except struct.error:
+            raise TableError("table '{}' has values out of range for {}".format(name, kind))
+        layout.append((name, kind, len(data), len(values)))
+        data += packed
+    return data, layout
+
+
+def write_header(path, layout, resource_path):
+    lines = [
+        "// Generated by lut_gen.py from {}. Do not edit.".format(os.path.basename(resource_path)),
+        "#pragma once",
+        "",
+        "#include <stdint.h>",
+        "",
+    ]
+    for name, kind, offset, count in layout:
+        ctype = TYPES[kind][1]
+        lines += [
+            "#define LUT_{}_OFFSET {}".format(name, offset),
+            "#define LUT_{}_COUNT {}".format(name, count),
+            "#define LUT_{0}(base) ((const {1} *)((const uint8_t *)(base) + LUT_{0}_OFFSET))"
+            .format(name, ctype),
+            "",
+        ]
+    with open(path, 'w') as f:
+        f.write('\n'.join(lines))
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument('generator')
+    parser.add_argument('output')
+    parser.add_argument('--header', help="C header with the offsets of the tables")
+    parser.add_argument('-D', dest='defines', action='append', default=[],
+                        help="NAME=VALUE to set in the generator script")
+    args = parser.parse_args(argv)
+
+    try:
+        tables = run_generator(args.generator, dict(parse_define(d) for d in args.defines))
+        data, layout = pack_tables(tables)
+    except (IOError, SyntaxError, TableError) as e:
+        print("error: {}: {}".format(args.generator, e), file=sys.stderr)
+        return 1
+    with open(args.output, 'wb') as f:
+        f.write(data)
+    if args.header:
+        write_header(args.header, layout, args.output)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
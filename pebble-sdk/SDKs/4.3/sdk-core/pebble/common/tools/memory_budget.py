@@ -0,0 +1,229 @@
+#!/usr/bin/env python
+"""
+Report the memory an app uses on each platform after a build and check it against a budget.
+
+The app binary, its data and bss and the heap share the app's RAM, so every byte the binary
+grows is a byte less heap, on aplite out of 24 KB. For each build/<platform> directory this
+tool reports:
+
+    text, data, bss     the sizes of the app's sections, from pebble-app.elf
+    virtual_size        the RAM the app takes when loaded, from pebble-app.bin
+    relocs              relocated words, which the loader patches one by one on each launch
+    resources           the size of app_resources.pbpack and its largest resources
+    free heap           the app's RAM minus virtual_size, an estimate of the heap left after
+                        loading, before the app allocates anything
+
+The same is reported for the worker if the build has one, against the worker's 10 KB.
+
+Usage:
+    memory_budget.py [--build-dir DIR] [--budget FILE] [--json] [PLATFORM...]
+
+The budget is a JSON file, memory_budget.json in the current directory by default, with limits
+for all platforms under "default" and for single platforms under their name:
+
+    {"default": {"min_free_heap": 4096, "max_relocs": 2000},
+     "aplite": {"min_free_heap": 6144, "max_resources": 98304}}
+
+The limits are min_free_heap, max_text, max_data, max_bss, max_virtual_size, max_relocs and
+max_resources, in bytes or words; limits for apps apply to workers with a worker_ prefix, such
+as worker_min_free_heap. The exit status is nonzero if a platform exceeds a limit. To fail
+the build, run the tool after the build in the wscript, with MEMORY_BUDGET set to its path:
+
+    def build(ctx):
+        ...
+        ctx.add_post_fun(check_memory)
+
+    def check_memory(ctx):
+        if ctx.exec_command(['python', MEMORY_BUDGET, '--build-dir', ctx.out_dir]):
+            ctx.fatal('memory budget exceeded')
+"""
+
+from __future__ import print_function
+
+import argparse
+import json
+import os
+import re
+import struct
+import sys
+
+# RAM available to the app binary and its heap, and to the worker.
+APP_RAM = {'aplite': 24 * 1024, 'basalt': 64 * 1024, 'chalk': 64 * 1024,
+           'diorite': 64 * 1024, 'emery': 128 * 1024}
+WORKER_RAM = 10 * 1024
+
+# PebbleProcessInfo up to and including virtual_size, see pebble_process_info.h.
+PROCESS_INFO_FORMAT = '<8sBBBBBBHII32s32sIIII16sIIH'
+PROCESS_INFO_HEADER = b'PBLAPP'
+
+# app_resources.pbpack: number of resources, crc and timestamp, then a table of 256 entries of
+# id, offset, length and crc.
+PBPACK_MANIFEST = struct.Struct('<III')
+PBPACK_ENTRY = struct.Struct('<IIII')
+PBPACK_MAX_RESOURCES = 256
+
+SHT_NOBITS = 8
+SHF_WRITE = 0x1
+SHF_ALLOC = 0x2
+
+RESOURCE_ID = re.compile(r'\bRESOURCE_ID_(\w+)\s*=\s*(\d+)')
+LIMITS = ('min_free_heap', 'max_text', 'max_data', 'max_bss', 'max_virtual_size', 'max_relocs',
+          'max_resources')
+
+
+def elf_sections(path):
+    """Return (text, data, bss) of the loaded sections of a 32-bit little-endian ELF file."""
+    with open(path, 'rb') as f:
+        elf = f.read()
+    if elf[:4] != b'\x7fELF' or elf[4:5] != b'\x01' or elf[5:6] != b'\x01':
+        raise ValueError("{} is not a 32-bit little-endian ELF file".format(path))
+    shoff, = struct.unpack_from('<I', elf, 0x20)
+    shentsize, shnum = struct.unpack_from('<HH', elf, 0x2e)
+    text = data = bss = 0
+    for i in range(shnum):
+        _, kind, flags, _, _, size = struct.unpack_from('<IIIIII', elf, shoff + i * shentsize)
+        if not flags & SHF_ALLOC:
+            continue
+        if kind == SHT_NOBITS:
+            bss += size
+        elif flags & SHF_WRITE:
+            data += size
+        else:
+            text += size
+    return text, data, bss
+
+
+def process_info(path):
+    with open(path, 'rb') as f:
+        fields = struct.unpack(PROCESS_INFO_FORMAT, f.read(struct.calcsize(PROCESS_INFO_FORMAT)))
+    if not fields[0].startswith(PROCESS_INFO_HEADER):
+        raise ValueError("{} is not a Pebble process binary".format(path))
+    return {'relocs': fields[15], 'virtual_size': fields[19]}
+
+
+def resource_names(build_dir, platform):
+    for path in (os.path.join(build_dir, platform, 'src', 'resource_ids.auto.h'),
+                 os.path.join(build_dir, 'include', 'resource_ids.auto.h')):
+        if os.path.exists(path):
+            with open(path) as f:
+                return dict((int(i), name) for name, i in RESOURCE_ID.findall(f.read()))
+    return {}
+
+
+def resources(path, names):
+    """Return the size of a resource pack and its resources as [(name, size)], largest first."""
+    with open(path, 'rb') as f:
+        pack = f.read()
+    count, _, _ = PBPACK_MANIFEST.unpack_from(pack)
+    entries = []
+    for i in range(min(count, PBPACK_MAX_RESOURCES)):
+        resource_id, _, length, _ = PBPACK_ENTRY.unpack_from(
+            pack, PBPACK_MANIFEST.size + i * PBPACK_ENTRY.size)
+        entries.append((names.get(resource_id, '#{}'.format(resource_id)), length))
+    entries.sort(key=lambda entry: -entry[1])
+    return len(pack), entries
+
+
+def measure(build_dir, platform, kind, ram):
+    base = os.path.join(build_dir, platform, 'pebble-{}'.format(kind))
+    if not os.path.exists(base + '.bin'):
+        return None
+    text, data, bss = elf_sections(base + '.elf')
+    info = process_info(base + '.bin')
+    return {'text': text, 'data': data, 'bss': bss, 'virtual_size': info['virtual_size'],
+            'relocs': info['relocs'], 'free_heap': ram - info['virtual_size']}
+
+
+def check(usage, limits, kind):
+    """Return the limits the app or worker usage exceeds, as messages."""
+    prefix = '' if kind == 'app' else kind + '_'
+    failures = []
+    for limit in LIMITS:
+        value = limits.get(prefix + limit)
+        if value is None:
+            continue
+        if limit == 'min_free_heap':
+            if usage['free_heap'] < value:
+                failures.append("{} free heap {} is below {}"
+                                .format(kind, usage['free_heap'], value))
+        elif limit[4:] in usage and usage[limit[4:]] > value:
+            failures.append("{} {} {} is above {}".format(kind, limit[4:], usage[limit[4:]],
+                                                         value))
+    return failures
+
+
+def report(build_dir, platform, budget):
+    app = measure(build_dir, platform, 'app', APP_RAM.get(platform, APP_RAM['basalt']))
+    if app is None:
+        raise ValueError("{} has no pebble-app.bin; build the app first"
+                         .format(os.path.join(build_dir, platform)))
+    pack = os.path.join(build_dir, platform, 'app_resources.pbpack')
+    if os.path.exists(pack):
+        app['resources'], app['largest_resources'] = resources(
+            pack, resource_names(build_dir, platform))
+        app['largest_resources'] = app['largest_resources'][:5]
+    limits = dict(budget.get('default', {}), **budget.get(platform, {}))
+    result = {'app': app, 'failures': check(app, limits, 'app')}
+    worker = measure(build_dir, platform, 'worker', WORKER_RAM)
+    if worker is not None:
+        result['worker'] = worker
+        result['failures'] += check(worker, limits, 'worker')
+    return result
+
+
+def print_usage(platform, result):
+    for kind in ('app', 'worker'):
+        usage = result.get(kind)
+        if usage is None:
+            continue
+        print("{} {}: text {text} data {data} bss {bss} virtual_size {virtual_size} "
+              "relocs {relocs} free heap {free_heap}".format(platform, kind, **usage))
+        if 'resources' in usage:
+            print("  resources {} bytes, largest: {}".format(
+                usage['resources'], ', '.join('{} {}'.format(name, size)
+                                              for name, size in usage['largest_resources'])))
+    for failure in result['failures']:
+        print("  over budget: {}".format(failure))
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument('platforms', nargs='*', metavar='PLATFORM')
+    parser.add_argument('--build-dir', default='build')
+    parser.add_argument('--budget', help="limits to check (default: memory_budget.json, if any)")
+    parser.add_argument('--json', action='store_true', help="write the report as JSON")
+    args = parser.parse_args(argv)
+
+    try:
+        budget = {}
+        path = args.budget or ('memory_budget.json' if os.path.exists('memory_budget.json')
+                               else None)
+        if path:
+            with open(path) as f:
+                budget = json.load(f)
+            unknown = set(key for limits in budget.values() for key in limits
+                          if key not in LIMITS and not (key.startswith('worker_') and
+                                                        key[len('worker_'):] in LIMITS))
+            if unknown:
+                raise ValueError("{}: unknown limits {}".format(path, ', '.join(sorted(unknown))))
+        platforms = args.platforms or sorted(
+            name for name in APP_RAM
+            if os.path.exists(os.path.join(args.build_dir, name, 'pebble-app.bin')))
+        if not platforms:
+            raise ValueError("no platform builds in {}".format(args.build_dir))
+        results = dict((platform, report(args.build_dir, platform, budget))
+                       for platform in platforms)
+    except (IOError, ValueError, struct.error) as e:
+        print("error: {}".format(e), file=sys.stderr)
+        return 1
+
+    if args.json:
+        print(json.dumps(results, indent=2, sort_keys=True, separators=(',', ': ')))
+    else:
+        for platform in platforms:
+            print_usage(platform, results[platform])
+    return 1 if any(result['failures'] for result in results.values()) else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,136 @@
+#!/usr/bin/env python
+"""
+Compile a JSON menu description to a menu resource, for resources of type "menu".
+
+simple_menu_layer_create_with_resource() displays menu resources straight from flash, so static
+menus cost no app RAM for their titles or icons. The menu is described as JSON:
+
+    {"sections": [
+      {"title": "Display",
+       "items": [
+         {"title": "Backlight", "subtitle": "Auto", "icon": "IMAGE_BACKLIGHT", "id": 1},
+         {"title": "Font size"}
+       ]}
+    ]}
+
+Section titles, subtitles, icons and ids are optional. "icon" is the name of a resource in the
+app's package.json, whose resource ID is looked up the way the build numbers resources. "id" is
+passed to the select callback and defaults to the item's position in the whole menu, starting
+at 0. Identical strings are stored once.
+
+The resource build numbers each platform's resources separately, skipping entries whose
+"targetPlatforms" leave the platform out, so an icon's ID can differ between platforms. A menu
+with icons is then compiled once per platform with --platform. Files with a ~tag, such as
+icon~bw.png, replace an entry's file on some platforms but do not change the numbering.
+
+Usage:
+    menu_resource.py [--package package.json [--platform PLATFORM]] INPUT OUTPUT
+"""
+
+from __future__ import print_function
+
+import argparse
+import json
+import struct
+import sys
+
+MAGIC = b'PMNU'
+VERSION = 1
+HEADER = struct.Struct('<4sHH')
+SECTION = struct.Struct('<IHH')
+ITEM = struct.Struct('<IIII')
+
+
+class MenuError(Exception):
+    pass
+
+
+def resource_ids(package_path, platform=None):
+    """Return resource names mapped to IDs on a platform, as in its resource_ids.auto.h.
+
+    The resources of resources.media that the platform builds are numbered from 1, in order.
+    Without a platform, the package must not limit any resource to some platforms.
+    """
+    if package_path is None:
+        return {}
+    with open(package_path) as f:
+        package = json.load(f)
+    media = package.get('pebble', {}).get('resources', {}).get('media', [])
+    if platform is None:
+        limited = [entry['name'] for entry in media if 'targetPlatforms' in entry]
+        if limited:
+            raise MenuError("resource IDs differ between platforms because of the "
+                            "targetPlatforms of {}; give --platform".format(', '.join(limited)))
+    media = [entry for entry in media
+             if platform is None or platform in entry.get('targetPlatforms', [platform])]
+    return dict((entry['name'], number) for number, entry in enumerate(media, 1))
+
+
+class StringTable(object):
+    def __init__(self):
+        self.data = bytearray()
+        self.offsets = {}
+
+    def add(self, text, base):
+        if text is None:
+            return 0
+        if text not in self.offsets:
+            self.offsets[text] = base + len(self.data)
+            self.data += text.encode('utf-8') + b'\0'
+        return self.offsets[text]
+
+
+def compile_menu(menu, ids, platform=None):
+    sections = menu.get('sections')
+    if not isinstance(sections, list) or not sections:
+        raise MenuError("the menu has no sections")
+    if len(sections) > 0xffff:
+        raise MenuError("the menu has too many sections")
+    items = [item for section in sections for item in section.get('items', [])]
+    if len(items) > 0xffff:
+        raise MenuError("the menu has too many items")
+    base = HEADER.size + SECTION.size * len(sections) + 4 + ITEM.size * len(items)
+    strings = StringTable()
+
+    out = bytearray(HEADER.pack(MAGIC, VERSION, len(sections)))
+    first = 0
+    for section in sections:
+        num_items = len(section.get('items', []))
+        out += SECTION.pack(strings.add(section.get('title'), base), first, num_items)
+        first += num_items
+    out += struct.pack('<I', len(items))
+    for index, item in enumerate(items):
+        if not item.get('title'):
+            raise MenuError("item {} has no title".format(index))
+        icon = item.get('icon')
+        if icon is not None and icon not in ids:
+            raise MenuError("item '{}' uses icon '{}', which is not a resource in package.json{}"
+                            .format(item['title'], icon,
+                                    " for " + platform if platform else ""))
+        out += ITEM.pack(strings.add(item['title'], base), strings.add(item.get('subtitle'), base),
+                         ids[icon] if icon is not None else 0, item.get('id', index))
+    return out + strings.data
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument('input')
+    parser.add_argument('output')
+    parser.add_argument('--package', help="the app's package.json, to resolve icon names")
+    parser.add_argument('--platform', help="the platform whose resource IDs the icons use")
+    args = parser.parse_args(argv)
+
+    try:
+        with open(args.input) as f:
+            menu = json.load(f)
+        data = compile_menu(menu, resource_ids(args.package, args.platform), args.platform)
+    except (IOError, ValueError, MenuError) as e:
+        print("error: {}: {}".format(args.input, e), file=sys.stderr)
+        return 1
+    with open(args.output, 'wb') as f:
+        f.write(data)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
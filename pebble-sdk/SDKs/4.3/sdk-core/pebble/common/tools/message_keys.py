@@ -0,0 +1,122 @@
+#!/usr/bin/env python
+"""
+Generate dense message key numbers from the messageKeys of an app's package.json.
+
+Each message key is numbered from 0 in the order it is listed, so keys take as few bytes as
+possible on the wire and dict_index_dense() can look tuples up by indexing a table of
+MESSAGE_KEY_COUNT entries. An array key such as "values[10]" gets a single number, and its
+values are sent together as one packed tuple with dict_write_int32_array() on the watch and
+packedArray.packInt32() (common/pkjs/packed_array.js) in PebbleKit JS. Its length is available
+as MESSAGE_KEY_<name>_LENGTH.
+
+If messageKeys is an object of names to numbers, those numbers are kept as they are.
+
+Usage:
+    message_keys.py [PACKAGE_JSON] [--header build/include/message_keys.auto.h]
+                    [--json build/js/message_keys.json]
+
+The header defines MESSAGE_KEY_<name> for C code, and the JSON file maps names to numbers for
+the appKeys of the app's appinfo and for PebbleKit JS.
+"""
+
+from __future__ import print_function
+
+import argparse
+import json
+import os
+import re
+import sys
+
+KEY_PATTERN = re.compile(r'^([A-Za-z_][A-Za-z0-9_]*)(?:\[(\d+)\])?$')
+
+# Tables for dict_index_dense() larger than this are probably a mistake.
+MAX_DENSE_KEYS = 256
+
+
+def assign_keys(message_keys):
+    """Return a list of (name, number, length); length is None for scalar keys."""
+    if isinstance(message_keys, dict):
+        items = sorted(message_keys.items(), key=lambda item: item[1])
+    else:
+        items = [(name, None) for name in message_keys]
+    keys = []
+    used = set()
+    next_number = 0
+    for spec, number in items:
+        m = KEY_PATTERN.match(spec)
+        if not m:
+            raise ValueError("invalid message key '{}'".format(spec))
+        name, length = m.group(1), int(m.group(2)) if m.group(2) else None
+        if length == 0:
+            raise ValueError("message key '{}' has no elements".format(spec))
+        if number is None:
+            number = next_number
+        if name in (k[0] for k in keys) or number in used:
+            raise ValueError("message key '{}' is defined twice".format(name))
+        used.add(number)
+        next_number = number + 1
+        keys.append((name, number, length))
+    return keys
+
+
+def header(keys):
+    count = max(number for _, number, _ in keys) + 1 if keys else 0
+    lines = [
+        '#pragma once',
+        '',
+        '// Generated from the messageKeys in package.json by message_keys.py. Do not edit.',
+        '',
+    ]
+    for name, number, length in keys:
+        lines.append('#define MESSAGE_KEY_{} {}'.format(name, number))
+        if length is not None:
+            lines.append('#define MESSAGE_KEY_{}_LENGTH {}'.format(name, length))
+    lines += [
+        '',
+        '// Number of entries a dict_index_dense() table needs for all message keys',
+        '#define MESSAGE_KEY_COUNT {}'.format(count),
+        '',
+    ]
+    return '\n'.join(lines), count
+
+
+def write(path, text):
+    if os.path.dirname(path) and not os.path.isdir(os.path.dirname(path)):
+        os.makedirs(os.path.dirname(path))
+    # Leave an unchanged file alone, so that C sources including it are not rebuilt.
+    if os.path.exists(path):
+        with open(path) as f:
+            if f.read() == text:
+                return
+    with open(path, 'w') as f:
+        f.write(text)
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument('package', nargs='?', default='package.json')
+    parser.add_argument('--header', default=os.path.join('build', 'include',
+                                                         'message_keys.auto.h'))
+    parser.add_argument('--json', default=os.path.join('build', 'js', 'message_keys.json'))
+    args = parser.parse_args(argv)
+
+    with open(args.package) as f:
+        package = json.load(f)
+    try:
+        keys = assign_keys(package.get('pebble', {}).get('messageKeys', []))
+    except ValueError as e:
+        print("error: {}".format(e), file=sys.stderr)
+        return 1
+
+    text, count = header(keys)
+    if count > MAX_DENSE_KEYS:
+        print("warning: message keys go up to {}; dict_index_dense() tables would be large"
+              .format(count - 1), file=sys.stderr)
+    write(args.header, text)
+    write(args.json, json.dumps(dict((name, number) for name, number, _ in keys), indent=2,
+                                sort_keys=True, separators=(',', ': ')) + '\n')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,497 @@
+#!/usr/bin/env python
+"""
+Generate C structs and matching C and JavaScript serializers from message schemas.
+
+Hand-written marshalling writes every field as its own tuple with dict_write_*() and finds it
+again with dict_find(), on both sides of the connection. With a schema, each message is a C
+struct that is encoded straight into a packed little-endian byte string and sent as a single
+byte array tuple. The generated PebbleKit JS module encodes and decodes the same layout, so
+the two sides cannot drift apart.
+
+A schema is a JSON file:
+
+    {
+      "messages": {
+        "Weather": {
+          "key": "weather",
+          "fields": [
+            {"name": "temperature", "type": "int16"},
+            {"name": "conditions", "type": "string", "max_length": 31},
+            {"name": "hourly", "type": "int8", "count": 12}
+          ]
+        }
+      }
+    }
+
+"key" is a name from messageKeys, used as MESSAGE_KEY_<key> in C and by name in JavaScript,
+or a number. Field types are int8, uint8, int16, uint16, int32, uint32 and bool, which can have a
+fixed "count" to make an array, and string and bytes, which need a "max_length" of at most 255.
+On the wire, numbers are little endian and strings and bytes are a length byte followed by
+their contents; a string field in the struct has room for its terminating NUL.
+
+For a message Weather the C code provides:
+
+    typedef struct { ... } Weather;
+    size_t weather_encode(const Weather *msg, uint8_t *buffer, size_t size);
+    bool weather_decode(Weather *msg, const uint8_t *buffer, size_t size);
+    AppMessageResult weather_send(const Weather *msg);
+    bool weather_read(Weather *msg, DictionaryIterator *iter);
+
+and the JavaScript module `Weather.encode(object)`, `Weather.decode(bytes)`,
+`Weather.send(object, success, failure)` and `Weather.read(payload)`.
+
+Usage:
+    message_schema.py SCHEMA.json --c-dir src/c --js-dir src/pkjs [--name messages]
+
+This writes <name>.h and <name>.c to the C directory and <name>.js to the JavaScript one.
+"""
+
+from __future__ import print_function
+
+import argparse
+import json
+import os
+import re
+import sys
+
+INT_TYPES = {
+    'int8': ('int8_t', 1, True),
+    'uint8': ('uint8_t', 1, False),
+    'int16': ('int16_t', 2, True),
+    'uint16': ('uint16_t', 2, False),
+    'int32': ('int32_t', 4, True),
+    'uint32': ('uint32_t', 4, False),
+    'bool': ('bool', 1, False),
+}
+VAR_TYPES = ('string', 'bytes')
+IDENTIFIER = re.compile(r'^[A-Za-z_][A-Za-z0-9_]*$')
+
+
+def snake_case(name):
+    return re.sub(r'(?<=[a-z0-9])([A-Z])', r'_\1', name).lower()
+
+
+def validate(schema):
+    messages = schema.get('messages')
+    if not isinstance(messages, dict) or not messages:
+        raise ValueError("schema has no messages")
+    for name, message in sorted(messages.items()):
+        if not IDENTIFIER.match(name):
+            raise ValueError("invalid message name '{}'".format(name))
+        if 'key' not in message:
+            raise ValueError("message {} has no key".format(name))
+        for field in message.get('fields', []):
+            where = "{}.{}".format(name, field.get('name'))
+            if not IDENTIFIER.match(field.get('name', '')):
+                raise ValueError("invalid field name in {}".format(name))
+            ftype = field.get('type')
+            if ftype in VAR_TYPES:
+                if not 0 < field.get('max_length', 0) <= 255:
+                    raise ValueError("{} needs a max_length from 1 to 255".format(where))
+                if 'count' in field:
+                    raise ValueError("{}: {} fields cannot have a count".format(where, ftype))
+            elif ftype in INT_TYPES:
+                if field.get('count', 1) < 1:
+                    raise ValueError("{} has an invalid count".format(where))
+            else:
+                raise ValueError("{} has unknown type '{}'".format(where, ftype))
+
+
+def max_size(message):
+    size = 0
+    for field in message.get('fields', []):
+        if field['type'] in VAR_TYPES:
+            size += 1 + field['max_length']
+        else:
+            size += INT_TYPES[field['type']][1] * field.get('count', 1)
+    return size
+
+
+def c_key(message):
+    key = message['key']
+    return str(key) if isinstance(key, int) else 'MESSAGE_KEY_' + key
+
+
+def generate_header(schema, name):
+    out = [
+        '#pragma once',
+        '',
+        '// Generated from a message schema by message_schema.py. Do not edit.',
+        '',
+        '#include <pebble.h>',
+        '',
+    ]
+    for mname, message in sorted(schema['messages'].items()):
+        fn = snake_case(mname)
+        out.append('typedef struct {')
+        for field in message.get('fields', []):
+            ftype = field['type']
+            if ftype == 'string':
+                out.append('  char {}[{}];'.format(field['name'], field['max_length'] + 1))
+            elif ftype == 'bytes':
+                out.append('  uint8_t {}_length;'.format(field['name']))
+                out.append('  uint8_t {}[{}];'.format(field['name'], field['max_length']))
+            elif 'count' in field:
+                out.append('  {} {}[{}];'.format(INT_TYPES[ftype][0], field['name'],
+                                                 field['count']))
+            else:
+                out.append('  {} {};'.format(INT_TYPES[ftype][0], field['name']))
+        out += [
+            '}} {};'.format(mname),
+            '',
+            '//! The largest encoded size of a {}'.format(mname),
+            '#define {}_MAX_SIZE {}'.format(fn.upper(), max_size(message)),
+            '',
+            '//! Encodes a {} into a buffer.'.format(mname),
+            '//! @return The number of bytes written, or 0 if the buffer is too small or a length',
+            '//! is out of range',
+            'size_t {}_encode(const {} *msg, uint8_t *buffer, size_t size);'.format(fn, mname),
+            '',
+            '//! Decodes a {} encoded by {}_encode() or the JavaScript module.'.format(mname, fn),
+            '//! @return false if the data is truncated or a length is out of range',
+            'bool {}_decode({} *msg, const uint8_t *buffer, size_t size);'.format(fn, mname),
+            '',
+            '//! Sends a {} as a single tuple with the key {}.'.format(mname, c_key(message)),
+        ]
+        if message.get('fields'):
+            out += [
+                '//! @return APP_MSG_INVALID_ARGS, without sending anything, if the message cannot',
+                '//! be encoded',
+            ]
+        out += [
+            'AppMessageResult {}_send(const {} *msg);'.format(fn, mname),
+            '',
+            '//! Reads a {} from a received message.'.format(mname),
+            '//! @return false if the message does not contain a valid {}'.format(mname),
+            'bool {}_read({} *msg, DictionaryIterator *iter);'.format(fn, mname),
+            '',
+        ]
+    return '\n'.join(out)
+
+
+def generate_source(schema, name):
+    types = set(f['type'] for m in schema['messages'].values() for f in m.get('fields', []))
+    out = [
+        '// Generated from a message schema by message_schema.py. Do not edit.',
+        '',
+        '#include "{}.h"'.format(name),
+        '',
+    ]
+    # Only emit the helpers that are used, since unused static functions fail -Werror builds.
+    if types & set(INT_TYPES):
+        out += [
+            'static uint8_t *prv_put(uint8_t *p, uint32_t value, size_t width) {',
+            '  for (size_t i = 0; i < width; i++) {',
+            '    *p++ = (uint8_t)(value >> (8 * i));',
+            '  }',
+            '  return p;',
+            '}',
+            '',
+            'static const uint8_t *prv_get(const uint8_t *p, uint32_t *value, size_t width) {',
+            '  *value = 0;',
+            '  for (size_t i = 0; i < width; i++) {',
+            '    *value |= (uint32_t)*p++ << (8 * i);',
+            '  }',
+            '  return p;',
+            '}',
+            '',
+        ]
+    if 'string' in types:
+        out += [
+            'static size_t prv_strnlen(const char *s, size_t max_length) {',
+            '  size_t length = 0;',
+            "  while (length < max_length && s[length] != '\\0') {",
+            '    length++;',
+            '  }',
+            '  return length;',
+            '}',
+            '',
+        ]
+    for mname, message in sorted(schema['messages'].items()):
+        fn = snake_case(mname)
+        fields = message.get('fields', [])
+        enc = [
+            'size_t {}_encode(const {} *msg, uint8_t *buffer, size_t size) {{'.format(fn, mname),
+            '  uint8_t *p = buffer;',
+            '  const uint8_t *end = buffer + size;',
+        ]
+        dec = [
+            'bool {}_decode({} *msg, const uint8_t *buffer, size_t size) {{'.format(fn, mname),
+            '  const uint8_t *p = buffer;',
+            '  const uint8_t *end = buffer + size;',
+        ]
+        if any(f['type'] in INT_TYPES for f in fields):
+            dec.append('  uint32_t value;')
+        for field in fields:
+            ftype = field['type']
+            fname = field['name']
+            if ftype in VAR_TYPES:
+                if ftype == 'string':
+                    length = 'prv_strnlen(msg->{0}, {1})'.format(fname, field['max_length'])
+                else:
+                    length = 'msg->{}_length'.format(fname)
+                enc += [
+                    '  {',
+                    '    const size_t length = {};'.format(length),
+                    '    if (length > {} || end - p < (ptrdiff_t)(1 + length)) {{'.format(
+                        field['max_length']),
+                    '      return 0;',
+                    '    }',
+                    '    *p++ = (uint8_t)length;',
+                    '    memcpy(p, msg->{}, length);'.format(fname),
+                    '    p += length;',
+                    '  }',
+                ]
+                dec += [
+                    '  {',
+                    '    if (end - p < 1 || *p > {} || end - p < 1 + *p) {{'.format(
+                        field['max_length']),
+                    '      return false;',
+                    '    }',
+                    '    const size_t length = *p++;',
+                    '    memcpy(msg->{}, p, length);'.format(fname),
+                ]
+                if ftype == 'string':
+                    dec.append("    msg->{}[length] = '\\0';".format(fname))
+                else:
+                    dec.append('    msg->{}_length = (uint8_t)length;'.format(fname))
+                dec += [
+                    '    p += length;',
+                    '  }',
+                ]
+                continue
+            ctype, width, signed = INT_TYPES[ftype]
+            count = field.get('count')
+            total = width * (count or 1)
+            enc += [
+                '  if (end - p < {}) {{'.format(total),
+                '    return 0;',
+                '  }',
+            ]
+            dec += [
+                '  if (end - p < {}) {{'.format(total),
+                '    return false;',
+                '  }',
+            ]
+            target = 'msg->{}[i]'.format(fname) if count else 'msg->{}'.format(fname)
+            if ftype == 'bool':
+                read = '{} = (value != 0);'.format(target)
+            elif signed and width < 4:
+                # Sign extend from the field's width.
+                read = '{} = ({})((int32_t)(value << {}) >> {});'.format(
+                    target, ctype, 32 - 8 * width, 32 - 8 * width)
+            else:
+                read = '{} = ({})value;'.format(target, ctype)
+            if count:
+                enc += [
+                    '  for (size_t i = 0; i < {}; i++) {{'.format(count),
+                    '    p = prv_put(p, (uint32_t){}, {});'.format(target, width),
+                    '  }',
+                ]
+                dec += [
+                    '  for (size_t i = 0; i < {}; i++) {{'.format(count),
+                    '    p = prv_get(p, &value, {});'.format(width),
+                    '    ' + read,
+                    '  }',
+                ]
+            else:
+                enc.append('  p = prv_put(p, (uint32_t){}, {});'.format(target, width))
+                dec += [
+                    '  p = prv_get(p, &value, {});'.format(width),
+                    '  ' + read,
+                ]
+        enc += ['  return (size_t)(p - buffer);', '}', '']
+        dec += ['  return true;', '}', '']
+        out += enc + dec
+        out += [
+            'AppMessageResult {}_send(const {} *msg) {{'.format(fn, mname),
+            '  uint8_t buffer[{}_MAX_SIZE];'.format(fn.upper()),
+            '  const size_t size = {}_encode(msg, buffer, sizeof(buffer));'.format(fn),
+        ]
+        if fields:
+            out += [
+                '  if (size == 0) {',
+                '    return APP_MSG_INVALID_ARGS;',
+                '  }',
+            ]
+        out += [
+            '  DictionaryIterator *iter;',
+            '  AppMessageResult result = app_message_outbox_begin(&iter);',
+            '  if (result != APP_MSG_OK) {',
+            '    return result;',
+            '  }',
+            '  if (dict_write_data(iter, {}, buffer, (uint16_t)size) != DICT_OK) {{'.format(
+                c_key(message)),
+            '    return APP_MSG_BUFFER_OVERFLOW;',
+            '  }',
+            '  return app_message_outbox_send();',
+            '}',
+            '',
+            'bool {}_read({} *msg, DictionaryIterator *iter) {{'.format(fn, mname),
+            '  const Tuple *tuple = dict_find(iter, {});'.format(c_key(message)),
+            '  if (!tuple || tuple->type != TUPLE_BYTE_ARRAY) {',
+            '    return false;',
+            '  }',
+            '  return {}_decode(msg, tuple->value->data, tuple->length);'.format(fn),
+            '}',
+            '',
+        ]
+    return '\n'.join(out)
+
+
+JS_RUNTIME = """\
+function utf8Encode(text) {
+  var encoded = unescape(encodeURIComponent(text));
+  var bytes = [];
+  for (var i = 0; i < encoded.length; i++) {
+    bytes.push(encoded.charCodeAt(i));
+  }
+  return bytes;
+}
+
+function utf8Decode(bytes) {
+  return decodeURIComponent(escape(String.fromCharCode.apply(null, bytes)));
+}
+
+function putInt(out, value, width) {
+  for (var i = 0; i < width; i++) {
+    out.push(value >> (8 * i) & 0xff);
+  }
+}
+
+function getInt(bytes, pos, width, signed) {
+  var value = 0;
+  for (var i = 0; i < width; i++) {
+    value += bytes[pos + i] * Math.pow(2, 8 * i);
+  }
+  var limit = Math.pow(2, 8 * width);
+  return signed && value >= limit / 2 ? value - limit : value;
+}
+
+function putVar(out, bytes, maxLength, name) {
+  if (bytes.length > maxLength) {
+    throw new Error(name + ' is longer than ' + maxLength + ' bytes');
+  }
+  out.push(bytes.length);
+  for (var i = 0; i < bytes.length; i++) {
+    out.push(bytes[i]);
+  }
+}
+
+function makeMessage(key, fields) {
+  return {
+    key: key,
+    encode: function(object) {
+      var out = [];
+      fields.forEach(function(f) {
+        var value = object[f.name];
+        if (f.type === 'string') {
+          putVar(out, utf8Encode(value || ''), f.maxLength, f.name);
+        } else if (f.type === 'bytes') {
+          putVar(out, Array.prototype.slice.call(value || []), f.maxLength, f.name);
+        } else {
+          var values = f.count ? value || [] : [value];
+          for (var i = 0; i < (f.count || 1); i++) {
+            putInt(out, f.type === 'bool' ? (values[i] ? 1 : 0) : values[i] || 0, f.width);
+          }
+        }
+      });
+      return out;
+    },
+    decode: function(bytes) {
+      var object = {};
+      var pos = 0;
+      fields.forEach(function(f) {
+        if (f.type === 'string' || f.type === 'bytes') {
+          var length = bytes[pos++];
+          var data = Array.prototype.slice.call(bytes, pos, pos + length);
+          object[f.name] = f.type === 'string' ? utf8Decode(data) : data;
+          pos += length;
+        } else {
+          var values = [];
+          for (var i = 0; i < (f.count || 1); i++) {
+            var v = getInt(bytes, pos, f.width, f.signed);
+            values.push(f.type === 'bool' ? v !== 0 : v);
+            pos += f.width;
+          }
+          object[f.name] = f.count ? values : values[0];
+        }
+      });
+      return object;
+    },
+    send: function(object, success, failure) {
+      var payload = {};
+      try {
+        payload[key] = this.encode(object);
+      } catch (e) {
+        // Nothing is sent if the object cannot be encoded.
+        if (failure) {
+          failure({data: payload, error: e.message});
+        }
+        return;
+      }
+      Pebble.sendAppMessage(payload, success, failure);
+    },
+    read: function(payload) {
+      var bytes = payload[key];
+      return bytes === undefined ? null : this.decode(bytes);
+    }
+  };
+}
+"""
+
+
+def generate_js(schema):
+    out = [
+        '// Generated from a message schema by message_schema.py. Do not edit.',
+        '',
+        JS_RUNTIME,
+    ]
+    for mname, message in sorted(schema['messages'].items()):
+        fields = []
+        for field in message.get('fields', []):
+            desc = {'name': field['name'], 'type': field['type']}
+            if field['type'] in VAR_TYPES:
+                desc['maxLength'] = field['max_length']
+            else:
+                desc['width'] = INT_TYPES[field['type']][1]
+                desc['signed'] = INT_TYPES[field['type']][2]
+                if 'count' in field:
+                    desc['count'] = field['count']
+            fields.append(desc)
+        out.append('module.exports.{} = makeMessage({}, {});'.format(
+            mname, json.dumps(message['key']), json.dumps(fields, sort_keys=True)))
+    out.append('')
+    return '\n'.join(out)
+
+
+def write(path, text):
+    if os.path.dirname(path) and not os.path.isdir(os.path.dirname(path)):
+        os.makedirs(os.path.dirname(path))
+    with open(path, 'w') as f:
+        f.write(text)
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument('schema')
+    parser.add_argument('--c-dir', default=os.path.join('src', 'c'))
+    parser.add_argument('--js-dir', default=os.path.join('src', 'pkjs'))
+    parser.add_argument('--name', default='messages', help="base name of the generated files")
+    args = parser.parse_args(argv)
+
+    with open(args.schema) as f:
+        schema = json.load(f)
+    try:
+        validate(schema)
+    except ValueError as e:
+        print("error: {}".format(e), file=sys.stderr)
+        return 1
+    write(os.path.join(args.c_dir, args.name + '.h'), generate_header(schema, args.name))
+    write(os.path.join(args.c_dir, args.name + '.c'), generate_source(schema, args.name))
+    write(os.path.join(args.js_dir, args.name + '.js'), generate_js(schema))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,150 @@
+#!/usr/bin/env python
+"""
+Choose functions to compile for speed with PBL_OPTIMIZE_SPEED, and report what they cost in size.
+
+Apps are built with -Os so that they fit the smaller platforms. PBL_OPTIMIZE_SPEED compiles
+single functions with -O2, and `#pragma GCC optimize ("O2")` whole files, so that draw loops
+get the faster code without the rest of the app growing.
+
+Usage:
+    opt_profile.py suggest [LOG] [--top N] [--min-share PERCENT]
+    opt_profile.py sizes ELF... [--baseline DIR] [--functions NAME,...]
+
+suggest reads `pebble logs` output of an app that prints PROFILE_SCOPE statistics with
+profiler_print_stats(), from LOG or stdin, and lists the sections that take the most cycles in
+total, with their share of all measured cycles. These are the functions worth marking, if the
+PROFILE_SCOPE labels are named after them as usual.
+
+sizes lists, for each build/<platform>/pebble-app.elf, the size of the app's code and the
+largest functions. With --baseline, the ELF files of the same platforms in that directory, such
+as a copy of build/ from before any function was marked, are compared with them and the
+functions that grew the most are listed instead. --functions limits the list to the given
+functions.
+"""
+
+from __future__ import print_function
+
+import argparse
+import os
+import struct
+import sys
+
+from emu_cycles import PROFILE_LINE
+
+SHT_SYMTAB = 2
+STT_FUNC = 2
+SHF_EXECINSTR = 0x4
+
+
+def read_elf(path):
+    """Return (code size, {function name: size}) of a 32-bit little-endian ELF file."""
+    with open(path, 'rb') as f:
+        elf = f.read()
+    if elf[:4] != b'\x7fELF' or elf[4:5] != b'\x01' or elf[5:6] != b'\x01':
+        raise ValueError("{} is not a 32-bit little-endian ELF file".format(path))
+    shoff, = struct.unpack_from('<I', elf, 0x20)
+    shentsize, shnum = struct.unpack_from('<HH', elf, 0x2e)
+    # name, type, flags, addr, offset, size, link, info, addralign, entsize
+    sections = [struct.unpack_from('<IIIIIIIIII', elf, shoff + i * shentsize)
+                for i in range(shnum)]
+    code = sum(s[5] for s in sections if s[2] & SHF_EXECINSTR)
+    functions = {}
+    for section in sections:
+        if section[1] != SHT_SYMTAB:
+            continue
+        strtab = sections[section[6]]
+        names = elf[strtab[4]:strtab[4] + strtab[5]]
+        for pos in range(section[4], section[4] + section[5], 16):
+            name, _, size, info, _, _ = struct.unpack_from('<IIIBBH', elf, pos)
+            if info & 0xf == STT_FUNC and size:
+                label = names[name:names.index(b'\0', name)].decode('utf-8', 'replace')
+                functions[label] = functions.get(label, 0) + size
+    if not functions:
+        raise ValueError("{} has no symbol table; was it stripped?".format(path))
+    return code, functions
+
+
+def platform_of(path):
+    return os.path.basename(os.path.dirname(os.path.abspath(path)))
+
+
+def suggest(lines, top, min_share):
+    totals = {}
+    for line in lines:
+        match = PROFILE_LINE.search(line)
+        if match:
+            name, count, _, avg, _ = match.groups()
+            # The last statistics printed for a section include all earlier ones.
+            totals[name] = int(count) * int(avg)
+    overall = sum(totals.values())
+    ranked = sorted(totals.items(), key=lambda item: -item[1])
+    return [(name, cycles, 100.0 * cycles / overall) for name, cycles in ranked[:top]
+            if overall and 100.0 * cycles / overall >= min_share]
+
+
+def size_report(paths, baseline, only):
+    for path in paths:
+        platform = platform_of(path)
+        code, functions = read_elf(path)
+        if only:
+            functions = dict((name, functions.get(name, 0)) for name in only)
+        if baseline is None:
+            print("{}: code {} bytes".format(platform, code))
+            rows = sorted(functions.items(), key=lambda item: -item[1])
+            for name, size in rows[:None if only else 10]:
+                print("  {:>7} {}".format(size, name))
+            continue
+        old_path = os.path.join(baseline, platform, os.path.basename(path))
+        old_code, old_functions = read_elf(old_path)
+        print("{}: code {} bytes, {:+d} from {}".format(platform, code, code - old_code,
+                                                        old_code))
+        deltas = [(name, size - old_functions.get(name, 0), size)
+                  for name, size in functions.items()]
+        deltas.sort(key=lambda item: -item[1])
+        for name, delta, size in deltas[:None if only else 10]:
+            if delta or only:
+                print("  {:>+7} {:>7} {}".format(delta, size, name))
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    sub = parser.add_subparsers(dest='command')
+    p = sub.add_parser('suggest', help="rank PROFILE_SCOPE sections by total cycles")
+    p.add_argument('log', nargs='?', help="pebble logs output (default: stdin)")
+    p.add_argument('--top', type=int, default=5, help="sections to list (default: 5)")
+    p.add_argument('--min-share', type=float, default=5.0,
+                   help="leave out sections with a smaller share of the cycles (default: 5)")
+    p = sub.add_parser('sizes', help="report code size per platform")
+    p.add_argument('elf', nargs='+', help="build/<platform>/pebble-app.elf files")
+    p.add_argument('--baseline', help="directory with the platform builds to compare with")
+    p.add_argument('--functions', help="comma-separated functions to report")
+    args = parser.parse_args(argv)
+
+    if args.command == 'suggest':
+        try:
+            stream = open(args.log) if args.log else sys.stdin
+        except IOError as e:
+            print("error: {}".format(e), file=sys.stderr)
+            return 1
+        rows = suggest(stream, args.top, args.min_share)
+        if not rows:
+            print("error: no profile statistics found; does the app call profiler_print_stats()?",
+                  file=sys.stderr)
+            return 1
+        for name, cycles, share in rows:
+            print("{:5.1f}% {:>12} cycles  {}".format(share, cycles, name))
+        return 0
+    if args.command != 'sizes':
+        parser.print_usage()
+        return 2
+    only = [name for name in (args.functions or '').split(',') if name]
+    try:
+        size_report(args.elf, args.baseline, only)
+    except (IOError, ValueError, struct.error) as e:
+        print("error: {}".format(e), file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,151 @@
+#!/usr/bin/env python
+"""
+Machine-wide cache of compiled Pebble packages.
+
+Every app build compiles the C code of all its package dependencies for every target platform,
+although a package at a given version compiles to the same archive each time. This tool runs
+each package compilation at most once per machine, in the way resource_cache.py does for
+resources. The cache key is the package's name and version, a hash of its files, the target
+platform, the SDK version with a hash of the platform's SDK headers, the compiler with its
+version and the compiler flags. A change to any of them, such as a patched package in
+node_modules or an SDK upgrade, compiles the package again.
+
+The jobs are read as a JSON list, from a file or stdin:
+    [{"package": "node_modules/pebble-ui-helpers", "platform": "basalt",
+      "compiler": "arm-none-eabi-gcc", "flags": ["-mcpu=cortex-m3", "-Os", "-flto"],
+      "output": "build/basalt/libpebble-ui-helpers.a",
+      "command": ["build_package.sh", "{package}", "{flags}", "{output}"]}, ...]
+"{package}" expands to the package directory, "{flags}" to the flags and "{output}" to the
+output path. The files of the package's "build" and "node_modules" directories are not hashed.
+"sdk" is the directory with the platforms' include directories the package is compiled against,
+this SDK by default.
+
+Usage:
+    package_cache.py [--cache-dir DIR] [-j JOBS] [--max-size MB] [JOBFILE]
+
+The cache is shared with resource_cache.py unless --cache-dir or PEBBLE_PACKAGE_CACHE says
+otherwise; the keys of the two never collide.
+"""
+
+from __future__ import print_function
+
+import argparse
+import hashlib
+import json
+import os
+import re
+import subprocess
+import sys
+import threading
+
+from resource_cache import DEFAULT_CACHE_DIR, ResourceCache, run_jobs
+
+DEFAULT_SDK = os.path.dirname(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+# Change this when the way keys are computed changes.
+CACHE_VERSION = 2
+SKIPPED_DIRS = ('build', 'node_modules', '.git')
+
+_compiler_versions = {}
+_compiler_lock = threading.Lock()
+_sdk_versions = {}
+_sdk_lock = threading.Lock()
+
+
+def compiler_version(compiler):
+    with _compiler_lock:
+        if compiler not in _compiler_versions:
+            try:
+                output = subprocess.check_output([compiler, '--version'])
+            except (OSError, subprocess.CalledProcessError):
+                raise ValueError("cannot run the compiler '{}'".format(compiler))
+            _compiler_versions[compiler] = output.decode('utf-8', 'replace').splitlines()[0]
+        return _compiler_versions[compiler]
+
+
+def sdk_version(sdk_dir, platform):
+    """Return the SDK version of a platform's headers and a hash of the headers."""
+    include_dir = os.path.join(sdk_dir, platform, 'include')
+    with _sdk_lock:
+        if include_dir not in _sdk_versions:
+            if not os.path.isdir(include_dir):
+                raise ValueError("{} does not exist".format(include_dir))
+            h = hashlib.sha1()
+            hash_package(h, include_dir)
+            with open(os.path.join(include_dir, 'pebble_process_info.h')) as f:
+                defines = dict(re.findall(r'#define PROCESS_INFO_CURRENT_SDK_VERSION_(MAJOR|MINOR)'
+                                          r'\s+(\w+)', f.read()))
+            version = '{}.{}'.format(defines.get('MAJOR'), defines.get('MINOR'))
+            _sdk_versions[include_dir] = [version, h.hexdigest()]
+        return _sdk_versions[include_dir]
+
+
+def hash_package(h, package_dir):
+    for root, dirs, files in os.walk(package_dir):
+        dirs[:] = sorted(d for d in dirs if d not in SKIPPED_DIRS)
+        for name in sorted(files):
+            path = os.path.join(root, name)
+            h.update(os.path.relpath(path, package_dir).replace(os.sep, '/').encode('utf-8'))
+            with open(path, 'rb') as f:
+                h.update(hashlib.sha1(f.read()).digest())
+
+
+class PackageCache(ResourceCache):
+    def key(self, job):
+        with open(os.path.join(job['package'], 'package.json')) as f:
+            package = json.load(f)
+        h = hashlib.sha1()
+        h.update(json.dumps(['package', CACHE_VERSION, package.get('name'), package.get('version'),
+                             job['platform'],
+                             sdk_version(job.get('sdk', DEFAULT_SDK), job['platform']),
+                             compiler_version(job.get('compiler', 'gcc')),
+                             job.get('flags', []), job['command_template']]).encode('utf-8'))
+        hash_package(h, job['package'])
+        return h.hexdigest()
+
+
+def expand_package_job(job):
+    """Return the job with {package} and {flags} expanded, in the form run_jobs() expects."""
+    command = []
+    for arg in job['command']:
+        if arg == '{flags}':
+            command.extend(job.get('flags', []))
+        else:
+            command.append(arg.replace('{package}', job['package']))
+    # The key is computed from the unexpanded command, so that the same package compiled for
+    # different projects shares one cache entry.
+    return dict(job, command=command, command_template=job['command'], inputs=[])
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument('jobfile', nargs='?', help="JSON list of jobs (default: stdin)")
+    parser.add_argument('--cache-dir', default=os.environ.get('PEBBLE_PACKAGE_CACHE',
+                                                              DEFAULT_CACHE_DIR))
+    parser.add_argument('-j', '--jobs', type=int, help="parallel compilations (default: CPUs)")
+    parser.add_argument('--max-size', type=int, default=512,
+                        help="prune the cache to this many MB afterwards (default: 512)")
+    args = parser.parse_args(argv)
+
+    if args.jobfile:
+        with open(args.jobfile) as f:
+            jobs = json.load(f)
+    else:
+        jobs = json.load(sys.stdin)
+
+    cache = PackageCache(args.cache_dir)
+    try:
+        hits = run_jobs(cache, [expand_package_job(job) for job in jobs], args.jobs)
+    except subprocess.CalledProcessError as e:
+        print("package compilation failed: {}".format(' '.join(e.cmd)), file=sys.stderr)
+        return 1
+    except (IOError, ValueError) as e:
+        print("error: {}".format(e), file=sys.stderr)
+        return 1
+    cache.prune(args.max_size * 1024 * 1024)
+    print("{} packages, {} from cache".format(len(jobs), hits))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,163 @@
+#!/usr/bin/env python
+"""
+Store resource packs that several platforms share only once in a pbw.
+
+A pbw holds one directory per platform, each with its own app_resources.pbpack. Platforms with
+the same display shape and color support, such as basalt and emery for many apps, often end
+up with byte-identical packs. Because the pbw stores each copy separately, an app store or
+archive holding many bundles stores and transfers every shared pack several times.
+
+This tool moves every pack used by more than one platform to shared/<crc>.pbpack, at the root
+of the bundle, and points the platforms' manifests at it. Each affected "resources" entry is
+marked "shared": true, its "name" is then relative to the bundle root instead of the platform
+directory, and "platform_name" keeps the name it had. The pack's "crc", which is also the
+resource_crc field in the platform's PebbleProcessInfo, stays unchanged.
+
+A deduplicated bundle is a distribution format, for storing and transferring many apps, and
+cannot be installed: the pebble tool and the mobile apps read each platform's pack from the
+platform directory. --expand turns it back into an installable pbw, identical in content to the
+original. Readers of deduplicated bundles should resolve pack paths with resource_pack_path().
+
+Usage:
+    pbw_dedup.py INPUT.pbw OUTPUT.pbw
+    pbw_dedup.py --expand INPUT.pbw OUTPUT.pbw
+
+The output has to be a different file than the input, so that the installable bundle is kept.
+"""
+
+from __future__ import print_function
+
+import argparse
+import hashlib
+import json
+import os
+import posixpath
+import shutil
+import sys
+import tempfile
+import zipfile
+
+MANIFEST = 'manifest.json'
+SHARED_DIR = 'shared'
+
+
+def resource_pack_path(platform_dir, resources):
+    """Return the path within the bundle of a platform's resource pack."""
+    if resources.get('shared'):
+        return resources['name']
+    return posixpath.join(platform_dir, resources['name'])
+
+
+def platform_dirs(names):
+    return sorted(posixpath.dirname(n) for n in names if posixpath.basename(n) == MANIFEST)
+
+
+def dedup(src, dst):
+    with zipfile.ZipFile(src) as zin:
+        names = zin.namelist()
+        manifests = {}
+        packs = {}
+        for pdir in platform_dirs(names):
+            manifest = json.loads(zin.read(posixpath.join(pdir, MANIFEST)).decode('utf-8'))
+            resources = manifest.get('resources')
+            if not resources or resources.get('shared'):
+                continue
+            manifests[pdir] = manifest
+            path = resource_pack_path(pdir, resources)
+            digest = hashlib.sha1(zin.read(path)).hexdigest()
+            packs.setdefault(digest, []).append(pdir)
+
+        # Maps each shared pack to the entry its data is copied from.
+        shared_packs = {}
+        replaced = set()
+        for digest, pdirs in packs.items():
+            if len(pdirs) < 2:
+                continue
+            first = manifests[pdirs[0]]['resources']
+            shared = posixpath.join(SHARED_DIR, '{:08x}.pbpack'.format(first['crc']))
+            shared_packs[shared] = resource_pack_path(pdirs[0], first)
+            for pdir in pdirs:
+                resources = manifests[pdir]['resources']
+                replaced.add(resource_pack_path(pdir, resources))
+                resources['platform_name'] = resources['name']
+                resources['name'] = shared
+                resources['shared'] = True
+
+        with zipfile.ZipFile(dst, 'w', zipfile.ZIP_DEFLATED) as zout:
+            for name in names:
+                if name in replaced:
+                    continue
+                if posixpath.basename(name) == MANIFEST and posixpath.dirname(name) in manifests:
+                    manifest = manifests[posixpath.dirname(name)]
+                    zout.writestr(name, json.dumps(manifest, indent=4, sort_keys=True))
+                else:
+                    zout.writestr(zin.getinfo(name), zin.read(name))
+            for shared, original in sorted(shared_packs.items()):
+                zout.writestr(shared, zin.read(original))
+
+    saved = sum(len(p) - 1 for p in packs.values() if len(p) > 1)
+    return saved
+
+
+def expand(src, dst):
+    """Write an installable copy of a deduplicated bundle. Returns the number of packs restored."""
+    with zipfile.ZipFile(src) as zin:
+        names = zin.namelist()
+        manifests = {}
+        for pdir in platform_dirs(names):
+            manifest = json.loads(zin.read(posixpath.join(pdir, MANIFEST)).decode('utf-8'))
+            if manifest.get('resources', {}).get('shared'):
+                manifests[pdir] = manifest
+
+        with zipfile.ZipFile(dst, 'w', zipfile.ZIP_DEFLATED) as zout:
+            for name in names:
+                if name.startswith(SHARED_DIR + '/'):
+                    continue
+                if posixpath.basename(name) == MANIFEST and posixpath.dirname(name) in manifests:
+                    resources = manifests[posixpath.dirname(name)]['resources']
+                    shared = resources['name']
+                    resources['name'] = resources.pop('platform_name')
+                    del resources['shared']
+                    zout.writestr(resource_pack_path(posixpath.dirname(name), resources),
+                                  zin.read(shared))
+                    zout.writestr(name, json.dumps(manifests[posixpath.dirname(name)], indent=4,
+                                                   sort_keys=True))
+                else:
+                    zout.writestr(zin.getinfo(name), zin.read(name))
+    return len(manifests)
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument('input')
+    parser.add_argument('output')
+    parser.add_argument('--expand', action='store_true',
+                        help="restore an installable pbw from a deduplicated one")
+    args = parser.parse_args(argv)
+    if os.path.abspath(args.output) == os.path.abspath(args.input):
+        parser.error("the output has to be a different file than the input")
+
+    fd, tmp = tempfile.mkstemp(suffix='.pbw')
+    os.close(fd)
+    try:
+        if args.expand:
+            count = expand(args.input, tmp)
+        else:
+            count = dedup(args.input, tmp)
+        shutil.move(tmp, args.output)
+    except (IOError, ValueError, KeyError, zipfile.BadZipfile) as e:
+        print("error: {}".format(e), file=sys.stderr)
+        return 1
+    finally:
+        if os.path.exists(tmp):
+            os.remove(tmp)
+    if args.expand:
+        print("restored {} platform resource pack(s)".format(count))
+    else:
+        print("removed {} duplicate resource pack(s); the output is not installable, use "
+              "--expand to restore an installable pbw".format(count))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,163 @@
+#!/usr/bin/env python
+"""
+Install a pbw on many watches and emulators at once and collect their logs.
+
+Runs one `pebble install` per target at the same time, optionally followed by log streaming
+(`pebble install --logs`), and interleaves their output line by line. Each line is prefixed
+with the target it came from. When all installs have finished, or when --duration runs out
+while streaming logs, a summary of which targets succeeded is printed. A target succeeded if
+its `pebble install` exited with status 0, or if it was stopped while streaming logs after
+reporting a successful install; runs that exit with an error, are killed or do not exit fail.
+The exit status is nonzero if any target failed.
+
+Targets are given as KIND:ADDRESS, one per argument or one per line in a --targets file:
+    phone:192.168.1.20        a phone running the Pebble app with the developer connection on
+    emulator:basalt           an emulator started by the SDK for that platform
+    serial:/dev/ttyUSB0       a watch connected over a serial console
+    qemu:localhost:12344      an already running QEMU instance
+
+Usage:
+    pebble_fanout.py BUNDLE.pbw [--logs] [--duration SECONDS] [--targets FILE] [TARGET...]
+"""
+
+from __future__ import print_function
+
+import argparse
+import subprocess
+import sys
+import threading
+import time
+
+try:
+    import Queue as queue
+except ImportError:
+    import queue
+
+TARGET_FLAGS = {
+    'phone': '--phone',
+    'emulator': '--emulator',
+    'serial': '--serial',
+    'qemu': '--qemu',
+}
+
+# What `pebble install` prints once the app is on the watch, before streaming logs.
+INSTALLED_LINE = 'App install succeeded'
+
+# Seconds to wait for a stopped run to exit.
+STOP_TIMEOUT = 5
+
+
+def parse_target(spec):
+    kind, sep, address = spec.partition(':')
+    if not sep or kind not in TARGET_FLAGS or not address:
+        raise ValueError("bad target '{}', expected one of {}:ADDRESS"
+                         .format(spec, '/'.join(sorted(TARGET_FLAGS))))
+    return kind, address
+
+
+class TargetRun(object):
+    def __init__(self, args, spec, lines):
+        kind, address = parse_target(spec)
+        self.label = spec
+        self.cmd = [args.pebble, 'install', args.bundle, TARGET_FLAGS[kind], address]
+        if args.logs:
+            self.cmd.append('--logs')
+        self.lines = lines
+        self.process = None
+        self.thread = None
+        self.returncode = None
+        self.installed = False
+        self.stopped = False
+
+    def start(self):
+        self.process = subprocess.Popen(self.cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                                        universal_newlines=True)
+        self.thread = threading.Thread(target=self._pump)
+        self.thread.daemon = True
+        self.thread.start()
+
+    def _pump(self):
+        for line in iter(self.process.stdout.readline, ''):
+            if INSTALLED_LINE in line:
+                self.installed = True
+            self.lines.put((self.label, line.rstrip('\n')))
+        self.returncode = self.process.wait()
+        self.lines.put((self.label, None))
+
+    def stop(self):
+        if self.process is not None and self.returncode is None:
+            self.stopped = True
+            self.process.terminate()
+
+    def failed(self):
+        """Return whether the run failed, which includes runs that did not exit.
+
+        A run stopped while streaming logs after a successful install has not failed.
+        """
+        if self.returncode == 0:
+            return False
+        return not (self.stopped and self.installed and self.returncode is not None)
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument('bundle', help="the pbw to install")
+    parser.add_argument('targets', nargs='*', metavar='TARGET')
+    parser.add_argument('--targets', dest='targets_file', help="file with one target per line")
+    parser.add_argument('--logs', action='store_true', help="stream logs after installing")
+    parser.add_argument('--duration', type=float,
+                        help="stop streaming logs after this many seconds")
+    parser.add_argument('--pebble', default='pebble', help="the pebble tool to run")
+    args = parser.parse_args(argv)
+
+    specs = list(args.targets)
+    if args.targets_file:
+        with open(args.targets_file) as f:
+            specs += [l.strip() for l in f if l.strip() and not l.startswith('#')]
+    if not specs:
+        parser.error("no targets given")
+
+    lines = queue.Queue()
+    try:
+        runs = [TargetRun(args, spec, lines) for spec in specs]
+    except ValueError as e:
+        parser.error(str(e))
+
+    width = max(len(r.label) for r in runs)
+    deadline = time.time() + args.duration if args.duration else None
+    for run in runs:
+        run.start()
+
+    remaining = len(runs)
+    try:
+        while remaining:
+            if deadline is not None and time.time() >= deadline:
+                break
+            try:
+                # Poll so that the deadline and Ctrl-C are noticed.
+                label, line = lines.get(timeout=0.5)
+            except queue.Empty:
+                continue
+            if line is None:
+                remaining -= 1
+                continue
+            print("{:<{}} | {}".format(label, width, line))
+            sys.stdout.flush()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        for run in runs:
+            run.stop()
+        for run in runs:
+            run.thread.join(STOP_TIMEOUT)
+
+    failed = [r for r in runs if r.failed()]
+    print()
+    for run in runs:
+        status = 'FAILED' if run in failed else 'ok'
+        print("{:<{}} | {}".format(run.label, width, status))
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,169 @@
+#!/usr/bin/env python
+"""
+Precompile pebble.h for each target platform of an app.
+
+Every C file of an app includes pebble.h, which with pebble_sdk_version.h and
+gcolor_definitions.h is several thousand lines that GCC parses again for every file and every
+platform. This tool compiles it once per platform into build/<platform>/pch/pebble.h.gch, with
+the same flags the app's C files are compiled with, and prints the flags that make GCC use it:
+
+    $ pebble_pch.py basalt chalk -- $CFLAGS -Ibuild/include ...
+    -Ibuild/basalt/pch -Winvalid-pch
+    -Ibuild/chalk/pch -Winvalid-pch
+
+The flags after -- are the ones every platform shares. The SDK's platform defines, such as
+PBL_PLATFORM_BASALT and PBL_COLOR, are added for each platform, and --platform-flag adds any
+other flag that differs between platforms, such as -mcpu:
+
+    $ pebble_pch.py aplite basalt --platform-flag=basalt:-mcpu=cortex-m4 -- $CFLAGS ...
+
+What is compiled is a one-line header in the pch directory that includes pebble.h, so that
+GCC does not warn about the #pragma once of a main file, which -Werror would make fatal.
+
+GCC looks for pebble.h.gch in each include directory just before looking for pebble.h there,
+so the pch directory has to come before the SDK's include directory. A precompiled header is
+only used by files whose first line of code is `#include <pebble.h>`, and only if the file is
+compiled with the same flags; otherwise GCC parses pebble.h as usual, and -Winvalid-pch says
+why.
+
+pebble.h includes the app's generated resource_ids.auto.h and message_keys.auto.h, so the flags
+have to put them on the include path as for the app's own files. A platform is compiled again
+when the compiler, the flags or any header pebble.h includes changed, which is checked from the
+list of headers GCC recorded for the last compilation.
+
+Usage:
+    pebble_pch.py [--sdk DIR] [--build-dir DIR] [--cc CC] [-j JOBS]
+                  [--platform-flag=PLATFORM:FLAG]... PLATFORM... -- FLAGS...
+"""
+
+from __future__ import print_function
+
+import argparse
+import hashlib
+import json
+import os
+import subprocess
+import sys
+from multiprocessing.pool import ThreadPool
+
+from package_cache import compiler_version
+from platform_groups import PLATFORM_DEFINES
+
+DEFAULT_SDK = os.path.dirname(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+# Change this when the stamp format or the way keys are computed changes.
+STAMP_VERSION = 2
+
+WRAPPER = '#include <pebble.h>\n'
+
+
+def file_hash(path):
+    with open(path, 'rb') as f:
+        return hashlib.sha1(f.read()).hexdigest()
+
+
+def read_deps(path):
+    """Return the prerequisites listed in a makefile rule written by gcc -MD."""
+    with open(path) as f:
+        text = f.read().replace('\\\n', ' ')
+    text = text.split(':', 1)[1] if ': ' in text else ''
+    return [dep.replace('\0', ' ') for dep in text.replace('\\ ', '\0').split()]
+
+
+def platform_flag(value):
+    platform, sep, flag = value.partition(':')
+    if not sep or not flag:
+        raise argparse.ArgumentTypeError("expected PLATFORM:FLAG, not '{}'".format(value))
+    return platform, flag
+
+
+class Platform(object):
+    def __init__(self, platform, args):
+        self.platform = platform
+        self.header = os.path.join(args.sdk, platform, 'include', 'pebble.h')
+        self.pch_dir = os.path.join(args.build_dir, platform, 'pch')
+        self.output = os.path.join(self.pch_dir, 'pebble.h.gch')
+        self.stamp = self.output + '.json'
+        self.wrapper = os.path.join(self.pch_dir, 'pebble_pch.h')
+        self.flags = (['-D' + define for define in PLATFORM_DEFINES.get(platform, [])] +
+                      [flag for name, flag in args.platform_flags if name == platform] +
+                      args.flags)
+        self.command = ([args.cc, '-x', 'c-header'] + self.flags +
+                        ['-I', os.path.join(args.sdk, platform, 'include'),
+                         '-MD', '-MF', self.output + '.d', self.wrapper, '-o', self.output])
+        self.key = [STAMP_VERSION, compiler_version(args.cc), self.command]
+
+    def up_to_date(self):
+        if not os.path.exists(self.output) or not os.path.exists(self.stamp):
+            return False
+        with open(self.stamp) as f:
+            stamp = json.load(f)
+        if stamp.get('key') != self.key:
+            return False
+        for path, digest in stamp.get('headers', {}).items():
+            if not os.path.exists(path) or file_hash(path) != digest:
+                return False
+        return True
+
+    def build(self):
+        """Compile the header unless it is up to date. Returns True if it was compiled."""
+        if self.up_to_date():
+            return False
+        if not os.path.isdir(self.pch_dir):
+            os.makedirs(self.pch_dir)
+        with open(self.wrapper, 'w') as f:
+            f.write(WRAPPER)
+        subprocess.check_call(self.command)
+        headers = dict((path, file_hash(path)) for path in read_deps(self.output + '.d'))
+        with open(self.stamp, 'w') as f:
+            json.dump({'key': self.key, 'headers': headers}, f, indent=2, sort_keys=True,
+                      separators=(',', ': '))
+            f.write('\n')
+        return True
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument('platforms', nargs='+', metavar='PLATFORM')
+    parser.add_argument('--sdk', default=DEFAULT_SDK,
+                        help="directory with the platforms' include directories "
+                             "(default: this SDK)")
+    parser.add_argument('--build-dir', default='build')
+    parser.add_argument('--cc', default='arm-none-eabi-gcc')
+    parser.add_argument('-j', '--jobs', type=int, help="parallel compilations (default: CPUs)")
+    parser.add_argument('--platform-flag', type=platform_flag, action='append', default=[],
+                        dest='platform_flags', metavar='PLATFORM:FLAG',
+                        help="a flag for one platform only; may be given several times")
+    argv = sys.argv[1:] if argv is None else argv
+    flags = []
+    if '--' in argv:
+        argv, flags = argv[:argv.index('--')], argv[argv.index('--') + 1:]
+    args = parser.parse_args(argv)
+    args.flags = flags
+
+    try:
+        platforms = [Platform(platform, args) for platform in args.platforms]
+        for p in platforms:
+            if not os.path.exists(p.header):
+                raise ValueError("{} does not exist".format(p.header))
+        pool = ThreadPool(args.jobs or len(platforms))
+        try:
+            built = pool.map(lambda p: p.build(), platforms)
+        finally:
+            pool.close()
+            pool.join()
+    except subprocess.CalledProcessError as e:
+        print("precompiling pebble.h failed: {}".format(' '.join(e.cmd)), file=sys.stderr)
+        return 1
+    except (IOError, ValueError) as e:
+        print("error: {}".format(e), file=sys.stderr)
+        return 1
+    for p, compiled in zip(platforms, built):
+        print("{}: {}".format(p.platform, "compiled" if compiled else "up to date"),
+              file=sys.stderr)
+        print("-I{} -Winvalid-pch".format(p.pch_dir))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
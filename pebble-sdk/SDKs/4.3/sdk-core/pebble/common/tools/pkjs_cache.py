@@ -0,0 +1,139 @@
+#!/usr/bin/env python
+"""
+Skip the webpack run for PebbleKit JS bundles whose sources have not changed.
+
+webpack bundles the PebbleKit JS sources and their dependencies from scratch on every build,
+even when none of them changed. This tool wraps the bundling command. It hashes the contents of
+every input file together with the command, and if a bundle for that hash is cached, copies it
+to the output paths instead of running the command. Otherwise it runs the command and caches
+what it produced. The cache is shared with resource_cache.py's format and pruning.
+
+Rehashing node_modules on every build would cost more than it saves, so file hashes are kept
+in an index next to the cache keyed by path, size and modification time. A rebuild where
+nothing changed only stats the inputs.
+
+Usage:
+    pkjs_cache.py [--project DIR] [--input PATH]... -o OUTPUT [-o OUTPUT]... -- COMMAND...
+
+The default inputs are the project's package.json, src/pkjs, src/common, src/js and
+node_modules. Each -o names a file the command writes, such as build/pebble-js-app.js and its
+source map.
+"""
+
+from __future__ import print_function
+
+import argparse
+import hashlib
+import json
+import os
+import subprocess
+import sys
+import tempfile
+
+from resource_cache import ResourceCache
+
+DEFAULT_CACHE_DIR = os.path.join(os.path.expanduser('~'), '.pebble-sdk', 'pkjs-cache')
+DEFAULT_INPUTS = ['package.json', 'src/pkjs', 'src/common', 'src/js', 'node_modules']
+INDEX_NAME = 'hash-index.json'
+
+# Change this when the way keys are computed changes.
+CACHE_VERSION = 1
+
+
+def input_files(project, inputs):
+    for name in inputs:
+        path = os.path.join(project, name)
+        if os.path.isfile(path):
+            yield path
+        for root, dirs, files in os.walk(path):
+            dirs.sort()
+            for f in sorted(files):
+                yield os.path.join(root, f)
+
+
+class HashIndex(object):
+    """File content hashes, reused while a file's size and modification time are unchanged."""
+
+    def __init__(self, path):
+        self.path = path
+        self.dirty = False
+        try:
+            with open(path) as f:
+                self.entries = json.load(f)
+        except (IOError, ValueError):
+            self.entries = {}
+
+    def digest(self, path):
+        st = os.stat(path)
+        stamp = [st.st_size, st.st_mtime]
+        entry = self.entries.get(path)
+        if entry and entry[0] == stamp:
+            return entry[1]
+        with open(path, 'rb') as f:
+            digest = hashlib.sha1(f.read()).hexdigest()
+        self.entries[path] = [stamp, digest]
+        self.dirty = True
+        return digest
+
+    def save(self):
+        if not self.dirty:
+            return
+        fd, tmp = tempfile.mkstemp(dir=os.path.dirname(self.path))
+        with os.fdopen(fd, 'w') as f:
+            json.dump(self.entries, f)
+        os.rename(tmp, self.path)
+
+
+def bundle_key(project, inputs, command, index):
+    h = hashlib.sha1()
+    h.update(json.dumps([CACHE_VERSION, command]).encode('utf-8'))
+    for path in input_files(project, inputs):
+        rel = os.path.relpath(path, project)
+        h.update(rel.encode('utf-8'))
+        h.update(index.digest(os.path.abspath(path)).encode('ascii'))
+    return h.hexdigest()
+
+
+def main(argv=None):
+    argv = sys.argv[1:] if argv is None else argv
+    if '--' not in argv:
+        print("usage: pkjs_cache.py [options] -o OUTPUT -- COMMAND...", file=sys.stderr)
+        return 2
+    split = argv.index('--')
+    command = argv[split + 1:]
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument('--project', default='.', help="the app's project directory")
+    parser.add_argument('--input', action='append', dest='inputs',
+                        help="a file or directory the bundle depends on, relative to the project")
+    parser.add_argument('-o', '--output', action='append', required=True, dest='outputs')
+    parser.add_argument('--cache-dir', default=os.environ.get('PEBBLE_PKJS_CACHE',
+                                                              DEFAULT_CACHE_DIR))
+    parser.add_argument('--max-size', type=int, default=128,
+                        help="prune the cache to this many MB afterwards (default: 128)")
+    args = parser.parse_args(argv[:split])
+    if not command:
+        parser.error("no command given after --")
+
+    if not os.path.isdir(args.cache_dir):
+        os.makedirs(args.cache_dir)
+    cache = ResourceCache(args.cache_dir)
+    index = HashIndex(os.path.join(args.cache_dir, INDEX_NAME))
+    key = bundle_key(args.project, args.inputs or DEFAULT_INPUTS, command, index)
+    index.save()
+
+    keys = [hashlib.sha1((key + output).encode('utf-8')).hexdigest() for output in args.outputs]
+    if all(cache.get(k, output) for k, output in zip(keys, args.outputs)):
+        print("pkjs bundle unchanged, using cached build")
+        return 0
+
+    returncode = subprocess.call(command)
+    if returncode != 0:
+        return returncode
+    for k, output in zip(keys, args.outputs):
+        cache.put(k, output)
+    cache.prune(args.max_size * 1024 * 1024)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,165 @@
+#!/usr/bin/env python
+"""
+Find which platforms of a multi-platform build compile each source file identically.
+
+Every file of an app is normally compiled once per target platform, even though most files
+never use a platform macro and produce the same object every time. This tool preprocesses each
+file against the headers of every platform, hashes the result and groups platforms whose
+preprocessed output is identical. A build can then compile a file once per group and reuse the
+object for every platform in it. Files that do depend on the platform end up in several groups
+and keep their separate compiles.
+
+Results are cached together with the headers each file includes, as reported by the
+preprocessor. A file is only preprocessed again when it or one of those headers changes.
+
+Usage:
+    platform_groups.py [--platforms aplite,basalt,...] [-I DIR]... [-D NAME[=VALUE]]...
+                       [--cache FILE] [--output FILE] SOURCE...
+
+The output is a JSON object mapping each source file to a list of platform groups, e.g.
+    {"src/c/main.c": [["aplite", "diorite"], ["basalt", "chalk", "emery"]]}
+Objects shared this way differ from separately built ones only in the header paths recorded
+in their debug information.
+"""
+
+from __future__ import print_function
+
+import argparse
+import hashlib
+import json
+import os
+import subprocess
+import sys
+import tempfile
+
+SDK_ROOT = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..'))
+
+PLATFORMS = ['aplite', 'basalt', 'chalk', 'diorite', 'emery']
+
+# The platform defines passed to the compiler by the SDK build.
+PLATFORM_DEFINES = {
+    'aplite': ['PBL_PLATFORM_APLITE', 'PBL_BW', 'PBL_RECT', 'PBL_COMPASS',
+               'PBL_DISPLAY_WIDTH=144', 'PBL_DISPLAY_HEIGHT=168'],
+    'basalt': ['PBL_PLATFORM_BASALT', 'PBL_COLOR', 'PBL_RECT', 'PBL_MICROPHONE',
+               'PBL_SMARTSTRAP', 'PBL_HEALTH', 'PBL_COMPASS',
+               'PBL_DISPLAY_WIDTH=144', 'PBL_DISPLAY_HEIGHT=168'],
+    'chalk': ['PBL_PLATFORM_CHALK', 'PBL_COLOR', 'PBL_ROUND', 'PBL_MICROPHONE',
+              'PBL_SMARTSTRAP', 'PBL_HEALTH', 'PBL_COMPASS',
+              'PBL_DISPLAY_WIDTH=180', 'PBL_DISPLAY_HEIGHT=180'],
+    'diorite': ['PBL_PLATFORM_DIORITE', 'PBL_BW', 'PBL_RECT', 'PBL_MICROPHONE',
+                'PBL_SMARTSTRAP', 'PBL_HEALTH',
+                'PBL_DISPLAY_WIDTH=144', 'PBL_DISPLAY_HEIGHT=168'],
+    'emery': ['PBL_PLATFORM_EMERY', 'PBL_COLOR', 'PBL_RECT', 'PBL_MICROPHONE',
+              'PBL_SMARTSTRAP', 'PBL_HEALTH', 'PBL_COMPASS',
+              'PBL_DISPLAY_WIDTH=200', 'PBL_DISPLAY_HEIGHT=228'],
+}
+
+CACHE_VERSION = 1
+
+
+def parse_depfile(path):
+    with open(path) as f:
+        text = f.read().replace('\\\n', ' ')
+    _, _, deps = text.partition(':')
+    return sorted(set(d for d in deps.split() if d))
+
+
+def preprocess(args, source, platform):
+    """Return the hash of the preprocessed source and the files it read."""
+    fd, depfile = tempfile.mkstemp(suffix='.d')
+    os.close(fd)
+    cmd = [args.cc, '-E', '-P', '-MD', '-MF', depfile, '-std=c99']
+    cmd += ['-D' + d for d in PLATFORM_DEFINES.get(platform, []) + args.define]
+    cmd += ['-I' + os.path.join(SDK_ROOT, platform, 'include')]
+    cmd += ['-I' + d for d in args.include]
+    cmd += [source]
+    try:
+        output = subprocess.check_output(cmd)
+        deps = parse_depfile(depfile)
+    finally:
+        os.remove(depfile)
+    return hashlib.sha1(output).hexdigest(), deps
+
+
+def snapshot(paths):
+    stamps = {}
+    for path in paths:
+        try:
+            stamps[path] = os.path.getmtime(path)
+        except OSError:
+            stamps[path] = None
+    return stamps
+
+
+def group_source(args, source):
+    by_hash = {}
+    deps = set([source])
+    for platform in args.platforms:
+        digest, platform_deps = preprocess(args, source, platform)
+        by_hash.setdefault(digest, []).append(platform)
+        deps.update(platform_deps)
+    groups = sorted(by_hash.values(), key=lambda g: args.platforms.index(g[0]))
+    return groups, snapshot(deps)
+
+
+def load_cache(path, key):
+    if not path or not os.path.exists(path):
+        return {}
+    try:
+        with open(path) as f:
+            cache = json.load(f)
+    except ValueError:
+        return {}
+    if cache.get('version') != CACHE_VERSION or cache.get('key') != key:
+        return {}
+    return cache.get('sources', {})
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument('sources', nargs='+', metavar='SOURCE')
+    parser.add_argument('--platforms', default=','.join(PLATFORMS),
+                        help="comma-separated target platforms (default: all)")
+    parser.add_argument('--cc', default='arm-none-eabi-gcc', help="the compiler to preprocess with")
+    parser.add_argument('-I', dest='include', action='append', default=[],
+                        help="additional include directory, such as the build directory")
+    parser.add_argument('-D', dest='define', action='append', default=[],
+                        help="additional define for every platform")
+    parser.add_argument('--cache', help="file to keep results in between builds")
+    parser.add_argument('--output', help="write the groups here instead of to stdout")
+    args = parser.parse_args(argv)
+    args.platforms = [p for p in args.platforms.split(',') if p]
+
+    for platform in args.platforms:
+        if not os.path.isdir(os.path.join(SDK_ROOT, platform, 'include')):
+            parser.error("unknown platform '{}'".format(platform))
+
+    # Cached results are only valid for the same compiler, flags and platforms.
+    key = hashlib.sha1(json.dumps([args.cc, args.platforms, args.include, args.define])
+                       .encode('utf-8')).hexdigest()
+    cached = load_cache(args.cache, key)
+
+    results = {}
+    for source in args.sources:
+        entry = cached.get(source)
+        if entry is None or snapshot(entry['deps']) != entry['deps']:
+            groups, deps = group_source(args, source)
+            entry = {'groups': groups, 'deps': deps}
+        results[source] = entry
+
+    if args.cache:
+        with open(args.cache, 'w') as f:
+            json.dump({'version': CACHE_VERSION, 'key': key, 'sources': results}, f)
+
+    groups = dict((source, entry['groups']) for source, entry in results.items())
+    if args.output:
+        with open(args.output, 'w') as f:
+            json.dump(groups, f, indent=2, sort_keys=True)
+    else:
+        json.dump(groups, sys.stdout, indent=2, sort_keys=True)
+        print()
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
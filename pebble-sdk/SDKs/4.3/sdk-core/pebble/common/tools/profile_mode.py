@@ -0,0 +1,90 @@
+#!/usr/bin/env python
+"""
+Recover libstdc++ profile mode trace files from an app log.
+
+C++ apps built with -D_GLIBCXX_PROFILE -D_GLIBCXX_PROFILE_LOG_OUTPUT write the profile mode
+trace files to the app log instead of the file system, see profile/impl/profiler_log.h in the
+toolchain's C++ headers. The app calls __profcxx_report() from its deinit function; run it in the
+emulator with "pebble logs" saved to a file, then point this tool at the log:
+
+    pebble install --emulator basalt --logs > app.log
+    profile_mode.py app.log
+
+This writes libstdcxx-profile.txt with the advice for the worst container uses, the raw
+per-diagnostic data in libstdcxx-profile.raw and the cost factors in
+libstdcxx-profile.conf.out, the same files a desktop build writes. If the app reported more than
+once, the last complete report wins. The advice is also printed.
+
+Usage:
+    profile_mode.py [--output-dir DIR] [--quiet] [LOG]
+"""
+
+from __future__ import print_function
+
+import argparse
+import os
+import re
+import sys
+
+LINE = re.compile(r'(?P<name>[\w.-]+\.(?:txt|raw|conf\.out))(?:(?P<sep>[:+]) (?P<text>.*)'
+                  r'| (?P<marker>begin|end))$')
+
+
+def parse_log(lines):
+    """Return the complete trace files found in a log, mapped from name to text."""
+    files = {}
+    open_files = {}
+    for line in lines:
+        match = LINE.search(line.rstrip('\r\n'))
+        if not match:
+            continue
+        name = match.group('name')
+        marker = match.group('marker')
+        if marker == 'begin':
+            open_files[name] = []
+        elif name not in open_files:
+            # Lines of a file whose beginning was not logged.
+            continue
+        elif marker == 'end':
+            files[name] = ''.join(line + '\n' for line in open_files.pop(name))
+        elif match.group('sep') == '+' and open_files[name]:
+            open_files[name][-1] += match.group('text')
+        else:
+            open_files[name].append(match.group('text'))
+    return files
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument('log', nargs='?', help="saved output of pebble logs (default: stdin)")
+    parser.add_argument('--output-dir', default='.',
+                        help="directory the trace files are written to (default: .)")
+    parser.add_argument('--quiet', action='store_true', help="do not print the advice")
+    args = parser.parse_args(argv)
+
+    try:
+        if args.log:
+            with open(args.log) as f:
+                files = parse_log(f)
+        else:
+            files = parse_log(sys.stdin)
+    except IOError as e:
+        print("error: {}".format(e), file=sys.stderr)
+        return 1
+    if not files:
+        print("error: {}: no complete profile mode report found; does the app call "
+              "__profcxx_report()?".format(args.log or 'stdin'), file=sys.stderr)
+        return 1
+
+    for name in sorted(files):
+        with open(os.path.join(args.output_dir, name), 'w') as f:
+            f.write(files[name])
+    if not args.quiet:
+        for name in sorted(files):
+            if name.endswith('.txt'):
+                sys.stdout.write(files[name] or "{}: no advice\n".format(name))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,263 @@
+#!/usr/bin/env python
+"""
+Content-addressed cache and parallel runner for resource conversion.
+
+Converting the images in resources.media to PBI, PNG8 or PDC for every target platform is the
+slowest part of most app builds, and nearly all of it repeats work done by an earlier build.
+This tool runs each conversion at most once for a given input. The cache key is a hash of the
+input files' contents, the target platform, the conversion command and the converter, with the
+output path left out. A conversion whose key is already cached is satisfied by copying the
+cached output.
+
+The converter is identified by the contents of the command's program, found on PATH, and of
+every other file the command names, such as the script run by "python". A converter that is
+made of more files than these can give its version as "converter_version" in the job instead.
+A fixed converter then converts everything again instead of serving old outputs.
+
+Conversions that are not cached run in parallel, one worker per CPU by default, so the five
+platforms of an app are converted at the same time. The cache directory can be shared by every
+project on a machine, so CI jobs that build many apps benefit from each other's results.
+
+The jobs are read as a JSON list, from a file or stdin:
+    [{"platform": "basalt", "inputs": ["resources/images/bg.png"], "output": "build/bg.pbi",
+      "command": ["png2pbi", "--platform", "basalt", "{inputs}", "{output}"]}, ...]
+"{inputs}" expands to the input paths and "{output}" to the output path.
+
+After the conversions the cache is pruned to --max-size, least recently used entries first.
+Entries used or written in the last hour are kept, since a concurrent build may be about to copy
+them.
+
+Usage:
+    resource_cache.py [--cache-dir DIR] [-j JOBS] [--max-size MB] [JOBFILE]
+"""
+
+from __future__ import print_function
+
+import argparse
+import errno
+import hashlib
+import json
+import multiprocessing
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+from multiprocessing.pool import ThreadPool
+
+DEFAULT_CACHE_DIR = os.path.join(os.path.expanduser('~'), '.pebble-sdk', 'resource-cache')
+
+# Change this when the cache layout or the way keys are computed changes.
+CACHE_VERSION = 2
+
+# Entries younger than this are not pruned, and neither are temporary files, which may belong
+# to a build that is still writing them.
+PRUNE_MIN_AGE = 60 * 60
+TMP_PREFIX = '.tmp-'
+
+_file_hashes = {}
+_file_hash_lock = threading.Lock()
+
+
+def _which(program):
+    if os.path.dirname(program):
+        return program
+    for directory in os.environ.get('PATH', '').split(os.pathsep):
+        path = os.path.join(directory, program)
+        if os.path.isfile(path) and os.access(path, os.X_OK):
+            return path
+    return None
+
+
+def _file_hash(path):
+    st = os.stat(path)
+    stamp = (os.path.abspath(path), st.st_size, st.st_mtime)
+    with _file_hash_lock:
+        if stamp not in _file_hashes:
+            with open(path, 'rb') as f:
+                _file_hashes[stamp] = hashlib.sha1(f.read()).hexdigest()
+        return _file_hashes[stamp]
+
+
+def converter_version(job):
+    """Identify the converter a job runs, so that a changed converter misses the cache."""
+    if 'converter_version' in job:
+        return job['converter_version']
+    command = job['command']
+    program = _which(command[0])
+    if program is None:
+        raise ValueError("cannot find the converter '{}'".format(command[0]))
+    paths = [program] + [arg for arg in command[1:] if '{' not in arg and os.path.isfile(arg)]
+    return [_file_hash(path) for path in paths]
+
+
+class ResourceCache(object):
+    def __init__(self, cache_dir):
+        self.cache_dir = cache_dir
+
+    def key(self, job):
+        h = hashlib.sha1()
+        h.update(json.dumps([CACHE_VERSION, job['platform'], job['command'],
+                             converter_version(job)]).encode('utf-8'))
+        for path in job['inputs']:
+            with open(path, 'rb') as f:
+                h.update(hashlib.sha1(f.read()).digest())
+        return h.hexdigest()
+
+    def _path(self, key):
+        return os.path.join(self.cache_dir, key[:2], key)
+
+    def get(self, key, output):
+        """Copy the cached result for key to output. Returns False on a cache miss."""
+        path = self._path(key)
+        if not os.path.exists(path):
+            return False
+        try:
+            _copy(path, output)
+            # Keep recently used entries from being pruned.
+            os.utime(path, None)
+        except (IOError, OSError) as e:
+            # Pruned by another build since the check.
+            if e.errno != errno.ENOENT:
+                raise
+            return False
+        return True
+
+    def put(self, key, output):
+        path = self._path(key)
+        if not os.path.isdir(os.path.dirname(path)):
+            try:
+                os.makedirs(os.path.dirname(path))
+            except OSError:
+                pass
+        # Write atomically, as several builds may share the cache.
+        fd, tmp = tempfile.mkstemp(prefix=TMP_PREFIX, dir=os.path.dirname(path))
+        os.close(fd)
+        try:
+            shutil.copyfile(output, tmp)
+            os.rename(tmp, path)
+        finally:
+            if os.path.exists(tmp):
+                os.remove(tmp)
+
+    def _entries(self):
+        """Yield (mtime, size, path) of the files in the key directories."""
+        if not os.path.isdir(self.cache_dir):
+            return
+        for prefix in sorted(os.listdir(self.cache_dir)):
+            directory = os.path.join(self.cache_dir, prefix)
+            if len(prefix) != 2 or not os.path.isdir(directory):
+                continue
+            for name in os.listdir(directory):
+                path = os.path.join(directory, name)
+                try:
+                    st = os.stat(path)
+                except OSError:
+                    continue
+                yield st.st_mtime, st.st_size, path
+
+    def prune(self, max_bytes, min_age=PRUNE_MIN_AGE):
+        """Remove the least recently used entries until the cache fits in max_bytes.
+
+        Entries used or written less than min_age seconds ago are kept even if the cache stays
+        larger than max_bytes. Temporary files older than that are left over from failed builds
+        and are removed.
+        """
+        cutoff = time.time() - min_age
+        entries = []
+        for mtime, size, path in self._entries():
+            if os.path.basename(path).startswith(TMP_PREFIX):
+                if mtime < cutoff:
+                    _remove(path)
+            else:
+                entries.append((mtime, size, path))
+        total = sum(size for _, size, _ in entries)
+        for mtime, size, path in sorted(entries):
+            if total <= max_bytes or mtime >= cutoff:
+                break
+            _remove(path)
+            total -= size
+
+
+def _remove(path):
+    try:
+        os.remove(path)
+    except OSError as e:
+        # Another build may have pruned it first.
+        if e.errno != errno.ENOENT:
+            raise
+
+
+def _copy(src, dst):
+    if os.path.dirname(dst) and not os.path.isdir(os.path.dirname(dst)):
+        os.makedirs(os.path.dirname(dst))
+    shutil.copyfile(src, dst)
+
+
+def expand_command(job):
+    cmd = []
+    for arg in job['command']:
+        if arg == '{inputs}':
+            cmd.extend(job['inputs'])
+        else:
+            cmd.append(arg.replace('{output}', job['output']))
+    return cmd
+
+
+def run_job(cache, job):
+    """Produce job['output'], from the cache if possible. Returns True on a cache hit."""
+    key = cache.key(job)
+    if cache.get(key, job['output']):
+        return True
+    if os.path.dirname(job['output']) and not os.path.isdir(os.path.dirname(job['output'])):
+        os.makedirs(os.path.dirname(job['output']))
+    subprocess.check_call(expand_command(job))
+    cache.put(key, job['output'])
+    return False
+
+
+def run_jobs(cache, jobs, workers=None):
+    """Run jobs in parallel. Returns the number of cache hits."""
+    pool = ThreadPool(workers or multiprocessing.cpu_count())
+    try:
+        hits = pool.map(lambda job: run_job(cache, job), jobs)
+    finally:
+        pool.close()
+        pool.join()
+    return sum(1 for hit in hits if hit)
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument('jobfile', nargs='?', help="JSON list of jobs (default: stdin)")
+    parser.add_argument('--cache-dir', default=os.environ.get('PEBBLE_RESOURCE_CACHE',
+                                                              DEFAULT_CACHE_DIR))
+    parser.add_argument('-j', '--jobs', type=int, help="parallel conversions (default: CPUs)")
+    parser.add_argument('--max-size', type=int, default=512,
+                        help="prune the cache to this many MB afterwards (default: 512)")
+    args = parser.parse_args(argv)
+
+    if args.jobfile:
+        with open(args.jobfile) as f:
+            jobs = json.load(f)
+    else:
+        jobs = json.load(sys.stdin)
+
+    cache = ResourceCache(args.cache_dir)
+    try:
+        hits = run_jobs(cache, jobs, args.jobs)
+    except subprocess.CalledProcessError as e:
+        print("resource conversion failed: {}".format(' '.join(e.cmd)), file=sys.stderr)
+        return 1
+    except (IOError, ValueError) as e:
+        print("error: {}".format(e), file=sys.stderr)
+        return 1
+    cache.prune(args.max_size * 1024 * 1024)
+    print("{} resources, {} from cache".format(len(jobs), hits))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,100 @@
+#!/usr/bin/env node
+/*
+ * Shrink a Rocky.js app bundle before it is packaged, so the watch parses less at launch.
+ *
+ * The watch parses and compiles the app's JavaScript every time the app starts, and the parser
+ * keeps the source, its identifiers and the syntax tree on the small Rocky heap while it does.
+ * This step runs the webpack output through the SDK's uglify-js with settings that suit the
+ * engine: dead code and debugger statements are dropped, constant expressions are folded and
+ * all identifiers that are not properties are shortened, which shrinks the identifier table.
+ *
+ * With --snapshot, the minified source is then compiled into a bytecode snapshot by the
+ * JerryScript snapshot tool given, so that the watch can skip parsing entirely. Snapshots only
+ * load on firmware built from the same JerryScript version as the tool.
+ *
+ * Usage:
+ *   rocky_precompile.js IN.js OUT.js [--snapshot JERRY_SNAPSHOT_TOOL] [--keep-names]
+ *
+ * Run it on build/rocky-app.js after `pebble build` compiled the JavaScript and before the pbw is
+ * bundled, or as a separate step followed by `pebble build` with the result in place.
+ */
+
+'use strict';
+
+var childProcess = require('child_process');
+var fs = require('fs');
+var UglifyJS = require('uglify-js');
+
+// Names the Rocky runtime looks up in the app's global scope.
+var RESERVED_NAMES = ['require', 'module', 'exports', 'rocky', '_rocky'];
+
+function usage() {
+  console.error('usage: rocky_precompile.js IN.js OUT.js [--snapshot TOOL] [--keep-names]');
+  process.exit(2);
+}
+
+function parseArgs(argv) {
+  var args = {files: [], snapshot: null, keepNames: false};
+  for (var i = 0; i < argv.length; i++) {
+    if (argv[i] === '--snapshot') {
+      args.snapshot = argv[++i];
+      if (!args.snapshot) {
+        usage();
+      }
+    } else if (argv[i] === '--keep-names') {
+      args.keepNames = true;
+    } else {
+      args.files.push(argv[i]);
+    }
+  }
+  if (args.files.length !== 2) {
+    usage();
+  }
+  return args;
+}
+
+function minify(source, keepNames) {
+  return UglifyJS.minify(source, {
+    fromString: true,
+    compress: {
+      dead_code: true,
+      drop_debugger: true,
+      evaluate: true,
+      sequences: true,
+      unused: true,
+      // The engine checks property access strictly, so getters must not be assumed pure.
+      pure_getters: false,
+      unsafe: false,
+      global_defs: {DEBUG: false}
+    },
+    mangle: keepNames ? false : {toplevel: false, except: RESERVED_NAMES},
+    output: {ascii_only: true, comments: false}
+  }).code;
+}
+
+function main() {
+  var args = parseArgs(process.argv.slice(2));
+  var input = args.files[0];
+  var output = args.files[1];
+  var source = fs.readFileSync(input, 'utf8');
+  var code = minify(source, args.keepNames);
+
+  if (args.snapshot) {
+    var tmp = output + '.min.js';
+    fs.writeFileSync(tmp, code);
+    var result = childProcess.spawnSync(args.snapshot,
+        ['--save-snapshot-for-global', output, tmp], {stdio: 'inherit'});
+    fs.unlinkSync(tmp);
+    if (result.error || result.status !== 0) {
+      console.error('error: snapshot tool failed' +
+                    (result.error ? ': ' + result.error.message : ''));
+      process.exit(1);
+    }
+  } else {
+    fs.writeFileSync(output, code);
+  }
+  console.log(input + ': ' + Buffer.byteLength(source) + ' -> ' + fs.statSync(output).size +
+              ' bytes');
+}
+
+main();
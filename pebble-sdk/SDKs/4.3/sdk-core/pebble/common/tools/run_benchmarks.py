@@ -0,0 +1,241 @@
+#!/usr/bin/env python
+"""
+Run the SDK benchmark app on emulators or watches and collect its results as JSON.
+
+The benchmark app in common/benchmarks times drawing, text, dictionary, persistent storage,
+animation and AppMessage operations with the Profiling cycle counter, and logs one line per
+benchmark:
+
+    BENCH <name> <iterations> <total cycles> <cycles per second>
+
+followed by BENCH_DONE once every benchmark has run. This tool builds the app with the pebble
+tool, installs it on each target with log streaming on, and parses those lines until
+BENCH_DONE or the timeout. The results are written as JSON:
+
+    {"basalt": {"gpath_draw_filled": {"iterations": 100, "cycles": ...,
+                                      "us_per_iteration": ...}, ...}, ...}
+
+Targets are given as KIND:ADDRESS, as for pebble_fanout.py. A bare platform name is treated as
+emulator:PLATFORM. Without targets, every platform in the app's package.json is run in the
+emulator.
+
+Usage:
+    run_benchmarks.py [--no-build] [--timeout SECONDS] [-o RESULTS.json] [--sdk VERSION]...
+                      [--baseline RESULTS.json] [--threshold PERCENT] [TARGET...]
+
+With --sdk, given once for each installed SDK to run, the app is cleaned, built and run with
+each of them in turn, and the results are grouped by SDK: {"3.9": {"basalt": ...}, ...}.
+Emulator targets of platforms an SDK does not have are left out for it. SDKs before 4.3 have
+no cycle counter, so the app times them with the milliseconds clock, which is only precise
+enough for the slower benchmarks.
+
+Each benchmark's time per iteration is compared with --baseline, a results file of the same
+shape from an earlier run, or with --sdk and no baseline, with the results of the first SDK
+given that built. Benchmarks that got slower by more than --threshold percent are listed as regressions.
+
+The exit status is nonzero if any target failed to report BENCH_DONE or any benchmark
+regressed, so the results can gate SDK and firmware rollouts in CI.
+"""
+
+from __future__ import print_function
+
+import argparse
+import json
+import os
+import re
+import subprocess
+import sys
+import threading
+
+BENCHMARKS_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), os.pardir, 'benchmarks')
+SDKS_DIR = os.path.join(os.path.expanduser('~'), '.pebble-sdk', 'SDKs')
+
+TARGET_FLAGS = {
+    'phone': '--phone',
+    'emulator': '--emulator',
+    'serial': '--serial',
+    'qemu': '--qemu',
+}
+
+BENCH_LINE = re.compile(r'\bBENCH (\S+) (\d+) (\d+) (\d+)\s*$')
+SKIPPED_LINE = re.compile(r'\bBENCH_SKIPPED (\S+)')
+DONE_LINE = re.compile(r'\bBENCH_DONE\b')
+
+
+def parse_target(spec):
+    kind, sep, address = spec.partition(':')
+    if not sep:
+        return 'emulator', spec
+    if kind not in TARGET_FLAGS or not address:
+        raise ValueError("bad target '{}', expected PLATFORM or one of {}:ADDRESS"
+                         .format(spec, '/'.join(sorted(TARGET_FLAGS))))
+    return kind, address
+
+
+def parse_results(lines):
+    """Return (results, skipped, done) for the app's log lines."""
+    results = {}
+    skipped = []
+    for line in lines:
+        m = BENCH_LINE.search(line)
+        if m:
+            name, iterations, cycles, cps = m.group(1), int(m.group(2)), int(m.group(3)), \
+                int(m.group(4))
+            result = {'iterations': iterations, 'cycles': cycles}
+            if iterations and cps:
+                result['us_per_iteration'] = round(cycles * 1e6 / cps / iterations, 3)
+            results[name] = result
+            continue
+        m = SKIPPED_LINE.search(line)
+        if m:
+            skipped.append(m.group(1))
+            continue
+        if DONE_LINE.search(line):
+            return results, skipped, True
+    return results, skipped, False
+
+
+def sdk_args(sdk):
+    return ['--sdk', sdk] if sdk else []
+
+
+def sdk_has_target(sdks_dir, sdk, spec):
+    """Return False for emulator targets of platforms that an installed SDK does not have."""
+    kind, address = parse_target(spec)
+    platforms_dir = os.path.join(sdks_dir, sdk, 'sdk-core', 'pebble')
+    if kind != 'emulator' or not os.path.isdir(platforms_dir):
+        return True
+    return os.path.isdir(os.path.join(platforms_dir, address))
+
+
+def find_regressions(baseline, report, threshold):
+    """Return (target, benchmark, old us, new us, percent) for benchmarks slower than threshold."""
+    regressions = []
+    for spec, results in sorted(report.items()):
+        for name, result in sorted(results.items()):
+            old = baseline.get(spec, {}).get(name, {}).get('us_per_iteration')
+            new = result.get('us_per_iteration')
+            if old and new and (new - old) * 100.0 / old > threshold:
+                regressions.append((spec, name, old, new, (new - old) * 100.0 / old))
+    return regressions
+
+
+def run_target(args, spec, project, sdk=None):
+    kind, address = parse_target(spec)
+    cmd = [args.pebble, 'install', TARGET_FLAGS[kind], address, '--logs'] + sdk_args(sdk)
+    process = subprocess.Popen(cmd, cwd=project, stdout=subprocess.PIPE,
+                               stderr=subprocess.STDOUT, universal_newlines=True)
+    # The app never exits on its own, so stop streaming once it is done or the time is up.
+    timer = threading.Timer(args.timeout, process.terminate)
+    timer.start()
+
+    def lines():
+        for line in iter(process.stdout.readline, ''):
+            if args.verbose:
+                print("{} | {}".format(spec, line.rstrip('\n')), file=sys.stderr)
+            yield line
+
+    try:
+        results, skipped, done = parse_results(lines())
+    finally:
+        timer.cancel()
+        if process.poll() is None:
+            process.terminate()
+        process.wait()
+    return results, skipped, done
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument('targets', nargs='*', metavar='TARGET')
+    parser.add_argument('--project', default=BENCHMARKS_DIR, help="the benchmark app to run")
+    parser.add_argument('--no-build', action='store_true', help="install the existing build")
+    parser.add_argument('--timeout', type=float, default=120,
+                        help="seconds to wait for each target to finish")
+    parser.add_argument('-o', '--output', help="write the results here instead of stdout")
+    parser.add_argument('--pebble', default='pebble', help="the pebble tool to run")
+    parser.add_argument('-v', '--verbose', action='store_true', help="echo the app's logs")
+    parser.add_argument('--sdk', action='append', dest='sdks', metavar='VERSION',
+                        help="run with this installed SDK; may be given several times")
+    parser.add_argument('--sdks-dir', default=SDKS_DIR,
+                        help="where the pebble tool installs SDKs (default: ~/.pebble-sdk/SDKs)")
+    parser.add_argument('--baseline', help="earlier results to compare with")
+    parser.add_argument('--threshold', type=float, default=10,
+                        help="percent a benchmark may slow down before it counts as a regression "
+                             "(default: 10)")
+    args = parser.parse_args(argv)
+
+    project = os.path.abspath(args.project)
+    specs = args.targets
+    if not specs:
+        with open(os.path.join(project, 'package.json')) as f:
+            specs = json.load(f)['pebble']['targetPlatforms']
+    try:
+        for spec in specs:
+            parse_target(spec)
+    except ValueError as e:
+        parser.error(str(e))
+
+    baseline = None
+    if args.baseline:
+        try:
+            with open(args.baseline) as f:
+                baseline = json.load(f)
+        except (IOError, ValueError) as e:
+            print("error: {}: {}".format(args.baseline, e), file=sys.stderr)
+            return 1
+
+    report = {}
+    failed = []
+    regressions = []
+    for sdk in args.sdks or [None]:
+        label = "{} ".format(sdk) if sdk else ""
+        if sdk and not args.no_build:
+            subprocess.call([args.pebble, 'clean'], cwd=project)
+        if not args.no_build and subprocess.call([args.pebble, 'build'] + sdk_args(sdk),
+                                                 cwd=project) != 0:
+            print("error: {}build failed".format(label), file=sys.stderr)
+            if not sdk:
+                return 1
+            failed.append(sdk)
+            continue
+        sdk_report = {}
+        for spec in specs:
+            if sdk and not sdk_has_target(args.sdks_dir, sdk, spec):
+                continue
+            results, skipped, done = run_target(args, spec, project, sdk)
+            sdk_report[spec] = results
+            if skipped:
+                print("{}{}: skipped {}".format(label, spec, ', '.join(skipped)), file=sys.stderr)
+            if not done:
+                print("{}{}: did not finish within {}s".format(label, spec, args.timeout),
+                      file=sys.stderr)
+                failed.append(label + spec)
+        if sdk:
+            report[sdk] = sdk_report
+            # Without a baseline, SDKs are compared with the first one that built.
+            first = next(s for s in args.sdks if s in report)
+            reference = baseline.get(sdk, {}) if baseline else report[first]
+        else:
+            report = sdk_report
+            reference = baseline or {}
+        regressions += [(label + spec, name, old, new, percent) for spec, name, old, new, percent
+                        in find_regressions(reference, sdk_report, args.threshold)]
+    if args.sdks and not report:
+        print("error: no SDK built the benchmark app", file=sys.stderr)
+        return 1
+
+    output = json.dumps(report, indent=2, sort_keys=True, separators=(',', ': '))
+    if args.output:
+        with open(args.output, 'w') as f:
+            f.write(output + '\n')
+    else:
+        print(output)
+    for spec, name, old, new, percent in regressions:
+        print("{} {}: regressed from {}us to {}us per iteration (+{:.1f}%)"
+              .format(spec, name, old, new, percent), file=sys.stderr)
+    return 1 if failed or regressions else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
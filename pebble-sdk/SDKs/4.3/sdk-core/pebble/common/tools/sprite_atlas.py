@@ -0,0 +1,242 @@
+#!/usr/bin/env python
+"""
+Pack the icons of an app into one sprite atlas bitmap per platform, with their rectangles.
+
+Every bitmap resource costs a resource table entry, a bitmap header and a separate
+gbitmap_create_with_resource() load, with its own heap block. An app with dozens of small icons
+opens windows faster and fragments the heap less if it loads a single bitmap and creates the
+icons as sub-bitmaps of it. This tool does the packing when the icons change. An atlas is a
+bitmap entry in resources.media of package.json that lists its sprites:
+
+    {"type": "bitmap", "name": "ICONS", "file": "atlas/icons.png",
+     "sprites": ["images/play.png", "images/pause.png",
+                 {"name": "NEXT", "file": "images/skip.png"}]}
+
+Sprite files are relative to the resources directory and are resolved for each platform the
+way the SDK resolves resource files, so images/play~bw.png or images/play~chalk.png replace
+images/play.png where they exist. For each target platform the sprites are packed into
+resources/atlas/icons~<platform>.png, which the SDK then builds as the ICONS resource for that
+platform, and the position of each sprite is written to a header:
+
+    #define ICONS_PLAY GRect(0, 0, 24, 24)
+
+A sprite's name is its "name", or its file name in upper case. In the app:
+
+    #include "sprite_atlas.auto.h"
+
+    s_icons = gbitmap_create_with_resource(RESOURCE_ID_ICONS);
+    s_play = gbitmap_create_as_sub_bitmap(s_icons, ICONS_PLAY);
+
+Usage:
+    sprite_atlas.py [--project DIR] [--header FILE] [--padding PIXELS] [--list]
+
+Run it before `pebble build` whenever a sprite changes. Files whose content would not change are
+not rewritten, so running it on every build does not cause resources to be rebuilt. With --list,
+the layout of each atlas is printed instead of written.
+"""
+
+from __future__ import print_function
+
+import argparse
+import json
+import os
+import re
+import struct
+import sys
+import zlib
+
+from dither import PNG_SIGNATURE, read_png
+
+PLATFORMS = {'aplite': ('bw', 'rect'), 'basalt': ('color', 'rect'), 'chalk': ('color', 'round'),
+             'diorite': ('bw', 'rect'), 'emery': ('color', 'rect')}
+PLATFORM_MACRO = 'PBL_PLATFORM_{}'
+
+
+class AtlasError(Exception):
+    pass
+
+
+def platform_file(resources_dir, path, platform):
+    """Return the file the SDK would use for path on a platform, most specific tag first."""
+    base, ext = os.path.splitext(path)
+    for tag in (platform,) + PLATFORMS[platform]:
+        tagged = os.path.join(resources_dir, '{}~{}{}'.format(base, tag, ext))
+        if os.path.exists(tagged):
+            return tagged
+    return os.path.join(resources_dir, path)
+
+
+def sprite_name(sprite):
+    if isinstance(sprite, dict):
+        if 'name' in sprite:
+            return sprite['name']
+        sprite = sprite['file']
+    name = os.path.splitext(os.path.basename(sprite))[0].split('~')[0]
+    return re.sub(r'\W', '_', name).upper()
+
+
+def pack(sizes, padding):
+    """Return (width, height, [(x, y)]) of a shelf packing of sizes, with the smallest area.
+
+    Sprites are placed tallest first on rows as wide as the atlas; every width from the widest
+    sprite to all sprites side by side is tried, and squarer atlases win ties.
+    """
+    order = sorted(range(len(sizes)), key=lambda i: (-sizes[i][1], -sizes[i][0]))
+    widest = max(w for w, _ in sizes)
+    best = None
+    for width in range(widest, sum(w + padding for w, _ in sizes) + 1):
+        x = y = shelf = used = 0
+        positions = [None] * len(sizes)
+        for i in order:
+            w, h = sizes[i]
+            if x and x + w > width:
+                x, y, shelf = 0, y + shelf + padding, 0
+            positions[i] = (x, y)
+            used = max(used, x + w)
+            x += w + padding
+            shelf = max(shelf, h)
+        height = y + shelf
+        key = (used * height, abs(used - height))
+        if best is None or key < best[0]:
+            best = (key, used, height, positions)
+    return best[1], best[2], best[3]
+
+
+def write_png(width, height, pixels):
+    """Return an 8-bit RGBA PNG of rows of (r, g, b, a) tuples."""
+    raw = bytearray()
+    for row in pixels:
+        raw.append(0)
+        for pixel in row:
+            raw.extend(pixel)
+
+    def chunk(kind, body):
+        return (struct.pack('>I', len(body)) + kind + body +
+                struct.pack('>I', zlib.crc32(kind + body) & 0xffffffff))
+
+    return (PNG_SIGNATURE +
+            chunk(b'IHDR', struct.pack('>IIBBBBB', width, height, 8, 6, 0, 0, 0)) +
+            chunk(b'IDAT', zlib.compress(bytes(raw), 9)) + chunk(b'IEND', b''))
+
+
+def build_atlas(resources_dir, entry, platform, padding):
+    """Return (png, [(name, (x, y, w, h))]) of an atlas entry on a platform."""
+    sprites = entry['sprites']
+    names = [sprite_name(sprite) for sprite in sprites]
+    duplicates = sorted(set(name for name in names if names.count(name) > 1))
+    if duplicates:
+        raise AtlasError("atlas {} has more than one sprite named {}"
+                         .format(entry['name'], ', '.join(duplicates)))
+    images = []
+    for sprite in sprites:
+        path = platform_file(resources_dir, sprite['file'] if isinstance(sprite, dict)
+                             else sprite, platform)
+        try:
+            images.append(read_png(path))
+        except (IOError, ValueError, KeyError) as e:
+            raise AtlasError("{}: {}".format(path, e))
+    width, height, positions = pack([(w, h) for w, h, _ in images], padding)
+    pixels = [[(0, 0, 0, 0)] * width for _ in range(height)]
+    for (w, h, rows), (x, y) in zip(images, positions):
+        for row in range(h):
+            pixels[y + row][x:x + w] = rows[row]
+    return (write_png(width, height, pixels),
+            [(name, (x, y, w, h)) for name, (w, h, _), (x, y) in zip(names, images, positions)])
+
+
+def atlas_path(resources_dir, entry, platform):
+    base, ext = os.path.splitext(entry['file'])
+    return os.path.join(resources_dir, '{}~{}{}'.format(base, platform, ext))
+
+
+def header(layouts):
+    """Return the header for layouts, {atlas name: {platform: [(name, rect)]}}."""
+    lines = ['// Generated by sprite_atlas.py from package.json, do not edit.', '#pragma once', '',
+             '#include <pebble.h>']
+    for atlas in sorted(layouts):
+        # Platforms with the same layout share one set of defines.
+        groups = []
+        for platform in sorted(layouts[atlas]):
+            for group in groups:
+                if group[1] == layouts[atlas][platform]:
+                    group[0].append(platform)
+                    break
+            else:
+                groups.append(([platform], layouts[atlas][platform]))
+        lines += ['', '// Sprites of RESOURCE_ID_{}.'.format(atlas)]
+        for n, (platforms, rects) in enumerate(groups):
+            if len(groups) > 1:
+                lines.append('{} {}'.format('#if' if n == 0 else '#elif', ' || '.join(
+                    'defined({})'.format(PLATFORM_MACRO.format(p.upper())) for p in platforms)))
+            lines += ['#define {}_{} GRect({}, {}, {}, {})'.format(atlas, name, *rect)
+                      for name, rect in rects]
+        if len(groups) > 1:
+            lines.append('#endif')
+    return '\n'.join(lines) + '\n'
+
+
+def write_if_changed(path, data):
+    if os.path.exists(path):
+        with open(path, 'rb') as f:
+            if f.read() == data:
+                return False
+    directory = os.path.dirname(path)
+    if directory and not os.path.isdir(directory):
+        os.makedirs(directory)
+    with open(path, 'wb') as f:
+        f.write(data)
+    return True
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument('--project', default='.', help="the app project (default: .)")
+    parser.add_argument('--header', default=os.path.join('src', 'c', 'sprite_atlas.auto.h'),
+                        help="the header to write, relative to the project "
+                             "(default: src/c/sprite_atlas.auto.h)")
+    parser.add_argument('--padding', type=int, default=0,
+                        help="transparent pixels between sprites (default: 0)")
+    parser.add_argument('--list', action='store_true', help="print the layouts instead")
+    args = parser.parse_args(argv)
+
+    try:
+        with open(os.path.join(args.project, 'package.json')) as f:
+            pebble = json.load(f)['pebble']
+        resources_dir = os.path.join(args.project, 'resources')
+        atlases = [entry for entry in pebble.get('resources', {}).get('media', [])
+                   if 'sprites' in entry]
+        if not atlases:
+            raise AtlasError("package.json has no resources with sprites")
+        platforms = [p for p in pebble.get('targetPlatforms', sorted(PLATFORMS))
+                     if p in PLATFORMS]
+        layouts = {}
+        outputs = []
+        for entry in atlases:
+            if not entry['sprites']:
+                raise AtlasError("atlas {} has no sprites".format(entry['name']))
+            layouts[entry['name']] = {}
+            for platform in platforms:
+                png, rects = build_atlas(resources_dir, entry, platform, args.padding)
+                layouts[entry['name']][platform] = rects
+                outputs.append((atlas_path(resources_dir, entry, platform), png))
+        outputs.append((os.path.join(args.project, args.header),
+                        header(layouts).encode('utf-8')))
+    except (IOError, ValueError, KeyError, AtlasError) as e:
+        print("error: {}".format(e), file=sys.stderr)
+        return 1
+
+    if args.list:
+        for atlas in sorted(layouts):
+            for platform in platforms:
+                print("{} {}:".format(atlas, platform))
+                for name, rect in layouts[atlas][platform]:
+                    print("  {:<24} x {:>4} y {:>4} w {:>4} h {:>4}".format(name, *rect))
+        return 0
+    for path, data in outputs:
+        if write_if_changed(path, data):
+            print("wrote {}".format(path))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
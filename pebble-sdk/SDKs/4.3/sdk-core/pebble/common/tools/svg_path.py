@@ -0,0 +1,284 @@
+#!/usr/bin/env python
+"""
+Convert a shape from an SVG file to a path resource, for resources of type "path".
+
+Reads the first <path>, <polygon> or <polyline> element of an SVG file, or the one with the
+given --id, flattens its curves into points and writes the Path File Format described in
+pebble.h, which gpath_create_with_resource() loads. With --triangulate, the filled area is also
+split into triangles that gpath_draw_filled() fills instead of the outline.
+
+Coordinates are SVG user units. --origin moves the given point to (0, 0), which is the point a
+GPath rotates around, for example the pivot of a watch hand. --scale multiplies all
+coordinates afterwards. Points are rounded to whole pixels.
+
+Usage:
+    svg_path.py [--id ID] [--origin X,Y] [--scale S] [--tolerance PX] [--triangulate]
+                INPUT OUTPUT
+
+Only a single closed or open outline per path is supported, since a GPath has exactly one.
+Elliptical arc commands are not supported; convert arcs to curves in the editor first.
+"""
+
+from __future__ import print_function
+
+import argparse
+import math
+import re
+import struct
+import sys
+import xml.etree.ElementTree as ElementTree
+
+MAGIC = b'PPTH'
+VERSION = 1
+HEADER = struct.Struct('<4sHHHH')
+MAX_POINTS = 0xffff
+
+TOKEN = re.compile(r'[MmLlHhVvCcSsQqTtAaZz]|[-+]?(?:\d+\.?\d*|\.\d+)(?:[eE][-+]?\d+)?')
+
+
+class PathError(Exception):
+    pass
+
+
+def find_shape(root, shape_id):
+    for element in root.iter():
+        tag = element.tag.rsplit('}', 1)[-1]
+        if tag not in ('path', 'polygon', 'polyline'):
+            continue
+        if shape_id is None or element.get('id') == shape_id:
+            return tag, element
+    raise PathError("no path, polygon or polyline{} found".format(
+        " with id '{}'".format(shape_id) if shape_id else ""))
+
+
+def curve_steps(points, tolerance):
+    length = sum(math.hypot(b[0] - a[0], b[1] - a[1]) for a, b in zip(points, points[1:]))
+    return max(1, min(64, int(math.ceil(length / max(tolerance, 0.1) / 4))))
+
+
+def cubic(p0, p1, p2, p3, tolerance):
+    n = curve_steps([p0, p1, p2, p3], tolerance)
+    out = []
+    for i in range(1, n + 1):
+        t = i / float(n)
+        u = 1 - t
+        out.append((u * u * u * p0[0] + 3 * u * u * t * p1[0] + 3 * u * t * t * p2[0] +
+                    t * t * t * p3[0],
+                    u * u * u * p0[1] + 3 * u * u * t * p1[1] + 3 * u * t * t * p2[1] +
+                    t * t * t * p3[1]))
+    return out
+
+
+def quadratic(p0, p1, p2, tolerance):
+    n = curve_steps([p0, p1, p2], tolerance)
+    out = []
+    for i in range(1, n + 1):
+        t = i / float(n)
+        u = 1 - t
+        out.append((u * u * p0[0] + 2 * u * t * p1[0] + t * t * p2[0],
+                    u * u * p0[1] + 2 * u * t * p1[1] + t * t * p2[1]))
+    return out
+
+
+def parse_path_data(d, tolerance):
+    """Return (points, closed) of the outline described by an SVG path's d attribute."""
+    tokens = TOKEN.findall(d)
+    points = []
+    closed = False
+    pos = (0.0, 0.0)
+    control = None
+    command = None
+    i = 0
+
+    def numbers(count):
+        values = tokens[i:i + count]
+        if len(values) < count or any(re.match('[A-Za-z]', v) for v in values):
+            raise PathError("missing coordinates for '{}'".format(command))
+        return [float(v) for v in values]
+
+    while i < len(tokens):
+        if re.match('[A-Za-z]', tokens[i]):
+            command = tokens[i]
+            i += 1
+            if command in 'Zz':
+                closed = True
+                continue
+        elif command is None:
+            raise PathError("path data does not start with a command")
+        if closed:
+            raise PathError("paths with more than one outline are not supported")
+        if command in 'Aa':
+            raise PathError("elliptical arcs are not supported")
+        relative = command.islower()
+        base = pos if relative else (0.0, 0.0)
+
+        def absolute(x, y):
+            return (base[0] + x, base[1] + y)
+
+        c = command.upper()
+        if c == 'M':
+            if points:
+                raise PathError("paths with more than one outline are not supported")
+            x, y = numbers(2)
+            i += 2
+            pos = absolute(x, y)
+            points.append(pos)
+            # Further coordinate pairs after a moveto are implicit linetos.
+            command = 'l' if relative else 'L'
+            control = None
+        elif c == 'L':
+            x, y = numbers(2)
+            i += 2
+            pos = absolute(x, y)
+            points.append(pos)
+            control = None
+        elif c == 'H':
+            x, = numbers(1)
+            i += 1
+            pos = (base[0] + x if relative else x, pos[1])
+            points.append(pos)
+            control = None
+        elif c == 'V':
+            y, = numbers(1)
+            i += 1
+            pos = (pos[0], base[1] + y if relative else y)
+            points.append(pos)
+            control = None
+        elif c in 'CS':
+            if c == 'C':
+                x1, y1, x2, y2, x, y = numbers(6)
+                i += 6
+                p1 = absolute(x1, y1)
+            else:
+                x2, y2, x, y = numbers(4)
+                i += 4
+                p1 = (2 * pos[0] - control[0], 2 * pos[1] - control[1]) if control else pos
+            p2 = absolute(x2, y2)
+            end = absolute(x, y)
+            points += cubic(pos, p1, p2, end, tolerance)
+            pos, control = end, p2
+        elif c in 'QT':
+            if c == 'Q':
+                x1, y1, x, y = numbers(4)
+                i += 4
+                p1 = absolute(x1, y1)
+            else:
+                x, y = numbers(2)
+                i += 2
+                p1 = (2 * pos[0] - control[0], 2 * pos[1] - control[1]) if control else pos
+            end = absolute(x, y)
+            points += quadratic(pos, p1, end, tolerance)
+            pos, control = end, p1
+        if command.upper() not in 'CSQT':
+            control = None
+    return points, closed
+
+
+def parse_points(text):
+    values = [float(v) for v in TOKEN.findall(text)]
+    return list(zip(values[0::2], values[1::2]))
+
+
+def to_pixels(points, origin, scale):
+    out = []
+    for x, y in points:
+        p = (int(round((x - origin[0]) * scale)), int(round((y - origin[1]) * scale)))
+        if not out or p != out[-1]:
+            out.append(p)
+    if len(out) > 1 and out[0] == out[-1]:
+        out.pop()
+    return out
+
+
+def signed_area(points):
+    return sum(a[0] * b[1] - b[0] * a[1]
+               for a, b in zip(points, points[1:] + points[:1])) / 2.0
+
+
+def cross(o, a, b):
+    return (a[0] - o[0]) * (b[1] - o[1]) - (a[1] - o[1]) * (b[0] - o[0])
+
+
+def triangulate(points):
+    """Split a simple polygon into triangles by ear clipping; returns index triples."""
+    winding = 1 if signed_area(points) > 0 else -1
+    remaining = list(range(len(points)))
+    triangles = []
+    while len(remaining) > 3:
+        for k in range(len(remaining)):
+            ia, ib, ic = remaining[k - 1], remaining[k], remaining[(k + 1) % len(remaining)]
+            a, b, c = points[ia], points[ib], points[ic]
+            turn = cross(a, b, c) * winding
+            if turn < 0:
+                continue
+            if turn == 0:
+                # Drop points on a straight line, they do not add any area.
+                remaining.pop(k)
+                break
+            if any(cross(a, b, points[j]) * winding >= 0 and cross(b, c, points[j]) * winding >= 0
+                   and cross(c, a, points[j]) * winding >= 0
+                   for j in remaining if j not in (ia, ib, ic)):
+                continue
+            triangles.append((ia, ib, ic))
+            remaining.pop(k)
+            break
+        else:
+            raise PathError("the outline intersects itself and cannot be triangulated")
+    if len(remaining) == 3 and cross(*[points[j] for j in remaining]) != 0:
+        triangles.append(tuple(remaining))
+    return triangles
+
+
+def encode(points, triangles):
+    out = bytearray(HEADER.pack(MAGIC, VERSION, len(points), len(triangles), 0))
+    for x, y in points:
+        out += struct.pack('<hh', x, y)
+    for triangle in triangles:
+        out += struct.pack('<HHH', *triangle)
+    return out
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument('input')
+    parser.add_argument('output')
+    parser.add_argument('--id', help="id of the element to convert")
+    parser.add_argument('--origin', default='0,0',
+                        help="point moved to (0, 0), in SVG user units (default: 0,0)")
+    parser.add_argument('--scale', type=float, default=1.0)
+    parser.add_argument('--tolerance', type=float, default=0.5,
+                        help="approximate length in pixels of curve segments (default: 0.5)")
+    parser.add_argument('--triangulate', action='store_true')
+    args = parser.parse_args(argv)
+
+    try:
+        origin = tuple(float(v) for v in args.origin.split(','))
+        if len(origin) != 2:
+            raise ValueError
+    except ValueError:
+        parser.error("--origin must be X,Y")
+    try:
+        tag, element = find_shape(ElementTree.parse(args.input).getroot(), args.id)
+        if tag == 'path':
+            points, _ = parse_path_data(element.get('d', ''), args.tolerance / args.scale)
+        else:
+            points = parse_points(element.get('points', ''))
+        points = to_pixels(points, origin, args.scale)
+        if len(points) < 2:
+            raise PathError("the shape has fewer than 2 points")
+        if len(points) > MAX_POINTS:
+            raise PathError("the shape has more than {} points".format(MAX_POINTS))
+        if any(not -32768 <= v <= 32767 for p in points for v in p):
+            raise PathError("coordinates do not fit into a GPoint")
+        triangles = triangulate(points) if args.triangulate and len(points) >= 3 else []
+    except (IOError, ElementTree.ParseError, PathError) as e:
+        print("error: {}: {}".format(args.input, e), file=sys.stderr)
+        return 1
+
+    with open(args.output, 'wb') as f:
+        f.write(encode(points, triangles))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,250 @@
+#!/usr/bin/env python
+"""
+Show the counters an app sends with profiler_telemetry_start() on a live dashboard.
+
+While enabled, the watch sends one record every interval, all fields little endian:
+
+    uint32_t sequence       number of the record since sending started
+    uint32_t time_ms        time of the record, in ms since sending started
+    uint16_t counters       the TelemetryCounter flags the record holds
+    uint16_t reserved
+    uint32_t render_us      render time of the last frame
+    uint32_t display_us     time until the last frame appeared on the display
+    uint32_t frames         frames rendered since sending started
+    uint32_t heap_free      free bytes of the app heap
+    uint32_t heap_largest   largest free block of the app heap
+    uint16_t outbox_queue   messages waiting in the AppMessage outbox
+    uint16_t inbox_queue    messages waiting in the AppMessage inbox
+    uint32_t max_wait_us    longest event queue wait since the previous record
+    uint32_t max_handler_us longest event handler run since the previous record
+
+render_us, display_us and frames are sent with TelemetryCounterFrameTime, the heap fields with
+TelemetryCounterHeap, the queue fields with TelemetryCounterAppMessageQueue and the last two
+with TelemetryCounterEventLatency. Fields of counters that were not selected are 0.
+
+Usage:
+    telemetry_dashboard.py [STREAM] [--port PORT] [--bind ADDRESS] [--history N]
+    telemetry_dashboard.py [STREAM] --text
+
+The records are read from the STREAM file, or from stdin, as they arrive. The dashboard is served
+on http://127.0.0.1:PORT/ and plots the last N records of each counter; the records are also
+available as JSON from /records. The dashboard keeps showing the last records after the stream
+ends, until Ctrl-C. With --text, each record is printed as a line instead.
+"""
+
+from __future__ import print_function
+
+import argparse
+import collections
+import json
+import struct
+import sys
+import threading
+
+try:
+    from http.server import BaseHTTPRequestHandler, HTTPServer
+except ImportError:
+    from BaseHTTPServer import BaseHTTPRequestHandler, HTTPServer
+
+RECORD = struct.Struct('<IIHHIIIIIHHII')
+FIELDS = ('sequence', 'time_ms', 'counters', 'reserved', 'render_us', 'display_us', 'frames',
+          'heap_free', 'heap_largest', 'outbox_queue', 'inbox_queue', 'max_wait_us',
+          'max_handler_us')
+# Counter flags and the fields they fill in.
+COUNTERS = (
+    (1 << 0, ('render_us', 'display_us', 'frames')),
+    (1 << 1, ('heap_free', 'heap_largest')),
+    (1 << 2, ('outbox_queue', 'inbox_queue')),
+    (1 << 3, ('max_wait_us', 'max_handler_us')),
+)
+
+PAGE = b"""<!DOCTYPE html>
+<html><head><meta charset="utf-8"><title>Pebble telemetry</title>
+<style>
+body { font: 13px sans-serif; margin: 16px; }
+.chart { display: inline-block; margin: 0 16px 16px 0; }
+canvas { border: 1px solid #ccc; display: block; }
+</style></head>
+<body><div id="status">waiting for records...</div><div id="charts"></div>
+<script>
+var CHARTS = [['render_us', 'display_us'], ['fps'], ['heap_free', 'heap_largest'],
+              ['outbox_queue', 'inbox_queue'], ['max_wait_us', 'max_handler_us']];
+var COLORS = ['#0077cc', '#cc5500'];
+var canvases = CHARTS.map(function (names) {
+  var div = document.createElement('div'), label = document.createElement('div');
+  var canvas = document.createElement('canvas');
+  div.className = 'chart';
+  canvas.width = 480;
+  canvas.height = 120;
+  div.appendChild(label);
+  div.appendChild(canvas);
+  document.getElementById('charts').appendChild(div);
+  return {names: names, canvas: canvas, label: label};
+});
+
+function draw(chart, records) {
+  var ctx = chart.canvas.getContext('2d'), w = chart.canvas.width, h = chart.canvas.height;
+  var max = 1;
+  records.forEach(function (r) {
+    chart.names.forEach(function (n) { max = Math.max(max, r[n]); });
+  });
+  ctx.clearRect(0, 0, w, h);
+  chart.label.innerHTML = chart.names.map(function (n, i) {
+    var last = records.length ? records[records.length - 1][n] : 0;
+    return '<span style="color:' + COLORS[i] + '">' + n + ' ' + last + '</span>';
+  }).join(' &nbsp; ') + ' &nbsp; (max ' + max + ')';
+  chart.names.forEach(function (n, i) {
+    ctx.strokeStyle = COLORS[i];
+    ctx.beginPath();
+    records.forEach(function (r, x) {
+      var px = records.length > 1 ? x * (w - 1) / (records.length - 1) : 0;
+      var py = h - 1 - r[n] * (h - 2) / max;
+      if (x) { ctx.lineTo(px, py); } else { ctx.moveTo(px, py); }
+    });
+    ctx.stroke();
+  });
+}
+
+function update() {
+  fetch('/records').then(function (response) { return response.json(); }).then(function (data) {
+    var records = data.records;
+    document.getElementById('status').textContent = data.ended ? 'stream ended' :
+      records.length + ' records';
+    canvases.forEach(function (chart) { draw(chart, records); });
+    if (!data.ended) { setTimeout(update, 250); }
+  }, function () { setTimeout(update, 1000); });
+}
+update();
+</script></body></html>
+"""
+
+
+def records(stream):
+    """Yield a dict for each complete record of a stream, as the records arrive."""
+    previous = None
+    while True:
+        data = stream.read(RECORD.size)
+        if len(data) < RECORD.size:
+            return
+        record = dict(zip(FIELDS, RECORD.unpack(data)))
+        del record['reserved']
+        for flag, names in COUNTERS:
+            if not record['counters'] & flag:
+                for name in names:
+                    record[name] = None
+        # Frames per second over the interval since the previous record.
+        record['fps'] = None
+        if (previous and record['frames'] is not None and previous['frames'] is not None and
+                record['time_ms'] > previous['time_ms']):
+            record['fps'] = round((record['frames'] - previous['frames']) * 1000.0 /
+                                  (record['time_ms'] - previous['time_ms']), 1)
+        previous = record
+        yield record
+
+
+def format_record(record):
+    return ' '.join('{}={}'.format(name, record[name])
+                    for name in ('time_ms',) + FIELDS[4:] + ('fps',)
+                    if record[name] is not None)
+
+
+class Dashboard(object):
+    """The last records of a stream, read on a thread of its own."""
+
+    def __init__(self, stream, history):
+        self.records = collections.deque(maxlen=history)
+        self.ended = False
+        self.error = None
+        self.lock = threading.Lock()
+        self.thread = threading.Thread(target=self.read, args=(stream,))
+        self.thread.daemon = True
+
+    def read(self, stream):
+        try:
+            for record in records(stream):
+                with self.lock:
+                    self.records.append(dict((k, 0 if v is None else v)
+                                             for k, v in record.items()))
+        except IOError as e:
+            self.error = e
+        self.ended = True
+
+    def snapshot(self):
+        with self.lock:
+            return {'records': list(self.records), 'ended': self.ended}
+
+
+def make_handler(dashboard):
+    class Handler(BaseHTTPRequestHandler):
+        def do_GET(self):
+            if self.path == '/':
+                body, kind = PAGE, 'text/html; charset=utf-8'
+            elif self.path == '/records':
+                body = json.dumps(dashboard.snapshot()).encode('utf-8')
+                kind = 'application/json'
+            else:
+                self.send_error(404)
+                return
+            self.send_response(200)
+            self.send_header('Content-Type', kind)
+            self.send_header('Content-Length', str(len(body)))
+            self.send_header('Cache-Control', 'no-cache')
+            self.end_headers()
+            self.wfile.write(body)
+
+        def log_message(self, *args):
+            pass
+
+    return Handler
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument('stream', nargs='?', help="the record stream (default: stdin)")
+    parser.add_argument('--port', type=int, default=8008, help="dashboard port (default: 8008)")
+    parser.add_argument('--bind', default='127.0.0.1',
+                        help="address the dashboard listens on (default: 127.0.0.1)")
+    parser.add_argument('--history', type=int, default=600,
+                        help="records shown on the dashboard (default: 600)")
+    parser.add_argument('--text', action='store_true', help="print the records instead")
+    args = parser.parse_args(argv)
+
+    try:
+        stream = open(args.stream, 'rb') if args.stream else getattr(sys.stdin, 'buffer',
+                                                                     sys.stdin)
+    except IOError as e:
+        print("error: {}".format(e), file=sys.stderr)
+        return 1
+    if args.text:
+        try:
+            for record in records(stream):
+                print(format_record(record))
+                sys.stdout.flush()
+        except KeyboardInterrupt:
+            pass
+        return 0
+
+    dashboard = Dashboard(stream, args.history)
+    try:
+        server = HTTPServer((args.bind, args.port), make_handler(dashboard))
+    except (IOError, OSError) as e:
+        print("error: cannot listen on {}:{}: {}".format(args.bind, args.port, e),
+              file=sys.stderr)
+        return 1
+    dashboard.thread.start()
+    print("dashboard on http://{}:{}/".format(args.bind, server.server_address[1]),
+          file=sys.stderr)
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        server.server_close()
+    if dashboard.error:
+        print("error: {}".format(dashboard.error), file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -4,19 +4,34 @@
 //! compiling code on SDKs that support the functions they're attempting to use.
 
 #define _PBL_API_EXISTS_i18n_get_system_locale
+#define _PBL_API_EXISTS_string_table_create_with_resource
+#define _PBL_API_EXISTS_string_table_get
+#define _PBL_API_EXISTS_string_table_destroy
 #define _PBL_API_EXISTS_watch_info_get_model
 #define _PBL_API_EXISTS_watch_info_get_firmware_version
 #define _PBL_API_EXISTS_watch_info_get_color
 #define _PBL_API_EXISTS_sin_lookup
 #define _PBL_API_EXISTS_cos_lookup
 #define _PBL_API_EXISTS_atan2_lookup
+#define _PBL_API_EXISTS_atan2_lookup_k
+#define _PBL_API_EXISTS_integer_sqrt
+#define _PBL_API_EXISTS_integer_hypot
+#define _PBL_API_EXISTS_dsp_fir_filter
+#define _PBL_API_EXISTS_dsp_biquad_filter
+#define _PBL_API_EXISTS_dsp_spectrum
+#define _PBL_API_EXISTS_dsp_find_peaks
 #define _PBL_API_EXISTS_clock_copy_time_string
 #define _PBL_API_EXISTS_clock_is_24h_style
 #define _PBL_API_EXISTS_clock_to_timestamp
 #define _PBL_API_EXISTS_clock_is_timezone_set
 #define _PBL_API_EXISTS_clock_get_timezone
+#define _PBL_API_EXISTS_clock_get_local_time
+#define _PBL_API_EXISTS_time_formatter_create
+#define _PBL_API_EXISTS_time_formatter_format
+#define _PBL_API_EXISTS_time_formatter_destroy
 #define _PBL_API_EXISTS_connection_service_peek_pebble_app_connection
 #define _PBL_API_EXISTS_connection_service_peek_pebblekit_connection
+#define _PBL_API_EXISTS_connection_service_peek_link_quality
 #define _PBL_API_EXISTS_connection_service_subscribe
 #define _PBL_API_EXISTS_connection_service_unsubscribe
 #define _PBL_API_EXISTS_bluetooth_connection_service_peek
@@ -28,6 +43,10 @@
 #define _PBL_API_EXISTS_battery_state_service_subscribe
 #define _PBL_API_EXISTS_battery_state_service_unsubscribe
 #define _PBL_API_EXISTS_battery_state_service_peek
+#define _PBL_API_EXISTS_performance_tier_service_subscribe
+#define _PBL_API_EXISTS_performance_tier_service_unsubscribe
+#define _PBL_API_EXISTS_performance_tier_service_peek
+#define _PBL_API_EXISTS_performance_tier_set_follow
 #define _PBL_API_EXISTS_accel_service_peek
 #define _PBL_API_EXISTS_accel_service_set_sampling_rate
 #define _PBL_API_EXISTS_accel_service_set_samples_per_update
@@ -36,17 +55,29 @@
 #define _PBL_API_EXISTS_accel_tap_service_subscribe
 #define _PBL_API_EXISTS_accel_tap_service_unsubscribe
 #define _PBL_API_EXISTS_accel_raw_data_service_subscribe
+#define _PBL_API_EXISTS_accel_raw_data_service_subscribe_batched
+#define _PBL_API_EXISTS_accel_feature_service_subscribe
+#define _PBL_API_EXISTS_accel_data_service_set_motion_gate
 #define _PBL_API_EXISTS_compass_service_set_heading_filter
 #define _PBL_API_EXISTS_compass_service_subscribe
 #define _PBL_API_EXISTS_compass_service_unsubscribe
 #define _PBL_API_EXISTS_compass_service_peek
+#define _PBL_API_EXISTS_compass_orientation_service_subscribe
+#define _PBL_API_EXISTS_compass_orientation_service_unsubscribe
 #define _PBL_API_EXISTS_tick_timer_service_subscribe
 #define _PBL_API_EXISTS_tick_timer_service_unsubscribe
+#define _PBL_API_EXISTS_tick_timer_service_add_subscription
+#define _PBL_API_EXISTS_tick_timer_service_add_subsecond_subscription
+#define _PBL_API_EXISTS_tick_timer_service_remove_subscription
+#define _PBL_API_EXISTS_display_frame_service_subscribe
+#define _PBL_API_EXISTS_display_frame_service_unsubscribe
+#define _PBL_API_EXISTS_display_frame_service_peek
 #define _PBL_API_EXISTS_health_service_sum
 #define _PBL_API_EXISTS_health_service_sum_today
 #define _PBL_API_EXISTS_health_service_peek_current_value
 #define _PBL_API_EXISTS_health_service_sum_averaged
 #define _PBL_API_EXISTS_health_service_aggregate_averaged
+#define _PBL_API_EXISTS_health_service_query_many
 #define _PBL_API_EXISTS_health_service_peek_current_activities
 #define _PBL_API_EXISTS_health_service_activities_iterate
 #define _PBL_API_EXISTS_health_service_metric_accessible
@@ -55,18 +86,32 @@
 #define _PBL_API_EXISTS_health_service_any_activity_accessible
 #define _PBL_API_EXISTS_health_service_events_subscribe
 #define _PBL_API_EXISTS_health_service_events_unsubscribe
+#define _PBL_API_EXISTS_health_service_set_event_filter
 #define _PBL_API_EXISTS_health_service_set_heart_rate_sample_period
 #define _PBL_API_EXISTS_health_service_get_heart_rate_sample_period_expiration_sec
+#define _PBL_API_EXISTS_health_service_set_heart_rate_batch_handler
 #define _PBL_API_EXISTS_health_service_register_metric_alert
 #define _PBL_API_EXISTS_health_service_cancel_metric_alert
 #define _PBL_API_EXISTS_health_service_get_minute_history
+#define _PBL_API_EXISTS_health_service_minute_history_iterate
 #define _PBL_API_EXISTS_health_service_get_measurement_system_for_display
+#define _PBL_API_EXISTS_sensor_pipeline_create
+#define _PBL_API_EXISTS_sensor_pipeline_add_stream
+#define _PBL_API_EXISTS_sensor_pipeline_start
+#define _PBL_API_EXISTS_sensor_pipeline_stop
+#define _PBL_API_EXISTS_sensor_pipeline_destroy
 #define _PBL_API_EXISTS_data_logging_create
+#define _PBL_API_EXISTS_data_logging_create_buffered
+#define _PBL_API_EXISTS_data_logging_create_with_schema
 #define _PBL_API_EXISTS_data_logging_finish
 #define _PBL_API_EXISTS_data_logging_log
+#define _PBL_API_EXISTS_data_logging_flush
+#define _PBL_API_EXISTS_data_logging_get_stats
+#define _PBL_API_EXISTS_data_logging_set_usage_handler
 #define _PBL_API_EXISTS_uuid_equal
 #define _PBL_API_EXISTS_uuid_to_string
 #define _PBL_API_EXISTS_app_log
+#define _PBL_API_EXISTS_app_log_binary
 #define _PBL_API_EXISTS_dict_calc_buffer_size
 #define _PBL_API_EXISTS_dict_size
 #define _PBL_API_EXISTS_dict_write_begin
@@ -79,6 +124,10 @@
 #define _PBL_API_EXISTS_dict_write_int8
 #define _PBL_API_EXISTS_dict_write_int16
 #define _PBL_API_EXISTS_dict_write_int32
+#define _PBL_API_EXISTS_dict_write_int32_array
+#define _PBL_API_EXISTS_dict_write_space_left
+#define _PBL_API_EXISTS_dict_write_reserve
+#define _PBL_API_EXISTS_dict_write_shrink_last
 #define _PBL_API_EXISTS_dict_write_end
 #define _PBL_API_EXISTS_dict_read_begin_from_buffer
 #define _PBL_API_EXISTS_dict_read_next
@@ -90,13 +139,24 @@
 #define _PBL_API_EXISTS_dict_calc_buffer_size_from_tuplets
 #define _PBL_API_EXISTS_dict_merge
 #define _PBL_API_EXISTS_dict_find
+#define _PBL_API_EXISTS_dict_index_init
+#define _PBL_API_EXISTS_dict_index_find
+#define _PBL_API_EXISTS_dict_index_dense
+#define _PBL_API_EXISTS_dict_read_int32_array
+#define _PBL_API_EXISTS_dict_encode_compact
+#define _PBL_API_EXISTS_dict_decode_compact
 #define _PBL_API_EXISTS_dictation_session_create
 #define _PBL_API_EXISTS_dictation_session_destroy
 #define _PBL_API_EXISTS_dictation_session_start
 #define _PBL_API_EXISTS_dictation_session_stop
 #define _PBL_API_EXISTS_dictation_session_enable_confirmation
 #define _PBL_API_EXISTS_dictation_session_enable_error_dialogs
+#define _PBL_API_EXISTS_dictation_session_set_partial_callback
 #define _PBL_API_EXISTS_app_message_open
+#define _PBL_API_EXISTS_app_message_open_with_inbox_pool
+#define _PBL_API_EXISTS_app_message_set_outbox_depth
+#define _PBL_API_EXISTS_app_message_set_priority_lanes
+#define _PBL_API_EXISTS_app_message_set_compact_encoding
 #define _PBL_API_EXISTS_app_message_deregister_callbacks
 #define _PBL_API_EXISTS_app_message_get_context
 #define _PBL_API_EXISTS_app_message_set_context
@@ -107,55 +167,137 @@
 #define _PBL_API_EXISTS_app_message_inbox_size_maximum
 #define _PBL_API_EXISTS_app_message_outbox_size_maximum
 #define _PBL_API_EXISTS_app_message_outbox_begin
+#define _PBL_API_EXISTS_app_message_outbox_begin_with_priority
 #define _PBL_API_EXISTS_app_message_outbox_send
+#define _PBL_API_EXISTS_app_message_outbox_send_with_callback
+#define _PBL_API_EXISTS_app_message_inbox_retain
+#define _PBL_API_EXISTS_app_message_inbox_release
+#define _PBL_API_EXISTS_app_message_set_inbox_inflate
+#define _PBL_API_EXISTS_app_message_inflate_tuple
+#define _PBL_API_EXISTS_app_message_get_stats
+#define _PBL_API_EXISTS_app_message_reset_stats
+#define _PBL_API_EXISTS_app_message_set_stats_log_interval
 #define _PBL_API_EXISTS_app_sync_init
 #define _PBL_API_EXISTS_app_sync_deinit
 #define _PBL_API_EXISTS_app_sync_set
 #define _PBL_API_EXISTS_app_sync_get
+#define _PBL_API_EXISTS_app_sync_set_delta_mode
+#define _PBL_API_EXISTS_app_sync_get_version
+#define _PBL_API_EXISTS_app_transfer_open
+#define _PBL_API_EXISTS_app_transfer_close
+#define _PBL_API_EXISTS_app_transfer_resume
+#define _PBL_API_EXISTS_app_transfer_cancel
 #define _PBL_API_EXISTS_resource_get_handle
 #define _PBL_API_EXISTS_resource_size
 #define _PBL_API_EXISTS_resource_load
 #define _PBL_API_EXISTS_resource_load_byte_range
+#define _PBL_API_EXISTS_resource_reader_create
+#define _PBL_API_EXISTS_resource_reader_read
+#define _PBL_API_EXISTS_resource_reader_destroy
+#define _PBL_API_EXISTS_resource_get_mapped_data
 #define _PBL_API_EXISTS_app_event_loop
+#define _PBL_API_EXISTS_app_idle_register
+#define _PBL_API_EXISTS_app_idle_cancel
+#define _PBL_API_EXISTS_app_task_spawn
+#define _PBL_API_EXISTS_app_task_yield
 #define _PBL_API_EXISTS_app_worker_is_running
 #define _PBL_API_EXISTS_app_worker_launch
 #define _PBL_API_EXISTS_app_worker_kill
 #define _PBL_API_EXISTS_app_worker_message_subscribe
 #define _PBL_API_EXISTS_app_worker_message_unsubscribe
 #define _PBL_API_EXISTS_app_worker_send_message
+#define _PBL_API_EXISTS_app_worker_ring_buffer_open
+#define _PBL_API_EXISTS_app_worker_ring_buffer_close
+#define _PBL_API_EXISTS_app_worker_ring_buffer_write
+#define _PBL_API_EXISTS_app_worker_ring_buffer_read
+#define _PBL_API_EXISTS_app_worker_ring_buffer_get_bytes_available
+#define _PBL_API_EXISTS_app_worker_shared_write
+#define _PBL_API_EXISTS_app_worker_shared_read
+#define _PBL_API_EXISTS_app_worker_shared_subscribe
+#define _PBL_API_EXISTS_app_worker_shared_unsubscribe
 #define _PBL_API_EXISTS_app_comm_set_sniff_interval
 #define _PBL_API_EXISTS_app_comm_get_sniff_interval
+#define _PBL_API_EXISTS_app_comm_set_adaptive_idle_timeout
 #define _PBL_API_EXISTS_psleep
 #define _PBL_API_EXISTS_app_timer_register
 #define _PBL_API_EXISTS_app_timer_reschedule
 #define _PBL_API_EXISTS_app_timer_cancel
+#define _PBL_API_EXISTS_app_timer_register_with_slack
 #define _PBL_API_EXISTS_heap_bytes_free
 #define _PBL_API_EXISTS_heap_bytes_used
+#define _PBL_API_EXISTS_heap_get_stats
+#define _PBL_API_EXISTS_heap_set_allocation_tracking
+#define _PBL_API_EXISTS_heap_log_allocations
+#define _PBL_API_EXISTS_heap_set_high_water_mark_logging
+#define _PBL_API_EXISTS_memory_pressure_subscribe
+#define _PBL_API_EXISTS_memory_pressure_unsubscribe
+#define _PBL_API_EXISTS_stack_get_stats
+#define _PBL_API_EXISTS_stack_set_exit_logging
+#define _PBL_API_EXISTS_arena_allocator_create
+#define _PBL_API_EXISTS_arena_allocator_destroy
+#define _PBL_API_EXISTS_arena_allocator_alloc
+#define _PBL_API_EXISTS_arena_allocator_reset
+#define _PBL_API_EXISTS_arena_allocator_bytes_free
+#define _PBL_API_EXISTS_arena_allocator_push
+#define _PBL_API_EXISTS_arena_allocator_pop
+#define _PBL_API_EXISTS_pool_allocator_create
+#define _PBL_API_EXISTS_pool_allocator_destroy
+#define _PBL_API_EXISTS_pool_allocator_alloc
+#define _PBL_API_EXISTS_pool_allocator_free
 #define _PBL_API_EXISTS_memory_cache_flush
 #define _PBL_API_EXISTS_persist_exists
 #define _PBL_API_EXISTS_persist_get_size
+#define _PBL_API_EXISTS_persist_get_stored_size
 #define _PBL_API_EXISTS_persist_read_bool
 #define _PBL_API_EXISTS_persist_read_int
 #define _PBL_API_EXISTS_persist_read_data
 #define _PBL_API_EXISTS_persist_read_string
+#define _PBL_API_EXISTS_persist_iterate
+#define _PBL_API_EXISTS_persist_read_many
 #define _PBL_API_EXISTS_persist_write_bool
 #define _PBL_API_EXISTS_persist_write_int
 #define _PBL_API_EXISTS_persist_write_data
 #define _PBL_API_EXISTS_persist_write_string
 #define _PBL_API_EXISTS_persist_delete
+#define _PBL_API_EXISTS_persist_set_compression
+#define _PBL_API_EXISTS_persist_blob_open
+#define _PBL_API_EXISTS_persist_blob_read
+#define _PBL_API_EXISTS_persist_blob_write
+#define _PBL_API_EXISTS_persist_blob_close
+#define _PBL_API_EXISTS_persist_transaction_begin
+#define _PBL_API_EXISTS_persist_transaction_commit
+#define _PBL_API_EXISTS_persist_transaction_abort
+#define _PBL_API_EXISTS_persist_log_open
+#define _PBL_API_EXISTS_persist_log_append
+#define _PBL_API_EXISTS_persist_log_iterate
+#define _PBL_API_EXISTS_persist_log_trim
+#define _PBL_API_EXISTS_persist_log_compact
+#define _PBL_API_EXISTS_persist_log_close
 #define _PBL_API_EXISTS_wakeup_service_subscribe
 #define _PBL_API_EXISTS_wakeup_schedule
+#define _PBL_API_EXISTS_wakeup_schedule_with_window
 #define _PBL_API_EXISTS_wakeup_cancel
 #define _PBL_API_EXISTS_wakeup_cancel_all
 #define _PBL_API_EXISTS_wakeup_get_launch_event
 #define _PBL_API_EXISTS_wakeup_query
 #define _PBL_API_EXISTS_launch_reason
 #define _PBL_API_EXISTS_launch_get_args
+#define _PBL_API_EXISTS_launch_get_timing
+#define _PBL_API_EXISTS_launch_set_timing_logging
 #define _PBL_API_EXISTS_exit_reason_set
+#define _PBL_API_EXISTS_app_snapshot_save
+#define _PBL_API_EXISTS_app_snapshot_restore
 #define _PBL_API_EXISTS_app_glance_add_slice
 #define _PBL_API_EXISTS_app_glance_reload
+#define _PBL_API_EXISTS_app_glance_append_slice
+#define _PBL_API_EXISTS_app_glance_replace_slice
+#define _PBL_API_EXISTS_app_glance_remove_slice
 #define _PBL_API_EXISTS_gcolor_equal
 #define _PBL_API_EXISTS_gcolor_legible_over
+#define _PBL_API_EXISTS_gcolor_from_rgb888
+#define _PBL_API_EXISTS_gcolor_from_hex
+#define _PBL_API_EXISTS_gcolor_blend
+#define _PBL_API_EXISTS_gcolor_blend_table
 #define _PBL_API_EXISTS_gpoint_equal
 #define _PBL_API_EXISTS_gsize_equal
 #define _PBL_API_EXISTS_grect_equal
@@ -174,13 +316,21 @@
 #define _PBL_API_EXISTS_gbitmap_get_palette
 #define _PBL_API_EXISTS_gbitmap_set_palette
 #define _PBL_API_EXISTS_gbitmap_create_with_resource
+#define _PBL_API_EXISTS_gbitmap_create_compressed
+#define _PBL_API_EXISTS_gbitmap_create_with_resource_async
+#define _PBL_API_EXISTS_gbitmap_load_cancel
 #define _PBL_API_EXISTS_gbitmap_create_with_data
 #define _PBL_API_EXISTS_gbitmap_create_as_sub_bitmap
 #define _PBL_API_EXISTS_gbitmap_create_from_png_data
 #define _PBL_API_EXISTS_gbitmap_create_blank
 #define _PBL_API_EXISTS_gbitmap_create_blank_with_palette
+#define _PBL_API_EXISTS_gbitmap_get_blank_storage_size
+#define _PBL_API_EXISTS_gbitmap_init_blank
 #define _PBL_API_EXISTS_gbitmap_create_palettized_from_1bit
 #define _PBL_API_EXISTS_gbitmap_destroy
+#define _PBL_API_EXISTS_gbitmap_acquire_with_resource
+#define _PBL_API_EXISTS_gbitmap_retain
+#define _PBL_API_EXISTS_gbitmap_release
 #define _PBL_API_EXISTS_gbitmap_sequence_create_with_resource
 #define _PBL_API_EXISTS_gbitmap_sequence_update_bitmap_next_frame
 #define _PBL_API_EXISTS_gbitmap_sequence_update_bitmap_by_elapsed
@@ -191,7 +341,11 @@
 #define _PBL_API_EXISTS_gbitmap_sequence_get_play_count
 #define _PBL_API_EXISTS_gbitmap_sequence_set_play_count
 #define _PBL_API_EXISTS_gbitmap_sequence_get_bitmap_size
+#define _PBL_API_EXISTS_gbitmap_sequence_set_frame_pool
+#define _PBL_API_EXISTS_gbitmap_sequence_get_next_frame
+#define _PBL_API_EXISTS_gbitmap_sequence_set_frame_skip_policy
 #define _PBL_API_EXISTS_gbitmap_get_data_row_info
+#define _PBL_API_EXISTS_gbitmap_get_data_row_infos
 #define _PBL_API_EXISTS_grect_align
 #define _PBL_API_EXISTS_grect_inset
 #define _PBL_API_EXISTS_graphics_context_set_stroke_color
@@ -200,23 +354,34 @@
 #define _PBL_API_EXISTS_graphics_context_set_compositing_mode
 #define _PBL_API_EXISTS_graphics_context_set_antialiased
 #define _PBL_API_EXISTS_graphics_context_set_stroke_width
+#define _PBL_API_EXISTS_graphics_context_set_blend_mode
+#define _PBL_API_EXISTS_graphics_context_create_with_bitmap
+#define _PBL_API_EXISTS_graphics_context_destroy
 #define _PBL_API_EXISTS_graphics_draw_pixel
 #define _PBL_API_EXISTS_graphics_draw_line
+#define _PBL_API_EXISTS_graphics_draw_lines
 #define _PBL_API_EXISTS_graphics_draw_rect
 #define _PBL_API_EXISTS_graphics_fill_rect
+#define _PBL_API_EXISTS_graphics_fill_rect_dithered
+#define _PBL_API_EXISTS_graphics_fill_gradient_dithered
 #define _PBL_API_EXISTS_graphics_draw_circle
 #define _PBL_API_EXISTS_graphics_fill_circle
 #define _PBL_API_EXISTS_graphics_draw_round_rect
 #define _PBL_API_EXISTS_graphics_draw_bitmap_in_rect
+#define _PBL_API_EXISTS_graphics_draw_bitmap_scaled
 #define _PBL_API_EXISTS_graphics_capture_frame_buffer
 #define _PBL_API_EXISTS_graphics_capture_frame_buffer_format
 #define _PBL_API_EXISTS_graphics_release_frame_buffer
 #define _PBL_API_EXISTS_graphics_frame_buffer_is_captured
 #define _PBL_API_EXISTS_graphics_draw_rotated_bitmap
 #define _PBL_API_EXISTS_graphics_draw_arc
+#define _PBL_API_EXISTS_graphics_draw_arcs
 #define _PBL_API_EXISTS_graphics_fill_radial
 #define _PBL_API_EXISTS_gpoint_from_polar
 #define _PBL_API_EXISTS_grect_centered_from_polar
+#define _PBL_API_EXISTS_gpoint_from_polar_batch
+#define _PBL_API_EXISTS_gtransform_from_rotation
+#define _PBL_API_EXISTS_gpoint_transform_batch
 #define _PBL_API_EXISTS_gdraw_command_draw
 #define _PBL_API_EXISTS_gdraw_command_get_type
 #define _PBL_API_EXISTS_gdraw_command_set_fill_color
@@ -238,21 +403,27 @@
 #define _PBL_API_EXISTS_gdraw_command_frame_set_duration
 #define _PBL_API_EXISTS_gdraw_command_frame_get_duration
 #define _PBL_API_EXISTS_gdraw_command_image_create_with_resource
+#define _PBL_API_EXISTS_gdraw_command_image_create_with_resource_mapped
 #define _PBL_API_EXISTS_gdraw_command_image_clone
 #define _PBL_API_EXISTS_gdraw_command_image_destroy
 #define _PBL_API_EXISTS_gdraw_command_image_draw
 #define _PBL_API_EXISTS_gdraw_command_image_get_bounds_size
 #define _PBL_API_EXISTS_gdraw_command_image_set_bounds_size
 #define _PBL_API_EXISTS_gdraw_command_image_get_command_list
+#define _PBL_API_EXISTS_gdraw_command_image_set_cached
+#define _PBL_API_EXISTS_gdraw_command_image_get_cached
 #define _PBL_API_EXISTS_gdraw_command_list_iterate
 #define _PBL_API_EXISTS_gdraw_command_list_draw
 #define _PBL_API_EXISTS_gdraw_command_list_get_command
 #define _PBL_API_EXISTS_gdraw_command_list_get_num_commands
 #define _PBL_API_EXISTS_gdraw_command_sequence_create_with_resource
+#define _PBL_API_EXISTS_gdraw_command_sequence_create_with_resource_mapped
 #define _PBL_API_EXISTS_gdraw_command_sequence_clone
 #define _PBL_API_EXISTS_gdraw_command_sequence_destroy
 #define _PBL_API_EXISTS_gdraw_command_sequence_get_frame_by_elapsed
 #define _PBL_API_EXISTS_gdraw_command_sequence_get_frame_by_index
+#define _PBL_API_EXISTS_gdraw_command_sequence_is_keyframed
+#define _PBL_API_EXISTS_gdraw_command_sequence_get_interpolated_frame
 #define _PBL_API_EXISTS_gdraw_command_sequence_get_bounds_size
 #define _PBL_API_EXISTS_gdraw_command_sequence_set_bounds_size
 #define _PBL_API_EXISTS_gdraw_command_sequence_get_play_count
@@ -261,15 +432,20 @@
 #define _PBL_API_EXISTS_gdraw_command_sequence_get_num_frames
 #define _PBL_API_EXISTS_gdraw_command_frame_get_command_list
 #define _PBL_API_EXISTS_gpath_create
+#define _PBL_API_EXISTS_gpath_init
+#define _PBL_API_EXISTS_gpath_create_with_resource
 #define _PBL_API_EXISTS_gpath_destroy
 #define _PBL_API_EXISTS_gpath_draw_filled
 #define _PBL_API_EXISTS_gpath_draw_outline
 #define _PBL_API_EXISTS_gpath_rotate_to
 #define _PBL_API_EXISTS_gpath_move_to
 #define _PBL_API_EXISTS_gpath_draw_outline_open
+#define _PBL_API_EXISTS_gpath_transform_points
 #define _PBL_API_EXISTS_fonts_get_system_font
 #define _PBL_API_EXISTS_fonts_load_custom_font
 #define _PBL_API_EXISTS_fonts_unload_custom_font
+#define _PBL_API_EXISTS_fonts_set_glyph_cache_budget
+#define _PBL_API_EXISTS_fonts_preload_glyphs
 #define _PBL_API_EXISTS_graphics_text_attributes_create
 #define _PBL_API_EXISTS_graphics_text_attributes_destroy
 #define _PBL_API_EXISTS_graphics_text_attributes_restore_default_text_flow
@@ -279,6 +455,12 @@
 #define _PBL_API_EXISTS_graphics_draw_text
 #define _PBL_API_EXISTS_graphics_text_layout_get_content_size
 #define _PBL_API_EXISTS_graphics_text_layout_get_content_size_with_attributes
+#define _PBL_API_EXISTS_graphics_text_fits_in_box
+#define _PBL_API_EXISTS_graphics_text_layout_create
+#define _PBL_API_EXISTS_graphics_text_layout_destroy
+#define _PBL_API_EXISTS_graphics_text_layout_set_text
+#define _PBL_API_EXISTS_graphics_text_layout_get_cached_content_size
+#define _PBL_API_EXISTS_graphics_draw_text_layout
 #define _PBL_API_EXISTS_smartstrap_subscribe
 #define _PBL_API_EXISTS_smartstrap_unsubscribe
 #define _PBL_API_EXISTS_smartstrap_set_timeout
@@ -290,13 +472,24 @@
 #define _PBL_API_EXISTS_smartstrap_attribute_read
 #define _PBL_API_EXISTS_smartstrap_attribute_begin_write
 #define _PBL_API_EXISTS_smartstrap_attribute_end_write
+#define _PBL_API_EXISTS_smartstrap_batch_send
+#define _PBL_API_EXISTS_smartstrap_attribute_stream_start
+#define _PBL_API_EXISTS_smartstrap_attribute_stream_stop
+#define _PBL_API_EXISTS_smartstrap_set_baud_rate
+#define _PBL_API_EXISTS_smartstrap_get_baud_rate
 #define _PBL_API_EXISTS_click_number_of_clicks_counted
 #define _PBL_API_EXISTS_click_recognizer_get_button_id
 #define _PBL_API_EXISTS_click_recognizer_is_repeating
 #define _PBL_API_EXISTS_layer_create
 #define _PBL_API_EXISTS_layer_create_with_data
 #define _PBL_API_EXISTS_layer_destroy
+#define _PBL_API_EXISTS_layer_pool_create
+#define _PBL_API_EXISTS_layer_pool_destroy
+#define _PBL_API_EXISTS_layer_pool_acquire
+#define _PBL_API_EXISTS_layer_pool_release
+#define _PBL_API_EXISTS_layer_pool_release_all
 #define _PBL_API_EXISTS_layer_mark_dirty
+#define _PBL_API_EXISTS_layer_mark_dirty_rect
 #define _PBL_API_EXISTS_layer_set_update_proc
 #define _PBL_API_EXISTS_layer_set_frame
 #define _PBL_API_EXISTS_layer_get_frame
@@ -315,6 +508,10 @@
 #define _PBL_API_EXISTS_layer_get_hidden
 #define _PBL_API_EXISTS_layer_set_clips
 #define _PBL_API_EXISTS_layer_get_clips
+#define _PBL_API_EXISTS_layer_set_cached
+#define _PBL_API_EXISTS_layer_get_cached
+#define _PBL_API_EXISTS_layer_set_spatial_index
+#define _PBL_API_EXISTS_layer_get_spatial_index
 #define _PBL_API_EXISTS_layer_get_data
 #define _PBL_API_EXISTS_window_create
 #define _PBL_API_EXISTS_window_destroy
@@ -325,7 +522,13 @@
 #define _PBL_API_EXISTS_window_set_window_handlers
 #define _PBL_API_EXISTS_window_get_root_layer
 #define _PBL_API_EXISTS_window_set_background_color
+#define _PBL_API_EXISTS_window_set_transparent
+#define _PBL_API_EXISTS_window_get_transparent
 #define _PBL_API_EXISTS_window_is_loaded
+#define _PBL_API_EXISTS_window_preload
+#define _PBL_API_EXISTS_window_cancel_preload
+#define _PBL_API_EXISTS_window_set_hibernation_handlers
+#define _PBL_API_EXISTS_window_is_hibernating
 #define _PBL_API_EXISTS_window_set_user_data
 #define _PBL_API_EXISTS_window_get_user_data
 #define _PBL_API_EXISTS_window_single_click_subscribe
@@ -334,12 +537,16 @@
 #define _PBL_API_EXISTS_window_long_click_subscribe
 #define _PBL_API_EXISTS_window_raw_click_subscribe
 #define _PBL_API_EXISTS_window_set_click_context
+#define _PBL_API_EXISTS_window_set_click_repeat_options
 #define _PBL_API_EXISTS_window_stack_push
 #define _PBL_API_EXISTS_window_stack_pop
 #define _PBL_API_EXISTS_window_stack_pop_all
 #define _PBL_API_EXISTS_window_stack_remove
 #define _PBL_API_EXISTS_window_stack_get_top_window
 #define _PBL_API_EXISTS_window_stack_contains_window
+#define _PBL_API_EXISTS_window_stack_set_hibernation_depth
+#define _PBL_API_EXISTS_window_stack_push_with_transition
+#define _PBL_API_EXISTS_window_stack_remove_with_transition
 #define _PBL_API_EXISTS_animation_create
 #define _PBL_API_EXISTS_animation_destroy
 #define _PBL_API_EXISTS_animation_clone
@@ -361,6 +568,9 @@
 #define _PBL_API_EXISTS_animation_get_curve
 #define _PBL_API_EXISTS_animation_set_custom_curve
 #define _PBL_API_EXISTS_animation_get_custom_curve
+#define _PBL_API_EXISTS_animation_set_curve_table
+#define _PBL_API_EXISTS_animation_get_curve_table
+#define _PBL_API_EXISTS_animation_get_builtin_curve_table
 #define _PBL_API_EXISTS_animation_set_handlers
 #define _PBL_API_EXISTS_animation_get_context
 #define _PBL_API_EXISTS_animation_schedule
@@ -369,9 +579,12 @@
 #define _PBL_API_EXISTS_animation_is_scheduled
 #define _PBL_API_EXISTS_animation_set_implementation
 #define _PBL_API_EXISTS_animation_get_implementation
+#define _PBL_API_EXISTS_animation_get_frame_time
+#define _PBL_API_EXISTS_animation_get_frame_interval
 #define _PBL_API_EXISTS_property_animation_create_layer_frame
 #define _PBL_API_EXISTS_property_animation_create_bounds_origin
 #define _PBL_API_EXISTS_property_animation_create
+#define _PBL_API_EXISTS_property_animation_create_with_fields
 #define _PBL_API_EXISTS_property_animation_destroy
 #define _PBL_API_EXISTS_property_animation_update_int16
 #define _PBL_API_EXISTS_property_animation_update_uint32
@@ -382,8 +595,15 @@
 #define _PBL_API_EXISTS_property_animation_subject
 #define _PBL_API_EXISTS_property_animation_from
 #define _PBL_API_EXISTS_property_animation_to
+#define _PBL_API_EXISTS_palette_animation_create
+#define _PBL_API_EXISTS_palette_animation_create_cycle
+#define _PBL_API_EXISTS_palette_animation_set_layer
+#define _PBL_API_EXISTS_palette_animation_get_animation
+#define _PBL_API_EXISTS_palette_animation_destroy
 #define _PBL_API_EXISTS_unobstructed_area_service_subscribe
 #define _PBL_API_EXISTS_unobstructed_area_service_unsubscribe
+#define _PBL_API_EXISTS_unobstructed_area_layout_add_layer
+#define _PBL_API_EXISTS_unobstructed_area_layout_remove_layer
 #define _PBL_API_EXISTS_text_layer_create
 #define _PBL_API_EXISTS_text_layer_destroy
 #define _PBL_API_EXISTS_text_layer_get_layer
@@ -397,6 +617,7 @@
 #define _PBL_API_EXISTS_text_layer_enable_screen_text_flow_and_paging
 #define _PBL_API_EXISTS_text_layer_restore_default_text_flow_and_paging
 #define _PBL_API_EXISTS_text_layer_get_content_size
+#define _PBL_API_EXISTS_text_layer_text_fits
 #define _PBL_API_EXISTS_text_layer_set_size
 #define _PBL_API_EXISTS_scroll_layer_create
 #define _PBL_API_EXISTS_scroll_layer_destroy
@@ -416,6 +637,8 @@
 #define _PBL_API_EXISTS_scroll_layer_get_shadow_hidden
 #define _PBL_API_EXISTS_scroll_layer_set_paging
 #define _PBL_API_EXISTS_scroll_layer_get_paging
+#define _PBL_API_EXISTS_scroll_layer_set_tiled_rendering
+#define _PBL_API_EXISTS_scroll_layer_get_tile_height
 #define _PBL_API_EXISTS_scroll_layer_get_content_indicator
 #define _PBL_API_EXISTS_content_indicator_create
 #define _PBL_API_EXISTS_content_indicator_destroy
@@ -436,14 +659,21 @@
 #define _PBL_API_EXISTS_menu_layer_set_selected_index
 #define _PBL_API_EXISTS_menu_layer_get_selected_index
 #define _PBL_API_EXISTS_menu_layer_reload_data
+#define _PBL_API_EXISTS_menu_layer_set_virtualized
+#define _PBL_API_EXISTS_menu_layer_reload_rows
+#define _PBL_API_EXISTS_menu_layer_insert_rows
+#define _PBL_API_EXISTS_menu_layer_delete_rows
+#define _PBL_API_EXISTS_menu_layer_update_rows
 #define _PBL_API_EXISTS_menu_cell_layer_is_highlighted
 #define _PBL_API_EXISTS_menu_layer_set_normal_colors
 #define _PBL_API_EXISTS_menu_layer_set_highlight_colors
+#define _PBL_API_EXISTS_menu_layer_set_row_cache_budget
 #define _PBL_API_EXISTS_menu_layer_pad_bottom_enable
 #define _PBL_API_EXISTS_menu_layer_get_center_focused
 #define _PBL_API_EXISTS_menu_layer_set_center_focused
 #define _PBL_API_EXISTS_menu_layer_is_index_selected
 #define _PBL_API_EXISTS_simple_menu_layer_create
+#define _PBL_API_EXISTS_simple_menu_layer_create_with_resource
 #define _PBL_API_EXISTS_simple_menu_layer_destroy
 #define _PBL_API_EXISTS_simple_menu_layer_get_layer
 #define _PBL_API_EXISTS_simple_menu_layer_get_selected_index
@@ -468,11 +698,13 @@
 #define _PBL_API_EXISTS_status_bar_layer_get_foreground_color
 #define _PBL_API_EXISTS_status_bar_layer_set_colors
 #define _PBL_API_EXISTS_status_bar_layer_set_separator_mode
+#define _PBL_API_EXISTS_status_bar_layer_set_shared_rendering
 #define _PBL_API_EXISTS_bitmap_layer_create
 #define _PBL_API_EXISTS_bitmap_layer_destroy
 #define _PBL_API_EXISTS_bitmap_layer_get_layer
 #define _PBL_API_EXISTS_bitmap_layer_get_bitmap
 #define _PBL_API_EXISTS_bitmap_layer_set_bitmap
+#define _PBL_API_EXISTS_bitmap_layer_set_bitmap_with_resource_async
 #define _PBL_API_EXISTS_bitmap_layer_set_alignment
 #define _PBL_API_EXISTS_bitmap_layer_set_background_color
 #define _PBL_API_EXISTS_bitmap_layer_set_compositing_mode
@@ -483,6 +715,7 @@
 #define _PBL_API_EXISTS_rot_bitmap_layer_increment_angle
 #define _PBL_API_EXISTS_rot_bitmap_set_src_ic
 #define _PBL_API_EXISTS_rot_bitmap_set_compositing_mode
+#define _PBL_API_EXISTS_rot_bitmap_layer_prerender_angle_steps
 #define _PBL_API_EXISTS_number_window_create
 #define _PBL_API_EXISTS_number_window_destroy
 #define _PBL_API_EXISTS_number_window_set_label
@@ -498,6 +731,7 @@
 #define _PBL_API_EXISTS_action_menu_level_set_display_mode
 #define _PBL_API_EXISTS_action_menu_level_add_action
 #define _PBL_API_EXISTS_action_menu_level_add_child
+#define _PBL_API_EXISTS_action_menu_level_add_lazy_child
 #define _PBL_API_EXISTS_action_menu_hierarchy_destroy
 #define _PBL_API_EXISTS_action_menu_get_context
 #define _PBL_API_EXISTS_action_menu_get_root_level
@@ -511,11 +745,31 @@
 #define _PBL_API_EXISTS_vibes_long_pulse
 #define _PBL_API_EXISTS_vibes_double_pulse
 #define _PBL_API_EXISTS_vibes_enqueue_custom_pattern
+#define _PBL_API_EXISTS_vibes_compile_pattern
+#define _PBL_API_EXISTS_vibes_compile_envelope
+#define _PBL_API_EXISTS_vibes_enqueue_compiled_pattern
+#define _PBL_API_EXISTS_vibes_destroy_compiled_pattern
 #define _PBL_API_EXISTS_light_enable_interaction
 #define _PBL_API_EXISTS_light_enable
 #define _PBL_API_EXISTS_preferred_result_display_duration
 #define _PBL_API_EXISTS_preferred_content_size
 #define _PBL_API_EXISTS_quiet_time_is_active
+#define _PBL_API_EXISTS_profiler_cycles
+#define _PBL_API_EXISTS_profiler_cycles_per_second
+#define _PBL_API_EXISTS_profiler_node_start
+#define _PBL_API_EXISTS_profiler_node_stop
+#define _PBL_API_EXISTS_profiler_node_stop_scope
+#define _PBL_API_EXISTS_profiler_print_stats
+#define _PBL_API_EXISTS_profiler_set_enabled
+#define _PBL_API_EXISTS_profiler_get_frame_stats
+#define _PBL_API_EXISTS_profiler_get_layer_render_time_us
+#define _PBL_API_EXISTS_profiler_set_log_interval
+#define _PBL_API_EXISTS_profiler_frame_stream_start
+#define _PBL_API_EXISTS_profiler_frame_stream_stop
+#define _PBL_API_EXISTS_profiler_telemetry_start
+#define _PBL_API_EXISTS_profiler_telemetry_stop
+#define _PBL_API_EXISTS_profiler_event_record_start
+#define _PBL_API_EXISTS_profiler_event_record_stop
 #define _PBL_API_EXISTS_strftime
 #define _PBL_API_EXISTS_localtime
 #define _PBL_API_EXISTS_gmtime
@@ -524,6 +778,8 @@
 #define _PBL_API_EXISTS_difftime
 #define _PBL_API_EXISTS_time_ms
 #define _PBL_API_EXISTS_time_start_of_today
+#define _PBL_API_EXISTS_int_snprintf
+#define _PBL_API_EXISTS_int_format
 
 //! @addtogroup Misc
 //! @{